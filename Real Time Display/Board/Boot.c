@@ -0,0 +1,97 @@
+/*************************************************************************
+* Boot.c - Staged start up with a boot profile, see Boot.h
+*
+*               Marks are kept as cycle counts from BootStart() and turned
+*               into us when they are read, so a mark costs a counter read
+*               and a critical section. The counter wraps after 2^32
+*               cycles, 23.8s at 180MHz, marks after that are meaningless.
+*
+* 10/18/2026 Initial version
+*************************************************************************
+* Header Files - Dependencies
+*************************************************************************/
+#include "MCUType.h"
+#include "os.h"
+#include "Boot.h"
+#include "CycCnt.h"
+
+/*************************************************************************
+  Global Variables
+*************************************************************************/
+#if BOOT_PROFILE_EN
+static INT32U bootStartCyc;
+static const INT8C *bootNames[BOOT_MAX_MARKS];
+static INT32U bootCyc[BOOT_MAX_MARKS];
+static INT8U bootNumMarks;
+#endif
+
+/*************************************************************************
+  BootStart() - Starts the boot clock                            (Public)
+
+        Call first thing in main(), before OSInit().
+*************************************************************************/
+void BootStart(void){
+#if BOOT_PROFILE_EN
+    CYC_CNT_INIT();
+    bootStartCyc = CYC_CNT_GET();
+    bootNumMarks = 0;
+#endif
+}
+
+/*************************************************************************
+  BootRun() - Runs start up stages in order                      (Public)
+
+        Each stage's name is marked when its Init returns. Called from
+        the start task, after the stage that starts the tick if any
+        stage uses OS delays.
+*************************************************************************/
+void BootRun(const BOOT_STAGE *stages, INT8U num){
+    INT8U stage;
+
+    for(stage = 0; stage < num; stage++){
+        stages[stage].Init();
+        BOOT_MARK(stages[stage].name);
+    }
+}
+
+#if BOOT_PROFILE_EN
+/*************************************************************************
+  BootMark() - Timestamps a point in start up                    (Public)
+*************************************************************************/
+void BootMark(const INT8C *name){
+    INT32U cyc;
+    CPU_SR_ALLOC();
+
+    cyc = CYC_CNT_GET() - bootStartCyc;
+    CPU_CRITICAL_ENTER();
+    if(bootNumMarks < BOOT_MAX_MARKS){
+        bootNames[bootNumMarks] = name;
+        bootCyc[bootNumMarks] = cyc;
+        bootNumMarks++;
+    }else{
+    }
+    CPU_CRITICAL_EXIT();
+}
+
+/*************************************************************************
+  BootProfileGet() - Copies the boot profile                     (Public)
+*************************************************************************/
+INT8U BootProfileGet(BOOT_MARK_T *marks, INT8U max){
+    INT8U mark, num;
+    INT32U cyc_per_us = SystemCoreClock / 1000000u;
+    CPU_SR_ALLOC();
+
+    CPU_CRITICAL_ENTER();
+    num = bootNumMarks;
+    CPU_CRITICAL_EXIT();
+    if(num > max){
+        num = max;
+    }else{
+    }
+    for(mark = 0; mark < num; mark++){
+        marks[mark].name = bootNames[mark];
+        marks[mark].us = bootCyc[mark] / cyc_per_us;
+    }
+    return(num);
+}
+#endif
@@ -0,0 +1,61 @@
+/*************************************************************************
+* Boot.h - Staged start up with a boot profile
+*
+*            Start up is a table of stages run in order by BootRun(),
+*            from the start task. A stage must not spin on hardware, a
+*            subsystem with long waits starts its own task in its stage
+*            and does the waits there as OS delays, so the stages after
+*            it run while it waits. The LCD power up is done that way.
+*
+*            Every stage end is timestamped on the DWT cycle counter,
+*            and a subsystem task can add its own marks with BOOT_MARK(),
+*            the LCD task marks the display powered up and its first
+*            frame. BootProfileGet() reads the marks at run time, in us
+*            from BootStart().
+*
+*            Set BOOT_PROFILE_EN to 0 and BOOT_MARK() compiles to
+*            nothing, BootRun() still runs the stages.
+*
+* 10/18/2026 Initial version
+*************************************************************************/
+#ifndef BOOT_DEF
+#define BOOT_DEF
+
+#ifndef BOOT_PROFILE_EN
+#define BOOT_PROFILE_EN 1
+#endif
+
+#define BOOT_MAX_MARKS 16u
+
+#if BOOT_PROFILE_EN
+#define BOOT_MARK(name) BootMark(name)
+#else
+#define BOOT_MARK(name)
+#endif
+
+typedef struct{
+    const INT8C *name;          /* Profile mark when the stage is done  */
+    void (*Init)(void);
+}BOOT_STAGE;
+
+typedef struct{
+    const INT8C *name;
+    INT32U us;                  /* Since BootStart()                    */
+}BOOT_MARK_T;
+
+void BootStart(void);           /* First thing in main(), starts the clock */
+
+void BootRun(const BOOT_STAGE *stages, INT8U num);
+                                /* Runs the stages in order, marking each */
+
+#if BOOT_PROFILE_EN
+void BootMark(const INT8C *name);
+                                /* Timestamps name, any task. The name is */
+                                /* not copied. Full profiles drop marks   */
+
+INT8U BootProfileGet(BOOT_MARK_T *marks, INT8U max);
+                                /* Copies up to max marks in the order    */
+                                /* made, returns the number copied        */
+#endif
+
+#endif
@@ -0,0 +1,22 @@
+/***************************************************************************************
+* CycCnt.h - Cortex-M4 DWT cycle counter access for timing measurements
+*
+*            CYC_CNT_INIT() enables the free running 32-bit core cycle counter.
+*            It is safe to call more than once. CYC_CNT_GET() reads it. The
+*            difference of two reads, as INT32U, is the elapsed core clocks
+*            for intervals up to 2^32 cycles (23.8s at 180MHz).
+*
+* 10/18/2026 Initial version
+****************************************************************************************/
+
+#ifndef CYC_CNT_H_
+#define CYC_CNT_H_
+
+#define CYC_CNT_INIT() do{                                          \
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;             \
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;                        \
+    }while(0)
+
+#define CYC_CNT_GET() ((INT32U)DWT->CYCCNT)
+
+#endif /* CYC_CNT_H_ */
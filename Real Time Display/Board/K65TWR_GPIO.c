@@ -3,9 +3,18 @@
 * Todd Morton, 10/08/2015
 * Todd Morton, 11/25/2015 Modified for new Debug bits. See EE344, Lab5, 2015
 * Todd Morton, 10/16/2017 Modified to remove includes.h
+* 10/18/2026 Added the debug bit trace
  ****************************************************************************************/
 #include "MCUType.h"
 #include "K65TWR_GPIO.h"
+#include "CycCnt.h"
+
+#if DB_TRACE_EN
+static DB_TRACE_REC gpioDBugTraceBuf[DB_TRACE_SIZE];
+static INT16U gpioDBugTraceHead;
+static INT16U gpioDBugTraceCount;
+static INT32U gpioDBugTraceLost;
+#endif
 
 /*****************************************************************************************
 * GpioSw3Init - Initialization for SW3 on the TWR-K65 board
@@ -94,5 +103,63 @@ void GpioDBugBitsInit(void){
     GPIOB_PCOR = GPIO_PIN(DB4_BIT)|GPIO_PIN(DB5_BIT)|GPIO_PIN(DB6_BIT)|GPIO_PIN(DB7_BIT);
     GPIOC_PDDR = GPIO_PIN(DB0_BIT)|GPIO_PIN(DB1_BIT)|GPIO_PIN(DB2_BIT)|GPIO_PIN(DB3_BIT);
     GPIOB_PDDR = GPIO_PIN(DB4_BIT)|GPIO_PIN(DB5_BIT)|GPIO_PIN(DB6_BIT)|GPIO_PIN(DB7_BIT);
+#if DB_TRACE_EN
+    CYC_CNT_INIT();
+#endif
+}
+
+#if DB_TRACE_EN
+/*****************************************************************************************
+* GpioDBugTrace - Logs a debug bit edge, called by the DBn_ macros.
+*   Safe from tasks and interrupts, the log is only touched with interrupts masked.
+* 10/18/2026
+ ****************************************************************************************/
+void GpioDBugTrace(INT8U bit, INT8U level){
+    DB_TRACE_REC *rec;
+    INT32U primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if(gpioDBugTraceCount < DB_TRACE_SIZE){
+        rec = &gpioDBugTraceBuf[(gpioDBugTraceHead + gpioDBugTraceCount) % DB_TRACE_SIZE];
+        rec->cyc = CYC_CNT_GET();
+        rec->bit = bit;
+        rec->level = level;
+        gpioDBugTraceCount++;
+    }else{
+        gpioDBugTraceLost++;
+    }
+    __set_PRIMASK(primask);
+}
+
+/*****************************************************************************************
+* GpioDBugTraceRead - Takes the oldest edge from the log.
+*   Returns TRUE if *rec was filled, FALSE if the log is empty.
+* 10/18/2026
+ ****************************************************************************************/
+INT8U GpioDBugTraceRead(DB_TRACE_REC *rec){
+    INT8U got;
+    INT32U primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if(gpioDBugTraceCount != 0){
+        *rec = gpioDBugTraceBuf[gpioDBugTraceHead];
+        gpioDBugTraceHead = (gpioDBugTraceHead + 1u) % DB_TRACE_SIZE;
+        gpioDBugTraceCount--;
+        got = TRUE;
+    }else{
+        got = FALSE;
+    }
+    __set_PRIMASK(primask);
+    return(got);
 }
 
+/*****************************************************************************************
+* GpioDBugTraceLost - Edges dropped because the log was full.
+* 10/18/2026
+ ****************************************************************************************/
+INT32U GpioDBugTraceLost(void){
+    return(gpioDBugTraceLost);
+}
+#endif
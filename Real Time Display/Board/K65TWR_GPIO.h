@@ -2,16 +2,45 @@
 * K65TWR_GPIO.h - K65TWR GPIO support package
 * Todd Morton, 10/08/2015
 * Todd Morton, 11/25/2015 Modified for new Debug bits. See EE344, Lab5, 2015
+* 10/18/2026 Added the debug bit trace, DB_TRACE_EN
 ****************************************************************************************/
 
 #ifndef GPIO_H_
 #define GPIO_H_
 
+/****************************************************************************************
+ * Set DB_TRACE_EN to 1 to also log every debug bit edge with its DWT cycle count, so
+ * the timing a scope shows on DB0-DB7 can be read back in software or on a host build.
+ * The log holds DB_TRACE_SIZE edges, newer edges are dropped while it is full.
+ ***************************************************************************************/
+#ifndef DB_TRACE_EN
+#define DB_TRACE_EN 0
+#endif
+#define DB_TRACE_SIZE 256u
+
+#define DB_TRACE_OFF    0u
+#define DB_TRACE_ON     1u
+#define DB_TRACE_TOGGLE 2u
+
+typedef struct{
+    INT32U cyc;         /* CYC_CNT_GET() at the edge */
+    INT8U bit;          /* Debug bit, 0 to 7 */
+    INT8U level;        /* DB_TRACE_OFF, DB_TRACE_ON or DB_TRACE_TOGGLE */
+}DB_TRACE_REC;
+
 void GpioSw3Init(INT8U irqc);
 void GpioSw2Init(INT8U irqc);
 void GpioLED8Init(void);
 void GpioLED9Init(void);
 void GpioDBugBitsInit(void);
+#if DB_TRACE_EN
+void GpioDBugTrace(INT8U bit, INT8U level);
+INT8U GpioDBugTraceRead(DB_TRACE_REC *rec);
+INT32U GpioDBugTraceLost(void);
+#define DB_TRACE(bit, level) GpioDBugTrace((bit), (level))
+#else
+#define DB_TRACE(bit, level) ((void)0)
+#endif
 
 /****************************************************************************************
  * Pin macro
@@ -54,30 +83,30 @@ void GpioDBugBitsInit(void);
 #define DB6_BIT 21
 #define DB7_BIT 20
 
-#define DB0_TURN_ON() (GPIOC_PSOR = GPIO_PIN(DB0_BIT))
-#define DB1_TURN_ON() (GPIOC_PSOR = GPIO_PIN(DB1_BIT))
-#define DB2_TURN_ON() (GPIOC_PSOR = GPIO_PIN(DB2_BIT))
-#define DB3_TURN_ON() (GPIOC_PSOR = GPIO_PIN(DB3_BIT))
-#define DB4_TURN_ON() (GPIOB_PSOR = GPIO_PIN(DB4_BIT))
-#define DB5_TURN_ON() (GPIOB_PSOR = GPIO_PIN(DB5_BIT))
-#define DB6_TURN_ON() (GPIOB_PSOR = GPIO_PIN(DB6_BIT))
-#define DB7_TURN_ON() (GPIOB_PSOR = GPIO_PIN(DB7_BIT))
+#define DB0_TURN_ON() (DB_TRACE(0u, DB_TRACE_ON), GPIOC_PSOR = GPIO_PIN(DB0_BIT))
+#define DB1_TURN_ON() (DB_TRACE(1u, DB_TRACE_ON), GPIOC_PSOR = GPIO_PIN(DB1_BIT))
+#define DB2_TURN_ON() (DB_TRACE(2u, DB_TRACE_ON), GPIOC_PSOR = GPIO_PIN(DB2_BIT))
+#define DB3_TURN_ON() (DB_TRACE(3u, DB_TRACE_ON), GPIOC_PSOR = GPIO_PIN(DB3_BIT))
+#define DB4_TURN_ON() (DB_TRACE(4u, DB_TRACE_ON), GPIOB_PSOR = GPIO_PIN(DB4_BIT))
+#define DB5_TURN_ON() (DB_TRACE(5u, DB_TRACE_ON), GPIOB_PSOR = GPIO_PIN(DB5_BIT))
+#define DB6_TURN_ON() (DB_TRACE(6u, DB_TRACE_ON), GPIOB_PSOR = GPIO_PIN(DB6_BIT))
+#define DB7_TURN_ON() (DB_TRACE(7u, DB_TRACE_ON), GPIOB_PSOR = GPIO_PIN(DB7_BIT))
 
-#define DB0_TURN_OFF() (GPIOC_PCOR = GPIO_PIN(DB0_BIT))
-#define DB1_TURN_OFF() (GPIOC_PCOR = GPIO_PIN(DB1_BIT))
-#define DB2_TURN_OFF() (GPIOC_PCOR = GPIO_PIN(DB2_BIT))
-#define DB3_TURN_OFF() (GPIOC_PCOR = GPIO_PIN(DB3_BIT))
-#define DB4_TURN_OFF() (GPIOB_PCOR = GPIO_PIN(DB4_BIT))
-#define DB5_TURN_OFF() (GPIOB_PCOR = GPIO_PIN(DB5_BIT))
-#define DB6_TURN_OFF() (GPIOB_PCOR = GPIO_PIN(DB6_BIT))
-#define DB7_TURN_OFF() (GPIOB_PCOR = GPIO_PIN(DB7_BIT))
+#define DB0_TURN_OFF() (DB_TRACE(0u, DB_TRACE_OFF), GPIOC_PCOR = GPIO_PIN(DB0_BIT))
+#define DB1_TURN_OFF() (DB_TRACE(1u, DB_TRACE_OFF), GPIOC_PCOR = GPIO_PIN(DB1_BIT))
+#define DB2_TURN_OFF() (DB_TRACE(2u, DB_TRACE_OFF), GPIOC_PCOR = GPIO_PIN(DB2_BIT))
+#define DB3_TURN_OFF() (DB_TRACE(3u, DB_TRACE_OFF), GPIOC_PCOR = GPIO_PIN(DB3_BIT))
+#define DB4_TURN_OFF() (DB_TRACE(4u, DB_TRACE_OFF), GPIOB_PCOR = GPIO_PIN(DB4_BIT))
+#define DB5_TURN_OFF() (DB_TRACE(5u, DB_TRACE_OFF), GPIOB_PCOR = GPIO_PIN(DB5_BIT))
+#define DB6_TURN_OFF() (DB_TRACE(6u, DB_TRACE_OFF), GPIOB_PCOR = GPIO_PIN(DB6_BIT))
+#define DB7_TURN_OFF() (DB_TRACE(7u, DB_TRACE_OFF), GPIOB_PCOR = GPIO_PIN(DB7_BIT))
 
-#define DB0_TOGGLE() (GPIOC_PTOR = GPIO_PIN(DB0_BIT))
-#define DB1_TOGGLE() (GPIOC_PTOR = GPIO_PIN(DB1_BIT))
-#define DB2_TOGGLE() (GPIOC_PTOR = GPIO_PIN(DB2_BIT))
-#define DB3_TOGGLE() (GPIOC_PTOR = GPIO_PIN(DB3_BIT))
-#define DB4_TOGGLE() (GPIOB_PTOR = GPIO_PIN(DB4_BIT))
-#define DB5_TOGGLE() (GPIOB_PTOR = GPIO_PIN(DB5_BIT))
-#define DB6_TOGGLE() (GPIOB_PTOR = GPIO_PIN(DB6_BIT))
-#define DB7_TOGGLE() (GPIOB_PTOR = GPIO_PIN(DB7_BIT))
+#define DB0_TOGGLE() (DB_TRACE(0u, DB_TRACE_TOGGLE), GPIOC_PTOR = GPIO_PIN(DB0_BIT))
+#define DB1_TOGGLE() (DB_TRACE(1u, DB_TRACE_TOGGLE), GPIOC_PTOR = GPIO_PIN(DB1_BIT))
+#define DB2_TOGGLE() (DB_TRACE(2u, DB_TRACE_TOGGLE), GPIOC_PTOR = GPIO_PIN(DB2_BIT))
+#define DB3_TOGGLE() (DB_TRACE(3u, DB_TRACE_TOGGLE), GPIOC_PTOR = GPIO_PIN(DB3_BIT))
+#define DB4_TOGGLE() (DB_TRACE(4u, DB_TRACE_TOGGLE), GPIOB_PTOR = GPIO_PIN(DB4_BIT))
+#define DB5_TOGGLE() (DB_TRACE(5u, DB_TRACE_TOGGLE), GPIOB_PTOR = GPIO_PIN(DB5_BIT))
+#define DB6_TOGGLE() (DB_TRACE(6u, DB_TRACE_TOGGLE), GPIOB_PTOR = GPIO_PIN(DB6_BIT))
+#define DB7_TOGGLE() (DB_TRACE(7u, DB_TRACE_TOGGLE), GPIOB_PTOR = GPIO_PIN(DB7_BIT))
 #endif /* DBUGBITS_H_ */
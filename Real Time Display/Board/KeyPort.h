@@ -0,0 +1,87 @@
+/*************************************************************************
+* KeyPort.h - Port driver interface for the 4x4 matrix keypad
+*
+*            uCOSKey.c decides when to scan and what a scan means. Driving
+*            the rows, reading the columns and the column pin-change
+*            interrupt are the job of a port driver, so the key task and
+*            its interrupt path can be run against the real PORTC or
+*            against a simulated keypad.
+*
+*            Rows and columns are passed as a bit per line, bit 0 is
+*            ROW1/COL1. A port driver provides:
+*               Init      - Configure the pins. Columns are inputs pulled
+*                           high, rows are released and preset to drive
+*                           low. Column interrupts off.
+*               Rows      - Drive the rows with a bit set low and release
+*                           the rest.
+*               Cols      - Read the columns, a bit is set for each one
+*                           pulled low by a pressed key.
+*               Settle    - Wait for a new row drive to reach the column
+*                           inputs. Returns the time waited in ns.
+*               IrqEnable - Non-zero to clear pending column flags and
+*                           interrupt on the next falling edge of any
+*                           column, zero to turn column interrupts off.
+*               Filter    - Glitch filter on the column inputs, width in
+*                           1kHz LPO clocks (1 to 31), zero for off. A
+*                           column must hold a level for longer than the
+*                           width before reads and interrupts see it, so
+*                           only change it with all rows driven. Returns
+*                           FALSE if the port has no filter.
+*
+*            The port driver's interrupt handler turns column interrupts
+*            off before it calls KeyColIrq(), so a press costs one
+*            interrupt however much the contacts bounce.
+*
+*            Set KEY_PORT_VIRTUAL_EN to 1 to run uCOSKey.c against the
+*            simulated keypad in KeyPortVirtual.c instead of PORTC.
+*
+* 10/18/2026 Initial version
+* 10/18/2026 Added the column glitch filter
+* 10/18/2026 Settle() returns the time it waited
+* 10/18/2026 Adaptive settle rounds
+*************************************************************************/
+#ifndef KEY_PORT_DEF
+#define KEY_PORT_DEF
+
+#ifndef KEY_PORT_VIRTUAL_EN
+#define KEY_PORT_VIRTUAL_EN 0
+#endif
+
+/* Settle time after a row change, in ns. With KEY_SETTLE_ADAPT_EN the */
+/* K65 driver starts here and comes down to twice the slowest column  */
+/* change of a round it has seen, going back up here now and then to  */
+/* look again. KEY_SETTLE_NS stays the ceiling.                       */
+#ifndef KEY_SETTLE_NS
+#define KEY_SETTLE_NS 830u
+#endif
+#ifndef KEY_SETTLE_ADAPT_EN
+#define KEY_SETTLE_ADAPT_EN 0
+#endif
+
+#define KEY_NUM_ROWS  4
+#define KEY_NUM_COLS  4
+#define KEY_ALL_ROWS  ((INT8U)((1u << KEY_NUM_ROWS) - 1u))
+#define KEY_FILTER_MAX 31u      /* Widest filter, in LPO clocks */
+
+/*************************************************************************
+  Port Driver Interface
+*************************************************************************/
+typedef struct{
+    void (*Init)(void);
+    void (*Rows)(INT8U rows);
+    INT8U (*Cols)(void);
+    INT32U (*Settle)(void);
+    void (*IrqEnable)(INT8U on);
+    INT8U (*Filter)(INT8U width);
+}KEY_PORT_DRV;
+
+extern const KEY_PORT_DRV KeyPortK65;          // PORTC, see KeyPortK65.c
+
+#if KEY_PORT_VIRTUAL_EN
+extern const KEY_PORT_DRV KeyPortVirtual;      // Simulated, KeyPortVirtual.c
+#endif
+
+void KeyColIrq(void);           /* Column edge, called by the port driver  */
+                                /* with column interrupts already off      */
+
+#endif
@@ -0,0 +1,256 @@
+/*************************************************************************
+* KeyPortK65.c - Keypad port driver for the K65TWR LCD/Keypad board
+*
+*               The keypad is wired on PORTC:
+*                   COL1->PTC3, COL2->PTC4, COL3->PTC5, COL4->PTC6
+*                   ROW1->PTC7, ROW2->PTC8, ROW3->PTC9, ROW4->PTC10
+*
+*               The columns are inputs with pull-ups. The rows are preset
+*               to zero and a row is pulled low by switching its pin to an
+*               output, so rows that are not being driven float.
+*
+*               Column interrupts come in on PORTC_IRQHandler(). The
+*               debug bits share PORTC but never have IRQC set.
+*
+*               The K65 only has the DFER/DFCR/DFWR digital filters on
+*               PORTD, so there is no hardware glitch filter for these
+*               columns and keyPortFilter() says so.
+*
+* 10/18/2026 Split from uCOSKey.c, added column interrupts
+* 10/18/2026 Added keyPortFilter()
+* 10/18/2026 Settle delay timed on the cycle counter
+* 10/18/2026 Adaptive settle only comes down after a round of changes
+*            and goes back to KEY_SETTLE_NS to look again
+*************************************************************************
+* Header Files - Dependencies
+*************************************************************************/
+#include "MCUType.h"
+#include "os.h"
+#include "KeyPort.h"
+#include "CycCnt.h"
+
+/*************************************************************************
+* Key Port Defines
+*************************************************************************/
+#define KEY_PORT_OUT   GPIOC_PDOR
+#define KEY_PORT_DIR   GPIOC_PDDR
+#define KEY_PORT_IN    GPIOC_PDIR
+#define COLS_SHIFT 3
+#define ROWS_SHIFT 7
+#define COLS_MASK 0x00000078
+#define ROWS_MASK 0x00000780
+#define KEY_IRQC_FALLING 10u
+#define KEY_SETTLE_MIN_NS 100u      /* Adaptive floor */
+#define KEY_SETTLE_MARGIN 2u        /* Adaptive wait per ns of column change */
+#define KEY_SETTLE_SEEN 32u         /* Changes in a round before it comes down */
+#define KEY_SETTLE_RECHECK 1024u    /* Settles between full KEY_SETTLE_NS rounds */
+
+/*************************************************************************
+  Private Local Functions
+*************************************************************************/
+static void keyPortInit(void);
+static void keyPortRows(INT8U rows);
+static INT8U keyPortCols(void);
+static INT32U keyPortDly(void);
+static INT32U keyPortNsToCyc(INT32U ns);
+#if KEY_SETTLE_ADAPT_EN
+static INT32U keyPortAdaptCyc(INT32U rise);
+#endif
+static void keyPortIrqEnable(INT8U on);
+static INT8U keyPortFilter(INT8U width);
+
+const KEY_PORT_DRV KeyPortK65 = {keyPortInit, keyPortRows, keyPortCols,
+                                 keyPortDly, keyPortIrqEnable, keyPortFilter};
+
+static INT32U keyPortCycPerUs;      /* Core clocks per us */
+static INT32U keyPortDlyCyc;        /* Settle wait in core clocks */
+#if KEY_SETTLE_ADAPT_EN
+static INT32U keyPortRiseCyc;       /* Slowest column change this round */
+static INT8U keyPortSeen;           /* Column changes seen this round */
+static INT16U keyPortSettles;       /* Settles since the wait was widened */
+#endif
+
+/*************************************************************************
+  keyPortInit() - Sets up PORTC for the keypad                   (Private)
+*************************************************************************/
+static void keyPortInit(void){
+    SIM_SCGC5 |= SIM_SCGC5_PORTC_MASK;              /* Enable clock gate for PORTC */
+    PORTC_PCR3=PORT_PCR_MUX(1)|PORT_PCR_PS_MASK|PORT_PCR_PE_MASK;
+    PORTC_PCR4=PORT_PCR_MUX(1)|PORT_PCR_PS_MASK|PORT_PCR_PE_MASK;
+    PORTC_PCR5=PORT_PCR_MUX(1)|PORT_PCR_PS_MASK|PORT_PCR_PE_MASK;
+    PORTC_PCR6=PORT_PCR_MUX(1)|PORT_PCR_PS_MASK|PORT_PCR_PE_MASK;
+    PORTC_PCR7=PORT_PCR_MUX(1);
+    PORTC_PCR8=PORT_PCR_MUX(1);
+    PORTC_PCR9=PORT_PCR_MUX(1);
+    PORTC_PCR10=PORT_PCR_MUX(1);
+    KEY_PORT_OUT &= ~ROWS_MASK;            /* Preset all rows to zero    */
+    KEY_PORT_DIR &= ~ROWS_MASK;            /* Rows released              */
+    NVIC_ClearPendingIRQ(PORTC_IRQn);
+    NVIC_EnableIRQ(PORTC_IRQn);
+    CYC_CNT_INIT();
+    keyPortCycPerUs = SystemCoreClock / 1000000u;
+    keyPortDlyCyc = keyPortNsToCyc(KEY_SETTLE_NS);
+#if KEY_SETTLE_ADAPT_EN
+    keyPortRiseCyc = 0;
+    keyPortSeen = 0;
+    keyPortSettles = 0;
+#endif
+}
+
+/*************************************************************************
+  keyPortNsToCyc() - Core clocks in ns, rounded up               (Private)
+*************************************************************************/
+static INT32U keyPortNsToCyc(INT32U ns){
+    return(((ns * keyPortCycPerUs) + 999u) / 1000u);
+}
+
+#if KEY_SETTLE_ADAPT_EN
+/*************************************************************************
+  keyPortAdaptCyc() - The wait for a column change time, with the
+                      margin and inside the limits               (Private)
+*************************************************************************/
+static INT32U keyPortAdaptCyc(INT32U rise){
+    INT32U dly;
+
+    dly = rise * KEY_SETTLE_MARGIN;
+    if(dly < keyPortNsToCyc(KEY_SETTLE_MIN_NS)){
+        dly = keyPortNsToCyc(KEY_SETTLE_MIN_NS);
+    }else if(dly > keyPortNsToCyc(KEY_SETTLE_NS)){
+        dly = keyPortNsToCyc(KEY_SETTLE_NS);
+    }else{
+    }
+    return(dly);
+}
+#endif
+
+/*************************************************************************
+  keyPortRows() - Pulls the passed rows low, releases the rest   (Private)
+*************************************************************************/
+static void keyPortRows(INT8U rows){
+    KEY_PORT_DIR = (KEY_PORT_DIR & ~ROWS_MASK)|(((INT32U)rows << ROWS_SHIFT) & ROWS_MASK);
+}
+
+/*************************************************************************
+  keyPortCols() - Reads the columns, set for each one pulled low (Private)
+*************************************************************************/
+static INT8U keyPortCols(void){
+    return((INT8U)(((~KEY_PORT_IN) & COLS_MASK) >> COLS_SHIFT));
+}
+
+/*************************************************************************
+  keyPortIrqEnable() - Turns the column interrupts on or off     (Private)
+
+        Pending flags are cleared before the interrupt is turned on, so
+        an old edge, from the rows switching during a scan, can't fire.
+*************************************************************************/
+static void keyPortIrqEnable(INT8U on){
+    INT32U irqc;
+
+    if(on != 0){
+        irqc = PORT_PCR_IRQC(KEY_IRQC_FALLING);
+        PORTC_ISFR = COLS_MASK;
+    }else{
+        irqc = 0;
+    }
+    PORTC_PCR3 = (PORTC_PCR3 & ~PORT_PCR_IRQC_MASK)|irqc;
+    PORTC_PCR4 = (PORTC_PCR4 & ~PORT_PCR_IRQC_MASK)|irqc;
+    PORTC_PCR5 = (PORTC_PCR5 & ~PORT_PCR_IRQC_MASK)|irqc;
+    PORTC_PCR6 = (PORTC_PCR6 & ~PORT_PCR_IRQC_MASK)|irqc;
+}
+
+/*************************************************************************
+  keyPortFilter() - No digital filter on PORTC                   (Private)
+
+        The columns would need to move to PORTD to use it.
+*************************************************************************/
+static INT8U keyPortFilter(INT8U width){
+    (void)width;
+    return(FALSE);
+}
+
+/*************************************************************************
+  PORTC_IRQHandler() - Column edge interrupt              (Interrupt)
+
+        Turns the column interrupts off and clears the flags, so bounce
+        does not interrupt again, then wakes the key task.
+*************************************************************************/
+void PORTC_IRQHandler(void){
+    OSIntEnter();
+    if((PORTC_ISFR & COLS_MASK) != 0){
+        keyPortIrqEnable(FALSE);
+        PORTC_ISFR = COLS_MASK;
+        KeyColIrq();
+    }else{
+    }
+    OSIntExit();
+}
+
+/********************************************************************
+ * keyPortDly() a delay for keyScan() to wait until port row
+ * bit direction and column inputs are settled.
+ * Timed on the DWT cycle counter, so it does not depend on the
+ * optimiser, flash wait states or the clock. keyPortDlyCyc is
+ * KEY_SETTLE_NS at SystemCoreClock, read at init.
+ * With KEY_SETTLE_ADAPT_EN the columns are read for the whole wait
+ * and the time of the last change is the column change time. A
+ * change only shows up if it is inside the wait, so:
+ *  - A change that needs more than the wait, KEY_SETTLE_MARGIN
+ *    times it, raises the wait straight away.
+ *  - The wait only comes down once KEY_SETTLE_SEEN changes have
+ *    been seen, to KEY_SETTLE_MARGIN times the slowest of them.
+ *  - Every KEY_SETTLE_RECHECK settles the wait goes back to
+ *    KEY_SETTLE_NS and a new round starts, so a column that has
+ *    become slower than the wait is seen again.
+ * The wait is never under KEY_SETTLE_MIN_NS or over KEY_SETTLE_NS.
+ * Returns the time waited in ns.
+ * TDM 01/20/2013
+ *******************************************************************/
+static INT32U keyPortDly(void){
+    INT32U start, cyc;
+#if KEY_SETTLE_ADAPT_EN
+    INT32U rise = 0;
+    INT8U cols, last;
+
+    start = CYC_CNT_GET();
+    last = keyPortCols();
+    do{
+        cyc = CYC_CNT_GET() - start;
+        cols = keyPortCols();
+        if(cols != last){
+            last = cols;
+            rise = cyc;
+        }else{
+        }
+    }while(cyc < keyPortDlyCyc);
+    if(rise != 0){
+        keyPortSeen++;
+        if(rise > keyPortRiseCyc){
+            keyPortRiseCyc = rise;
+        }else{
+        }
+        if(keyPortAdaptCyc(rise) > keyPortDlyCyc){
+            keyPortDlyCyc = keyPortAdaptCyc(rise);
+        }else if(keyPortSeen >= KEY_SETTLE_SEEN){
+            keyPortDlyCyc = keyPortAdaptCyc(keyPortRiseCyc);
+            keyPortRiseCyc = 0;
+            keyPortSeen = 0;
+        }else{
+        }
+    }else{
+    }
+    keyPortSettles++;
+    if(keyPortSettles >= KEY_SETTLE_RECHECK){
+        keyPortSettles = 0;
+        keyPortDlyCyc = keyPortNsToCyc(KEY_SETTLE_NS);
+        keyPortRiseCyc = 0;
+        keyPortSeen = 0;
+    }else{
+    }
+#else
+    start = CYC_CNT_GET();
+    do{
+        cyc = CYC_CNT_GET() - start;
+    }while(cyc < keyPortDlyCyc);
+#endif
+    return((cyc * 1000u) / keyPortCycPerUs);
+}
@@ -0,0 +1,288 @@
+/*************************************************************************
+* KeyPortVirtual.c - Simulated 4x4 matrix keypad
+*
+*               Implements the KEY_PORT_DRV interface without hardware.
+*               A column reads low if a key is down in any row being
+*               driven, like the real matrix with its pull-ups. Column
+*               interrupts latch a falling edge only while they are on,
+*               so an edge that happened before IrqEnable() is lost, the
+*               same as clearing PORTC_ISFR.
+*
+*               With a column's DFER bit set and the LPO clock selected,
+*               reads and interrupts see the filter output instead of the
+*               line. The output takes the line's level once it has been
+*               different for more than DFWR clocks, anything shorter is
+*               a glitch. With the bus clock selected the widest filter
+*               is under a microsecond, so the model passes the line
+*               through.
+*
+* 10/18/2026 Initial version
+* 10/18/2026 Added the digital filter register model
+* 10/18/2026 Added scripted key sequences
+*************************************************************************
+* Header Files - Dependencies
+*************************************************************************/
+#include "MCUType.h"
+#include "KeyPort.h"
+#include "KeyPortVirtual.h"
+
+#if KEY_PORT_VIRTUAL_EN
+
+/*************************************************************************
+  Private Local Functions
+*************************************************************************/
+static void keyVirtInit(void);
+static void keyVirtRows(INT8U rows);
+static INT8U keyVirtCols(void);
+static INT32U keyVirtSettle(void);
+static void keyVirtIrqEnable(INT8U on);
+static INT8U keyVirtFilter(INT8U width);
+static INT8U keyVirtMatrix(void);
+static INT8U keyVirtLines(void);
+static void keyVirtEdge(void);
+
+/*************************************************************************
+  Global Variables
+*************************************************************************/
+const KEY_PORT_DRV KeyPortVirtual = {keyVirtInit, keyVirtRows, keyVirtCols,
+                                     keyVirtSettle, keyVirtIrqEnable,
+                                     keyVirtFilter};
+
+static INT16U keyVirtKeys;          // Keys down, bit (row * 4) + col
+static INT8U keyVirtRowsDriven;
+static INT8U keyVirtColsLast;       // Column lines at the last change
+static INT8U keyVirtIrqOn;
+static KEY_VIRT_STATS keyVirtStats;
+static KEY_VIRT_REGS keyVirtRegs;
+static INT8U keyVirtFiltOut;        // Filter output, bit per column
+static INT8U keyVirtFiltCnt[KEY_NUM_COLS];  // Clocks the line has differed
+static const KEY_VIRT_STEP *keyVirtScript;
+static INT16U keyVirtScriptLen;
+static INT16U keyVirtScriptNext;    // Next step to play
+static INT16U keyVirtScriptWait;    // ms until it is due
+
+/*************************************************************************
+  KeyVirtSet() - Sets the keys that are down                      (Public)
+*************************************************************************/
+void KeyVirtSet(INT16U keys){
+    keyVirtKeys = keys;
+    keyVirtEdge();
+}
+
+/*************************************************************************
+  KeyVirtScript() - Loads a key sequence to play back             (Public)
+
+        The first step is due script[0].ms after the next tick. The
+        script is not copied, it must stay in place until played.
+*************************************************************************/
+void KeyVirtScript(const KEY_VIRT_STEP *script, INT16U len){
+    keyVirtScript = script;
+    keyVirtScriptLen = len;
+    keyVirtScriptNext = 0;
+    keyVirtScriptWait = (len != 0) ? script[0].ms : 0;
+}
+
+/*************************************************************************
+  KeyVirtScriptTick() - Plays 1ms of the script                   (Public)
+
+        Sets the keys of every step that has come due, then clocks the
+        column filter once. Returns TRUE while steps are left.
+*************************************************************************/
+INT8U KeyVirtScriptTick(void){
+    if(keyVirtScriptNext < keyVirtScriptLen){
+        if(keyVirtScriptWait != 0){
+            keyVirtScriptWait--;
+        }else{
+        }
+        while((keyVirtScriptNext < keyVirtScriptLen) && (keyVirtScriptWait == 0)){
+            KeyVirtSet(keyVirtScript[keyVirtScriptNext].keys);
+            keyVirtScriptNext++;
+            if(keyVirtScriptNext < keyVirtScriptLen){
+                keyVirtScriptWait = keyVirtScript[keyVirtScriptNext].ms;
+            }else{
+            }
+        }
+    }else{
+    }
+    KeyVirtLpoTick();
+    return((INT8U)(keyVirtScriptNext < keyVirtScriptLen));
+}
+
+/*************************************************************************
+  KeyVirtStatsGet() - Reads the port counters                     (Public)
+*************************************************************************/
+void KeyVirtStatsGet(KEY_VIRT_STATS *stats){
+    *stats = keyVirtStats;
+}
+
+/*************************************************************************
+  KeyVirtStatsClear() - Clears the port counters                  (Public)
+*************************************************************************/
+void KeyVirtStatsClear(void){
+    keyVirtStats.reads = 0;
+    keyVirtStats.settles = 0;
+    keyVirtStats.irqs = 0;
+    keyVirtStats.arms = 0;
+    keyVirtStats.glitches = 0;
+}
+
+/*************************************************************************
+  KeyVirtLpoTick() - Clocks the column filter once                (Public)
+*************************************************************************/
+void KeyVirtLpoTick(void){
+    INT8U col, bit, line;
+
+    if((keyVirtRegs.dfcr & PORT_DFCR_CS_MASK) != 0){
+        line = keyVirtMatrix();
+        for(col = 0; col < KEY_NUM_COLS; col++){
+            bit = (INT8U)(1u << col);
+            if((keyVirtRegs.dfer & bit) == 0){
+            }else if(((line ^ keyVirtFiltOut) & bit) != 0){
+                keyVirtFiltCnt[col]++;
+                if(keyVirtFiltCnt[col] > keyVirtRegs.dfwr){
+                    keyVirtFiltOut ^= bit;
+                    keyVirtFiltCnt[col] = 0;
+                }else{
+                }
+            }else if(keyVirtFiltCnt[col] != 0){
+                keyVirtStats.glitches++;
+                keyVirtFiltCnt[col] = 0;
+            }else{
+            }
+        }
+        keyVirtEdge();
+    }else{
+    }
+}
+
+/*************************************************************************
+  KeyVirtRegsGet() - Reads the filter registers                   (Public)
+*************************************************************************/
+void KeyVirtRegsGet(KEY_VIRT_REGS *regs){
+    *regs = keyVirtRegs;
+}
+
+/*************************************************************************
+  keyVirtInit() - No keys down, rows released, interrupts off    (Private)
+*************************************************************************/
+static void keyVirtInit(void){
+    keyVirtKeys = 0;
+    keyVirtRowsDriven = 0;
+    keyVirtColsLast = 0;
+    keyVirtIrqOn = FALSE;
+    keyVirtRegs.dfer = 0;
+    keyVirtRegs.dfcr = 0;
+    keyVirtRegs.dfwr = 0;
+    keyVirtFiltOut = 0;
+    keyVirtScriptLen = 0;
+    keyVirtScriptNext = 0;
+    KeyVirtStatsClear();
+}
+
+/*************************************************************************
+  keyVirtRows() - Drives the passed rows low                     (Private)
+*************************************************************************/
+static void keyVirtRows(INT8U rows){
+    keyVirtRowsDriven = rows & KEY_ALL_ROWS;
+    keyVirtEdge();
+}
+
+/*************************************************************************
+  keyVirtCols() - Reads the columns pulled low                   (Private)
+*************************************************************************/
+static INT8U keyVirtCols(void){
+    keyVirtStats.reads++;
+    return(keyVirtLines());
+}
+
+/*************************************************************************
+  keyVirtSettle() - Counts the settle delay, it takes no time    (Private)
+*************************************************************************/
+static INT32U keyVirtSettle(void){
+    keyVirtStats.settles++;
+    return(0);
+}
+
+/*************************************************************************
+  keyVirtIrqEnable() - Turns the column interrupts on or off     (Private)
+*************************************************************************/
+static void keyVirtIrqEnable(INT8U on){
+    if(on != 0){
+        keyVirtStats.arms++;
+        keyVirtColsLast = keyVirtLines();   // Pending flags cleared
+    }else{
+    }
+    keyVirtIrqOn = on;
+}
+
+/*************************************************************************
+  keyVirtFilter() - Programs the filter the way a PORT needs it  (Private)
+
+        DFCR and DFWR may only change with every DFER bit clear. The
+        filter starts out following the line.
+*************************************************************************/
+static INT8U keyVirtFilter(INT8U width){
+    INT8U col;
+
+    keyVirtRegs.dfer = 0;
+    if(width != 0){
+        keyVirtRegs.dfcr = PORT_DFCR_CS_MASK;
+        keyVirtRegs.dfwr = PORT_DFWR_FILT(width);
+        keyVirtFiltOut = keyVirtMatrix();
+        for(col = 0; col < KEY_NUM_COLS; col++){
+            keyVirtFiltCnt[col] = 0;
+        }
+        keyVirtRegs.dfer = (1u << KEY_NUM_COLS) - 1u;
+    }else{
+    }
+    keyVirtEdge();
+    return(TRUE);
+}
+
+/*************************************************************************
+  keyVirtMatrix() - The columns pulled low by keys in driven rows (Private)
+*************************************************************************/
+static INT8U keyVirtMatrix(void){
+    INT8U row, cols;
+
+    cols = 0;
+    for(row = 0; row < KEY_NUM_ROWS; row++) {
+        if((keyVirtRowsDriven & (1u << row)) != 0) {
+            cols |= (INT8U)((keyVirtKeys >> (row * KEY_NUM_COLS)) & 0x0f);
+        }else{
+        }
+    }
+    return(cols);
+}
+
+/*************************************************************************
+  keyVirtLines() - The columns as reads and interrupts see them  (Private)
+*************************************************************************/
+static INT8U keyVirtLines(void){
+    INT8U filtered;
+
+    if((keyVirtRegs.dfcr & PORT_DFCR_CS_MASK) != 0){
+        filtered = (INT8U)keyVirtRegs.dfer;
+    }else{
+        filtered = 0;
+    }
+    return((INT8U)((keyVirtMatrix() & (INT8U)~filtered)|(keyVirtFiltOut & filtered)));
+}
+
+/*************************************************************************
+  keyVirtEdge() - Takes the column interrupt on a falling edge   (Private)
+*************************************************************************/
+static void keyVirtEdge(void){
+    INT8U cols;
+
+    cols = keyVirtLines();
+    if(keyVirtIrqOn && ((cols & (INT8U)~keyVirtColsLast) != 0)) {
+        keyVirtIrqOn = FALSE;               // As PORTC_IRQHandler()
+        keyVirtStats.irqs++;
+        KeyColIrq();
+    }else{
+    }
+    keyVirtColsLast = cols;
+}
+
+#endif
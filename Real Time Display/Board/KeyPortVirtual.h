@@ -0,0 +1,61 @@
+/*************************************************************************
+* KeyPortVirtual.h - Simulated 4x4 matrix keypad
+*
+*            A port driver (KeyPortVirtual) for host builds
+*            (KEY_PORT_VIRTUAL_EN = 1). Keys are pressed and released by
+*            the test with KeyVirtSet(). The columns follow the rows the
+*            key task drives the way the real matrix does, and a falling
+*            column edge with interrupts on calls KeyColIrq() the way
+*            PORTC_IRQHandler() would.
+*
+*            The column glitch filter is modelled on the Kinetis PORT
+*            DFER/DFCR/DFWR registers, clocked from the LPO. The test
+*            advances the LPO one clock (1ms) at a time with
+*            KeyVirtLpoTick().
+*
+*            A scripted key sequence can be loaded with KeyVirtScript()
+*            and played back 1ms at a time with KeyVirtScriptTick(), so
+*            a host build can replay the same presses, with their
+*            bounce, run after run.
+*
+* 10/18/2026 Initial version
+* 10/18/2026 Added the digital filter register model
+* 10/18/2026 Added scripted key sequences
+*************************************************************************/
+#ifndef KEY_PORT_VIRTUAL_DEF
+#define KEY_PORT_VIRTUAL_DEF
+
+typedef struct{
+    INT32U reads;           // Column reads, a scan is one per row driven
+    INT32U settles;         // Settle() calls
+    INT32U irqs;            // Column interrupts taken
+    INT32U arms;            // IrqEnable() calls turning interrupts on
+    INT32U glitches;        // Column pulses the filter absorbed
+}KEY_VIRT_STATS;
+
+typedef struct{
+    INT32U dfer;            // Filter enable, bit per column
+    INT32U dfcr;            // PORT_DFCR_CS set for the 1kHz LPO clock
+    INT32U dfwr;            // Filter width in clocks, 0 to 31
+}KEY_VIRT_REGS;
+
+typedef struct{
+    INT16U ms;              // Time after the previous step
+    INT16U keys;            // Keys down from then on, as KeyVirtSet()
+}KEY_VIRT_STEP;
+
+void KeyVirtSet(INT16U keys);   /* Bit (row * 4) + col set for each key down */
+
+void KeyVirtScript(const KEY_VIRT_STEP *script, INT16U len);
+
+INT8U KeyVirtScriptTick(void);  /* 1ms of script and LPO, FALSE once done */
+
+void KeyVirtStatsGet(KEY_VIRT_STATS *stats);
+
+void KeyVirtStatsClear(void);
+
+void KeyVirtLpoTick(void);      /* One LPO clock for the column filter */
+
+void KeyVirtRegsGet(KEY_VIRT_REGS *regs);
+
+#endif
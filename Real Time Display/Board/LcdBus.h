@@ -0,0 +1,118 @@
+/*************************************************************************
+* LcdBus.h - Bus driver interface for a Hitachi HD44780-type LCD
+*
+*            LcdLayered.c composes layers into a frame and turns it
+*            into HD44780 instructions. Getting those instructions onto
+*            the wires is the job of a bus driver, so the compositor can
+*            be run against real GPIO or against a virtual display model.
+*
+*            A bus driver provides:
+*               Init   - Configure the port, E low, RS high.
+*               Strobe - Drive RS and the data lines, then pulse E. In
+*                        4-bit mode db holds one nibble in bits 0-3, in
+*                        8-bit mode it holds the whole byte.
+*                        Returns with E low and the hold time satisfied.
+*               Dlyus  - Block for at least the passed microseconds.
+*               Read   - Read the byte at the address counter, which
+*                        then steps as for a write. The caller waits out
+*                        the execution time. A null pointer if R/W is
+*                        not wired.
+*               Idle   - The bus sat idle for at least the passed
+*                        microseconds while the caller blocked in an OS
+*                        delay instead of calling Dlyus. For drivers that
+*                        keep their own clock, a null pointer otherwise.
+*
+*            Set LCD_BUS_VIRTUAL_EN to 1 to run LcdLayered.c against the
+*            virtual HD44780 model in LcdBusVirtual.c instead of GPIOD.
+*
+*            Set LCD_BUS_8BIT_EN to 1 for boards with all eight data
+*            lines wired. Each byte is then one strobe instead of two.
+*
+* 10/18/2026 Split from LcdLayered.c
+* 10/18/2026 Added 8-bit interface mode
+* 10/18/2026 Added Idle for waits done as OS delays
+*************************************************************************/
+#ifndef LCD_BUS_DEF
+#define LCD_BUS_DEF
+
+#ifndef LCD_BUS_VIRTUAL_EN
+#define LCD_BUS_VIRTUAL_EN 0
+#endif
+
+#ifndef LCD_BUS_8BIT_EN
+#define LCD_BUS_8BIT_EN 0
+#endif
+
+#if LCD_BUS_8BIT_EN
+#define LCD_BUS_DB_PINS 8       // DB0-DB7
+#else
+#define LCD_BUS_DB_PINS 4       // DB4-DB7
+#endif
+
+/*************************************************************************
+  LCD Command Macros
+*************************************************************************/
+/*                                                    R R D D D D D D D D
+                                                      / S B B B B B B B B
+                                                      W   7 6 5 4 3 2 1 0
+*/
+// Clear Display                                      0 0 0 0 0 0 0 0 0 1
+#define LCD_CLR_DISP()         (0x0001)
+// Return Home                                        0 0 0 0 0 0 0 0 1 *
+#define LCD_CUR_HOME()         (0x0002)
+// Entry Mode Set                                     0 0 0 0 0 0 0 1 ids
+#define LCD_ENTRY_MODE(id, s)  (0x0004                       \
+                                | ((INT16U)id ? 0x0002 : 0)  \
+                                | ((INT16U)s  ? 0x0001 : 0))
+// Display ON/OFF Control                             0 0 0 0 0 0 1 d c b
+#define LCD_ON_OFF(d, c, b)    (0x0008                       \
+                                | ((INT16U)d  ? 0x0004 : 0)  \
+                                | ((INT16U)c  ? 0x0002 : 0)  \
+                                | ((INT16U)b  ? 0x0001 : 0))
+// Cursor or Display Shift                            0 0 0 0 0 1 scrl* *
+#define LCD_SHIFT(sc, rl)      (0x0010                       \
+                                | ((INT16U)sc ? 0x0008 : 0)  \
+                                | ((INT16U)rl ? 0x0004 : 0))
+// Function Set                                       0 0 0 0 1 dln f * *
+#define LCD_FUNCTION(dl, n, f) (0x0020                       \
+                                | ((INT16U)dl ? 0x0010 : 0)  \
+                                | ((INT16U)n  ? 0x0008 : 0)  \
+                                | ((INT16U)f  ? 0x0004 : 0))
+// Set CG RAM Address                                 0 0 0 1 ----acg-----
+#define LCD_CG_RAM(acg)        (0x0040                       \
+                                | ((INT16U)acg  & 0x003F))
+// Set DD RAM Address                                 0 0 1 -----add------
+#define LCD_DD_RAM(add)        (0x0080                       \
+                                | (((INT16U)add)  & 0x007F))
+// Write Data to CG or DD RAM                         0 1 ------data------
+#define LCD_WRITE(data)        (0x0100                       \
+                                | ((INT16U)data & 0x00FF))
+
+#define LCD_RS_DATA    0x0100   // Register select bit of a command word
+
+/*************************************************************************
+  HD44780 execution times (fosc = 270kHz)
+*************************************************************************/
+#define LCD_EXEC_CLR_US    1520u   // Clear Display and Return Home
+#define LCD_EXEC_CMD_US    37u     // All other instructions
+#define LCD_EXEC_DATA_US   41u     // Data write, 37us + 4us tADD
+#define LCD_STROBE_NS      1500u   // E high 500ns plus 1us hold
+
+/*************************************************************************
+  Bus Driver Interface
+*************************************************************************/
+typedef struct{
+    void (*Init)(void);
+    void (*Strobe)(INT8U rs, INT8U db);
+    void (*Dlyus)(INT16U us);
+    INT8U (*Read)(void);
+    void (*Idle)(INT32U us);
+}LCD_BUS_DRV;
+
+extern const LCD_BUS_DRV LcdBusK65;         // GPIOD, 4-bit, see LcdBusK65.c
+
+#if LCD_BUS_VIRTUAL_EN
+extern const LCD_BUS_DRV LcdBusVirtual;     // HD44780 model, LcdBusVirtual.c
+#endif
+
+#endif
@@ -0,0 +1,147 @@
+/*************************************************************************
+* LcdBusK65.c - HD44780 bus driver for the K65TWR LCD/Keypad board
+*
+*               The LCD is wired in 4-bit mode on PORTD:
+*                   RS->PTD1, E->PTD2, DB4-DB7->PTD3-PTD6
+*
+*               With LCD_BUS_8BIT_EN, DB0-DB3 are also wired, to
+*               PTD7-PTD10. Data line pins come from lcdBusDbPin[] so
+*               other wirings only need the table changed.
+*
+*               Timing is done with software delay loops designed for
+*               a 120MHz or 150MHz core clock.
+*
+* 10/18/2026 Split from LcdLayered.c
+* 10/18/2026 Table driven data pins, 8-bit mode
+*************************************************************************
+* Header Files - Dependencies
+*************************************************************************/
+#include "MCUType.h"
+#include "LcdBus.h"
+
+/*************************************************************************
+* LCD Port Defines
+*************************************************************************/
+#define LCD_RS_PIN     1
+#define LCD_E_PIN      2
+#define LCD_RS_BIT     (1u << LCD_RS_PIN)
+#define LCD_E_BIT      (1u << LCD_E_PIN)
+#define LCD_PORT       GPIOD_PDOR
+#define LCD_PORT_DIR   GPIOD_PDDR
+#define INIT_BIT_DIR() (LCD_PORT_DIR |= (LCD_RS_BIT|LCD_E_BIT|lcdBusDbMask))
+#define LCD_SET_RS()   GPIOD_PSOR = LCD_RS_BIT
+#define LCD_CLR_RS()   GPIOD_PCOR = LCD_RS_BIT
+#define LCD_SET_E()    GPIOD_PSOR = LCD_E_BIT
+#define LCD_CLR_E()    GPIOD_PCOR = LCD_E_BIT
+#define LCD_WR_DB(bits) (GPIOD_PDOR = (GPIOD_PDOR & ~lcdBusDbMask)|(bits))
+
+/*************************************************************************
+  Data Line Pin Map - PORTD pin for each data line, lowest line first
+*************************************************************************/
+#if LCD_BUS_8BIT_EN
+static const INT8U lcdBusDbPin[LCD_BUS_DB_PINS] = {7, 8, 9, 10,  /* DB0-DB3 */
+                                                   3, 4, 5, 6};  /* DB4-DB7 */
+#else
+static const INT8U lcdBusDbPin[LCD_BUS_DB_PINS] = {3, 4, 5, 6};  /* DB4-DB7 */
+#endif
+
+// Port bits for each value of each data nibble, built from lcdBusDbPin[]
+// by lcdBusInit() so a strobe is a table lookup, not a bit loop
+static INT32U lcdBusDbMap[LCD_BUS_DB_PINS/4][16];
+static INT32U lcdBusDbMask;
+
+/*************************************************************************
+  Private Local Functions
+*************************************************************************/
+static void lcdBusInit(void);
+static void lcdBusStrobe(INT8U rs, INT8U db);
+static void lcdBusDlyus(INT16U us);
+static void lcdBusDly500ns(void);
+
+// R/W is tied low on the board, so DDRAM can't be read back. The
+// controller keeps its own time, nothing to do for Idle.
+const LCD_BUS_DRV LcdBusK65 = {lcdBusInit, lcdBusStrobe, lcdBusDlyus,
+                               (INT8U (*)(void))0, (void (*)(INT32U))0};
+
+/*************************************************************************
+  lcdBusInit() - Sets up PORTD for the LCD                       (Private)
+*************************************************************************/
+static void lcdBusInit(void) {
+    INT8U line, nib, val;
+
+    SIM_SCGC5 |= SIM_SCGC5_PORTD_MASK;              /* Enable clock gate for PORTD */
+    PORTD_PCR(LCD_RS_PIN)=(0|PORT_PCR_MUX(1));
+    PORTD_PCR(LCD_E_PIN)=(0|PORT_PCR_MUX(1));
+    lcdBusDbMask = 0;
+    for(line = 0; line < LCD_BUS_DB_PINS; line++) {
+        PORTD_PCR(lcdBusDbPin[line])=(0|PORT_PCR_MUX(1));
+        lcdBusDbMask |= (1u << lcdBusDbPin[line]);
+    }
+    for(nib = 0; nib < (LCD_BUS_DB_PINS/4); nib++) {
+        for(val = 0; val < 16; val++) {
+            lcdBusDbMap[nib][val] = 0;
+            for(line = 0; line < 4; line++) {
+                if((val & (1u << line)) != 0) {
+                    lcdBusDbMap[nib][val] |= (1u << lcdBusDbPin[(nib * 4) + line]);
+                }else{
+                }
+            }
+        }
+    }
+    INIT_BIT_DIR();
+    LCD_CLR_E();
+    LCD_SET_RS();           /*Data select unless in LcdWrCmd()  */
+}
+
+/*************************************************************************
+  lcdBusStrobe() - Writes one nibble, or one byte in 8-bit mode, (Private)
+                   to the LCD
+
+        rs selects the data (non-zero) or instruction register. Leaves
+        E low for 1us after the strobe so back to back nibbles meet the
+        enable cycle time.
+*************************************************************************/
+static void lcdBusStrobe(INT8U rs, INT8U db) {
+    if(rs != 0){
+        LCD_SET_RS(); //data write
+    }else{
+        LCD_CLR_RS(); //command write
+    }
+#if LCD_BUS_8BIT_EN
+    LCD_WR_DB(lcdBusDbMap[0][db & 0x0f] | lcdBusDbMap[1][db >> 4]);
+#else
+    LCD_WR_DB(lcdBusDbMap[0][db & 0x0f]);
+#endif
+    LCD_SET_E();
+    lcdBusDly500ns();
+    LCD_CLR_E();
+    lcdBusDly500ns();
+    lcdBusDly500ns();
+}
+
+/*************************************************************************
+  lcdBusDlyus() - Blocks for the passed number of microseconds   (Private)
+*************************************************************************/
+static void lcdBusDlyus(INT16U us) {
+    INT16U cnt;
+
+    for(cnt = 0; cnt <= us; cnt++) {
+        lcdBusDly500ns();
+        lcdBusDly500ns();
+    }
+
+}
+
+/********************************************************************
+** lcdBusDly500ns(void)
+*   Delays, at least, 500ns
+*   Designed for 120MHz or 150MHz clock.
+ *  Tdly >= (66.5ns)i (at 150MHz)
+ * Currently set to ~532ns with i=8.
+ * TDM 01/20/2013
+********************************************************************/
+static void lcdBusDly500ns(void){
+    INT32U i;
+    for(i=0;i<8;i++){
+    }
+}
@@ -0,0 +1,524 @@
+/*************************************************************************
+* LcdBusVirtual.c - Virtual HD44780 display model
+*
+*               Implements the LCD_BUS_DRV interface without hardware.
+*               Each E strobe is decoded the way the controller would:
+*               8-bit mode after power-on until a Function Set selects
+*               4 bits, then high nibble first. The wiring follows
+*               LCD_BUS_8BIT_EN, DB4-DB7 only or all eight lines.
+*               Executed instructions update DDRAM, CGRAM, the address
+*               counter and the display and cursor state.
+*
+*               Time only advances through the bus: LCD_STROBE_NS per E
+*               strobe plus whatever the driver asks Dlyus() to wait, or
+*               reports through Idle() as waited in an OS delay. Idle
+*               time is not bus time and is not counted in bus_ns. An
+*               instruction keeps the controller busy for its datasheet
+*               execution time; instructions that arrive before that has
+*               elapsed are counted in busy_drops and ignored, the same
+*               as a real module.
+*
+*               DDRAM is addressed as two 40 character lines, 0x00-0x27
+*               and 0x40-0x67, which is how LcdLayered.c sets it up.
+*
+*               There are LCD_VIRT_UNITS separate modules, each with its
+*               own driver in LcdBusVirtualUnits[] and its own clock, so
+*               several displays can be run at once. LcdBusVirtual is
+*               unit 0, the display LcdInit() sets up.
+*
+* 10/18/2026 Initial version
+* 10/18/2026 8-bit wiring
+* 10/18/2026 Added lcdVirtIdle()
+* 10/18/2026 A read straight after a data write returns garbage
+* 10/18/2026 Counts the data writes to each DDRAM cell
+* 10/18/2026 Four separate units for several displays
+*************************************************************************
+* Header Files - Dependencies
+*************************************************************************/
+#include "MCUType.h"
+#include "LcdBus.h"
+#include "LcdBusVirtual.h"
+
+#if LCD_BUS_VIRTUAL_EN
+
+#define LCD_VIRT_POR_US      15000u     // Power on reset time
+#define LCD_VIRT_LINE2_ADDR  0x40u
+#define LCD_VIRT_BLANK       0x20u
+
+// What the controller sees on DB7-DB0 (8-bit interface) and DB7-DB4
+// (4-bit interface) for a Strobe() db value
+#if LCD_BUS_8BIT_EN
+#define LCD_VIRT_DB8(db)     (db)
+#define LCD_VIRT_DB4(db)     ((INT8U)((db) >> 4))
+#else
+#define LCD_VIRT_DB8(db)     ((INT8U)(((db) & 0x0f) << 4))
+#define LCD_VIRT_DB4(db)     ((INT8U)((db) & 0x0f))
+#endif
+
+// A unit's controller, its clock and the nibble it is part way through
+typedef struct{
+    LCD_VIRT_STATE state;
+    LCD_VIRT_STATS stats;
+    INT64U now;                 // Virtual clock, ns
+    INT64U busy_until;          // Busy flag clears at this time
+    INT64U first_strobe;        // Time of the first strobe of an instruction
+    INT8U half;                 // High nibble latched, waiting for low
+    INT8U high_nib;
+    INT8U high_rs;
+    INT8U read_valid;           // Address set or read since the last data write
+}LCD_VIRT_UNIT;
+
+/*************************************************************************
+  Private Local Functions
+*************************************************************************/
+static void lcdVirtInit(void);
+static void lcdVirtStrobe(INT8U rs, INT8U db);
+static void lcdVirtDlyus(INT16U us);
+static INT8U lcdVirtRead(void);
+static void lcdVirtIdle(INT32U us);
+static void lcdVirtStatsClear(LCD_VIRT_UNIT *pu);
+static void lcdVirtExecute(INT8U rs, INT8U byte);
+static void lcdVirtWriteData(INT8U byte);
+static void lcdVirtAddrStep(INT8U increment);
+static void lcdVirtShiftDisp(INT8U right);
+static void lcdVirtBusy(INT16U us);
+
+/*************************************************************************
+  Unit Bus Functions - The driver functions of unit n, each selects the
+                       unit's model before it runs
+*************************************************************************/
+#define LCD_VIRT_UNIT_FNS(n)                                                \
+static void lcdVirtInit##n(void) {                                          \
+    lcdVirtU = &lcdVirtUnits[n];                                            \
+    lcdVirtInit();                                                          \
+}                                                                           \
+static void lcdVirtStrobe##n(INT8U rs, INT8U db) {                          \
+    lcdVirtU = &lcdVirtUnits[n];                                            \
+    lcdVirtStrobe(rs, db);                                                  \
+}                                                                           \
+static void lcdVirtDlyus##n(INT16U us) {                                    \
+    lcdVirtU = &lcdVirtUnits[n];                                            \
+    lcdVirtDlyus(us);                                                       \
+}                                                                           \
+static INT8U lcdVirtRead##n(void) {                                         \
+    lcdVirtU = &lcdVirtUnits[n];                                            \
+    return(lcdVirtRead());                                                  \
+}                                                                           \
+static void lcdVirtIdle##n(INT32U us) {                                     \
+    lcdVirtU = &lcdVirtUnits[n];                                            \
+    lcdVirtIdle(us);                                                        \
+}
+
+#define LCD_VIRT_UNIT_DRV(n) {lcdVirtInit##n, lcdVirtStrobe##n, lcdVirtDlyus##n, \
+                              lcdVirtRead##n, lcdVirtIdle##n}
+
+/*************************************************************************
+  Global Variables
+*************************************************************************/
+static LCD_VIRT_UNIT lcdVirtUnits[LCD_VIRT_UNITS];
+static LCD_VIRT_UNIT *lcdVirtU = &lcdVirtUnits[0];   // Unit being driven
+
+LCD_VIRT_UNIT_FNS(0)
+LCD_VIRT_UNIT_FNS(1)
+LCD_VIRT_UNIT_FNS(2)
+LCD_VIRT_UNIT_FNS(3)
+
+const LCD_BUS_DRV LcdBusVirtual = LCD_VIRT_UNIT_DRV(0);
+
+const LCD_BUS_DRV LcdBusVirtualUnits[LCD_VIRT_UNITS] = {
+    LCD_VIRT_UNIT_DRV(0), LCD_VIRT_UNIT_DRV(1), LCD_VIRT_UNIT_DRV(2), LCD_VIRT_UNIT_DRV(3)};
+
+/*************************************************************************
+  LcdVirtPowerOn() - Puts unit 0 in its power-on reset state     (Public)
+*************************************************************************/
+void LcdVirtPowerOn(void) {
+    lcdVirtInit0();
+}
+
+/*************************************************************************
+  LcdVirtStatsGet() - Copies unit 0's bus statistics             (Public)
+*************************************************************************/
+void LcdVirtStatsGet(LCD_VIRT_STATS *stats) {
+    (void)LcdVirtUnitStatsGet(0, stats);
+}
+
+/*************************************************************************
+  LcdVirtStatsClear() - Restarts unit 0's bus statistics         (Public)
+
+        Does not touch the display state or the virtual clock, so a
+        benchmark can clear, run one frame, and read bus_ns.
+*************************************************************************/
+void LcdVirtStatsClear(void) {
+    lcdVirtStatsClear(&lcdVirtUnits[0]);
+}
+
+/*************************************************************************
+  LcdVirtState() - Returns unit 0's controller state, read only  (Public)
+*************************************************************************/
+const LCD_VIRT_STATE *LcdVirtState(void) {
+    return(&lcdVirtUnits[0].state);
+}
+
+/*************************************************************************
+  LcdVirtGlassGet() - Copies what is visible on unit 0's glass   (Public)
+*************************************************************************/
+void LcdVirtGlassGet(INT8C glass[LCD_VIRT_ROWS][LCD_VIRT_COLS]) {
+    (void)LcdVirtUnitGlassGet(0, glass);
+}
+
+/*************************************************************************
+  LcdVirtUnitStatsGet() - Copies a unit's bus statistics         (Public)
+
+        Returns FALSE if there is no such unit.
+*************************************************************************/
+INT8U LcdVirtUnitStatsGet(INT8U unit, LCD_VIRT_STATS *stats) {
+    if(unit >= LCD_VIRT_UNITS) {
+        return(FALSE);
+    }else{
+    }
+    *stats = lcdVirtUnits[unit].stats;
+    return(TRUE);
+}
+
+/*************************************************************************
+  LcdVirtUnitGlassGet() - Copies what is visible on a unit's     (Public)
+                          glass
+
+        Applies the display shift to DDRAM. A display that is off shows
+        blanks. Returns FALSE if there is no such unit.
+*************************************************************************/
+INT8U LcdVirtUnitGlassGet(INT8U unit, INT8C glass[LCD_VIRT_ROWS][LCD_VIRT_COLS]) {
+    const LCD_VIRT_STATE *ps;
+    INT8U row, col;
+
+    if(unit >= LCD_VIRT_UNITS) {
+        return(FALSE);
+    }else{
+    }
+    ps = &lcdVirtUnits[unit].state;
+    for(row = 0; row < LCD_VIRT_ROWS; row++) {
+        for(col = 0; col < LCD_VIRT_COLS; col++) {
+            if(ps->disp_on) {
+                glass[row][col] = (INT8C)ps->ddram[row]
+                    [(col + ps->shift) % LCD_VIRT_DDRAM_COLS];
+            }else{
+                glass[row][col] = (INT8C)LCD_VIRT_BLANK;
+            }
+        }
+    }
+    return(TRUE);
+}
+
+/*************************************************************************
+  lcdVirtInit() - Bus Init, puts the unit in its power-on reset  (Private)
+                  state
+
+        DDRAM is filled with spaces, the interface is 8 bits and the
+        controller is busy for the power on reset time. The virtual
+        clock and the statistics are cleared.
+*************************************************************************/
+static void lcdVirtInit(void) {
+    INT8U row, col, cnt;
+
+    for(row = 0; row < LCD_VIRT_ROWS; row++) {
+        for(col = 0; col < LCD_VIRT_DDRAM_COLS; col++) {
+            lcdVirtU->state.ddram[row][col] = LCD_VIRT_BLANK;
+        }
+    }
+    for(cnt = 0; cnt < LCD_VIRT_CGRAM_SIZE; cnt++) {
+        lcdVirtU->state.cgram[cnt] = 0;
+    }
+    lcdVirtU->state.addr = 0;
+    lcdVirtU->state.cgram_sel = FALSE;
+    lcdVirtU->state.shift = 0;
+    lcdVirtU->state.increment = TRUE;
+    lcdVirtU->state.shift_on_write = FALSE;
+    lcdVirtU->state.disp_on = FALSE;
+    lcdVirtU->state.cursor_on = FALSE;
+    lcdVirtU->state.blink_on = FALSE;
+    lcdVirtU->state.four_bit = FALSE;
+    lcdVirtU->state.two_line = FALSE;
+
+    lcdVirtU->half = FALSE;
+    lcdVirtU->read_valid = FALSE;
+    lcdVirtU->now = 0;
+    lcdVirtU->busy_until = (INT64U)LCD_VIRT_POR_US * 1000u;
+    lcdVirtStatsClear(lcdVirtU);
+}
+
+/*************************************************************************
+  lcdVirtStatsClear() - Restarts a unit's bus statistics         (Private)
+*************************************************************************/
+static void lcdVirtStatsClear(LCD_VIRT_UNIT *pu) {
+    INT8U row, col;
+
+    pu->stats.bus_ns = 0;
+    pu->stats.strobes = 0;
+    pu->stats.cmds = 0;
+    pu->stats.data = 0;
+    pu->stats.reads = 0;
+    pu->stats.busy_drops = 0;
+    pu->stats.stale_reads = 0;
+    for(row = 0; row < LCD_VIRT_ROWS; row++) {
+        for(col = 0; col < LCD_VIRT_DDRAM_COLS; col++) {
+            pu->stats.ddram_writes[row][col] = 0;
+        }
+    }
+}
+
+/*************************************************************************
+  lcdVirtStrobe() - Bus Strobe, decodes one E strobe             (Private)
+
+        With 4-bit wiring, only DB4-DB7 are wired, so in 8-bit mode the
+        low data lines read as zero. In 4-bit mode the first strobe is
+        the high nibble.
+*************************************************************************/
+static void lcdVirtStrobe(INT8U rs, INT8U db) {
+
+    if(lcdVirtU->half == FALSE) {
+        lcdVirtU->first_strobe = lcdVirtU->now;
+    }
+    lcdVirtU->now += LCD_STROBE_NS;
+    lcdVirtU->stats.bus_ns += LCD_STROBE_NS;
+    lcdVirtU->stats.strobes++;
+
+    if(lcdVirtU->state.four_bit == FALSE) {
+        lcdVirtExecute(rs, LCD_VIRT_DB8(db));
+    }else if(lcdVirtU->half == FALSE) {
+        lcdVirtU->high_nib = LCD_VIRT_DB4(db);
+        lcdVirtU->high_rs = rs;
+        lcdVirtU->half = TRUE;
+    }else{
+        lcdVirtU->half = FALSE;
+        lcdVirtExecute(lcdVirtU->high_rs,
+                       (INT8U)((lcdVirtU->high_nib << 4) | LCD_VIRT_DB4(db)));
+    }
+}
+
+/*************************************************************************
+  lcdVirtDlyus() - Bus Dlyus, advances the virtual clock         (Private)
+*************************************************************************/
+static void lcdVirtDlyus(INT16U us) {
+    lcdVirtU->now += (INT64U)us * 1000u;
+    lcdVirtU->stats.bus_ns += (INT64U)us * 1000u;
+}
+
+/*************************************************************************
+  lcdVirtIdle() - Bus Idle, advances the virtual clock only      (Private)
+*************************************************************************/
+static void lcdVirtIdle(INT32U us) {
+    lcdVirtU->now += (INT64U)us * 1000u;
+}
+
+/*************************************************************************
+  lcdVirtRead() - Bus Read, reads data at the address counter    (Private)
+
+        One strobe in 8-bit mode, two in 4-bit mode. A read while the
+        controller is busy returns the busy flag instead, 0x80 here.
+        The controller only has valid read data after an address set,
+        a cursor shift or another read. A read straight after a data
+        write returns the complement of the cell here, so a driver that
+        skips the address set sees a mismatch, and is counted in
+        stale_reads. The address counter still steps.
+*************************************************************************/
+static INT8U lcdVirtRead(void) {
+    INT8U byte, col, strobes;
+
+    strobes = lcdVirtU->state.four_bit ? 2 : 1;
+    lcdVirtU->first_strobe = lcdVirtU->now;
+    lcdVirtU->now += (INT64U)strobes * LCD_STROBE_NS;
+    lcdVirtU->stats.bus_ns += (INT64U)strobes * LCD_STROBE_NS;
+    lcdVirtU->stats.strobes += strobes;
+
+    if(lcdVirtU->first_strobe < lcdVirtU->busy_until) {
+        lcdVirtU->stats.busy_drops++;
+        return(0x80);
+    }else{
+    }
+
+    lcdVirtU->stats.reads++;
+    if(lcdVirtU->state.cgram_sel) {
+        byte = lcdVirtU->state.cgram[lcdVirtU->state.addr & 0x3f];
+        if(lcdVirtU->state.increment) {
+            lcdVirtU->state.addr = (INT8U)((lcdVirtU->state.addr + 1) & 0x3f);
+        }else{
+            lcdVirtU->state.addr = (INT8U)((lcdVirtU->state.addr - 1) & 0x3f);
+        }
+    }else{
+        col = (INT8U)(lcdVirtU->state.addr & 0x3f);
+        if(col < LCD_VIRT_DDRAM_COLS) {
+            byte = lcdVirtU->state.ddram[(lcdVirtU->state.addr & LCD_VIRT_LINE2_ADDR) ? 1 : 0][col];
+        }else{
+            byte = 0;
+        }
+        lcdVirtAddrStep(lcdVirtU->state.increment);
+    }
+    if(lcdVirtU->read_valid == FALSE) {
+        lcdVirtU->stats.stale_reads++;
+        byte = (INT8U)~byte;
+    }else{
+    }
+    lcdVirtU->read_valid = TRUE;
+    lcdVirtBusy(LCD_EXEC_DATA_US);
+    return(byte);
+}
+
+/*************************************************************************
+  lcdVirtExecute() - Executes one instruction or data write      (Private)
+*************************************************************************/
+static void lcdVirtExecute(INT8U rs, INT8U byte) {
+    INT8U row, col;
+
+    if(lcdVirtU->first_strobe < lcdVirtU->busy_until) {
+        lcdVirtU->stats.busy_drops++;      // Controller ignores it
+        return;
+    }else{
+    }
+
+    if(rs != 0) {
+        lcdVirtU->stats.data++;
+        lcdVirtWriteData(byte);
+        lcdVirtU->read_valid = FALSE;
+        lcdVirtBusy(LCD_EXEC_DATA_US);
+        return;
+    }else{
+    }
+
+    lcdVirtU->stats.cmds++;
+    if(byte & 0x80) {                       // Set DD RAM address
+        lcdVirtU->state.addr = (INT8U)(byte & 0x7f);
+        lcdVirtU->state.cgram_sel = FALSE;
+        lcdVirtU->read_valid = TRUE;
+        lcdVirtBusy(LCD_EXEC_CMD_US);
+    }else if(byte & 0x40) {                 // Set CG RAM address
+        lcdVirtU->state.addr = (INT8U)(byte & 0x3f);
+        lcdVirtU->state.cgram_sel = TRUE;
+        lcdVirtU->read_valid = TRUE;
+        lcdVirtBusy(LCD_EXEC_CMD_US);
+    }else if(byte & 0x20) {                 // Function set
+        lcdVirtU->state.four_bit = ((byte & 0x10) == 0);
+        lcdVirtU->state.two_line = ((byte & 0x08) != 0);
+        lcdVirtBusy(LCD_EXEC_CMD_US);
+    }else if(byte & 0x10) {                 // Cursor or display shift
+        if(byte & 0x08) {
+            lcdVirtShiftDisp((INT8U)(byte & 0x04));
+        }else{
+            lcdVirtAddrStep((INT8U)(byte & 0x04));
+            lcdVirtU->read_valid = TRUE;
+        }
+        lcdVirtBusy(LCD_EXEC_CMD_US);
+    }else if(byte & 0x08) {                 // Display on/off control
+        lcdVirtU->state.disp_on = ((byte & 0x04) != 0);
+        lcdVirtU->state.cursor_on = ((byte & 0x02) != 0);
+        lcdVirtU->state.blink_on = ((byte & 0x01) != 0);
+        lcdVirtBusy(LCD_EXEC_CMD_US);
+    }else if(byte & 0x04) {                 // Entry mode set
+        lcdVirtU->state.increment = ((byte & 0x02) != 0);
+        lcdVirtU->state.shift_on_write = ((byte & 0x01) != 0);
+        lcdVirtBusy(LCD_EXEC_CMD_US);
+    }else if(byte & 0x02) {                 // Return home
+        lcdVirtU->state.addr = 0;
+        lcdVirtU->state.cgram_sel = FALSE;
+        lcdVirtU->state.shift = 0;
+        lcdVirtBusy(LCD_EXEC_CLR_US);
+    }else if(byte & 0x01) {                 // Clear display
+        for(row = 0; row < LCD_VIRT_ROWS; row++) {
+            for(col = 0; col < LCD_VIRT_DDRAM_COLS; col++) {
+                lcdVirtU->state.ddram[row][col] = LCD_VIRT_BLANK;
+            }
+        }
+        lcdVirtU->state.addr = 0;
+        lcdVirtU->state.cgram_sel = FALSE;
+        lcdVirtU->state.shift = 0;
+        lcdVirtU->state.increment = TRUE;
+        lcdVirtBusy(LCD_EXEC_CLR_US);
+    }else{                                  // 0x00 is not an instruction
+    }
+}
+
+/*************************************************************************
+  lcdVirtWriteData() - Writes to DDRAM or CGRAM at the address   (Private)
+                       counter and steps it
+*************************************************************************/
+static void lcdVirtWriteData(INT8U byte) {
+    INT8U row, col;
+
+    if(lcdVirtU->state.cgram_sel) {
+        lcdVirtU->state.cgram[lcdVirtU->state.addr & 0x3f] = byte;
+        if(lcdVirtU->state.increment) {
+            lcdVirtU->state.addr = (INT8U)((lcdVirtU->state.addr + 1) & 0x3f);
+        }else{
+            lcdVirtU->state.addr = (INT8U)((lcdVirtU->state.addr - 1) & 0x3f);
+        }
+    }else{
+        col = (INT8U)(lcdVirtU->state.addr & 0x3f);
+        if(col < LCD_VIRT_DDRAM_COLS) {     // 0x28-0x3F are not DDRAM
+            row = (lcdVirtU->state.addr & LCD_VIRT_LINE2_ADDR) ? 1 : 0;
+            lcdVirtU->state.ddram[row][col] = byte;
+            lcdVirtU->stats.ddram_writes[row][col]++;
+        }else{
+        }
+        lcdVirtAddrStep(lcdVirtU->state.increment);
+        if(lcdVirtU->state.shift_on_write) {
+            lcdVirtShiftDisp((INT8U)(lcdVirtU->state.increment == FALSE));
+        }else{
+        }
+    }
+}
+
+/*************************************************************************
+  lcdVirtAddrStep() - Moves the DDRAM address counter one place  (Private)
+
+        Line 1 wraps to line 2 and line 2 wraps back to line 1.
+*************************************************************************/
+static void lcdVirtAddrStep(INT8U increment) {
+    INT8U line, col;
+
+    line = (INT8U)(lcdVirtU->state.addr & LCD_VIRT_LINE2_ADDR);
+    col = (INT8U)(lcdVirtU->state.addr & 0x3f);
+    if(col >= LCD_VIRT_DDRAM_COLS) {
+        col = LCD_VIRT_DDRAM_COLS - 1;
+    }else{
+    }
+
+    if(increment) {
+        if(col == (LCD_VIRT_DDRAM_COLS - 1)) {
+            line ^= LCD_VIRT_LINE2_ADDR;
+            col = 0;
+        }else{
+            col++;
+        }
+    }else{
+        if(col == 0) {
+            line ^= LCD_VIRT_LINE2_ADDR;
+            col = LCD_VIRT_DDRAM_COLS - 1;
+        }else{
+            col--;
+        }
+    }
+    lcdVirtU->state.addr = (INT8U)(line | col);
+}
+
+/*************************************************************************
+  lcdVirtShiftDisp() - Shifts both lines of the display          (Private)
+
+        A left shift moves the text left, so the window onto DDRAM
+        moves one column right.
+*************************************************************************/
+static void lcdVirtShiftDisp(INT8U right) {
+    if(right) {
+        lcdVirtU->state.shift = (INT8U)((lcdVirtU->state.shift + LCD_VIRT_DDRAM_COLS - 1)
+                                % LCD_VIRT_DDRAM_COLS);
+    }else{
+        lcdVirtU->state.shift = (INT8U)((lcdVirtU->state.shift + 1) % LCD_VIRT_DDRAM_COLS);
+    }
+}
+
+/*************************************************************************
+  lcdVirtBusy() - Sets the busy flag for an execution time       (Private)
+*************************************************************************/
+static void lcdVirtBusy(INT16U us) {
+    lcdVirtU->busy_until = lcdVirtU->now + (INT64U)us * 1000u;
+}
+
+#endif
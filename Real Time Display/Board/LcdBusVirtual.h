@@ -0,0 +1,77 @@
+/*************************************************************************
+* LcdBusVirtual.h - Virtual HD44780 display model
+*
+*            A bus driver (LcdBusVirtual) that decodes the E strobes sent
+*            by LcdLayered.c the way an HD44780 controller would. It keeps
+*            DDRAM, CGRAM, the address counter, display shift and cursor
+*            state, and accounts bus time on a virtual clock, including
+*            the controller's execution time for every instruction.
+*
+*            Intended for Linux host builds (LCD_BUS_VIRTUAL_EN = 1) so
+*            LCD path changes can be measured in bus microseconds per
+*            frame without a target or a scope.
+*
+*            LcdBusVirtualUnits[] has a driver for each of LCD_VIRT_UNITS
+*            modules, for displays added with LcdDispAdd(). Unit 0 is
+*            LcdBusVirtual, and the functions without a unit number
+*            read it.
+*
+* 10/18/2026 Initial version
+* 10/18/2026 Added stale_reads
+* 10/18/2026 Added ddram_writes
+* 10/18/2026 Added the units
+*************************************************************************/
+#ifndef LCD_BUS_VIRTUAL_DEF
+#define LCD_BUS_VIRTUAL_DEF
+#include "LcdBus.h"
+
+#define LCD_VIRT_ROWS        2
+#define LCD_VIRT_COLS        16     // Visible columns on the glass
+#define LCD_VIRT_DDRAM_COLS  40     // DDRAM characters per line
+#define LCD_VIRT_CGRAM_SIZE  64
+#define LCD_VIRT_UNITS       4      // Modules, one per display
+
+typedef struct{
+    INT64U bus_ns;          // Virtual time spent on the bus, strobes + delays
+    INT32U strobes;         // E strobes
+    INT32U cmds;            // Instructions executed
+    INT32U data;            // DDRAM/CGRAM data writes executed
+    INT32U reads;           // DDRAM/CGRAM data reads executed
+    INT32U busy_drops;      // Instructions sent while busy, ignored
+    INT32U stale_reads;     // Reads straight after a data write, invalid
+    INT16U ddram_writes[LCD_VIRT_ROWS][LCD_VIRT_DDRAM_COLS];
+                            // Data writes to each DDRAM cell
+}LCD_VIRT_STATS;
+
+typedef struct{
+    INT8U ddram[LCD_VIRT_ROWS][LCD_VIRT_DDRAM_COLS];
+    INT8U cgram[LCD_VIRT_CGRAM_SIZE];
+    INT8U addr;             // Address counter
+    INT8U cgram_sel;        // Address counter points into CGRAM
+    INT8U shift;            // Display shift, 0 to LCD_VIRT_DDRAM_COLS-1
+    INT8U increment;        // Entry mode I/D
+    INT8U shift_on_write;   // Entry mode S
+    INT8U disp_on;
+    INT8U cursor_on;
+    INT8U blink_on;
+    INT8U four_bit;         // Interface data length is 4 bits
+    INT8U two_line;
+}LCD_VIRT_STATE;
+
+void LcdVirtPowerOn(void);
+
+void LcdVirtStatsGet(LCD_VIRT_STATS *stats);
+
+void LcdVirtStatsClear(void);
+
+const LCD_VIRT_STATE *LcdVirtState(void);
+
+void LcdVirtGlassGet(INT8C glass[LCD_VIRT_ROWS][LCD_VIRT_COLS]);
+
+extern const LCD_BUS_DRV LcdBusVirtualUnits[LCD_VIRT_UNITS];
+
+INT8U LcdVirtUnitStatsGet(INT8U unit, LCD_VIRT_STATS *stats);
+
+INT8U LcdVirtUnitGlassGet(INT8U unit, INT8C glass[LCD_VIRT_ROWS][LCD_VIRT_COLS]);
+
+#endif
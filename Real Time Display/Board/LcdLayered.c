@@ -5,11 +5,16 @@
 *                This allows asynchronous application tasks to write to  
 *                a single LCD display without interfering with each      
 *                other.                                                  
+*
+*                Up to LCD_NUM_DISPS displays, each with its own bus
+*                driver, geometry and layers, share one task.
 *                                                                        
 *                Requires the following be defined in app_cfg.h:         
 *                   APP_CFG_LCD_TASK_PRIO
 *                   APP_CFG_LCD_TASK_STK_SIZE
 *                                                                        
+*                Port access is done by a bus driver, see LcdBus.h
+*                                                                        
 *                It is derived from the work of Matthew Cohn, 2/26/2008
 *                
 *                Cursor code is derived from Keegan Morrow, 02/22/2013  
@@ -19,40 +24,72 @@
 * 02/03/2016, More cleanup. TDM
 * 01/13/2017 Changed name to LcdLayered (was LayeredLcd), fixed bugs. TDM
 * 01/18/2018 Changed to replace includes.h TDM
+* 10/18/2026 Moved port access and delays to LcdBus.h bus drivers
+* 10/18/2026 Multiple displays serviced by one task in priority order
+* 10/18/2026 Added LcdSwapLayers() for screen switches
+* 10/18/2026 LCD task stack tracked by StkMon.h
 *****************************************************************************************
 * Header Files - Dependencies
 *****************************************************************************************/
+#include <stdarg.h>
 #include "MCUType.h"
 #include "app_cfg.h"
 #include "os.h"
 #include "LcdLayered.h"
 #include "K65TWR_GPIO.h"
-
-/*****************************************************************************************
-* LCD Port Defines 
-*****************************************************************************************/
-#define LCD_RS_BIT     0x2
-#define LCD_E_BIT      0x4
-#define LCD_DB_MASK    0x78
-#define LCD_PORT       GPIOD_PDOR
-#define LCD_PORT_DIR   GPIOD_PDDR
-#define INIT_BIT_DIR() (LCD_PORT_DIR |= (LCD_RS_BIT|LCD_E_BIT|LCD_DB_MASK))
-#define LCD_SET_RS()   GPIOD_PSOR = LCD_RS_BIT
-#define LCD_CLR_RS()   GPIOD_PCOR = LCD_RS_BIT
-#define LCD_SET_E()    GPIOD_PSOR = LCD_E_BIT
-#define LCD_CLR_E()    GPIOD_PCOR = LCD_E_BIT
-#define LCD_WR_DB(nib) (GPIOD_PDOR = (GPIOD_PDOR & ~LCD_DB_MASK)|((nib)<<3))
-
+#include "LcdBus.h"
+#include "Boot.h"
+#include "StkMon.h"
+#if LCD_LATENCY_EN
+#include "CycCnt.h"
+#endif
 
 /*****************************************************************************************
 * LCD Defines                                                                            *
 *****************************************************************************************/
-// LCD Configuration
+// LCD Configuration, largest display supported. Each display sets its
+// own geometry up to this in LcdDispAdd().
 #define LCD_NUM_ROWS   2
-#define LCD_NUM_COLS   16
+#define LCD_NUM_COLS   16      // dirty holds a bit per column
+#define LCD_DDRAM_COLS 40      // DDRAM characters per line, the rest is off glass
 
-#define LCD_ENABLE     0x04
 #define LCD_CLEAR_BYTE 0x20    //SPACE is set as the transparent character
+#define LCD_NO_OWNER   0xFF    //No visible layer has a character in the cell
+
+// Function Set, 8-bit, as a Strobe() value for the reset sequence
+#if LCD_BUS_8BIT_EN
+#define LCD_RESET_DB   0x30
+#else
+#define LCD_RESET_DB   0x3     //DB4-DB7 only
+#endif
+#define LCD_DIRTY(pd, row, col) ((pd)->dirty[row] |= (INT16U)(1u << (col)))
+
+// Public layer numbers are LCD_LAYER(disp, layer)
+#define LCD_DISP_OF(layer)   (&lcdDisps[(layer) / LCD_NUM_LAYERS])
+#define LCD_LAYER_OF(layer)  ((INT8U)((layer) % LCD_NUM_LAYERS))
+#define LCD_LAYER_VALID(layer) ((layer) < (lcdNumDisps * LCD_NUM_LAYERS))
+
+// Latency instrumentation hooks, compiled out unless LCD_LATENCY_EN
+#if LCD_LATENCY_EN
+#define LCD_LAT_MARK(pd, layer) lcdLatMark(pd, layer)
+#define LCD_LAT_FLATTEN(pd)     lcdLatFlatten(pd)
+#define LCD_LAT_FRAME_END(pd)   lcdLatFrameEnd(pd)
+#else
+#define LCD_LAT_MARK(pd, layer)
+#define LCD_LAT_FLATTEN(pd)
+#define LCD_LAT_FRAME_END(pd)
+#endif
+
+// Waits this long or longer are OS delays, shorter ones spin
+#define LCD_DLY_BLOCK_US 1000u
+
+// Idle time before each scrub slice
+#define LCD_SCRUB_TICKS (((LCD_SCRUB_MS * OS_CFG_TICK_RATE_HZ) + 999u) / 1000u)
+
+// LcdPrintf() conversion flags
+#define LCD_FMT_ZERO   0x01    // '0' flag, pad numbers with zeros
+#define LCD_FMT_LEFT   0x02    // '-' flag, left justify
+#define LCD_FMT_DIGITS 10      // Digits in the largest 32-bit value
 
 // LCD Cursor typedef
 typedef struct {
@@ -69,18 +106,93 @@ typedef struct {
     LCD_CURSOR cursor;
 } LCD_BUFFER;
 
+// Mirror of the LCD module's DDRAM and display state
+typedef struct {
+    INT8C ddram[LCD_NUM_ROWS][LCD_DDRAM_COLS];
+    INT8U shift;        // Display shift, glass column 0 shows this DDRAM column
+    INT8U addr;         // Address counter
+    INT8U cursor_on;
+    INT8U blink;
+} LCD_DDRAM;
+
+// Marquee state for a layer, row is zero when the layer is not scrolling
+typedef struct {
+    const INT8C *text;
+    INT16U len;
+    INT16U pos;
+    INT8U row;
+} LCD_MARQUEE;
+
+// One display. Layer contents, the occlusion map and the latency call
+// side are protected by lcdLayersKey, the rest is only used by
+// lcdLayeredTask once the display is added.
+typedef struct {
+    const LCD_BUS_DRV *bus;     // Bus driver the display is attached to
+    INT8U rows;                 // Geometry, up to LCD_NUM_ROWS x LCD_NUM_COLS
+    INT8U cols;
+    INT8U prio;                 // Lower numbers are serviced first
+    INT8U powered;              // Power up sequence done, set by the LCD task
+    INT8U pending;              // Changed since the last flatten
+    LCD_BUFFER buffer;          // Flattened frame
+    LCD_DDRAM ddram;
+    LCD_BUFFER layers[LCD_NUM_LAYERS];
+    LCD_MARQUEE marquees[LCD_NUM_LAYERS];
+    // Occlusion map, the top visible layer with a character in each cell
+    INT8U owner[LCD_NUM_ROWS][LCD_NUM_COLS];
+    // Cells to copy into buffer at the next flatten, bit per column
+    INT16U dirty[LCD_NUM_ROWS];
+    LCD_STATS stats;
+    INT8U marquee_stepped;      // A marquee stepped since the last frame
+    // Frame scheduler
+    OS_TICK frame_ticks;        // Minimum ticks between frames, 0 for no cap
+    OS_TICK frame_tick;         // Tick the last frame started
+    INT32U urgent_layers;       // Bit per layer, changes bypass the cap
+    INT8U urgent_pending;       // An urgent layer changed since the last flatten
+#if LCD_SCRUB_EN
+    INT8U scrub_cell;           // Next glass cell to scrub, row major
+#endif
+#if LCD_LATENCY_EN
+    INT8U  lat_pending[LCD_NUM_LAYERS];     // Modified since last flatten
+    INT32U lat_call_ts[LCD_NUM_LAYERS];     // First call since last flatten
+    INT8U  lat_in_frame[LCD_NUM_LAYERS];    // Part of the frame being written
+    INT32U lat_frame_call_ts[LCD_NUM_LAYERS];
+    INT32U lat_flatten_ts;
+    LCD_LATENCY latency[LCD_NUM_LAYERS];
+#endif
+} LCD_DISP;
+
 /*************************************************************************
   Private Local Functions
 *************************************************************************/
-static void lcdDlyus(INT16U us);
-static void lcdDly500ns(void);
-static void lcdWrite(INT16U data);
+static void lcdWrite(LCD_DISP *pd, INT16U data);
 static void lcdClear(LCD_BUFFER *buffer);
 
-static void lcdFlattenLayers(LCD_BUFFER *dest_buffer,
-                             LCD_BUFFER *src_layers);
-static void lcdWriteBuffer(LCD_BUFFER *buffer);
-static void lcdMoveCursor(INT8U row, INT8U col);
+static void lcdDispInit(LCD_DISP *pd);
+static void lcdDispPowerUp(LCD_DISP *pd);
+static void lcdDlyus(LCD_DISP *pd, INT16U us);
+static LCD_DISP *lcdNextDisp(OS_TICK now, OS_TICK *wait);
+static void lcdFlattenLayers(LCD_DISP *pd);
+static void lcdWriteBuffer(LCD_DISP *pd);
+static void lcdCursorDispMode(LCD_DISP *pd, INT8U on, INT8U blink);
+static INT8U lcdWriteDiff(LCD_DISP *pd, LCD_BUFFER *buffer, INT8U shift, INT8U commit);
+static INT8U lcdNextAddr(INT8U row, INT8U dcol);
+static void lcdMarqueeRender(LCD_DISP *pd, INT8U layer);
+static void lcdLayerModified(LCD_DISP *pd, INT8U layer);
+#if LCD_SCRUB_EN
+static void lcdScrub(LCD_DISP *pd);
+#endif
+static INT8U lcdCellsWritten(LCD_DISP *pd, INT8U layer, INT8U row, INT8U col, INT8U cnt);
+static INT8U lcdOwnerBelow(LCD_DISP *pd, INT8U row, INT8U col, INT8U layer);
+static INT8U lcdTopLayer(LCD_DISP *pd);
+static INT8U lcdLayerVisibility(LCD_DISP *pd, INT8U layer, INT8U hidden);
+#if LCD_LATENCY_EN
+static void lcdLatMark(LCD_DISP *pd, INT8U layer);
+static void lcdLatFlatten(LCD_DISP *pd);
+static void lcdLatFrameEnd(LCD_DISP *pd);
+#endif
+static INT8U lcdFmtNum(INT8C *line, INT8U idx, INT32U val, INT8U neg,
+                       INT8U base, INT8U upper, INT8U width, INT8U flags,
+                       INT8U end);
 
 /*************************************************************************
   MicroC/OS Resources
@@ -96,73 +208,142 @@ static CPU_STK  lcdLayeredTaskStk[APP_CFG_LCD_TASK_STK_SIZE];
 // Stored Constants
 static const INT8U lcdRowAddress[LCD_NUM_ROWS] = {0x00, 0x40};
 
+// Bus driver of display 0, see LcdBus.h
+#if LCD_BUS_VIRTUAL_EN
+#define LCD_BUS_DEFAULT (&LcdBusVirtual)
+#else
+#define LCD_BUS_DEFAULT (&LcdBusK65)
+#endif
+
 // Static Globals
-static LCD_BUFFER lcdBuffer;
-static LCD_BUFFER lcdPreviousBuffer;
-static LCD_BUFFER lcdLayers[LCD_NUM_LAYERS];
-
-/*************************************************************************
-  LCD Command Macros
-*************************************************************************/
-/*                                                    R R D D D D D D D D
-                                                      / S B B B B B B B B
-                                                      W   7 6 5 4 3 2 1 0
-*/
-// Clear Display                                      0 0 0 0 0 0 0 0 0 1
-#define LCD_CLR_DISP()         (0x0001)      
-// Return Home                                        0 0 0 0 0 0 0 0 1 *
-#define LCD_CUR_HOME()         (0x0002)      
-// Entry Mode Set                                     0 0 0 0 0 0 0 1 ids
-#define LCD_ENTRY_MODE(id, s)  (0x0004                       \
-                                | ((INT16U)id ? 0x0002 : 0)  \
-                                | ((INT16U)s  ? 0x0001 : 0))
-// Display ON/OFF Control                             0 0 0 0 0 0 1 d c b
-#define LCD_ON_OFF(d, c, b)    (0x0008                       \
-                                | ((INT16U)d  ? 0x0004 : 0)  \
-                                | ((INT16U)c  ? 0x0002 : 0)  \
-                                | ((INT16U)b  ? 0x0001 : 0))
-// Cursor or Display Shift                            0 0 0 0 0 1 scrl* *
-#define LCD_SHIFT(sc, rl)      (0x0010                       \
-                                | ((INT16U)sc ? 0x0008 : 0)  \
-                                | ((INT16U)rl ? 0x0004 : 0))
-// Function Set                                       0 0 0 0 1 dln f * *
-#define LCD_FUNCTION(dl, n, f) (0x0020                       \
-                                | ((INT16U)dl ? 0x0010 : 0)  \
-                                | ((INT16U)n  ? 0x0008 : 0)  \
-                                | ((INT16U)f  ? 0x0004 : 0))
-// Set CG RAM Address                                 0 0 0 1 ----acg-----
-#define LCD_CG_RAM(acg)        (0x0040                       \
-                                | ((INT16U)agc  & 0x003F))
-// Set DD RAM Address                                 0 0 1 -----add------
-#define LCD_DD_RAM(add)        (0x0080                       \
-                                | (((INT16U)add)  & 0x007F))
-// Write Data to CG or DD RAM                         0 1 ------data------
-#define LCD_WRITE(data)        (0x0100                       \
-                                | ((INT16U)data & 0x00FF))
-                                                                       
+static LCD_DISP lcdDisps[LCD_NUM_DISPS];
+static INT8U lcdNumDisps;           // Displays added, protected by lcdLayersKey
+#if LCD_SCRUB_EN
+static INT8U lcdScrubDisp;          // Next display to scrub
+#endif
+#if BOOT_PROFILE_EN
+static INT8U lcdBootFrame;          // Display 0's first frame is written
+#endif
+
 /******************************************************************************
-  lcdLayeredTask() - Handles writing to the LCD module      (Private Task)
+  lcdLayeredTask() - Handles writing to the LCD modules      (Private Task)
   
         When writing to the LCD, will block until thescreen is updated.  
         This is worst-case x.xms, but will be much lower if not every character 
         on the screen is changing.
+
+        One task services every display. Each pass writes a frame to the
+        highest priority display that has changed and is ready, so a
+        display costs RAM for its buffers but no task or stack.
+
+        Frames to a display are started no more often than every
+        frame_ticks. Changes that arrive while a frame is held back are
+        merged into it, so a burst of updates costs one frame per period.
+        A change to an urgent layer releases the frame straight away.
+
+        When no display has changed for LCD_SCRUB_MS, a scrub slice is
+        run instead, so the scrub only uses an idle bus.
+
+        Displays that have been added are powered up first, the task
+        being the only user of the bus.
 ******************************************************************************/
 static void lcdLayeredTask(void *p_arg) {
     OS_ERR os_err;
+    OS_TICK now, wait;
+    INT8U disp;
+    LCD_DISP *pd;
     
     // Avoid compiler warning
     (void)p_arg;
     
     while(1) {
-    
-        // Wait for an lcd layer to be modified
-    	DB4_TURN_OFF();
-        OSTaskSemPend(0,OS_OPT_PEND_BLOCKING,(CPU_TS *)0, &os_err);
-    	DB4_TURN_ON();
-        
-        lcdFlattenLayers(&lcdBuffer, (LCD_BUFFER *)&lcdLayers);
-        lcdWriteBuffer(&lcdBuffer);
+        for(disp = 0; disp < lcdNumDisps; disp++) {
+            pd = &lcdDisps[disp];
+            if(pd->powered == FALSE) {
+                lcdDispPowerUp(pd);
+                pd->powered = TRUE;
+                BOOT_MARK("LCD powered up");
+            }else{
+            }
+        }
+        now = OSTimeGet(&os_err);
+        pd = lcdNextDisp(now, &wait);
+
+        if(pd == (LCD_DISP *)0) {
+            // Wait for an lcd layer to be modified, or for a held back
+            // frame to come due
+            DB4_TURN_OFF();
+#if LCD_SCRUB_EN
+            OSTaskSemPend((wait != 0) ? wait : LCD_SCRUB_TICKS,
+                          OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
+            DB4_TURN_ON();
+            if((os_err == OS_ERR_TIMEOUT) && (wait == 0)) {
+                lcdScrub(&lcdDisps[lcdScrubDisp]);
+                lcdScrubDisp++;
+                if(lcdScrubDisp >= lcdNumDisps) {
+                    lcdScrubDisp = 0;
+                }else{
+                }
+            }else{
+            }
+#else
+            OSTaskSemPend(wait, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
+            DB4_TURN_ON();
+#endif
+            // The pending flags hold the changes, extra posts add nothing
+            (void)OSTaskSemSet((OS_TCB *)0, 0, &os_err);
+        }else{
+            if(pd->urgent_pending && ((now - pd->frame_tick) < pd->frame_ticks)) {
+                pd->stats.urgent++;
+            }else{
+            }
+            pd->frame_tick = now;
+            lcdFlattenLayers(pd);
+            lcdWriteBuffer(pd);
+#if BOOT_PROFILE_EN
+            if((pd == &lcdDisps[0]) && (lcdBootFrame == FALSE)) {
+                lcdBootFrame = TRUE;
+                BOOT_MARK("LCD first frame");
+            }else{
+            }
+#endif
+        }
+    }
+}
+
+/*************************************************************************
+  lcdNextDisp() - The display to write next                      (Private)
+
+        Returns the highest priority display that has changed and whose
+        frame period is up, or has an urgent change. Displays still
+        waiting to be powered up are skipped. If there is none,
+        returns 0 and sets *wait to the ticks until the first held back
+        frame comes due, 0 if no display has changed.
+*************************************************************************/
+static LCD_DISP *lcdNextDisp(OS_TICK now, OS_TICK *wait) {
+    INT8U disp;
+    OS_TICK elapsed;
+    LCD_DISP *pd, *next;
+
+    next = (LCD_DISP *)0;
+    *wait = 0;
+    for(disp = 0; disp < lcdNumDisps; disp++) {
+        pd = &lcdDisps[disp];
+        if(pd->pending && pd->powered) {
+            elapsed = now - pd->frame_tick;
+            if(pd->urgent_pending || (elapsed >= pd->frame_ticks)) {
+                if((next == (LCD_DISP *)0) || (pd->prio < next->prio)) {
+                    next = pd;
+                }else{
+                }
+            }else if((*wait == 0) || ((pd->frame_ticks - elapsed) < *wait)) {
+                *wait = pd->frame_ticks - elapsed;
+            }else{
+            }
+        }else{
+        }
     }
+    return(next);
 }
 
 /*************************************************************************
@@ -175,22 +356,32 @@ static void lcdLayeredTask(void *p_arg) {
 *************************************************************************/
 INT8U LcdCursor(INT8U row, INT8U col, INT8U layer, INT8U on, INT8U blink){
     INT8U noerr = TRUE;
+    INT8U modified = FALSE;
     OS_ERR os_err;
+    LCD_DISP *pd = LCD_DISP_OF(layer);
     
     OSMutexPend(&lcdLayersKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
 
-    if ((layer < LCD_NUM_LAYERS) && (col <= LCD_NUM_COLS) && (row <= LCD_NUM_ROWS)){
-        lcdLayers[layer].cursor.col = col;
-        lcdLayers[layer].cursor.row = row;
+    if (LCD_LAYER_VALID(layer) && (col <= pd->cols) && (row <= pd->rows)){
+        layer = LCD_LAYER_OF(layer);
+        pd->layers[layer].cursor.col = col;
+        pd->layers[layer].cursor.row = row;
         if ( blink ){
-            lcdLayers[layer].cursor.blink = TRUE;
+            pd->layers[layer].cursor.blink = TRUE;
         }else{
-            lcdLayers[layer].cursor.blink = FALSE;
+            pd->layers[layer].cursor.blink = FALSE;
         }
         if ( on ){
-            lcdLayers[layer].cursor.on = TRUE;
+            pd->layers[layer].cursor.on = TRUE;
         }else{
-            lcdLayers[layer].cursor.on = FALSE;
+            pd->layers[layer].cursor.on = FALSE;
+        }
+        // Only the top visible layer's cursor is shown
+        if(layer == lcdTopLayer(pd)) {
+            modified = TRUE;
+            lcdLayerModified(pd, layer);
+        }else{
+            pd->stats.occluded++;
         }
     }else{
         noerr = FALSE;
@@ -198,8 +389,11 @@ INT8U LcdCursor(INT8U row, INT8U col, INT8U layer, INT8U on, INT8U blink){
 
     (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
 
-    // We have modified a layer
-    (void)OSTaskSemPost(&lcdLayeredTaskTCB, OS_OPT_POST_NONE, &os_err);
+    // We have modified a visible part of a layer
+    if(modified) {
+        (void)OSTaskSemPost(&lcdLayeredTaskTCB, OS_OPT_POST_NONE, &os_err);
+    }else{
+    }
 
     return(noerr);
 }
@@ -211,7 +405,10 @@ INT8U LcdCursor(INT8U row, INT8U col, INT8U layer, INT8U on, INT8U blink){
 *************************************************************************/
 void LcdDispClear(INT8U layer) {
     OS_ERR os_err;
-    LCD_BUFFER *llayer = &lcdLayers[layer];
+    INT8U row;
+    INT8U modified = FALSE;
+    LCD_DISP *pd = LCD_DISP_OF(layer);
+    LCD_BUFFER *llayer = &pd->layers[LCD_LAYER_OF(layer)];
 
     OSMutexPend(&lcdLayersKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
     while(os_err != OS_ERR_NONE){           /* Error Trap                        */
@@ -219,12 +416,18 @@ void LcdDispClear(INT8U layer) {
 
     lcdClear(llayer);
 
+    for(row = 0; row < pd->rows; row++) {
+        modified |= lcdCellsWritten(pd, LCD_LAYER_OF(layer), row, 0, pd->cols);
+    }
     (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
     while(os_err != OS_ERR_NONE){           /* Error Trap                        */
     }
     
-    // We have modified a layer
-    (void)OSTaskSemPost(&lcdLayeredTaskTCB, OS_OPT_POST_NONE, &os_err);
+    // We have modified a visible part of a layer
+    if(modified) {
+        (void)OSTaskSemPost(&lcdLayeredTaskTCB, OS_OPT_POST_NONE, &os_err);
+    }else{
+    }
 }
 
 
@@ -235,28 +438,33 @@ void LcdDispClear(INT8U layer) {
                      Posts the lcdModifiedFlag semaphore
 *************************************************************************/
 void LcdDispClrLine(INT8U row, INT8U layer) {
-    INT8U col;
+    INT8U col, modified;
     OS_ERR os_err;
     
-    LCD_BUFFER *llayer = &lcdLayers[layer];
+    LCD_DISP *pd = LCD_DISP_OF(layer);
+    LCD_BUFFER *llayer = &pd->layers[LCD_LAYER_OF(layer)];
     
     OSMutexPend(&lcdLayersKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
     while(os_err != OS_ERR_NONE){           /* Error Trap                        */
     }
     
     // For each column...
-    for(col = 0; col < LCD_NUM_COLS; col++) {
+    for(col = 0; col < pd->cols; col++) {
 
         // Clear the character at that position
         llayer->lcd_char[row-1][col] = LCD_CLEAR_BYTE;
     }
     
+    modified = lcdCellsWritten(pd, LCD_LAYER_OF(layer), row-1, 0, pd->cols);
     (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
     while(os_err != OS_ERR_NONE){           /* Error Trap                        */
     }
     
-    // We have modified a layer
-    (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
+    // We have modified a visible part of a layer
+    if(modified) {
+        (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
+    }else{
+    }
 }
 
 
@@ -272,8 +480,9 @@ void LcdDispString(INT8U row,
                    const INT8C *string) {
 
     OS_ERR os_err;
-    INT8U cnt, row_index, col_index;
-    LCD_BUFFER *llayer = &lcdLayers[layer];
+    INT8U cnt, row_index, col_index, modified;
+    LCD_DISP *pd = LCD_DISP_OF(layer);
+    LCD_BUFFER *llayer = &pd->layers[LCD_LAYER_OF(layer)];
 
     row_index = row - 1;
     col_index = col - 1;
@@ -285,19 +494,23 @@ void LcdDispString(INT8U row,
     // Iterate through the string until we reach a null
     for(cnt = 0; string[cnt] != 0x00; cnt++) {
     
-        if((col_index+cnt) < LCD_NUM_COLS){ // not at end of row
+        if((col_index+cnt) < pd->cols){ // not at end of row
             // Copy from the passed paramater to the layer
             llayer->lcd_char[row_index][col_index+cnt] = string[cnt];
         }else{ //outside buffer
         }
     }
     
+    modified = lcdCellsWritten(pd, LCD_LAYER_OF(layer), row_index, col_index, cnt);
     (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
     while(os_err != OS_ERR_NONE){           /* Error Trap                        */
     }
     
-    // We have modified a layer
-    (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
+    // We have modified a visible part of a layer
+    if(modified) {
+        (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
+    }else{
+    }
 }
 
 
@@ -313,13 +526,14 @@ void LcdDispChar(INT8U row,
                  INT8U layer,
                  INT8C character) {
     OS_ERR os_err;
-    INT8U row_index, col_index;
-    LCD_BUFFER *llayer = &lcdLayers[layer];
+    INT8U row_index, col_index, modified;
+    LCD_DISP *pd = LCD_DISP_OF(layer);
+    LCD_BUFFER *llayer = &pd->layers[LCD_LAYER_OF(layer)];
 
     row_index = row - 1;
     col_index = col - 1;
     
-    if(col_index < LCD_NUM_COLS){
+    if(col_index < pd->cols){
         OSMutexPend(&lcdLayersKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
         while(os_err != OS_ERR_NONE){           /* Error Trap                        */
         }
@@ -327,12 +541,16 @@ void LcdDispChar(INT8U row,
         // Copy from the passed paramater to the layer
         llayer->lcd_char[row_index][col_index] = character;
     
+        modified = lcdCellsWritten(pd, LCD_LAYER_OF(layer), row_index, col_index, 1);
         (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
         while(os_err != OS_ERR_NONE){           /* Error Trap                        */
         }
     
-        // We have modified a layer
-        (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
+        // We have modified a visible part of a layer
+        if(modified) {
+            (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
+        }else{
+        }
     }else{ //outside layer
     }
 }
@@ -348,14 +566,15 @@ void LcdDispChar(INT8U row,
 *************************************************************************/
 void LcdDispByte(INT8U row, INT8U col, INT8U layer, INT8U byte) {
     OS_ERR os_err;
-    INT8U row_index, col_index;
-    LCD_BUFFER *llayer = &lcdLayers[layer];
+    INT8U row_index, col_index, modified;
+    LCD_DISP *pd = LCD_DISP_OF(layer);
+    LCD_BUFFER *llayer = &pd->layers[LCD_LAYER_OF(layer)];
     
     // Convert row / col index 1 to index 0
     row_index = row - 1;
     col_index = col - 1;
     
-    if(col < LCD_NUM_COLS){
+    if(col < pd->cols){
         OSMutexPend(&lcdLayersKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
         while(os_err != OS_ERR_NONE){           /* Error Trap                        */
         }
@@ -372,12 +591,16 @@ void LcdDispByte(INT8U row, INT8U col, INT8U layer, INT8U byte) {
             (llayer->lcd_char[row_index][col_index+1] <= 9 ? '0' : 'A' - 10);
 
 
+        modified = lcdCellsWritten(pd, LCD_LAYER_OF(layer), row_index, col_index, 2);
         (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
         while(os_err != OS_ERR_NONE){           /* Error Trap                        */
         }
 
-        // We have modified a layer
-        (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
+        // We have modified a visible part of a layer
+        if(modified) {
+            (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
+        }else{
+        }
         while(os_err != OS_ERR_NONE){           /* Error Trap                        */
         }
     }else{ //outside layer
@@ -399,10 +622,11 @@ void LcdDispDecByte(INT8U row,
                     INT8U lzeros) {
     
     OS_ERR os_err;
-    INT8U row_index, col_index, hunds, tens, ones;
-    LCD_BUFFER *llayer = &lcdLayers[layer];
+    INT8U row_index, col_index, hunds, tens, ones, modified;
+    LCD_DISP *pd = LCD_DISP_OF(layer);
+    LCD_BUFFER *llayer = &pd->layers[LCD_LAYER_OF(layer)];
     
-    if((col + 1) < LCD_NUM_COLS){
+    if((col + 1) < pd->cols){
         // Convert row / col index 1 to index 0
         row_index = row - 1;
         col_index = col - 1;
@@ -429,12 +653,16 @@ void LcdDispDecByte(INT8U row,
         llayer->lcd_char[row_index][col_index+2] += '0';      //  --> ASCII
         
 
+        modified = lcdCellsWritten(pd, LCD_LAYER_OF(layer), row_index, col_index, 3);
         (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
         while(os_err != OS_ERR_NONE){           /* Error Trap                        */
         }
 
-        // We have modified a layer
-        (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
+        // We have modified a visible part of a layer
+        if(modified) {
+            (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
+        }else{
+        }
         while(os_err != OS_ERR_NONE){           /* Error Trap                        */
         }
     }else{ //outside layer
@@ -454,10 +682,11 @@ void LcdDispTime(INT8U row,
                  INT8U mins,
                  INT8U secs) {
     OS_ERR os_err;
-    INT8U row_index, col_index;
-    LCD_BUFFER *llayer = &lcdLayers[layer];
+    INT8U row_index, col_index, modified;
+    LCD_DISP *pd = LCD_DISP_OF(layer);
+    LCD_BUFFER *llayer = &pd->layers[LCD_LAYER_OF(layer)];
 
-    if((col + 6) < LCD_NUM_COLS){
+    if((col + 6) < pd->cols){
         // Convert row / col index 1 to index 0
         row_index = row - 1;
         col_index = col - 1;
@@ -482,32 +711,255 @@ void LcdDispTime(INT8U row,
         llayer->lcd_char[row_index][col_index+7] = secs % 10 + '0';
     
            
+        modified = lcdCellsWritten(pd, LCD_LAYER_OF(layer), row_index, col_index, 8);
         (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
         while(os_err != OS_ERR_NONE){           /* Error Trap                        */
         }
     
-        // We have modified a layer
-        (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
+        // We have modified a visible part of a layer
+        if(modified) {
+            (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
+        }else{
+        }
     }else{ //outside layer
     }
 }
 
 
+/*************************************************************************
+  LcdPrintf - Writes formatted text to a layer                    (Public)
+
+        Formats straight into the layer with a single pend on
+        lcdLayersKey and a single post to the LCD task, so a status
+        line built from several fields costs one round trip instead of
+        one per LcdDisp call. Uses no heap and a fixed amount of stack.
+        Output stops at the end of the row.
+
+        Supports %c %s %d %i %u %x %X and %%, with the '0' and '-'
+        flags, a field width and the 'l' length modifier.
+
+        Returns the number of characters written to the layer.
+
+                Pends on the lcdLayersKey mutex
+                Posts the lcdModifiedFlag semaphore
+*************************************************************************/
+INT8U LcdPrintf(INT8U row,
+                INT8U col,
+                INT8U layer,
+                const INT8C *fmt, ...) {
+    OS_ERR os_err;
+    va_list args;
+    INT8U idx, start, flags, width, modified, end;
+    INT8C *line;
+    const INT8C *str;
+    INT32S sval;
+    INT32U uval;
+    LCD_DISP *pd;
+
+    if(!LCD_LAYER_VALID(layer)) {
+        return(0);
+    }else{
+    }
+    pd = LCD_DISP_OF(layer);
+    layer = LCD_LAYER_OF(layer);
+    end = pd->cols;
+    if((row == 0) || (row > pd->rows) || (col == 0) || (col > end)) {
+        return(0);
+    }else{
+    }
+    line = pd->layers[layer].lcd_char[row - 1];
+    start = col - 1;
+    idx = start;
+
+    va_start(args, fmt);
+    OSMutexPend(&lcdLayersKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
+    while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+    }
+
+    while((*fmt != 0x00) && (idx < end)) {
+        if(*fmt != '%') {
+            line[idx++] = *fmt++;
+            continue;
+        }else{
+        }
+        fmt++;
+
+        // Flags, width and length
+        flags = 0;
+        while((*fmt == '0') || (*fmt == '-')) {
+            flags |= (*fmt == '0') ? LCD_FMT_ZERO : LCD_FMT_LEFT;
+            fmt++;
+        }
+        width = 0;
+        while((*fmt >= '0') && (*fmt <= '9')) {
+            if(width < end) {
+                width = (INT8U)(width * 10 + (*fmt - '0'));
+            }else{
+            }
+            fmt++;
+        }
+        if(*fmt == 'l') {                   // int and long are both 32 bits
+            fmt++;
+        }else{
+        }
+
+        switch(*fmt) {
+            case('c'):
+                line[idx++] = (INT8C)va_arg(args, int);
+                break;
+            case('s'):
+                str = va_arg(args, const INT8C *);
+                for(uval = 0; str[uval] != 0x00; uval++) {
+                }
+                while(((flags & LCD_FMT_LEFT) == 0) && (width > uval)
+                      && (idx < end)) {
+                    line[idx++] = ' ';
+                    width--;
+                }
+                while((*str != 0x00) && (idx < end)) {
+                    line[idx++] = *str++;
+                }
+                while((width > uval) && (idx < end)) {
+                    line[idx++] = ' ';
+                    width--;
+                }
+                break;
+            case('d'):
+            case('i'):
+                sval = va_arg(args, INT32S);
+                if(sval < 0) {
+                    idx = lcdFmtNum(line, idx, (INT32U)0 - (INT32U)sval,
+                                    TRUE, 10, FALSE, width, flags, end);
+                }else{
+                    idx = lcdFmtNum(line, idx, (INT32U)sval,
+                                    FALSE, 10, FALSE, width, flags, end);
+                }
+                break;
+            case('u'):
+                idx = lcdFmtNum(line, idx, va_arg(args, INT32U),
+                                FALSE, 10, FALSE, width, flags, end);
+                break;
+            case('x'):
+            case('X'):
+                idx = lcdFmtNum(line, idx, va_arg(args, INT32U),
+                                FALSE, 16, (INT8U)(*fmt == 'X'), width, flags, end);
+                break;
+            case('%'):
+                line[idx++] = '%';
+                break;
+            default:                        // Unknown or truncated, stop
+                fmt--;
+                while(*fmt != 0x00) {
+                    fmt++;
+                }
+                continue;
+        }
+        fmt++;
+    }
+
+    modified = lcdCellsWritten(pd, layer, row - 1, start, (INT8U)(idx - start));
+    (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
+    while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+    }
+    va_end(args);
+
+    // We have modified a visible part of a layer
+    if(modified) {
+        (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
+    }else{
+    }
+
+    return((INT8U)(idx - start));
+}
+
+/*************************************************************************
+  lcdFmtNum - Writes a number for LcdPrintf                      (Private)
+
+        Converts val to digits in base 10 or 16 into a fixed digit
+        buffer and copies them to line[idx], padding to width. Stops
+        at end, the end of the row. Returns the next line index.
+*************************************************************************/
+static INT8U lcdFmtNum(INT8C *line, INT8U idx, INT32U val, INT8U neg,
+                       INT8U base, INT8U upper, INT8U width, INT8U flags,
+                       INT8U end) {
+    INT8C digits[LCD_FMT_DIGITS];
+    INT8U ndig, len, dig;
+
+    ndig = 0;
+    do {
+        dig = (INT8U)(val % base);
+        if(dig <= 9) {
+            digits[ndig++] = (INT8C)('0' + dig);
+        }else{
+            digits[ndig++] = (INT8C)((upper ? 'A' : 'a') + dig - 10);
+        }
+        val /= base;
+    } while(val != 0);
+
+    len = (INT8U)(ndig + (neg ? 1 : 0));
+    if((flags & LCD_FMT_LEFT) == 0) {
+        if(flags & LCD_FMT_ZERO) {
+            if(neg && (idx < end)) {
+                line[idx++] = '-';
+                neg = FALSE;
+            }else{
+            }
+            while((width > len) && (idx < end)) {
+                line[idx++] = '0';
+                width--;
+            }
+        }else{
+            while((width > len) && (idx < end)) {
+                line[idx++] = ' ';
+                width--;
+            }
+        }
+    }else{
+    }
+    if(neg && (idx < end)) {
+        line[idx++] = '-';
+    }else{
+    }
+    while((ndig != 0) && (idx < end)) {
+        line[idx++] = digits[--ndig];
+    }
+    while((width > len) && (idx < end)) {   // Left justified
+        line[idx++] = ' ';
+        width--;
+    }
+    return(idx);
+}
+
+
 /******************************************************************************
   LcdInit() - Initializes the LCD                                 (Public)
 
-        Initializes the LCD hardware, sets up our semaphores/mutexes/task,
-        clears all of our buffers and layers.  This needs to be run before
-        any other function that accesses the LCD.
+        Sets up our semaphores/mutexes/task, clears all of our buffers
+        and layers.  This needs to be run before any other function that
+        accesses the LCD. Does not wait for the LCD hardware, the LCD
+        task powers it up with OS delays once it runs and layers written
+        before then show in its first frame.
+
+        The board LCD is display 0, with the default bus driver and full
+        geometry. More displays can then be added with LcdDispAdd().
 ******************************************************************************/
 void LcdInit(void) {
-    INT8U layer_cnt;
     OS_ERR os_err;
+    INT8U disp;
     
     // Create mutex key, semaphore, and task
     OSMutexCreate(&lcdLayersKey,"LCD Layers Key", &os_err);
     while(os_err != OS_ERR_NONE){           /* Error Trap                        */
     }
+    lcdNumDisps = 0;
+
+#if LCD_LATENCY_EN
+    CYC_CNT_INIT();
+    LcdLatencyReset();
+#endif
+#if BOOT_PROFILE_EN
+    lcdBootFrame = FALSE;
+#endif
 
     OSTaskCreate((OS_TCB     *)&lcdLayeredTaskTCB,
                 (CPU_CHAR   *)"Layered LCD Task",
@@ -524,124 +976,227 @@ void LcdInit(void) {
                 (OS_ERR     *)&os_err);
     while(os_err != OS_ERR_NONE){           /* Error Trap                        */
     }
+    STK_MON_ADD(&lcdLayeredTaskTCB, APP_CFG_LCD_TASK_STK_SIZE);
+
+    disp = LcdDispAdd(LCD_BUS_DEFAULT, LCD_NUM_ROWS, LCD_NUM_COLS, 0);
+    while(disp != 0){                       /* Error Trap                        */
+    }
+}
+
+/********************************************************************
+** LcdDispAdd(const LCD_BUS_DRV *bus, INT8U rows, INT8U cols,
+**            INT8U prio)
+*
+*  FILENAME: LcdLayered.c
+*
+*  PARAMETERS: bus - Bus driver the display is attached to.
+*              rows, cols - Glass size, up to 2 x 16.
+*              prio - Service priority, lower numbers first when
+*                     several displays have frames waiting.
+*
+*  DESCRIPTION: Initializes another display and gives it its own
+*               layers, numbered LCD_LAYER(disp, layer). It shares
+*               the LCD task with the other displays, which runs the
+*               power up sequence, about 22ms, before its first frame.
+*               Does not block for it. Call after LcdInit().
+*
+*  RETURNS: The display number, LCD_NUM_DISPS if there is no room
+*           or the geometry is not supported.
+********************************************************************/
+INT8U LcdDispAdd(const LCD_BUS_DRV *bus, INT8U rows, INT8U cols, INT8U prio){
+    OS_ERR os_err;
+    INT8U disp;
+    LCD_DISP *pd;
+
+    if((rows == 0) || (rows > LCD_NUM_ROWS) || (cols == 0) || (cols > LCD_NUM_COLS)) {
+        return(LCD_NUM_DISPS);
+    }else{
+    }
+    OSMutexPend(&lcdLayersKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
+    while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+    }
+    disp = lcdNumDisps;
+    if(disp < LCD_NUM_DISPS) {
+        pd = &lcdDisps[disp];
+        pd->bus = bus;
+        pd->rows = rows;
+        pd->cols = cols;
+        pd->prio = prio;
+        lcdDispInit(pd);
+        lcdNumDisps++;                      // The LCD task can now use it
+    }else{
+    }
+    (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
+    while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+    }
+    return(disp);
+}
+
+/*************************************************************************
+  lcdDispInit() - Clears a display's state                       (Private)
+
+        The display is left to be powered up by the LCD task, the state
+        matches the cleared module it will then be.
+*************************************************************************/
+static void lcdDispInit(LCD_DISP *pd) {
+    INT8U layer_cnt, col;
+
+    pd->powered = FALSE;
 
-    // Perform LCD hardware initialisation
-    SIM_SCGC5 |= SIM_SCGC5_PORTD_MASK;              /* Enable clock gate for PORTD */
-    PORTD_PCR1=(0|PORT_PCR_MUX(1));
-    PORTD_PCR2=(0|PORT_PCR_MUX(1));
-    PORTD_PCR3=(0|PORT_PCR_MUX(1));
-    PORTD_PCR4=(0|PORT_PCR_MUX(1));
-    PORTD_PCR5=(0|PORT_PCR_MUX(1));
-    PORTD_PCR6=(0|PORT_PCR_MUX(1));
-    INIT_BIT_DIR();
-    LCD_CLR_E(); 
-    LCD_SET_RS();           /*Data select unless in LcdWrCmd()  */
-    lcdDlyus(15000);           /* LCD requires 15ms delay at powerup */
-   
-    LCD_CLR_RS();           /*Send first command for RESET sequence*/
-    LCD_WR_DB(0x3);
-    LCD_SET_E();
-    lcdDly500ns();
-    LCD_CLR_E();
-    lcdDlyus(4200);            /*Wait >4.1ms */
-  
-    LCD_WR_DB(0x3);         /*Repeat */
-    LCD_SET_E();
-    lcdDly500ns();
-    LCD_CLR_E();
-    lcdDlyus(101);            /*Wait >100us */
-  
-    LCD_WR_DB(0x3);         /* Repeat */
-    LCD_SET_E();
-    lcdDly500ns();
-    LCD_CLR_E();
-    lcdDlyus(41);           /*Wait >40us*/
-  
-    LCD_WR_DB(0x2);         /*Send last command for RESET sequence*/
-    LCD_SET_E();
-    lcdDly500ns();
-    LCD_CLR_E();
-    lcdDlyus(41);
-  
-    lcdWrite(LCD_FUNCTION(0, 1, 0));     /*Send command for 4-bit mode */
-    lcdWrite(LCD_ENTRY_MODE(1, 0)); // Increment, no shift
-    lcdWrite(LCD_ON_OFF(1, 0, 0));  // LCD on, cursor off, blink off
-    lcdWrite(LCD_CLR_DISP());       // Clear display
-    lcdDlyus(1650);
-    lcdWrite(LCD_DD_RAM(0x0000));   // Reset cursor
-    
-    
     // Clear all of our layers
     for(layer_cnt = 0; layer_cnt < LCD_NUM_LAYERS; layer_cnt++) {
-        lcdClear(&lcdLayers[layer_cnt]);
+        lcdClear(&pd->layers[layer_cnt]);
+        pd->marquees[layer_cnt].row = 0;
     }
+    pd->pending = FALSE;
     
-    // Clear the current buffer
-    // and the previous buffer
-    lcdClear(&lcdBuffer);
-    lcdClear(&lcdPreviousBuffer);
+    // Clear the current buffer and match the DDRAM mirror to the
+    // cleared module
+    lcdClear(&pd->buffer);
+    for(layer_cnt = 0; layer_cnt < LCD_NUM_ROWS; layer_cnt++) {
+        for(col = 0; col < LCD_DDRAM_COLS; col++) {
+            pd->ddram.ddram[layer_cnt][col] = LCD_CLEAR_BYTE;
+        }
+        for(col = 0; col < LCD_NUM_COLS; col++) {
+            pd->owner[layer_cnt][col] = LCD_NO_OWNER;
+        }
+        pd->dirty[layer_cnt] = 0;
+    }
+    pd->ddram.shift = 0;
+    pd->ddram.addr = 0;
+    pd->ddram.cursor_on = FALSE;
+    pd->ddram.blink = FALSE;
+
+    pd->frame_ticks = (OS_CFG_TICK_RATE_HZ + LCD_FRAME_RATE_HZ - 1) / LCD_FRAME_RATE_HZ;
+    pd->frame_tick = 0;
+    pd->urgent_layers = 0;
+    pd->urgent_pending = FALSE;
+#if LCD_SCRUB_EN
+    pd->scrub_cell = 0;
+#endif
+}
+
+/*************************************************************************
+  lcdDispPowerUp() - Runs a display's power up sequence          (Private)
+
+        Called by the LCD task before the display's first frame. The
+        15ms power up and 4.1ms reset waits and the clear are OS delays,
+        so the task sleeps through about 22ms of the sequence and the
+        rest of start up runs meanwhile.
+*************************************************************************/
+static void lcdDispPowerUp(LCD_DISP *pd) {
+
+    // Perform LCD hardware initialisation
+    pd->bus->Init();
+    lcdDlyus(pd, 15000);        /* LCD requires 15ms delay at powerup */
+
+    pd->bus->Strobe(0, LCD_RESET_DB);    /*Send first command for RESET sequence*/
+    lcdDlyus(pd, 4200);         /*Wait >4.1ms */
+
+    pd->bus->Strobe(0, LCD_RESET_DB);    /*Repeat */
+    pd->bus->Dlyus(101);        /*Wait >100us */
+
+    pd->bus->Strobe(0, LCD_RESET_DB);    /* Repeat */
+    pd->bus->Dlyus(41);         /*Wait >40us*/
+
+#if LCD_BUS_8BIT_EN
+    lcdWrite(pd, LCD_FUNCTION(1, 1, 0));     /*Send command for 8-bit mode */
+#else
+    pd->bus->Strobe(0, 0x2);    /*Send last command for RESET sequence*/
+    pd->bus->Dlyus(41);
+
+    lcdWrite(pd, LCD_FUNCTION(0, 1, 0));     /*Send command for 4-bit mode */
+#endif
+    lcdWrite(pd, LCD_ENTRY_MODE(1, 0)); // Increment, no shift
+    lcdWrite(pd, LCD_ON_OFF(1, 0, 0));  // LCD on, cursor off, blink off
+    lcdWrite(pd, LCD_CLR_DISP());       // Clear display
+    lcdDlyus(pd, 1650);
+    lcdWrite(pd, LCD_DD_RAM(0x0000));   // Reset cursor
+}
+
+/*************************************************************************
+  lcdDlyus() - Waits at least us microseconds                    (Private)
+
+        Waits of LCD_DLY_BLOCK_US or more block in OSTimeDly(), a tick
+        longer than the wait to cover the part of a tick already gone,
+        and are reported to the bus driver's Idle. Shorter ones spin in
+        the bus driver's Dlyus.
+*************************************************************************/
+static void lcdDlyus(LCD_DISP *pd, INT16U us) {
+    OS_ERR os_err;
+
+    if(us >= LCD_DLY_BLOCK_US) {
+        OSTimeDly((OS_TICK)(((((INT32U)us * OS_CFG_TICK_RATE_HZ) + 999999u) / 1000000u) + 1u),
+                  OS_OPT_TIME_DLY, &os_err);
+        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+        }
+        if(pd->bus->Idle != 0) {
+            pd->bus->Idle(us);
+        }else{
+        }
+    }else{
+        pd->bus->Dlyus(us);
+    }
 }
 
 
 /*************************************************************************
-  lcdFlattenLayers() - Combines *src_layers onto *dest_buffer    (Private)
+  lcdFlattenLayers() - Combines a display's layers onto its      (Private)
+                       buffer
 
-        The src_layer with the lowest index will be on the bottom, the
-        src_layer with the highest index will be on the top.  Treats the
+        The layer with the lowest index will be on the bottom, the
+        layer with the highest index will be on the top.  Treats the
         character defined as LCD_CLEAR_BYTE as a transparent byte.
 
+        owner already holds the top visible layer for each cell, so
+        each cell is a single copy, and only cells marked in dirty
+        are copied. The cursor comes from the top visible layer.
+
                        Pends on the lcdLayersKey mutex
 *************************************************************************/
-static void lcdFlattenLayers(LCD_BUFFER *dest_buffer,
-                             LCD_BUFFER *src_layers) {
+static void lcdFlattenLayers(LCD_DISP *pd) {
     
-    INT8U layer, row, col, current_char;
+    INT8U layer, row, col, owner;
+    INT16U dirty;
     OS_ERR os_err;
-    // Clear the destination buffer
-    lcdClear(dest_buffer);
+    LCD_BUFFER *dest_buffer = &pd->buffer;
 
 //    DBUG_PORT &= ~DBUG_LCDTASK;
     OSMutexPend(&lcdLayersKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
     while(os_err != OS_ERR_NONE){           /* Error Trap                        */
     }
+    LCD_LAT_FLATTEN(pd);
+    pd->pending = FALSE;
+    pd->urgent_pending = FALSE;
 //    DBUG_PORT |= DBUG_LCDTASK;
-    // Set the destination buffer cursor to false initially
-    dest_buffer->cursor.on = FALSE;
-    dest_buffer->cursor.blink = FALSE;
 
-    // For each layer...
-    for(layer = 0; layer < LCD_NUM_LAYERS; layer++) {
+    // For each row...
+    for(row = 0; row < pd->rows; row++) {
+        dirty = pd->dirty[row];
+        pd->dirty[row] = 0;
+        // For each dirty column...
+        for(col = 0; dirty != 0; col++, dirty >>= 1) {
+            if((dirty & 1) != 0) {
+                owner = pd->owner[row][col];
+                if(owner != LCD_NO_OWNER) {
+                    dest_buffer->lcd_char[row][col] = pd->layers[owner].lcd_char[row][col];
+                }else{
+                    dest_buffer->lcd_char[row][col] = LCD_CLEAR_BYTE;
+                }
+            }else{
+            }
+        }
+    }
 
-        // If that layer is not hidden...
-        if((src_layers+layer)->hidden == 0) {
-            // For each row...
-            for(row = 0; row < LCD_NUM_ROWS; row++) {
-                // For each column...
-                for(col = 0; col < LCD_NUM_COLS; col++) {
-                    current_char = (src_layers+layer)->lcd_char[row][col];
-                
-                    // If the source layer is not null
-                    if(current_char != LCD_CLEAR_BYTE) {
-                        // Copy from the source layer to the buffer
-                        dest_buffer->lcd_char[row][col] = current_char;
-                    }else{ //Do nothing - transparent
-                    }
-                    
-                } // column
-            } // row
-
-            //Handle the cursor status
-//            if ( (src_layers+layer)->cursor.on != FALSE){
-                dest_buffer->cursor.col = (src_layers+layer)->cursor.col;
-                dest_buffer->cursor.row = (src_layers+layer)->cursor.row;
-                dest_buffer->cursor.on = (src_layers+layer)->cursor.on;
-                dest_buffer->cursor.blink = (src_layers+layer)->cursor.blink;
-//            }else{
-                // This layer doesn't move the cursor, do nothing
-//            }
-        }else{ //Do nothing - layer is hidden
-        }
-    } // layer
+    //Handle the cursor status
+    layer = lcdTopLayer(pd);
+    if(layer != LCD_NO_OWNER) {
+        dest_buffer->cursor = pd->layers[layer].cursor;
+    }else{
+        // Set the destination buffer cursor to false
+        dest_buffer->cursor.on = FALSE;
+        dest_buffer->cursor.blink = FALSE;
+    }
     
     (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
     while(os_err != OS_ERR_NONE){           /* Error Trap                        */
@@ -653,95 +1208,255 @@ static void lcdFlattenLayers(LCD_BUFFER *dest_buffer,
 /*************************************************************************
   lcdWriteBuffer() - Sends an LCD_BUFFER buffer to lcdWrite()    (Private)
   
-        The previous buffer lcdPreviousBuffer is a global variable
-        containing a copy of the actual contents of the LCD module.  By 
-        using the lcdPreviousBuffer and repos_flag, we are able to only
-        write bytes that have changed.
-                                                           
+        lcdDdram is a copy of the actual contents of the LCD module's
+        DDRAM, so only bytes that have changed are written and the
+        address is only set when the address counter is not already
+        there.
+
+        Each DDRAM line is 40 characters but only 16 are on the glass.
+        Before writing, the cost of the frame is worked out with the
+        current display shift and with the display shifted one place
+        either way. A shift is one command, so a scrolling row whose
+        text is already in DDRAM costs one transaction per step. When
+        shifting would move other rows or layers that then have to be
+        rewritten, the unshifted diff is cheaper and is used instead.
+
                      Blocks for as long as lcdWrite() blocks
 *************************************************************************/
-static void lcdWriteBuffer(LCD_BUFFER *buffer) {
-    INT8U row, col, repos_flag;
-    
+static void lcdWriteBuffer(LCD_DISP *pd) {
+    INT8U shift, cost, best, addr;
+    INT32U writes;
+    LCD_BUFFER *buffer = &pd->buffer;
+
+    writes = pd->stats.writes;
+
+    // Find the cheapest display shift
+    shift = pd->ddram.shift;
+    best = lcdWriteDiff(pd, buffer, pd->ddram.shift, FALSE);
+    if(best != 0) {
+        cost = 1 + lcdWriteDiff(pd, buffer,
+                   (INT8U)((pd->ddram.shift + 1) % LCD_DDRAM_COLS), FALSE);
+        if(cost < best) {
+            best = cost;
+            shift = (INT8U)((pd->ddram.shift + 1) % LCD_DDRAM_COLS);
+        }else{
+        }
+        cost = 1 + lcdWriteDiff(pd, buffer,
+                   (INT8U)((pd->ddram.shift + LCD_DDRAM_COLS - 1) % LCD_DDRAM_COLS),
+                   FALSE);
+        if(cost < best) {
+            shift = (INT8U)((pd->ddram.shift + LCD_DDRAM_COLS - 1) % LCD_DDRAM_COLS);
+        }else{
+        }
+    }else{
+    }
+
+    if(shift != pd->ddram.shift) {
+        // Shift left moves the glass window one DDRAM column right
+        lcdWrite(pd, LCD_SHIFT(1, (shift != ((pd->ddram.shift + 1) % LCD_DDRAM_COLS))));
+        pd->ddram.shift = shift;
+        pd->stats.shifts++;
+    }else{
+    }
+    (void)lcdWriteDiff(pd, buffer, shift, TRUE);
+
+    // At the end setup the cursor. The address counter only matters
+    // when the cursor is showing.
+    if((buffer->cursor.on || buffer->cursor.blink)
+        && (buffer->cursor.row != 0) && (buffer->cursor.col != 0)) {
+        addr = lcdRowAddress[buffer->cursor.row - 1]
+               + ((buffer->cursor.col - 1 + pd->ddram.shift) % LCD_DDRAM_COLS);
+        if(addr != pd->ddram.addr) {
+            lcdWrite(pd, LCD_DD_RAM(addr));
+            pd->ddram.addr = addr;
+        }else{
+        }
+    }else{
+    }
+    if((buffer->cursor.on != pd->ddram.cursor_on)
+        || (buffer->cursor.blink != pd->ddram.blink)) {
+        lcdCursorDispMode(pd, buffer->cursor.on, buffer->cursor.blink);
+    }else{
+    }
+
+    LCD_LAT_FRAME_END(pd);
+    pd->stats.frames++;
+    pd->stats.last_writes = (INT16U)(pd->stats.writes - writes);
+    if(pd->marquee_stepped) {
+        pd->marquee_stepped = FALSE;
+        pd->stats.scroll_frames++;
+        pd->stats.scroll_writes += pd->stats.last_writes;
+    }else{
+    }
+}
+
+/*************************************************************************
+  lcdWriteDiff() - Diffs a buffer against lcdDdram for a         (Private)
+                   display shift
+
+        Returns the number of bus transactions needed to make the glass
+        show *buffer with the passed shift. If commit is TRUE they are
+        also written and lcdDdram is updated.
+*************************************************************************/
+static INT8U lcdWriteDiff(LCD_DISP *pd, LCD_BUFFER *buffer, INT8U shift, INT8U commit) {
+    INT8U row, col, dcol, addr, cnt;
+
+    cnt = 0;
+    addr = pd->ddram.addr;
     // For each row...
-    for(row = 0; row < LCD_NUM_ROWS; row++) {
-    
-        // Set our cursor to the beginning of the row
-        lcdWrite(LCD_DD_RAM(lcdRowAddress[row]));
-        repos_flag = 0;
-        
-        // For each column...
-        for(col = 0; col < LCD_NUM_COLS; col++) {
+    for(row = 0; row < pd->rows; row++) {
+        // For each column on the glass...
+        for(col = 0; col < pd->cols; col++) {
+            dcol = (INT8U)((col + shift) % LCD_DDRAM_COLS);
 
             // If the character at the current position has changed...
-            if(lcdPreviousBuffer.lcd_char[row][col]
-                != buffer->lcd_char[row][col]) {
-                
+            if(pd->ddram.ddram[row][dcol] != buffer->lcd_char[row][col]) {
+
                 // If we need to reposition, do that now
-                if(repos_flag == 1) {
-                    lcdWrite(LCD_DD_RAM((lcdRowAddress[row] + col)));
-                    repos_flag = 0;
+                if(addr != (lcdRowAddress[row] + dcol)) {
+                    cnt++;
+                    if(commit) {
+                        lcdWrite(pd, LCD_DD_RAM((lcdRowAddress[row] + dcol)));
+                    }else{
+                    }
+                }else{
+                }
+
+                // Write the character to the LCD and update the mirror
+                cnt++;
+                if(commit) {
+                    lcdWrite(pd, LCD_WRITE(buffer->lcd_char[row][col]));
+                    pd->ddram.ddram[row][dcol] = buffer->lcd_char[row][col];
+                }else{
                 }
-            
-                // Write the character to the LCD
-                lcdWrite(LCD_WRITE(buffer->lcd_char[row][col]));
-             
-                // And update the previous buffer
-                lcdPreviousBuffer.lcd_char[row][col] =
-                    buffer->lcd_char[row][col];
-            } else {
-                // Otherwise we don't write the character... but we need
-                //   to set the reposition flag
-                
-                repos_flag = 1;
+                addr = lcdNextAddr(row, dcol);
+            }else{
             }
-            
-        
         }
     }
-    // At the end setup the cursor
-    lcdMoveCursor(buffer->cursor.row,buffer->cursor.col);
-    LcdCursorDispMode(buffer->cursor.on, buffer->cursor.blink);
-
-}
-
-/******************************************************************************
-  lcdWrite() - Writes a command (both data and control busses)   (Private)
-               to the LCD.
-               data is a 16-bit value bits 9-15 are not used, bit 8 is the 
-               register select, bits 0-7 is the character or command.
-               
-******************************************************************************/
-static void lcdWrite(INT16U data) {
-    INT8U c;
-    // Set/Reset RS
-    if((data & 0x0100) == 0x0100){
-        LCD_SET_RS(); //data write
+    if(commit) {
+        pd->ddram.addr = addr;
     }else{
-        LCD_CLR_RS(); //command write
     }
-    
-    c = (INT8U)data;
-    // Write character/command to LCD
-    LCD_WR_DB((c>>4));
-    LCD_SET_E();
-    lcdDly500ns();
-    LCD_CLR_E();
-    lcdDly500ns();
-    lcdDly500ns();
-    LCD_WR_DB((c&0x0f));
-    LCD_SET_E();
-    lcdDly500ns();
-    LCD_CLR_E();
-    lcdDlyus(41);
+    return(cnt);
 }
 
-
+#if LCD_SCRUB_EN
 /*************************************************************************
-  lcdClear() - Clears a buffer or layer                          (Private)
+  lcdScrub() - Rewrites the next LCD_SCRUB_CELLS glass cells     (Private)
+               from lcdDdram
+
+        Cells are taken round robin over the glass at the current
+        display shift. With a bus Read() each cell is read back first
+        and only rewritten if it is wrong, which is counted in
+        scrub_fixes. The HD44780 returns invalid data on the first
+        read after a write, so the address is always set before a
+        read unless the last bus operation was a read. The address
+        counter is put back afterwards when the cursor is showing.
+
+        Only called from lcdLayeredTask, so the frame writes and the
+        scrub never share the bus. A display added while the task was
+        waiting is not powered up yet and is skipped.
 *************************************************************************/
-static void lcdClear(LCD_BUFFER *buffer) {
-    INT8U row, col;
+static void lcdScrub(LCD_DISP *pd) {
+    INT8U cnt, row, dcol, addr, cursor_addr;
+    INT8U read_ok = FALSE;      // Last bus operation was a read or address set
+    INT8C ch;
+
+    if(pd->powered == FALSE) {
+        return;
+    }else{
+    }
+    cursor_addr = pd->ddram.addr;
+    for(cnt = 0; cnt < LCD_SCRUB_CELLS; cnt++) {
+        row = (INT8U)(pd->scrub_cell / pd->cols);
+        dcol = (INT8U)(((pd->scrub_cell % pd->cols) + pd->ddram.shift) % LCD_DDRAM_COLS);
+        addr = (INT8U)(lcdRowAddress[row] + dcol);
+        ch = pd->ddram.ddram[row][dcol];
+
+        if((addr != pd->ddram.addr) || ((pd->bus->Read != 0) && (read_ok == FALSE))) {
+            lcdWrite(pd, LCD_DD_RAM(addr));
+            read_ok = TRUE;
+        }else{
+        }
+        if(pd->bus->Read != 0) {
+            if((INT8C)pd->bus->Read() != ch) {
+                pd->bus->Dlyus(LCD_EXEC_DATA_US);
+                lcdWrite(pd, LCD_DD_RAM(addr));
+                lcdWrite(pd, LCD_WRITE(ch));
+                read_ok = FALSE;
+                pd->stats.scrub_fixes++;
+            }else{
+                pd->bus->Dlyus(LCD_EXEC_DATA_US);
+            }
+        }else{
+            lcdWrite(pd, LCD_WRITE(ch));
+        }
+        pd->ddram.addr = lcdNextAddr(row, dcol);
+        pd->stats.scrub_cells++;
+
+        pd->scrub_cell++;
+        if(pd->scrub_cell == (pd->rows * pd->cols)) {
+            pd->scrub_cell = 0;
+            pd->stats.scrub_passes++;
+        }else{
+        }
+    }
+
+    if((pd->ddram.cursor_on || pd->ddram.blink) && (pd->ddram.addr != cursor_addr)) {
+        lcdWrite(pd, LCD_DD_RAM(cursor_addr));
+        pd->ddram.addr = cursor_addr;
+    }else{
+    }
+}
+#endif
+
+/*************************************************************************
+  lcdNextAddr() - The address counter after a DDRAM write        (Private)
+
+        The end of line 1 wraps to line 2 and the end of line 2 wraps
+        back to line 1. The controller is always in 2-line mode, so
+        this holds for a one row display too.
+*************************************************************************/
+static INT8U lcdNextAddr(INT8U row, INT8U dcol) {
+    if(dcol == (LCD_DDRAM_COLS - 1)) {
+        return(lcdRowAddress[(row == 0) ? 1 : 0]);
+    }else{
+        return((INT8U)(lcdRowAddress[row] + dcol + 1));
+    }
+}
+
+/******************************************************************************
+  lcdWrite() - Writes a command (both data and control busses)   (Private)
+               to the LCD.
+               data is a 16-bit value bits 9-15 are not used, bit 8 is the 
+               register select, bits 0-7 is the character or command.
+               
+******************************************************************************/
+static void lcdWrite(LCD_DISP *pd, INT16U data) {
+    INT8U c, rs;
+
+    pd->stats.writes++;
+
+    rs = (INT8U)((data & LCD_RS_DATA) == LCD_RS_DATA);
+    c = (INT8U)data;
+#if LCD_BUS_8BIT_EN
+    // Write character/command to LCD in one strobe
+    pd->bus->Strobe(rs, c);
+#else
+    // Write character/command to LCD, high nibble first
+    pd->bus->Strobe(rs, (INT8U)(c>>4));
+    pd->bus->Strobe(rs, (INT8U)(c&0x0f));
+#endif
+    pd->bus->Dlyus(41);
+}
+
+
+/*************************************************************************
+  lcdClear() - Clears a buffer or layer                          (Private)
+*************************************************************************/
+static void lcdClear(LCD_BUFFER *buffer) {
+    INT8U row, col;
     
     // For each row...
     for(row = 0; row < LCD_NUM_ROWS; row++) {
@@ -756,22 +1471,6 @@ static void lcdClear(LCD_BUFFER *buffer) {
     
 }
 
-/********************************************************************
-** lcdMoveCursor(INT8U row, INT8U col)
-*
-*  FILENAME: LCD.c
-*
-*  PARAMETERS: row - Destination row (1 or 2).
-*              col - Destination column (1 - 16).
-*
-*  DESCRIPTION: Moves the cursor to [row,col].
-*
-*  RETURNS: None
-********************************************************************/
-static void lcdMoveCursor(INT8U row, INT8U col) {
-   lcdWrite(LCD_DD_RAM((lcdRowAddress[(row-1)]) + (col-1)));
-}
-
 /********************************************************************
 ** LcdCursorDispMode(INT8U on, INT8U blink)
 *
@@ -780,12 +1479,21 @@ static void lcdMoveCursor(INT8U row, INT8U col) {
 *  PARAMETERS: on - (Binary)Turn cursor on if TRUE, off if FALSE.
 *              blink - (Binary)Cursor blinks if TRUE.
 *
-*  DESCRIPTION: Changes LCD cursor state.
+*  DESCRIPTION: Changes LCD cursor state of display 0.
 *
 *  RETURNS: None
 ********************************************************************/
 void LcdCursorDispMode(INT8U on, INT8U blink) {
-    lcdWrite(LCD_ON_OFF(1, on, blink));
+    lcdCursorDispMode(&lcdDisps[0], on, blink);
+}
+
+/*************************************************************************
+  lcdCursorDispMode() - Changes a display's cursor state         (Private)
+*************************************************************************/
+static void lcdCursorDispMode(LCD_DISP *pd, INT8U on, INT8U blink) {
+    lcdWrite(pd, LCD_ON_OFF(1, on, blink));
+    pd->ddram.cursor_on = on;
+    pd->ddram.blink = blink;
 }
 
 /********************************************************************
@@ -795,12 +1503,33 @@ void LcdCursorDispMode(INT8U on, INT8U blink) {
 *
 *  PARAMETERS: layer - The layer to be hidden
 *
-*  DESCRIPTION: Hides the specified layer
+*  DESCRIPTION: Hides the specified layer. The LCD task is posted
+*               only if the glass changes, and only the cells where
+*               the layer covered something different are redrawn.
 *
 *  RETURNS: None
 ********************************************************************/
 void LcdHideLayer(INT8U layer){
-    lcdLayers[layer].hidden = 1;
+    OS_ERR os_err;
+    INT8U modified;
+    LCD_DISP *pd = LCD_DISP_OF(layer);
+
+    if(LCD_LAYER_VALID(layer)) {
+        OSMutexPend(&lcdLayersKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
+        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+        }
+        modified = lcdLayerVisibility(pd, LCD_LAYER_OF(layer), TRUE);
+        (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
+        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+        }
+
+        // Only cells that look different are redrawn
+        if(modified) {
+            (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
+        }else{
+        }
+    }else{
+    }
 }
 
 
@@ -811,12 +1540,33 @@ void LcdHideLayer(INT8U layer){
 *
 *  PARAMETERS: layer - The layer to be shown
 *
-*  DESCRIPTION: Shows the specified layer
+*  DESCRIPTION: Shows the specified layer. The LCD task is posted
+*               only if the glass changes, and only the cells where
+*               the layer covers something different are redrawn.
 *
 *  RETURNS: None
 ********************************************************************/
 void LcdShowLayer(INT8U layer){
-    lcdLayers[layer].hidden = 0;
+    OS_ERR os_err;
+    INT8U modified;
+    LCD_DISP *pd = LCD_DISP_OF(layer);
+
+    if(LCD_LAYER_VALID(layer)) {
+        OSMutexPend(&lcdLayersKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
+        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+        }
+        modified = lcdLayerVisibility(pd, LCD_LAYER_OF(layer), FALSE);
+        (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
+        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+        }
+
+        // Only cells that look different are redrawn
+        if(modified) {
+            (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
+        }else{
+        }
+    }else{
+    }
 }
 
 /********************************************************************
@@ -826,42 +1576,631 @@ void LcdShowLayer(INT8U layer){
 *
 *  PARAMETERS: layer - The layer to be toggled
 *
-*  DESCRIPTION: Toggles the specified layer
+*  DESCRIPTION: Toggles the specified layer, see LcdHideLayer() and
+*               LcdShowLayer()
 *
 *  RETURNS: None
 ********************************************************************/
 void LcdToggleLayer(INT8U layer){
-    if(lcdLayers[layer].hidden){
-        lcdLayers[layer].hidden = 0;
+    OS_ERR os_err;
+    INT8U modified;
+    LCD_DISP *pd = LCD_DISP_OF(layer);
+
+    if(LCD_LAYER_VALID(layer)) {
+        OSMutexPend(&lcdLayersKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
+        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+        }
+        modified = lcdLayerVisibility(pd, LCD_LAYER_OF(layer), (INT8U)(pd->layers[LCD_LAYER_OF(layer)].hidden == 0));
+        (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
+        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+        }
+
+        // Only cells that look different are redrawn
+        if(modified) {
+            (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
+        }else{
+        }
+    }else{
+    }
+}
+
+/********************************************************************
+** LcdSwapLayers(INT8U hide, INT8U show)
+*
+*  FILENAME: LcdLayered.c
+*
+*  PARAMETERS: hide - The layer to be hidden
+*              show - The layer to be shown
+*
+*  DESCRIPTION: Hides one layer and shows another as one change, for
+*               a screen switch. Both are done under one pend on
+*               lcdLayersKey with one post to the LCD task, so the glass
+*               goes straight from one to the other in a single frame
+*               and never shows both or neither. Layers on different
+*               displays are done one at a time.
+*
+*  RETURNS: None
+********************************************************************/
+void LcdSwapLayers(INT8U hide, INT8U show){
+    OS_ERR os_err;
+    INT8U modified;
+    LCD_DISP *pd = LCD_DISP_OF(show);
+
+    if(LCD_LAYER_VALID(hide) && LCD_LAYER_VALID(show) && (LCD_DISP_OF(hide) == pd)) {
+        OSMutexPend(&lcdLayersKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
+        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+        }
+        modified = lcdLayerVisibility(pd, LCD_LAYER_OF(hide), TRUE);
+        modified |= lcdLayerVisibility(pd, LCD_LAYER_OF(show), FALSE);
+        (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
+        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+        }
+
+        // Only cells that look different are redrawn
+        if(modified) {
+            (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
+        }else{
+        }
     }else{
-        lcdLayers[layer].hidden = 1;
+        LcdHideLayer(hide);
+        LcdShowLayer(show);
     }
 }
 
 /*************************************************************************
-  lcdDlyus() - Blocks for the passed number of microseconds      (Private)
+  lcdLayerVisibility() - Hides or shows a layer and updates      (Private)
+                         owner
+
+        Only cells the layer owns (hiding) or has a character in
+        (showing) are looked at. Cells where the character on the glass
+        changes are marked dirty. Returns TRUE, and marks the layer
+        modified, if any cell changed or the layer's cursor went on or
+        off the glass.
+
+                       Must be called with lcdLayersKey held
 *************************************************************************/
-static void lcdDlyus(INT16U us) {
-    INT16U cnt;
-    
-    for(cnt = 0; cnt <= us; cnt++) {
-        lcdDly500ns();
-        lcdDly500ns();
+static INT8U lcdLayerVisibility(LCD_DISP *pd, INT8U layer, INT8U hidden) {
+    INT8U row, col, owner, below, top, modified;
+    INT8C under;
+
+    modified = FALSE;
+    if((pd->layers[layer].hidden != 0) == (hidden != 0)) {
+        return(modified);
+    }else{
+    }
+    top = lcdTopLayer(pd);
+    pd->layers[layer].hidden = hidden ? 1 : 0;
+    for(row = 0; row < pd->rows; row++) {
+        for(col = 0; col < pd->cols; col++) {
+            owner = pd->owner[row][col];
+            if(hidden) {
+                if(owner == layer) {
+                    below = lcdOwnerBelow(pd, row, col, layer);
+                    pd->owner[row][col] = below;
+                    under = (below != LCD_NO_OWNER) ?
+                        pd->layers[below].lcd_char[row][col] : LCD_CLEAR_BYTE;
+                    if(under != pd->layers[layer].lcd_char[row][col]) {
+                        LCD_DIRTY(pd, row, col);
+                        modified = TRUE;
+                    }else{
+                    }
+                }else{
+                }
+            }else{
+                if((pd->layers[layer].lcd_char[row][col] != LCD_CLEAR_BYTE)
+                    && ((owner == LCD_NO_OWNER) || (owner < layer))) {
+                    pd->owner[row][col] = layer;
+                    under = (owner != LCD_NO_OWNER) ?
+                        pd->layers[owner].lcd_char[row][col] : LCD_CLEAR_BYTE;
+                    if(under != pd->layers[layer].lcd_char[row][col]) {
+                        LCD_DIRTY(pd, row, col);
+                        modified = TRUE;
+                    }else{
+                    }
+                }else{
+                }
+            }
+        }
+    }
+    if(top != lcdTopLayer(pd)) {
+        modified = TRUE;                // The cursor comes from another layer
+    }else{
+    }
+    if(modified) {
+        lcdLayerModified(pd, layer);
+    }else{
+    }
+    return(modified);
+}
+
+/********************************************************************
+** LcdMarqueeStart(INT8U row, INT8U layer, const INT8C *text)
+*
+*  FILENAME: LcdLayered.c
+*
+*  PARAMETERS: row - Row of the layer to scroll (1 or 2).
+*              layer - The layer the marquee is drawn on.
+*              text - Null terminated text to scroll. It is not copied
+*                     so it must stay valid until LcdMarqueeStop().
+*                     Include trailing spaces for a gap between laps.
+*
+*  DESCRIPTION: Makes a row of a layer a marquee. The row shows 16
+*               characters of text starting at the first and wrapping
+*               around. Each LcdMarqueeStep() scrolls it one place left.
+*               Text exactly 40 characters long fills a whole DDRAM
+*               line, so once it has been round once every step is a
+*               single display shift command.
+*
+*  RETURNS: TRUE if no error, FALSE otherwise
+********************************************************************/
+INT8U LcdMarqueeStart(INT8U row, INT8U layer, const INT8C *text){
+    OS_ERR os_err;
+    INT16U len;
+    INT8U modified;
+    LCD_DISP *pd;
+
+    for(len = 0; text[len] != 0x00; len++) {
+    }
+    if(!LCD_LAYER_VALID(layer) || (len == 0)) {
+        return(FALSE);
+    }else{
+    }
+    pd = LCD_DISP_OF(layer);
+    layer = LCD_LAYER_OF(layer);
+    if((row == 0) || (row > pd->rows)) {
+        return(FALSE);
+    }else{
+    }
+
+    OSMutexPend(&lcdLayersKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
+    while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+    }
+
+    pd->marquees[layer].text = text;
+    pd->marquees[layer].len = len;
+    pd->marquees[layer].pos = 0;
+    pd->marquees[layer].row = row;
+    lcdMarqueeRender(pd, layer);
+
+    modified = lcdCellsWritten(pd, layer, row - 1, 0, pd->cols);
+    (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
+    while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+    }
+
+    // We have modified a visible part of a layer
+    if(modified) {
+        (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
+    }else{
+    }
+    return(TRUE);
+}
+
+/********************************************************************
+** LcdMarqueeStep(INT8U layer)
+*
+*  FILENAME: LcdLayered.c
+*
+*  PARAMETERS: layer - The layer with the marquee.
+*
+*  DESCRIPTION: Scrolls the layer's marquee one character left. The
+*               caller sets the scroll rate by how often it calls this.
+*
+*  RETURNS: None
+********************************************************************/
+void LcdMarqueeStep(INT8U layer){
+    OS_ERR os_err;
+    INT8U modified = FALSE;
+    LCD_DISP *pd = LCD_DISP_OF(layer);
+
+    if(LCD_LAYER_VALID(layer)) {
+        layer = LCD_LAYER_OF(layer);
+        OSMutexPend(&lcdLayersKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
+        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+        }
+
+        if(pd->marquees[layer].row != 0) {  /* Checked under the key, LcdMarqueeStop() */
+            pd->marquees[layer].pos++;
+            if(pd->marquees[layer].pos >= pd->marquees[layer].len) {
+                pd->marquees[layer].pos = 0;
+            }else{
+            }
+            lcdMarqueeRender(pd, layer);
+            pd->marquee_stepped = TRUE;
+
+            modified = lcdCellsWritten(pd, layer, pd->marquees[layer].row - 1, 0, pd->cols);
+        }else{ //not a marquee
+        }
+        (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
+        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+        }
+
+        // We have modified a visible part of a layer
+        if(modified) {
+            (void)OSTaskSemPost(&lcdLayeredTaskTCB,OS_OPT_POST_NONE,&os_err);
+        }else{
+        }
+    }else{
+    }
+}
+
+/********************************************************************
+** LcdMarqueeStop(INT8U layer)
+*
+*  FILENAME: LcdLayered.c
+*
+*  PARAMETERS: layer - The layer with the marquee.
+*
+*  DESCRIPTION: Stops the marquee. The row keeps its current text
+*               until it is cleared or overwritten.
+*               Pends on the lcdLayersKey mutex
+*
+*  RETURNS: None
+********************************************************************/
+void LcdMarqueeStop(INT8U layer){
+    OS_ERR os_err;
+
+    if(LCD_LAYER_VALID(layer)) {
+        OSMutexPend(&lcdLayersKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
+        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+        }
+
+        LCD_DISP_OF(layer)->marquees[LCD_LAYER_OF(layer)].row = 0;
+
+        (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
+        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+        }
+    }else{
+    }
+}
+
+/*************************************************************************
+  lcdMarqueeRender() - Draws a marquee into its layer row        (Private)
+
+                       Must be called with lcdLayersKey held
+*************************************************************************/
+static void lcdMarqueeRender(LCD_DISP *pd, INT8U layer) {
+    INT8U col;
+    INT16U idx;
+    LCD_MARQUEE *mq = &pd->marquees[layer];
+
+    idx = mq->pos;
+    for(col = 0; col < pd->cols; col++) {
+        pd->layers[layer].lcd_char[mq->row - 1][col] = mq->text[idx];
+        idx++;
+        if(idx >= mq->len) {
+            idx = 0;
+        }else{
+        }
     }
+}
 
+/********************************************************************
+** LcdStatsGet(INT8U disp, LCD_STATS *stats)
+*
+*  FILENAME: LcdLayered.c
+*
+*  PARAMETERS: disp - The display to read, 0 for the board LCD.
+*              stats - Destination for a copy of the counters.
+*
+*  DESCRIPTION: Reads the LCD bus counters of a display. Bus
+*               transactions per scroll step are scroll_writes /
+*               scroll_frames.
+*
+*  RETURNS: TRUE if no error, FALSE otherwise
+********************************************************************/
+INT8U LcdStatsGet(INT8U disp, LCD_STATS *stats){
+    CPU_SR_ALLOC();
+
+    if(disp >= lcdNumDisps) {
+        return(FALSE);
+    }else{
+    }
+    CPU_CRITICAL_ENTER();
+    *stats = lcdDisps[disp].stats;
+    CPU_CRITICAL_EXIT();
+    return(TRUE);
 }
 
+/********************************************************************
+** LcdFrameRateSet(INT8U disp, INT16U hz)
+*
+*  FILENAME: LcdLayered.c
+*
+*  PARAMETERS: disp - The display to set, 0 for the board LCD.
+*              hz - Maximum frames per second, 0 for no limit.
+*
+*  DESCRIPTION: Sets the refresh rate cap of a display. The
+*               period is rounded up to whole ticks.
+*
+*  RETURNS: TRUE if no error, FALSE otherwise
+********************************************************************/
+INT8U LcdFrameRateSet(INT8U disp, INT16U hz){
+    if(disp >= lcdNumDisps) {
+        return(FALSE);
+    }else{
+    }
+    if(hz == 0) {
+        lcdDisps[disp].frame_ticks = 0;
+    }else{
+        lcdDisps[disp].frame_ticks = (OS_CFG_TICK_RATE_HZ + hz - 1) / hz;
+    }
+    return(TRUE);
+}
 
 /********************************************************************
-** lcdDly500ns(void)
-*   Delays, at least, 500ns
-*   Designed for 120MHz or 150MHz clock.
- *  Tdly >= (66.5ns)i (at 150MHz)
- * Currently set to ~532ns with i=8.
- * TDM 01/20/2013
+** LcdLayerUrgent(INT8U layer, INT8U urgent)
+*
+*  FILENAME: LcdLayered.c
+*
+*  PARAMETERS: layer - The layer to set.
+*              urgent - TRUE if changes to the layer bypass the
+*                       refresh rate cap.
+*
+*  DESCRIPTION: Use for layers where the user is waiting on the
+*               result, like a cursor moving under key presses.
+*
+*  RETURNS: None
 ********************************************************************/
-static void lcdDly500ns(void){
-    INT32U i;
-    for(i=0;i<8;i++){
+void LcdLayerUrgent(INT8U layer, INT8U urgent){
+    OS_ERR os_err;
+    LCD_DISP *pd = LCD_DISP_OF(layer);
+
+    if(LCD_LAYER_VALID(layer)) {
+        layer = LCD_LAYER_OF(layer);
+        OSMutexPend(&lcdLayersKey, 0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
+        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+        }
+        if(urgent) {
+            pd->urgent_layers |= ((INT32U)1 << layer);
+        }else{
+            pd->urgent_layers &= ~((INT32U)1 << layer);
+        }
+        (void)OSMutexPost(&lcdLayersKey, OS_OPT_POST_NONE, &os_err);
+        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+        }
+    }else{
+    }
+}
+
+/*************************************************************************
+  lcdLayerModified() - Notes that a layer has changed            (Private)
+
+                       Must be called with lcdLayersKey held
+*************************************************************************/
+static void lcdLayerModified(LCD_DISP *pd, INT8U layer) {
+    OS_ERR os_err;
+
+    LCD_LAT_MARK(pd, layer);
+    if(pd->urgent_layers & ((INT32U)1 << layer)) {
+        pd->urgent_pending = TRUE;
+    }else{
+    }
+    if((OSTimeGet(&os_err) - pd->frame_tick) < pd->frame_ticks) {
+        pd->stats.dropped++;        // Would have been a frame of its own
+    }else if(pd->pending) {
+        pd->stats.merged++;         // Rides on the frame already queued
+    }else{
+    }
+    pd->pending = TRUE;
+}
+
+/*************************************************************************
+  lcdCellsWritten() - Updates owner after cnt cells of a row     (Private)
+                      of a layer have been written
+
+        A cell is visible if no higher visible layer has a character in
+        it. Visible cells take this layer as owner, or hand it back to
+        the layers below if the new character is transparent. Returns
+        TRUE if any cell was visible, in which case the layer is marked
+        modified and the caller must post the LCD task. Writes that are
+        completely covered are counted in pd->stats.occluded and do not
+        wake the task at all.
+
+                       Must be called with lcdLayersKey held
+*************************************************************************/
+static INT8U lcdCellsWritten(LCD_DISP *pd, INT8U layer, INT8U row, INT8U col, INT8U cnt) {
+    INT8U owner, visible;
+
+    visible = FALSE;
+    if(pd->layers[layer].hidden == 0) {
+        for(; (cnt != 0) && (col < pd->cols); cnt--, col++) {
+            owner = pd->owner[row][col];
+            if((owner == LCD_NO_OWNER) || (owner <= layer)) {
+                visible = TRUE;
+                LCD_DIRTY(pd, row, col);
+                if(pd->layers[layer].lcd_char[row][col] != LCD_CLEAR_BYTE) {
+                    pd->owner[row][col] = layer;
+                }else if(owner == layer) {
+                    pd->owner[row][col] = lcdOwnerBelow(pd, row, col, layer);
+                }else{
+                }
+            }else{ //covered by a higher layer
+            }
+        }
+    }else{
+    }
+    if(visible) {
+        lcdLayerModified(pd, layer);
+    }else{
+        pd->stats.occluded++;
+    }
+    return(visible);
+}
+
+/*************************************************************************
+  lcdOwnerBelow() - The top visible layer under layer with a     (Private)
+                    character at [row, col], or LCD_NO_OWNER
+*************************************************************************/
+static INT8U lcdOwnerBelow(LCD_DISP *pd, INT8U row, INT8U col, INT8U layer) {
+    while(layer != 0) {
+        layer--;
+        if((pd->layers[layer].hidden == 0)
+            && (pd->layers[layer].lcd_char[row][col] != LCD_CLEAR_BYTE)) {
+            return(layer);
+        }else{
+        }
+    }
+    return(LCD_NO_OWNER);
+}
+
+/*************************************************************************
+  lcdTopLayer() - The top visible layer, or LCD_NO_OWNER         (Private)
+*************************************************************************/
+static INT8U lcdTopLayer(LCD_DISP *pd) {
+    INT8U layer;
+
+    layer = LCD_NUM_LAYERS;
+    while(layer != 0) {
+        layer--;
+        if(pd->layers[layer].hidden == 0) {
+            return(layer);
+        }else{
+        }
+    }
+    return(LCD_NO_OWNER);
+}
+
+#if LCD_LATENCY_EN
+/********************************************************************
+** LcdLatencyGet(INT8U layer, LCD_LATENCY *lat)
+*
+*  FILENAME: LcdLayered.c
+*
+*  PARAMETERS: layer - The layer to read.
+*              lat - Destination for a copy of the statistics.
+*
+*  DESCRIPTION: Reads the update latency of a layer in core clock
+*               cycles, from the first LcdDisp/LcdCursor/LcdPrintf/
+*               LcdMarquee call that modified the layer to the last
+*               bus write of the frame that showed it. Later calls
+*               merged into the same frame are not counted separately.
+*               The average is sum / count.
+*
+*  RETURNS: TRUE if no error, FALSE otherwise
+********************************************************************/
+INT8U LcdLatencyGet(INT8U layer, LCD_LATENCY *lat){
+    CPU_SR_ALLOC();
+
+    if(!LCD_LAYER_VALID(layer)) {
+        return(FALSE);
+    }else{
+    }
+    CPU_CRITICAL_ENTER();
+    *lat = LCD_DISP_OF(layer)->latency[LCD_LAYER_OF(layer)];
+    CPU_CRITICAL_EXIT();
+    return(TRUE);
+}
+
+/********************************************************************
+** LcdLatencyReset(void)
+*
+*  FILENAME: LcdLayered.c
+*
+*  DESCRIPTION: Clears the latency statistics of every layer.
+*
+*  RETURNS: None
+********************************************************************/
+void LcdLatencyReset(void){
+    INT8U disp, layer, bin;
+    LCD_DISP *pd;
+    CPU_SR_ALLOC();
+
+    CPU_CRITICAL_ENTER();
+    for(disp = 0; disp < LCD_NUM_DISPS; disp++) {
+        pd = &lcdDisps[disp];
+        for(layer = 0; layer < LCD_NUM_LAYERS; layer++) {
+            pd->latency[layer].count = 0;
+            pd->latency[layer].min = 0xFFFFFFFFu;
+            pd->latency[layer].max = 0;
+            pd->latency[layer].sum = 0;
+            pd->latency[layer].flatten_max = 0;
+            pd->latency[layer].flatten_sum = 0;
+            for(bin = 0; bin < LCD_LAT_BINS; bin++) {
+                pd->latency[layer].hist[bin] = 0;
+            }
+        }
+    }
+    CPU_CRITICAL_EXIT();
+}
+
+/*************************************************************************
+  lcdLatMark() - Timestamps the first change to a layer since    (Private)
+                 the last flatten
+
+                 Must be called with lcdLayersKey held
+*************************************************************************/
+static void lcdLatMark(LCD_DISP *pd, INT8U layer) {
+    if(pd->lat_pending[layer] == FALSE) {
+        pd->lat_call_ts[layer] = CYC_CNT_GET();
+        pd->lat_pending[layer] = TRUE;
+    }else{
+    }
+}
+
+/*************************************************************************
+  lcdLatFlatten() - Moves pending changes into the frame         (Private)
+
+                    Must be called with lcdLayersKey held
+*************************************************************************/
+static void lcdLatFlatten(LCD_DISP *pd) {
+    INT8U layer;
+
+    pd->lat_flatten_ts = CYC_CNT_GET();
+    for(layer = 0; layer < LCD_NUM_LAYERS; layer++) {
+        if(pd->lat_pending[layer]) {
+            pd->lat_pending[layer] = FALSE;
+            pd->lat_in_frame[layer] = TRUE;
+            pd->lat_frame_call_ts[layer] = pd->lat_call_ts[layer];
+        }else{
+        }
+    }
+}
+
+/*************************************************************************
+  lcdLatFrameEnd() - Records latency for the layers in the frame (Private)
+
+        Called after the last lcdWrite() of the frame. The histogram
+        bin is floor(log2(cycles)), the last bin also takes anything
+        longer.
+*************************************************************************/
+static void lcdLatFrameEnd(LCD_DISP *pd) {
+    INT8U layer, bin;
+    INT32U now, lat;
+    LCD_LATENCY *pl;
+    CPU_SR_ALLOC();
+
+    now = CYC_CNT_GET();
+    for(layer = 0; layer < LCD_NUM_LAYERS; layer++) {
+        if(pd->lat_in_frame[layer]) {
+            pd->lat_in_frame[layer] = FALSE;
+            lat = now - pd->lat_frame_call_ts[layer];
+            bin = (lat == 0) ? 0 : (INT8U)(31 - __CLZ(lat));
+            if(bin >= LCD_LAT_BINS) {
+                bin = LCD_LAT_BINS - 1;
+            }else{
+            }
+            pl = &pd->latency[layer];
+            CPU_CRITICAL_ENTER();
+            pl->count++;
+            pl->sum += lat;
+            if(lat < pl->min) {
+                pl->min = lat;
+            }else{
+            }
+            if(lat > pl->max) {
+                pl->max = lat;
+            }else{
+            }
+            lat = pd->lat_flatten_ts - pd->lat_frame_call_ts[layer];
+            pl->flatten_sum += lat;
+            if(lat > pl->flatten_max) {
+                pl->flatten_max = lat;
+            }else{
+            }
+            pl->hist[bin]++;
+            CPU_CRITICAL_EXIT();
+        }else{
+        }
     }
 }
+#endif
@@ -12,20 +12,103 @@
 * 01/22/2015, Added to git repo, general clean up. TDM
 * 02/03/2016, More cleanup. TDM
 * 01/13/2017 Changed name to LcdLayered (was LayeredLcd), fixed bugs. TDM
+* 10/18/2026 Four layers, one per screen, added LcdSwapLayers()
 *************************************************************************/
 
 #ifndef LCD_DEF
 #define LCD_DEF
+#include "LcdBus.h"
 /*************************************************************************
 * LCD Layers - Define all layer values here                              *
 *              Range from 0 to (LCD_NUM_LAYERS - 1)                      *
 *              Arranged from largest number on top, down to 0 on bottom. *
 *************************************************************************/
-#define LCD_NUM_LAYERS 2
+#define LCD_NUM_LAYERS 4
 
-#define TIMESETLAYER 1
+/*************************************************************************
+* LCD Displays - Displays that can be driven, display 0 is set up by
+*                LcdInit() and the rest by LcdDispAdd(). Every display
+*                has LCD_NUM_LAYERS layers, a layer of display d is
+*                passed to the layer functions as LCD_LAYER(d, layer).
+*                Display 0's layers are just 0 to (LCD_NUM_LAYERS - 1).
+*************************************************************************/
+#ifndef LCD_NUM_DISPS
+#define LCD_NUM_DISPS 1
+#endif
+
+#define LCD_LAYER(disp, layer) ((INT8U)(((disp) * LCD_NUM_LAYERS) + (layer)))
+
+#define TIMESETLAYER 3        // Time set overlay, over the clock screen
+#define STATSLAYER 2          // One layer per screen, see Screen.h
+#define SWATCHLAYER 1
 #define TIMEDISPLAYER 0
 
+/*************************************************************************
+* LCD Frame Rate - Default cap on frames per second, see LcdFrameRateSet()
+*************************************************************************/
+#ifndef LCD_FRAME_RATE_HZ
+#define LCD_FRAME_RATE_HZ 50u
+#endif
+
+/*************************************************************************
+* LCD Scrub - When the LCD task has been idle for LCD_SCRUB_MS, it
+*             rewrites the next LCD_SCRUB_CELLS glass cells from its
+*             DDRAM mirror, round robin. A module glitch is then
+*             repaired within one pass without a full LcdInit(). If the
+*             bus driver can read DDRAM, cells are read first and only
+*             those that differ are rewritten.
+*************************************************************************/
+#ifndef LCD_SCRUB_EN
+#define LCD_SCRUB_EN 1
+#endif
+#ifndef LCD_SCRUB_MS
+#define LCD_SCRUB_MS 100u
+#endif
+#ifndef LCD_SCRUB_CELLS
+#define LCD_SCRUB_CELLS 2u      // Cells per slice, under 200us of bus time
+#endif
+
+/*************************************************************************
+* LCD Latency - Set LCD_LATENCY_EN to 1 to timestamp layer updates with
+*               the DWT cycle counter. When 0 the hooks compile to
+*               nothing.
+*************************************************************************/
+#ifndef LCD_LATENCY_EN
+#define LCD_LATENCY_EN 0
+#endif
+
+#define LCD_LAT_BINS 28         // log2 histogram, 2^27 cycles is 0.75s
+
+typedef struct {
+    INT32U count;               // Updates measured
+    INT32U min;                 // Call to last bus write, cycles
+    INT32U max;
+    INT64U sum;
+    INT32U flatten_max;         // Call to start of flatten, cycles
+    INT64U flatten_sum;
+    INT32U hist[LCD_LAT_BINS];  // hist[n] counts 2^n <= latency < 2^(n+1)
+} LCD_LATENCY;
+
+/*************************************************************************
+* LCD Statistics - Bus transactions are lcdWrite() calls, each one an
+*                  instruction or a character.
+*************************************************************************/
+typedef struct {
+    INT32U frames;          // Frames written to the LCD
+    INT32U writes;          // Bus transactions, all frames
+    INT16U last_writes;     // Bus transactions in the last frame
+    INT32U shifts;          // Frames that used a display shift
+    INT32U scroll_frames;   // Frames following a marquee step
+    INT32U scroll_writes;   // Bus transactions in those frames
+    INT32U dropped;         // Changes held back by the rate cap and merged
+    INT32U merged;          // Changes already queued when a frame started
+    INT32U urgent;          // Frames released early by an urgent layer
+    INT32U occluded;        // Layer writes completely covered, no frame
+    INT32U scrub_cells;     // Cells rewritten, or read back, by the scrub
+    INT32U scrub_passes;    // Complete passes over the glass
+    INT32U scrub_fixes;     // Cells read back wrong and corrected
+} LCD_STATS;
+
 /*************************************************************************
   Public Functions
 *************************************************************************/
@@ -40,6 +123,8 @@ void LcdDispString(INT8U row,INT8U col,INT8U layer,
 void LcdDispTime(INT8U row,INT8U col,INT8U layer,
                         INT8U hrs,INT8U mins,INT8U secs);
                         
+INT8U LcdPrintf(INT8U row,INT8U col,INT8U layer,const INT8C *fmt, ...);
+
 void LcdDispByte(INT8U row,INT8U col,INT8U layer,INT8U byte);
                         
 void LcdDispDecByte(INT8U row,INT8U col,INT8U layer,
@@ -53,5 +138,17 @@ void LcdCursorDispMode(INT8U on, INT8U blink);
 void LcdHideLayer(INT8U layer);
 void LcdShowLayer(INT8U layer);
 void LcdToggleLayer(INT8U layer);
+void LcdSwapLayers(INT8U hide, INT8U show);
+INT8U LcdMarqueeStart(INT8U row, INT8U layer, const INT8C *text);
+void LcdMarqueeStep(INT8U layer);
+void LcdMarqueeStop(INT8U layer);
+INT8U LcdDispAdd(const LCD_BUS_DRV *bus, INT8U rows, INT8U cols, INT8U prio);
+INT8U LcdStatsGet(INT8U disp, LCD_STATS *stats);
+INT8U LcdFrameRateSet(INT8U disp, INT16U hz);
+void LcdLayerUrgent(INT8U layer, INT8U urgent);
+#if LCD_LATENCY_EN
+INT8U LcdLatencyGet(INT8U layer, LCD_LATENCY *lat);
+void LcdLatencyReset(void);
+#endif
 #endif
 
@@ -0,0 +1,307 @@
+/*************************************************************************
+* StkMon.c - Stack high-water analyser, see StkMon.h
+*
+*               Every stack is zero filled before it is used, the task
+*               stacks by OS_OPT_TASK_STK_CLR and the ISR stack by OSInit(),
+*               so the high-water mark is the part of a stack that is no
+*               longer zero. Stacks are scanned when they are read, nothing
+*               is sampled while the app runs. A word pushed as zero at the
+*               very edge is missed, the margin covers it.
+*
+* 10/18/2026 Initial version
+*************************************************************************
+* Header Files - Dependencies
+*************************************************************************/
+#include "MCUType.h"
+#include "app_cfg.h"
+#include "os.h"
+#include "StkMon.h"
+
+#if STK_MON_EN
+
+#if (OS_CFG_STAT_TASK_STK_CHK_EN != DEF_ENABLED)
+#error "StkMon needs OS_CFG_STAT_TASK_STK_CHK_EN for OSTaskStkChk()"
+#endif
+
+#if (OS_CFG_ISR_STK_SIZE > 0u)
+#define STK_MON_ISR 1u
+#else
+#define STK_MON_ISR 0u
+#endif
+
+#define STK_MON_NONE 0u         /* stkMonScan() results */
+#define STK_MON_APP  1u         /* Size is in app_cfg.h */
+#define STK_MON_OS   2u         /* Size is in os_cfg_app.h */
+
+#define STK_MON_NAME_COLS 30u
+
+typedef struct{
+    OS_TCB *tcb;
+    const INT8C *cfg;
+    INT8U os;                   /* Kernel task */
+}STK_MON_TASK;
+
+/*************************************************************************
+  Global Variables
+*************************************************************************/
+static STK_MON_TASK stkMonTasks[STK_MON_MAX_TASKS];
+static INT8U stkMonNumTasks;
+
+/*************************************************************************
+  Private Functions
+*************************************************************************/
+static void stkMonTaskAdd(OS_TCB *p_tcb, const INT8C *cfg, INT8U os);
+static INT8U stkMonScan(INT8U stk, STK_MON_INFO *info);
+static INT32U stkMonRec(INT32U used, INT32U min);
+static void stkMonPuts(void (*Putc)(INT8C c), const INT8C *str, INT8U width);
+static void stkMonPutNum(void (*Putc)(INT8C c), INT32U num, INT8U width);
+
+/*************************************************************************
+  StkMonInit() - Adds the kernel task stacks                     (Public)
+
+        Call after OSInit() and before the first STK_MON_ADD(). The ISR
+        stack is always scanned, it needs no entry.
+*************************************************************************/
+void StkMonInit(void){
+
+    stkMonNumTasks = 0;
+#if (OS_CFG_TASK_IDLE_EN == DEF_ENABLED)
+    stkMonTaskAdd(&OSIdleTaskTCB, "OS_CFG_IDLE_TASK_STK_SIZE", TRUE);
+#endif
+#if (OS_CFG_TASK_TICK_EN == DEF_ENABLED)
+    stkMonTaskAdd(&OSTickTaskTCB, "OS_CFG_TICK_TASK_STK_SIZE", TRUE);
+#endif
+#if (OS_CFG_STAT_TASK_EN == DEF_ENABLED)
+    stkMonTaskAdd(&OSStatTaskTCB, "OS_CFG_STAT_TASK_STK_SIZE", TRUE);
+#endif
+#if (OS_CFG_TMR_EN == DEF_ENABLED)
+    stkMonTaskAdd(&OSTmrTaskTCB, "OS_CFG_TMR_TASK_STK_SIZE", TRUE);
+#endif
+}
+
+/*************************************************************************
+  StkMonAdd() - Adds an app task, use STK_MON_ADD()              (Public)
+*************************************************************************/
+void StkMonAdd(OS_TCB *p_tcb, const INT8C *cfg){
+    stkMonTaskAdd(p_tcb, cfg, FALSE);
+}
+
+/*************************************************************************
+  StkMonGet() - Scans the stacks                                 (Public)
+*************************************************************************/
+INT8U StkMonGet(STK_MON_INFO *info, INT8U max){
+    INT8U stk, num = 0;
+
+    for(stk = 0; (stk < (stkMonNumTasks + STK_MON_ISR)) && (num < max); stk++){
+        if(stkMonScan(stk, &info[num]) != STK_MON_NONE){
+            num++;
+        }else{
+        }
+    }
+    return(num);
+}
+
+/*************************************************************************
+  StkMonLeastFree() - Least free words on any stack              (Public)
+
+        Scans one stack at a time, so it is cheap on the caller's stack.
+*************************************************************************/
+INT32U StkMonLeastFree(void){
+    STK_MON_INFO info;
+    INT8U stk;
+    INT32U least = 0xFFFFFFFFu;
+
+    for(stk = 0; stk < (stkMonNumTasks + STK_MON_ISR); stk++){
+        if((stkMonScan(stk, &info) != STK_MON_NONE) &&
+           ((info.size - info.used) < least)){
+            least = info.size - info.used;
+        }else{
+        }
+    }
+    return(least);
+}
+
+/*************************************************************************
+  StkMonCfgWrite() - Writes the stack report and sizes           (Public)
+
+        A comment block with every stack's size, high-water mark and
+        recommended size, and the RAM they take now and at the
+        recommended sizes. A full stack may have overflowed, its Rec
+        is a floor. Then the app_cfg.h #defines at the
+        recommended sizes, and the os_cfg_app.h sizes commented out so
+        the text can be pasted over the app_cfg.h stack section as is.
+*************************************************************************/
+void StkMonCfgWrite(void (*Putc)(INT8C c)){
+    STK_MON_INFO info;
+    INT8U stk, kind;
+    INT32U size_bytes = 0;
+    INT32U rec_bytes = 0;
+
+    stkMonPuts(Putc, "/* Stack sizes from StkMon in CPU_STK words, Rec is the\n", 0);
+    stkMonPuts(Putc, " * high-water mark + ", 0);
+    stkMonPutNum(Putc, STK_MON_MARGIN_PCT, 0);
+    stkMonPuts(Putc, "%, at least ", 0);
+    stkMonPutNum(Putc, STK_MON_MARGIN_MIN, 0);
+    stkMonPuts(Putc, " words more\n *\n", 0);
+    stkMonPuts(Putc, " * Stack size", STK_MON_NAME_COLS + 3u);
+    stkMonPuts(Putc, "  Size  Used   Rec\n", 0);
+    for(stk = 0; stk < (stkMonNumTasks + STK_MON_ISR); stk++){
+        if(stkMonScan(stk, &info) != STK_MON_NONE){
+            stkMonPuts(Putc, " * ", 0);
+            stkMonPuts(Putc, info.cfg, STK_MON_NAME_COLS);
+            stkMonPutNum(Putc, info.size, 6u);
+            stkMonPutNum(Putc, info.used, 6u);
+            stkMonPutNum(Putc, info.rec, 6u);
+            stkMonPuts(Putc, (info.used < info.size) ? "\n" : "  Full, overflowed?\n", 0);
+            size_bytes += info.size * sizeof(CPU_STK);
+            rec_bytes += info.rec * sizeof(CPU_STK);
+        }else{
+        }
+    }
+    stkMonPuts(Putc, " * RAM bytes", STK_MON_NAME_COLS + 3u);
+    stkMonPutNum(Putc, size_bytes, 6u);
+    stkMonPuts(Putc, "", 6u);
+    stkMonPutNum(Putc, rec_bytes, 6u);
+    if(rec_bytes <= size_bytes){
+        stkMonPuts(Putc, "\n * Saves", STK_MON_NAME_COLS + 16u);
+        stkMonPutNum(Putc, size_bytes - rec_bytes, 6u);
+    }else{
+        stkMonPuts(Putc, "\n * Costs", STK_MON_NAME_COLS + 16u);
+        stkMonPutNum(Putc, rec_bytes - size_bytes, 6u);
+    }
+    stkMonPuts(Putc, "\n */\n\n", 0);
+
+    for(kind = STK_MON_APP; kind <= STK_MON_OS; kind++){
+        if(kind == STK_MON_OS){
+            stkMonPuts(Putc, "\n/* os_cfg_app.h */\n", 0);
+        }else{
+        }
+        for(stk = 0; stk < (stkMonNumTasks + STK_MON_ISR); stk++){
+            if(stkMonScan(stk, &info) == kind){
+                stkMonPuts(Putc, (kind == STK_MON_OS) ? "/* #define " : "#define ", 0);
+                stkMonPuts(Putc, info.cfg, 0);
+                stkMonPuts(Putc, " ", 0);
+                stkMonPutNum(Putc, info.rec, 0);
+                stkMonPuts(Putc, (kind == STK_MON_OS) ? "u */\n" : "u\n", 0);
+            }else{
+            }
+        }
+    }
+}
+
+/*************************************************************************
+  stkMonTaskAdd() - Adds a task to the table                    (Private)
+*************************************************************************/
+static void stkMonTaskAdd(OS_TCB *p_tcb, const INT8C *cfg, INT8U os){
+
+    while(stkMonNumTasks >= STK_MON_MAX_TASKS){}    /* Error Trap */
+
+    stkMonTasks[stkMonNumTasks].tcb = p_tcb;
+    stkMonTasks[stkMonNumTasks].cfg = cfg;
+    stkMonTasks[stkMonNumTasks].os = os;
+    stkMonNumTasks++;
+}
+
+/*************************************************************************
+  stkMonScan() - High-water mark of one stack                   (Private)
+
+        stk is an index in stkMonTasks[], one past the end for the ISR
+        stack. Returns STK_MON_NONE for a task that was deleted or made
+        without OS_OPT_TASK_STK_CHK.
+*************************************************************************/
+static INT8U stkMonScan(INT8U stk, STK_MON_INFO *info){
+    OS_ERR os_err;
+    CPU_STK_SIZE stk_free, used;
+#if (OS_CFG_ISR_STK_SIZE > 0u)
+    const CPU_STK *p_stk;
+#endif
+
+    if(stk < stkMonNumTasks){
+        OSTaskStkChk(stkMonTasks[stk].tcb, &stk_free, &used, &os_err);
+        if(os_err != OS_ERR_NONE){
+            return(STK_MON_NONE);
+        }else{
+        }
+        info->cfg = stkMonTasks[stk].cfg;
+        info->size = (INT32U)stkMonTasks[stk].tcb->StkSize;
+        info->used = (INT32U)used;
+        info->rec = stkMonRec(info->used, OS_CFG_STK_SIZE_MIN);
+        return((stkMonTasks[stk].os != FALSE) ? STK_MON_OS : STK_MON_APP);
+    }else{
+    }
+
+#if (OS_CFG_ISR_STK_SIZE > 0u)
+    stk_free = 0;                           /* Grows down, count up from the base */
+    p_stk = OSCfg_ISRStkBasePtr;
+    while((stk_free < OSCfg_ISRStkSize) && (*p_stk == 0u)){
+        p_stk++;
+        stk_free++;
+    }
+    info->cfg = "OS_CFG_ISR_STK_SIZE";
+    info->size = (INT32U)OSCfg_ISRStkSize;
+    info->used = (INT32U)(OSCfg_ISRStkSize - stk_free);
+    info->rec = stkMonRec(info->used, 0);
+    return(STK_MON_OS);
+#else
+    return(STK_MON_NONE);
+#endif
+}
+
+/*************************************************************************
+  stkMonRec() - Recommended size for a high-water mark          (Private)
+*************************************************************************/
+static INT32U stkMonRec(INT32U used, INT32U min){
+    INT32U rec = used + ((used * STK_MON_MARGIN_PCT) / 100u);
+
+    if(rec < (used + STK_MON_MARGIN_MIN)){
+        rec = used + STK_MON_MARGIN_MIN;
+    }else{
+    }
+    rec = (rec + (STK_MON_ROUND - 1u)) & ~(STK_MON_ROUND - 1u);
+    if(rec < min){
+        rec = min;
+    }else{
+    }
+    return(rec);
+}
+
+/*************************************************************************
+  stkMonPuts() - Writes a string, padded to width               (Private)
+*************************************************************************/
+static void stkMonPuts(void (*Putc)(INT8C c), const INT8C *str, INT8U width){
+    INT8U cols = 0;
+
+    while(*str != '\0'){
+        Putc(*str);
+        str++;
+        cols++;
+    }
+    while(cols < width){
+        Putc(' ');
+        cols++;
+    }
+}
+
+/*************************************************************************
+  stkMonPutNum() - Writes a number, right justified to width    (Private)
+*************************************************************************/
+static void stkMonPutNum(void (*Putc)(INT8C c), INT32U num, INT8U width){
+    INT8C digits[10];
+    INT8U ndig = 0;
+
+    do{
+        digits[ndig] = (INT8C)('0' + (num % 10u));
+        num /= 10u;
+        ndig++;
+    }while(num != 0u);
+    while(width > ndig){
+        Putc(' ');
+        width--;
+    }
+    while(ndig > 0){
+        ndig--;
+        Putc(digits[ndig]);
+    }
+}
+
+#endif
@@ -0,0 +1,70 @@
+/*************************************************************************
+* StkMon.h - Stack high-water analyser
+*
+*            Tracks the high-water mark of every task stack and the ISR
+*            stack, and recommends a size for each: the high-water mark
+*            plus STK_MON_MARGIN_PCT, at least STK_MON_MARGIN_MIN words,
+*            rounded up to STK_MON_ROUND words. Task sizes are never
+*            below OS_CFG_STK_SIZE_MIN, OSTaskCreate() rejects less.
+*
+*            StkMonInit() picks up the kernel tasks and the ISR stack,
+*            each module adds its task with STK_MON_ADD() right after
+*            OSTaskCreate(), naming the app_cfg.h size it was created
+*            with. Run the app through everything it does, then read the
+*            marks with StkMonGet() or have StkMonCfgWrite() write an
+*            app_cfg.h stack section with a before/after RAM footprint.
+*
+*            The marks are only as good as the run, a path not taken is
+*            not counted. Set STK_MON_EN to 0 and STK_MON_ADD() compiles
+*            to nothing.
+*
+* 10/18/2026 Initial version
+*************************************************************************/
+#ifndef STK_MON_DEF
+#define STK_MON_DEF
+
+#ifndef STK_MON_EN
+#define STK_MON_EN 1
+#endif
+
+#define STK_MON_MAX_TASKS   12u
+#define STK_MON_MARGIN_PCT  25u     /* Margin on the high-water mark      */
+#define STK_MON_MARGIN_MIN  16u     /* Words, an FPU exception frame is 26 */
+                                    /* but lazy stacking rarely needs it   */
+#define STK_MON_ROUND       8u      /* Words, a power of 2                */
+
+#if STK_MON_EN
+#define STK_MON_ADD(p_tcb, cfg) StkMonAdd((p_tcb), #cfg)
+#else
+#define STK_MON_ADD(p_tcb, cfg)
+#endif
+
+typedef struct{
+    const INT8C *cfg;           /* Size #define it was created with, names  */
+                                /* the stack, task names need OS_CFG_DBG_EN */
+    INT32U size;                /* CPU_STK words                            */
+    INT32U used;                /* High-water mark, words                   */
+    INT32U rec;                 /* Recommended size, words                  */
+}STK_MON_INFO;
+
+#if STK_MON_EN
+void StkMonInit(void);          /* After OSInit(), adds the kernel stacks */
+
+void StkMonAdd(OS_TCB *p_tcb, const INT8C *cfg);
+                                /* Use STK_MON_ADD(). The task must have */
+                                /* OS_OPT_TASK_STK_CHK|OS_OPT_TASK_STK_CLR */
+
+INT8U StkMonGet(STK_MON_INFO *info, INT8U max);
+                                /* Scans the stacks, tasks in the order  */
+                                /* added then the ISR stack. Returns the */
+                                /* number copied. Task level only        */
+
+INT32U StkMonLeastFree(void);   /* Least free words on any stack         */
+
+void StkMonCfgWrite(void (*Putc)(INT8C c));
+                                /* Writes the report and the app_cfg.h   */
+                                /* stack sizes as C text, one character  */
+                                /* at a time. Task level only            */
+#endif
+
+#endif
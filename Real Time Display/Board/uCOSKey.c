@@ -1,11 +1,41 @@
 /********************************************************************
 * uCOSKey.c - A keypad module that runs under MicroC/OS for a 4x4 
 * matrix keypad.
-* This version allows for multiple column keys to be pressed and 
-* mapped to a different code by changing ColTable[] in keyScan().
-* Multiple rows can not be resolved. The topmost button will be used.
+* Each scan reads all 16 keys into a bitmap, so keys held together
+* (chords) are reported key by key. The keypad has no diodes, so three
+* keys on the corners of a rectangle make the fourth look pressed.
+* Scans with that pattern are counted as ghosts and ignored.
+* Every key is debounced at once by vertical counters, a key changes
+* after KEY_DEBOUNCE_SAMPLES scans in a row disagree with it.
 * The keyCodeTable[] is currently set to generate ASCII codes.
 *
+* With KEY_HW_FILTER_MS the port's glitch filter is on while the task
+* waits, so the column interrupt only comes once a column has been low
+* for the whole filter width. Presses found by the scan that follows
+* skip the software count. Releases and keys pressed while another is
+* down are still counted in software, the filter is off while scanning
+* because it would delay every row change by its width.
+*
+* The scan period follows the keypad's activity, from the
+* KEY_RATE_TABLE policy: fast while a key is changing, slower while
+* keys are held still and slowest once all keys have been up for
+* KEY_RATE_QUIET_MS.
+*
+* With KEY_IRQ_EN the slowest rate can be no scans at all. When all
+* keys are up the task drives every row low and sleeps until a column
+* pin change interrupt, so an idle keypad costs no CPU time.
+*
+* Port access is done by a port driver, see KeyPort.h
+*
+* Verified presses and their releases are queued as timestamped
+* KEY_EVENTs, so keys pressed faster than the application reads them
+* are kept in order up to KEY_QUEUE_SIZE.
+*
+* A held key can auto-repeat and send a long-press KEY_HOLD event,
+* timed per key by keyTiming[]. The times are measured between scan
+* timestamps, so they need no timer and cost nothing while no key is
+* down. They have the resolution of the scan period.
+*
 * Requires the following be defined in app_cfg.h:
 *                   APP_CFG_KEY_TASK_PRIO
 *                   APP_CFG_KEY_TASK_STK_SIZE
@@ -14,6 +44,16 @@
 * 01/14/2013 TDM Modified for K70 custom tower board.
 * 02/12/2013 TDM Modified to run under MicroC/OS-III
 * 01/18/2018 Changed to replace includes.h TDM
+* 10/18/2026 Port access moved to KeyPort.h drivers, added KEY_IRQ_EN
+* 10/18/2026 Replaced the single byte keyBuffer with an event queue
+* 10/18/2026 Added auto-repeat and long-press events
+* 10/18/2026 Full matrix bitmap scan, chords and ghost detection
+* 10/18/2026 Vertical counter debouncing
+* 10/18/2026 Hardware column filter option, KEY_HW_FILTER_MS
+* 10/18/2026 Settle time per scan in KEY_STATS
+* 10/18/2026 Scan rate set by activity from KEY_RATE_TABLE
+* 10/18/2026 Key task stack tracked by StkMon.h
+* 10/18/2026 KEY_RATE_TABLE built from checked per-level periods
 *********************************************************************
 * Header Files - Dependencies
 ********************************************************************/
@@ -22,36 +62,90 @@
 #include "os.h"
 #include "uCOSKey.h"
 #include "k65TWR_GPIO.h"
+#include "KeyPort.h"
+#include "StkMon.h"
 /********************************************************************
 * Module Defines
-* This version is designed for the custom LCD/Keypad board, which
-* has the following mapping:
-*  COL1->PTC3, COL2->PTC4, COL3->PTC5, COL4->PTC6
-*  ROW1->PTC7, ROW2->PTC8, ROW3->PTC9, ROW4->PTC10
-********************************************************************/
-typedef enum{KEY_OFF,KEY_EDGE,KEY_VERF} KEYSTATES;
-#define KEY_PORT_OUT   GPIOC_PDOR
-#define KEY_PORT_DIR   GPIOC_PDDR
-#define KEY_PORT_IN	   GPIOC_PDIR
-#define COLS_MASK 0x00000078
-#define ROWS_MASK 0x00000780
+* This version is designed for the custom LCD/Keypad board, see
+* KeyPortK65.c for the pin mapping.
+********************************************************************/
+#define KEY_NONE 0xFFu          /* No key held */
+#define KEY_VC_BITS 3           /* Vertical counter bits, up to 7 samples */
+#if (KEY_DEBOUNCE_SAMPLES < 1) || (KEY_DEBOUNCE_SAMPLES >= (1 << KEY_VC_BITS))
+#error "KEY_DEBOUNCE_SAMPLES must be 1 to 7"
+#endif
+#if (KEY_HW_FILTER_MS > KEY_FILTER_MAX) || ((KEY_HW_FILTER_MS != 0) && !KEY_IRQ_EN)
+#error "KEY_HW_FILTER_MS must be 0 to 31 and needs KEY_IRQ_EN"
+#endif
+#if (KEY_RATE_ACTIVE_MS == 0) || (KEY_RATE_HELD_MS == 0) || (KEY_RATE_UP_MS == 0) \
+    || ((KEY_RATE_SLEEP_MS == 0) && !KEY_IRQ_EN)
+#error "KEY_RATE_..._MS must not be 0, except KEY_RATE_SLEEP_MS with KEY_IRQ_EN"
+#endif
+#define KEY_BIT(key) ((INT16U)(1u << (key)))
+#define KEY_MS_TO_TICKS(ms) ((INT16U)((((INT32U)(ms) * OS_CFG_TICK_RATE_HZ) + 999u) / 1000u))
+#define KEY_REPEAT_DLY  KEY_MS_TO_TICKS(500)   /* Default timing, digits */
+#define KEY_REPEAT_PER  KEY_MS_TO_TICKS(150)
+#define KEY_HOLD_TIME   KEY_MS_TO_TICKS(1000)  /* Default, every key */
 #define DC1 (INT8U)0x11     /*ASCII control code for the A button */
 #define DC2 (INT8U)0x12     /*ASCII control code for the B button */
 #define DC3 (INT8U)0x13     /*ASCII control code for the C button */
 #define DC4 (INT8U)0x14     /*ASCII control code for the D button */
 typedef struct{
-    INT8U buffer;
-    OS_SEM flag;
-}KEY_BUFFER;
+    KEY_EVENT events[KEY_QUEUE_SIZE];
+    INT8U head;                     /* Oldest event */
+    INT8U count;                    /* Events queued */
+    OS_SEM flag;                    /* Counts events queued */
+    KEY_STATS stats;
+}KEY_QUEUE;
+typedef struct{                     /* Ticks, from the press */
+    INT16U repeat_dly;              /* First repeat */
+    INT16U repeat_per;              /* Between repeats, 0 for no repeat */
+    INT16U hold;                    /* KEY_HOLD, 0 for none */
+}KEY_TIMING;
 /********************************************************************
 * Private Resources
 ********************************************************************/
-static INT8U keyScan(void);         /* Makes a single keypad scan  */
+static INT16U keyScan(void);        /* Makes a single keypad scan  */
+static INT8U keyGhost(INT16U keys); /* Checks a scan for ghosting  */
+static INT16U keyDebounce(INT16U sample);  /* Debounces every key */
+static INT16U keyDebounceSet(INT16U keys); /* Takes keys as debounced */
+static INT8U keyRateLevel(INT16U pending, INT16U keys, INT32U quiet);
+static const INT16U keyRateTable[KEY_RATE_LEVELS] = KEY_RATE_TABLE;  /* ms */
 static const INT8U keyCodeTable[16] =
    {'1','2','3',DC1,'4','5','6',DC2,'7','8','9',DC3,'*','0','#',DC4};
-static void keyDly(void);  /* Added for GPIO to settle before read */
 static void keyTask(void *p_arg);
-static KEY_BUFFER keyBuffer;
+static INT8U keyPost(INT8U code, INT8U type, INT16U keys, INT32U ts);
+/* Auto-repeat and long-press timing, in keyCodeTable[] order */
+static KEY_TIMING keyTiming[16] = {
+    {KEY_REPEAT_DLY,KEY_REPEAT_PER,KEY_HOLD_TIME},  /* 1 */
+    {KEY_REPEAT_DLY,KEY_REPEAT_PER,KEY_HOLD_TIME},  /* 2 */
+    {KEY_REPEAT_DLY,KEY_REPEAT_PER,KEY_HOLD_TIME},  /* 3 */
+    {0,0,KEY_HOLD_TIME},                            /* A */
+    {KEY_REPEAT_DLY,KEY_REPEAT_PER,KEY_HOLD_TIME},  /* 4 */
+    {KEY_REPEAT_DLY,KEY_REPEAT_PER,KEY_HOLD_TIME},  /* 5 */
+    {KEY_REPEAT_DLY,KEY_REPEAT_PER,KEY_HOLD_TIME},  /* 6 */
+    {0,0,KEY_HOLD_TIME},                            /* B */
+    {KEY_REPEAT_DLY,KEY_REPEAT_PER,KEY_HOLD_TIME},  /* 7 */
+    {KEY_REPEAT_DLY,KEY_REPEAT_PER,KEY_HOLD_TIME},  /* 8 */
+    {KEY_REPEAT_DLY,KEY_REPEAT_PER,KEY_HOLD_TIME},  /* 9 */
+    {0,0,KEY_HOLD_TIME},                            /* C */
+    {0,0,KEY_HOLD_TIME},                            /* * */
+    {KEY_REPEAT_DLY,KEY_REPEAT_PER,KEY_HOLD_TIME},  /* 0 */
+    {0,0,KEY_HOLD_TIME},                            /* # */
+    {0,0,KEY_HOLD_TIME}};                           /* D */
+#if KEY_IRQ_EN
+static INT8U keyIdle(void);         /* Sleeps until a key goes down */
+#endif
+static KEY_QUEUE keyQueue;
+static INT16U keyVc[KEY_VC_BITS];   /* Vertical counters, bit plane per bit */
+static INT16U keyDebounced;         /* Debounced keys down */
+
+// Port driver the keypad is attached to, see KeyPort.h
+#if KEY_PORT_VIRTUAL_EN
+static const KEY_PORT_DRV *const keyPort = &KeyPortVirtual;
+#else
+static const KEY_PORT_DRV *const keyPort = &KeyPortK65;
+#endif
 /**********************************************************************************
 * Allocate task control blocks
 **********************************************************************************/
@@ -62,13 +156,80 @@ static OS_TCB keyTaskTCB;
 static CPU_STK keyTaskStk[APP_CFG_KEY_TASK_STK_SIZE];
 
 /********************************************************************
-* KeyPend() - A function to provide access to the key buffer via a
+* KeyPend() - A function to provide access to the key queue via a
 *             semaphore.
+*           - Returns the code of the next key press or auto-repeat,
+*             release and hold events are read and dropped. The
+*             timeout starts again after each dropped event.
+*           - Returns zero if *os_err is not OS_ERR_NONE.
 *    - Public
 ********************************************************************/
 INT8U KeyPend(INT16U tout, OS_ERR *os_err){
-    OSSemPend(&(keyBuffer.flag),tout, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, os_err);
-    return(keyBuffer.buffer);
+    KEY_EVENT event;
+
+    do{
+        KeyPendEvent(&event, tout, os_err);
+    }while((*os_err == OS_ERR_NONE) && (event.type != KEY_PRESS)
+          && (event.type != KEY_REPEAT));
+    return((*os_err == OS_ERR_NONE) ? event.code : 0);
+}
+
+/********************************************************************
+* KeyPendEvent() - Waits for the next key event.
+*                - *event is only written if *os_err is OS_ERR_NONE.
+*                  Error codes are identical to a semaphore.
+*    - Public
+********************************************************************/
+void KeyPendEvent(KEY_EVENT *event, INT16U tout, OS_ERR *os_err){
+    CPU_SR_ALLOC();
+
+    (void)OSSemPend(&(keyQueue.flag),tout, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, os_err);
+    if(*os_err == OS_ERR_NONE){
+        CPU_CRITICAL_ENTER();
+        *event = keyQueue.events[keyQueue.head];
+        keyQueue.head = (INT8U)((keyQueue.head + 1) % KEY_QUEUE_SIZE);
+        keyQueue.count--;
+        CPU_CRITICAL_EXIT();
+    }else{
+    }
+}
+
+/********************************************************************
+* KeyStatsGet() - Reads the key queue counters.
+*    - Public
+********************************************************************/
+void KeyStatsGet(KEY_STATS *stats){
+    CPU_SR_ALLOC();
+
+    CPU_CRITICAL_ENTER();
+    *stats = keyQueue.stats;
+    CPU_CRITICAL_EXIT();
+}
+
+/********************************************************************
+* KeyRepeatSet() - Sets the auto-repeat and long-press timing of the
+*                  key with ASCII code code. Times are rounded up to
+*                  ticks and take effect at the next press.
+*                - Returns TRUE if no error, FALSE if there is no key
+*                  with that code.
+*    - Public
+********************************************************************/
+INT8U KeyRepeatSet(INT8U code, INT16U dly_ms, INT16U period_ms, INT16U hold_ms){
+    INT8U key;
+    CPU_SR_ALLOC();
+
+    for(key = 0; (key < 16) && (keyCodeTable[key] != code); key++){
+    }
+    if(key >= 16){
+        return(FALSE);
+    }else{
+    }
+    CPU_CRITICAL_ENTER();
+    keyTiming[key].repeat_dly = KEY_MS_TO_TICKS(dly_ms);
+    keyTiming[key].repeat_per = KEY_MS_TO_TICKS(period_ms);
+    keyTiming[key].hold = KEY_MS_TO_TICKS(hold_ms);
+    CPU_CRITICAL_EXIT();
+    return(TRUE);
 }
 
 /********************************************************************
@@ -81,20 +242,25 @@ INT8U KeyPend(INT16U tout, OS_ERR *os_err){
 void KeyInit(void){
 
     OS_ERR os_err;
+    INT8U level;
 	/* Key port init */
-    SIM_SCGC5 |= SIM_SCGC5_PORTC_MASK;              /* Enable clock gate for PORTC */
-    PORTC_PCR3=PORT_PCR_MUX(1)|PORT_PCR_PS_MASK|PORT_PCR_PE_MASK;
-    PORTC_PCR4=PORT_PCR_MUX(1)|PORT_PCR_PS_MASK|PORT_PCR_PE_MASK;
-    PORTC_PCR5=PORT_PCR_MUX(1)|PORT_PCR_PS_MASK|PORT_PCR_PE_MASK;
-    PORTC_PCR6=PORT_PCR_MUX(1)|PORT_PCR_PS_MASK|PORT_PCR_PE_MASK;
-	PORTC_PCR7=PORT_PCR_MUX(1);
-	PORTC_PCR8=PORT_PCR_MUX(1);
-	PORTC_PCR9=PORT_PCR_MUX(1);
-	PORTC_PCR10=PORT_PCR_MUX(1);
-    KEY_PORT_OUT &= ~ROWS_MASK;            /* Preset all rows to zero    */
-    // Initialize the Key Buffer and semaphore
-    keyBuffer.buffer = 0x00;           /* Init KeyBuffer      */
-    OSSemCreate(&(keyBuffer.flag),"Key Semaphore",0,&os_err);
+    keyPort->Init();
+    // Initialize the Key Queue and semaphore
+    keyQueue.head = 0;
+    keyQueue.count = 0;
+    keyQueue.stats.events = 0;
+    keyQueue.stats.overflows = 0;
+    keyQueue.stats.max_depth = 0;
+    keyQueue.stats.chords = 0;
+    keyQueue.stats.ghosts = 0;
+    keyQueue.stats.settle_ns = 0;
+    keyQueue.stats.settle_max_ns = 0;
+    keyQueue.stats.scans = 0;
+    for(level = 0; level < KEY_RATE_LEVELS; level++){
+        keyQueue.stats.rate_scans[level] = 0;
+    }
+    (void)keyDebounceSet(0);
+    OSSemCreate(&(keyQueue.flag),"Key Semaphore",0,&os_err);
     while(os_err != OS_ERR_NONE){           /* Error Trap                        */
     }
     //Create the key task
@@ -113,110 +279,404 @@ void KeyInit(void){
                 (OS_ERR     *)&os_err);
     while(os_err != OS_ERR_NONE){           /* Error Trap                        */
     }
+    STK_MON_ADD(&keyTaskTCB, APP_CFG_KEY_TASK_STK_SIZE);
 
 }
 
 /********************************************************************
-* KeyTask() - Read the keypad and updates KeyBuffer. 
-*             A task decomposed into states for detecting and
-*             verifying keypresses. This task should be called
-*             periodically with a period greater than the worst case
-*             switch bounce time and less than the shortest switch
-*             activation time minus the bounce time. The switch must 
-*             be released to have multiple acknowledged presses.
+* KeyTask() - Read the keypad and updates the key queue.
+*             A task that debounces the key bitmap: a key goes down
+*             or up when KEY_DEBOUNCE_SAMPLES scans in a row agree on
+*             it. The active scan period times the sample count
+*             should be greater than the worst case switch bounce
+*             time and less than the shortest switch activation
+*             time. The next period is picked after each scan by
+*             keyRateLevel(). Keys are
+*             pressed and released independently, so a chord is
+*             two presses with no release between them.
+*             The last key pressed is the one that repeats.
+*             A scan after a wake through the hardware filter is
+*             taken as is.
+*             The first delay after an idle wait is relative, the
+*             periodic base is stale by then. A period that has
+*             already passed (OS_ERR_TIME_ZERO_DLY) scans at once.
 * (Public)
 ********************************************************************/
 static void keyTask(void *p_arg) {
 
     OS_ERR os_err;
-    INT8U cur_key;
-    INT8U last_key = 0;
-    KEYSTATES KeyState = KEY_OFF;
+    OS_OPT dly_opt = OS_OPT_TIME_DLY;   /* Relative until the period is running */
+    INT16U cur_keys;
+    INT16U new_keys;
+    INT8U level = KEY_RATE_SLEEP;       /* Scan rate for the next scan */
+    INT32U change_ts = 0;               /* Last scan anything moved */
+    INT16U keys = 0;                    /* Verified keys down */
+    INT16U queued = 0;                  /* Verified presses that were queued */
+    INT16U change;
+    INT16U presses;
+    INT8U key;
+    INT8U held = KEY_NONE;              /* Key that repeats */
+    INT32U scan_ts;
+    INT32U press_ts = 0;
+    INT32U repeat_ts = 0;               /* Next repeat due */
+    INT8U hold_sent = FALSE;
+    INT8U steady = FALSE;               /* Woken through the column filter */
+    KEY_TIMING timing = {0,0,0};        /* Of the key held */
+    CPU_SR_ALLOC();
     (void)p_arg;
     while(1){
+#if KEY_IRQ_EN
+        if(keyRateTable[level] == 0){
+            steady = keyIdle();             /* Scan on the next edge */
+            change_ts = (INT32U)OSTimeGet(&os_err);
+            dly_opt = OS_OPT_TIME_DLY;
+        }else{
+            steady = FALSE;
+            DB1_TURN_OFF();
+            OSTimeDly(KEY_MS_TO_TICKS(keyRateTable[level]),dly_opt,&os_err);
+            DB1_TURN_ON();
+            while((os_err != OS_ERR_NONE) && (os_err != OS_ERR_TIME_ZERO_DLY)){ /* Error Trap */
+            }
+            dly_opt = OS_OPT_TIME_PERIODIC;
+        }
+#else
 		DB1_TURN_OFF();
-        OSTimeDly(8,OS_OPT_TIME_PERIODIC,&os_err);
+        OSTimeDly(KEY_MS_TO_TICKS(keyRateTable[level]),dly_opt,&os_err);
 		DB1_TURN_ON();
-        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+        while((os_err != OS_ERR_NONE) && (os_err != OS_ERR_TIME_ZERO_DLY)){ /* Error Trap */
+        }
+        dly_opt = OS_OPT_TIME_PERIODIC;
+#endif
+        cur_keys = keyScan();
+        scan_ts = (INT32U)OSTimeGet(&os_err);
+        CPU_CRITICAL_ENTER();
+        keyQueue.stats.scans++;
+        keyQueue.stats.rate_scans[level]++;
+        CPU_CRITICAL_EXIT();
+        if(keyGhost(cur_keys)){             /* Can't tell which keys are real */
+            CPU_CRITICAL_ENTER();
+            keyQueue.stats.ghosts++;
+            CPU_CRITICAL_EXIT();
+            new_keys = keys;                /* Not a sample, wait for a clean scan */
+        }else if(steady){                   /* Debounced by the filter */
+            new_keys = keyDebounceSet(cur_keys);
+        }else{
+            new_keys = keyDebounce(cur_keys);
         }
-        cur_key = keyScan();
-        if(KeyState == KEY_OFF){    /* Key released state */
-            if(cur_key != 0){
-                KeyState = KEY_EDGE;
-            }else{ /* wait for key press */
+        if((cur_keys != new_keys) || (new_keys != keys)){
+            change_ts = scan_ts;
+        }else{
+        }
+        level = keyRateLevel(cur_keys ^ new_keys, new_keys, scan_ts - change_ts);
+        if(new_keys != keys){               /* Change verified */
+            presses = new_keys & (INT16U)~keys;
+            change = keys & (INT16U)~new_keys;
+            for(key = 0; change != 0; key++, change >>= 1){ /* Releases first */
+                if((change & 1u) != 0){
+                    keys &= (INT16U)~KEY_BIT(key);
+                    if((queued & KEY_BIT(key)) != 0){   /* No release for a dropped press */
+                        queued &= (INT16U)~KEY_BIT(key);
+                        (void)keyPost(keyCodeTable[key], KEY_RELEASE, keys, scan_ts);
+                    }else{
+                    }
+                    if(held == key){
+                        held = KEY_NONE;
+                    }else{
+                    }
+                }else{
+                }
+            }
+            change = presses;
+            for(key = 0; change != 0; key++, change >>= 1){
+                if((change & 1u) != 0){
+                    keys |= KEY_BIT(key);
+                    if(keyPost(keyCodeTable[key], KEY_PRESS, keys, scan_ts)){
+                        queued |= KEY_BIT(key);
+                    }else{
+                    }
+                    held = key;
+                }else{
+                }
             }
-        }else if(KeyState == KEY_EDGE){     /* Keypress detected state*/
-            if(cur_key == last_key){        /* Keypress verified */
-                KeyState = KEY_VERF;
-                keyBuffer.buffer = keyCodeTable[cur_key - 1]; /*update buffer */
-                (void)OSSemPost(&(keyBuffer.flag), OS_OPT_POST_1, &os_err);   /* Signal new data in buffer */
-                while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+            if(presses != 0){               /* New key to repeat */
+                CPU_CRITICAL_ENTER();
+                timing = keyTiming[held];
+                if((keys & (keys - 1u)) != 0){
+                    keyQueue.stats.chords++;
+                }else{
                 }
-            }else if( cur_key == 0){        /* Unvalidated, start over */
-                KeyState = KEY_OFF;
-            }else{                          /*Unvalidated, diff key edge*/
+                CPU_CRITICAL_EXIT();
+                press_ts = scan_ts;
+                repeat_ts = scan_ts + timing.repeat_dly;
+                hold_sent = (INT8U)(timing.hold == 0);
+            }else{
             }
-        }else if(KeyState == KEY_VERF){     /* Keypress verified state */
-            if((cur_key == 0) || (cur_key != last_key)){
-                KeyState = KEY_OFF;
-            }else{ /* wait for release or key change */
+        }else if(held != KEY_NONE){ /* Held, repeat and long-press from the scan time */
+            if((hold_sent == FALSE) && ((scan_ts - press_ts) >= timing.hold)){
+                hold_sent = TRUE;
+                (void)keyPost(keyCodeTable[held], KEY_HOLD, keys, scan_ts);
+            }else{
             }
-        }else{ /* In case of error */
-            KeyState = KEY_OFF;             /* Should never get here */
+            if((timing.repeat_per != 0) && ((INT32S)(scan_ts - repeat_ts) >= 0)){
+                (void)keyPost(keyCodeTable[held], KEY_REPEAT, keys, scan_ts);
+                repeat_ts += timing.repeat_per;
+                if((INT32S)(scan_ts - repeat_ts) >= 0){ /* Fell behind, no bursts */
+                    repeat_ts = scan_ts + timing.repeat_per;
+                }else{
+                }
+            }else{
+            }
+        }else{
         }
-        last_key = cur_key;                 /* Save key for next time */
     
     }
 }
 
 /********************************************************************
-* keyScan() - Scans the keypad and returns a keycode.
+* keyRateLevel() - Picks the scan rate from the keypad's activity.
+*                - pending has a bit set for each key the last scan
+*                  saw different from its debounced state, keys are
+*                  the debounced keys down and quiet is the ticks
+*                  since anything last changed.
+*                - Returns the KEY_RATE_TABLE level for the next scan.
+* (Private)
+********************************************************************/
+static INT8U keyRateLevel(INT16U pending, INT16U keys, INT32U quiet) {
+
+    INT8U level;
+
+    if(pending != 0){
+        level = KEY_RATE_ACTIVE;
+    }else if(keys != 0){
+        level = KEY_RATE_HELD;
+#if KEY_RATE_QUIET_MS
+    }else if(quiet < KEY_MS_TO_TICKS(KEY_RATE_QUIET_MS)){
+        level = KEY_RATE_UP;
+#endif
+    }else{
+        level = KEY_RATE_SLEEP;
+    }
+#if !KEY_RATE_QUIET_MS
+    (void)quiet;                        /* Sleeps as soon as all keys are up */
+#endif
+    return(level);
+}
+
+/********************************************************************
+* keyPost() - Queues a key event and signals it.
+*           - If the queue is full the new event is dropped and
+*             counted in overflows, so the oldest keys survive.
+*           - Returns TRUE if the event was queued.
+* (Private)
+********************************************************************/
+static INT8U keyPost(INT8U code, INT8U type, INT16U keys, INT32U ts){
+    OS_ERR os_err;
+    KEY_EVENT *event;
+    CPU_SR_ALLOC();
+
+    CPU_CRITICAL_ENTER();
+    if(keyQueue.count < KEY_QUEUE_SIZE){
+        event = &keyQueue.events[(keyQueue.head + keyQueue.count) % KEY_QUEUE_SIZE];
+        event->code = code;
+        event->type = type;
+        event->keys = keys;
+        event->ts = ts;
+        keyQueue.count++;
+        keyQueue.stats.events++;
+        if(keyQueue.count > keyQueue.stats.max_depth){
+            keyQueue.stats.max_depth = keyQueue.count;
+        }else{
+        }
+        CPU_CRITICAL_EXIT();
+        (void)OSSemPost(&(keyQueue.flag), OS_OPT_POST_1, &os_err);   /* Signal new event in queue */
+        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+        }
+        return(TRUE);
+    }else{
+        keyQueue.stats.overflows++;
+        CPU_CRITICAL_EXIT();
+        return(FALSE);
+    }
+}
+
+/********************************************************************
+* keyScan() - Scans the keypad and returns a bitmap of the keys down.
 *           - Designed for 4x4 keypad with columns pulled high.
-*           - Current keycodes follow:
-*               1->0x01,2->0x02,3->0x03,A->0x04
-*               4->0x05,5->0x06,6->0x07,B->0x08
-*               7->0x09,8->0x0A,9->0x0B,C->0x0C
-*               *->0x0D,0->0x0E,#->0x0F,D->0x10
+*           - Every row is read, bit (row * 4) + col is set for each
+*             key down, the same order as keyCodeTable[]:
+*               1->bit 0, 2->bit 1, 3->bit 2, A->bit 3
+*               4->bit 4, 5->bit 5, 6->bit 6, B->bit 7
+*               7->bit 8, 8->bit 9, 9->bit 10,C->bit 11
+*               *->bit 12,0->bit 13,#->bit 14,D->bit 15
 *           - Returns zero if no key is pressed.
-*           - ColTable[] can be changed to distinguish multiple keys
-*             pressed in the same row.
+*           - The time spent settling goes in the stats.
+* (Private)
+********************************************************************/
+static INT16U keyScan(void) {
+
+    INT16U keys;
+    INT8U row;
+    INT32U settle_ns;
+    CPU_SR_ALLOC();
+
+    keys = 0;
+    settle_ns = 0;
+    for(row = 0; row < KEY_NUM_ROWS; row++){ /* All rows, no early exit */
+        keyPort->Rows((INT8U)(1u << row));  /* Pull row low */
+        settle_ns += keyPort->Settle();	// wait for direction and col inputs to settle
+        keys |= (INT16U)((INT16U)keyPort->Cols() << (row * KEY_NUM_COLS));
+    }
+    keyPort->Rows(0);
+    CPU_CRITICAL_ENTER();
+    keyQueue.stats.settle_ns = settle_ns;
+    if(settle_ns > keyQueue.stats.settle_max_ns){
+        keyQueue.stats.settle_max_ns = settle_ns;
+    }else{
+    }
+    CPU_CRITICAL_EXIT();
+    return (keys); 
+}
+
+/********************************************************************
+* keyDebounce() - Debounces all 16 keys with vertical counters.
+*               - keyVc[] holds a counter per key, bit b of key k in
+*                 bit k of keyVc[b]. A key's counter counts scans in
+*                 a row that differ from its debounced state and is
+*                 cleared by any scan that agrees. The state flips
+*                 when the count reaches KEY_DEBOUNCE_SAMPLES.
+*               - Returns the debounced keys down.
 * (Private)
 ********************************************************************/
-static INT8U keyScan(void) {
-
-    INT8U kcode;
-    INT8U roff;
-    INT32U rbit;
-
-    const INT8U ColTable[16] = {0,1,2,2,3,3,3,3,4,4,4,4,4,4,4,4};
-
-    rbit = 0x00000080;
-    roff = 0x00;
-    while(rbit != 0){ /* Until all rows are scanned */
-        KEY_PORT_OUT &= ~ROWS_MASK;
-        KEY_PORT_DIR = (KEY_PORT_DIR & ~ROWS_MASK)|rbit;    /* Pull row low */
-        keyDly();	// wait for direction and col inputs to settle
-        kcode = (INT8U)(((~KEY_PORT_IN) & COLS_MASK)>>3);  /*Read columns */
-        KEY_PORT_DIR = (KEY_PORT_DIR &~ROWS_MASK); 
-        if(kcode != 0){        /* generate key code if key pressed */
-            kcode = roff + ColTable[kcode];
-            break;
+static INT16U keyDebounce(INT16U sample) {
+
+    INT16U delta, carry, next, match;
+    INT8U b;
+
+    delta = sample ^ keyDebounced;          /* Keys that disagree */
+    carry = delta;
+    match = delta;
+    for(b = 0; b < KEY_VC_BITS; b++){       /* Count them, clear the rest */
+        next = keyVc[b] & carry;
+        keyVc[b] = (keyVc[b] ^ carry) & delta;
+        carry = next;
+        if(((KEY_DEBOUNCE_SAMPLES >> b) & 1u) != 0){
+            match &= keyVc[b];
+        }else{
+            match &= (INT16U)~keyVc[b];
         }
-        rbit = ROWS_MASK & (rbit<<1);       /* setup for next row */
-        roff += 4;
     }
-    return (kcode); 
+    keyDebounced ^= match;                  /* Count reached, flip */
+    for(b = 0; b < KEY_VC_BITS; b++){
+        keyVc[b] &= (INT16U)~match;
+    }
+    return(keyDebounced);
+}
+
+/********************************************************************
+* keyDebounceSet() - Makes keys the debounced state, counters cleared.
+*                  - Returns keys.
+* (Private)
+********************************************************************/
+static INT16U keyDebounceSet(INT16U keys) {
+
+    INT8U b;
+
+    for(b = 0; b < KEY_VC_BITS; b++){
+        keyVc[b] = 0;
+    }
+    keyDebounced = keys;
+    return(keyDebounced);
 }
+
 /********************************************************************
- * keyDly() a software delay for keyScan() to wait until port row
- * bit direction and column inputs are settled .
- * With debug bits included and a 120Mhz bus the delay is 
- * 	Tdly = (83.2ns)i + 128ns
- * Currently set to ~830ns with i=10.
- * TDM 01/20/2013
- *******************************************************************/
-static void keyDly(void){
-	INT32U i;
-	for(i=0;i<10;i++){
-	}
+* keyGhost() - Checks a scan for a ghosting pattern.
+*            - With no diodes, keys down on three corners of a
+*              rectangle pull the fourth corner's row and column
+*              together, so it reads as down too. Any two rows that
+*              share two or more columns could be that, so the scan
+*              can't be trusted.
+*            - Returns TRUE if the scan could hold ghost keys.
+* (Private)
+********************************************************************/
+static INT8U keyGhost(INT16U keys) {
+
+    INT8U ra, rb;
+    INT8U shared;
+
+    for(ra = 0; ra < (KEY_NUM_ROWS - 1); ra++){
+        for(rb = ra + 1; rb < KEY_NUM_ROWS; rb++){
+            shared = (INT8U)((keys >> (ra * KEY_NUM_COLS)) & (keys >> (rb * KEY_NUM_COLS)) & 0x0f);
+            if((shared & (shared - 1u)) != 0){  /* Two or more columns */
+                return(TRUE);
+            }else{
+            }
+        }
+    }
+    return(FALSE);
+}
+
+#if KEY_IRQ_EN
+/********************************************************************
+* keyIdle() - Sleeps until a key goes down.
+*           - Drives every row low so any key pulls its column low,
+*             arms the column interrupt and pends on the task
+*             semaphore. Returns right away if a key went down before
+*             the interrupt was armed, since that edge is lost.
+*           - The first scan follows straight away. If it catches
+*             the contacts open while they bounce, the task comes
+*             back here and the next bounce edge wakes it again.
+*           - With KEY_HW_FILTER_MS the column filter is on while
+*             waiting and turned off again before the scan.
+*           - Returns TRUE if the wake came through the filter.
+* (Private)
+********************************************************************/
+static INT8U keyIdle(void){
+    OS_ERR os_err;
+    INT8U filtered = FALSE;
+    INT8U steady = FALSE;
+
+    keyPort->Rows(KEY_ALL_ROWS);
+    (void)keyPort->Settle();
+#if KEY_HW_FILTER_MS
+    filtered = keyPort->Filter(KEY_HW_FILTER_MS);
+#endif
+    keyPort->IrqEnable(TRUE);
+    if(keyPort->Cols() == 0){
+        DB1_TURN_OFF();
+        (void)OSTaskSemPend(0, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
+        DB1_TURN_ON();
+        while(os_err != OS_ERR_NONE){           /* Error Trap                        */
+        }
+        steady = filtered;
+    }else{
+        keyPort->IrqEnable(FALSE);
+        // Drop the post if the edge made it in after all
+        (void)OSTaskSemSet((OS_TCB *)0, 0, &os_err);
+    }
+    if(filtered){
+        (void)keyPort->Filter(0);
+    }else{
+    }
+    keyPort->Rows(0);
+    return(steady);
+}
+
+/********************************************************************
+* KeyColIrq() - Wakes the key task on a column edge.
+*             - Called from the port driver's interrupt handler with
+*               column interrupts already off.
+* (Public)
+********************************************************************/
+void KeyColIrq(void){
+    OS_ERR os_err;
+
+    (void)OSTaskSemPost(&keyTaskTCB, OS_OPT_POST_NONE, &os_err);
+}
+#else
+/********************************************************************
+* KeyColIrq() - Column interrupts are not used without KEY_IRQ_EN.
+* (Public)
+********************************************************************/
+void KeyColIrq(void){
 }
+#endif
@@ -7,11 +7,114 @@
 #ifndef UC_KEY_DEF
 #define UC_KEY_DEF
 
-INT8U KeyPend(INT16U tout, OS_ERR *os_err); /* Pend on key press*/
+/* Set to 0 to scan every 8ms even when no key is down, instead of    */
+/* waiting on the PORTC column interrupt.                             */
+#ifndef KEY_IRQ_EN
+#define KEY_IRQ_EN 1
+#endif
+
+/* Scans in a row, 8ms apart, that must agree before a key changes, */
+/* 1 to 7                                                            */
+#ifndef KEY_DEBOUNCE_SAMPLES
+#define KEY_DEBOUNCE_SAMPLES 2
+#endif
+
+/* Column glitch filter while waiting for a key, in ms (1 to 31), or  */
+/* 0 for none. A press that wakes the task through the filter has     */
+/* already stopped bouncing, so its first scan is taken as is. Only   */
+/* used if the port driver has a filter, needs KEY_IRQ_EN.            */
+#ifndef KEY_HW_FILTER_MS
+#define KEY_HW_FILTER_MS 0
+#endif
+
+/* Scan period in ms for each activity level: a key is bouncing or   */
+/* being debounced, keys are held still, all keys are up, and all     */
+/* keys have been up for KEY_RATE_QUIET_MS. Only the sleep period can */
+/* be 0, which waits for the column interrupt and needs KEY_IRQ_EN.   */
+/* The debounce time is KEY_DEBOUNCE_SAMPLES active periods.           */
+#ifndef KEY_RATE_ACTIVE_MS
+#define KEY_RATE_ACTIVE_MS 8
+#endif
+#ifndef KEY_RATE_HELD_MS
+#define KEY_RATE_HELD_MS 16
+#endif
+#ifndef KEY_RATE_UP_MS
+#define KEY_RATE_UP_MS 8
+#endif
+#if KEY_IRQ_EN
+#ifndef KEY_RATE_SLEEP_MS
+#define KEY_RATE_SLEEP_MS 0
+#endif
+#ifndef KEY_RATE_QUIET_MS
+#define KEY_RATE_QUIET_MS 0
+#endif
+#else
+#ifndef KEY_RATE_SLEEP_MS
+#define KEY_RATE_SLEEP_MS 50
+#endif
+#ifndef KEY_RATE_QUIET_MS
+#define KEY_RATE_QUIET_MS 2000
+#endif
+#endif
+
+#define KEY_RATE_ACTIVE 0u
+#define KEY_RATE_HELD   1u
+#define KEY_RATE_UP     2u
+#define KEY_RATE_SLEEP  3u
+#define KEY_RATE_LEVELS 4u
+#define KEY_RATE_TABLE {KEY_RATE_ACTIVE_MS, KEY_RATE_HELD_MS, \
+                        KEY_RATE_UP_MS, KEY_RATE_SLEEP_MS}
+
+/* Key events held for the application before new ones are dropped, */
+/* a press and its release are two events                            */
+#ifndef KEY_QUEUE_SIZE
+#define KEY_QUEUE_SIZE 16
+#endif
+
+#define KEY_PRESS   1u
+#define KEY_RELEASE 0u
+#define KEY_REPEAT  2u          /* Auto-repeat while the key is held    */
+#define KEY_HOLD    3u          /* Held for the key's long-press time   */
+
+typedef struct{
+    INT8U code;                 /* ASCII code of the key                */
+    INT8U type;                 /* KEY_PRESS, KEY_RELEASE, KEY_REPEAT   */
+                                /* or KEY_HOLD                          */
+    INT16U keys;                /* Keys down after the event, bit per   */
+                                /* key in keypad order, 1 is bit 0 and  */
+                                /* D is bit 15. A chord has several.    */
+    INT32U ts;                  /* OSTimeGet() of the scan that saw it  */
+}KEY_EVENT;
+
+typedef struct{
+    INT32U events;              /* Events queued                        */
+    INT32U overflows;           /* Events dropped with the queue full   */
+    INT8U max_depth;            /* Most events ever waiting             */
+    INT32U chords;              /* Presses made with other keys down    */
+    INT32U ghosts;              /* Scans ignored for a ghost pattern    */
+    INT32U settle_ns;           /* Time the last scan spent settling    */
+    INT32U settle_max_ns;       /* Most time a scan spent settling      */
+    INT32U scans;               /* Scans made                           */
+    INT32U rate_scans[KEY_RATE_LEVELS]; /* Scans at each rate level     */
+}KEY_STATS;
+
+INT8U KeyPend(INT16U tout, OS_ERR *os_err); /* Pend on key press or repeat */
                              /* tout - semaphore timeout           */
                              /* *err - destination of err code     */
                              /* Error codes are identical to a semaphore */
 
+void KeyPendEvent(KEY_EVENT *event, INT16U tout, OS_ERR *os_err);
+                             /* Pend on any key event, press or release */
+
+void KeyStatsGet(KEY_STATS *stats);
+
+INT8U KeyRepeatSet(INT8U code, INT16U dly_ms, INT16U period_ms, INT16U hold_ms);
+                             /* Auto-repeat and long-press timing of a key */
+                             /* dly_ms - first repeat after the press     */
+                             /* period_ms - between repeats, 0 for none   */
+                             /* hold_ms - KEY_HOLD after the press, 0 for */
+                             /*           none                            */
+
 void KeyInit(void);             /* Keypad Initialization    */
 
 #endif
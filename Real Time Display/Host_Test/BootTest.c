@@ -0,0 +1,150 @@
+/*************************************************************************
+* BootTest.c - The boot profile of the whole application
+*
+*            Runs the real Lab2.c (its main() built as AppMain()) with
+*            LcdBusVirtual as the display for BT_RUN_MS, then reads the
+*            profile with BootProfileGet().
+*
+*            The start task's mark and every appBootStages[] stage have
+*            to be there, in order, with the LCD task's "LCD powered up"
+*            and "LCD first frame" after "LCD". The first frame has to
+*            fall before the "CPU usage" stage ends, the clock is up
+*            before the 100ms OSStatTaskCPUUsageInit() window closes,
+*            and the LCD task has to have made its power up waits as OS
+*            delays, at least BT_POWER_DLYS of them, not spins.
+*
+*            The tick hook looks at the glass every tick, the first
+*            digit has to show within a tick of the "LCD first frame"
+*            mark. The report gives the profile.
+*
+* 10/18/2026 Initial version
+*************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "MCUType.h"
+#include "os.h"
+#include "app_cfg.h"
+#include "HostOs.h"
+#include "Boot.h"
+#include "LcdBusVirtual.h"
+
+#define BT_RUN_MS       1000u
+#define BT_POWER_DLYS   3u          /* 15ms, 4.1ms and the clear          */
+#define BT_TICK_US      (1000000u / OS_CFG_TICK_RATE_HZ)
+
+void AppMain(void);                 /* Lab2.c main() */
+
+/* The marks in the order they have to come, see Lab2.c and LcdLayered.c */
+static const INT8C *const btOrder[] = {
+    "Start task", "Tick", "LCD", "DBug bits", "Keys", "Time", "Screens", "Tasks", "CPU usage"};
+#define BT_ORDER ((INT8U)(sizeof(btOrder) / sizeof(btOrder[0])))
+
+static BOOT_MARK_T btMarks[BOOT_MAX_MARKS];
+static INT8U btNumMarks;
+static INT32U btDigitUs;            /* First tick with a digit on glass   */
+static HOST_TASK_STATS btLcd;
+
+static void btTickHook(void);
+static INT64U btBusNs(void);
+static INT32U btFind(const INT8C *name);
+static void btCheck(void);
+
+/*************************************************************************
+  main() - Runs the application, then checks the profile
+*************************************************************************/
+int main(void) {
+    INT8U mark;
+
+    HostBusHookSet(btBusNs);
+    HostTickHookSet(btTickHook);
+    AppMain();                          /* Returns once the hook stops it */
+
+    btNumMarks = BootProfileGet(btMarks, BOOT_MAX_MARKS);
+    btCheck();
+    printf("  mark                   us\n");
+    for(mark = 0; mark < btNumMarks; mark++) {
+        printf("  %-16s  %7u\n", btMarks[mark].name, btMarks[mark].us);
+    }
+    printf("  first digit seen  %7u\n", btDigitUs);
+    printf("BootTest: %u marks, %u failed checks\n", btNumMarks, HostFails());
+    return((HostFails() == 0) ? 0 : 1);
+}
+
+/*************************************************************************
+  btTickHook() - Watches the glass for the first digit
+*************************************************************************/
+static void btTickHook(void) {
+    INT8C glass[LCD_VIRT_ROWS][LCD_VIRT_COLS];
+    INT8U row, col;
+
+    if(btDigitUs == 0) {
+        LcdVirtGlassGet(glass);
+        for(row = 0; row < LCD_VIRT_ROWS; row++) {
+            for(col = 0; col < LCD_VIRT_COLS; col++) {
+                if((glass[row][col] >= '0') && (glass[row][col] <= '9')) {
+                    btDigitUs = (INT32U)(HostNsGet() / 1000u);
+                }else{
+                }
+            }
+        }
+    }else{
+    }
+    if(HostTickGet() >= BT_RUN_MS) {
+        (void)HostTaskStatsGet(APP_CFG_LCD_TASK_PRIO, &btLcd);
+        HostStop();
+    }else{
+    }
+}
+
+static INT64U btBusNs(void) {
+    LCD_VIRT_STATS stats;
+
+    LcdVirtStatsGet(&stats);
+    return(stats.bus_ns);
+}
+
+/* Index of the mark called name, btNumMarks if there is none */
+static INT32U btFind(const INT8C *name) {
+    INT8U mark;
+
+    for(mark = 0; (mark < btNumMarks) && (strcmp(btMarks[mark].name, name) != 0); mark++) {
+    }
+    return(mark);
+}
+
+/*************************************************************************
+  btCheck() - The marks, their order and the first frame
+*************************************************************************/
+static void btCheck(void) {
+    INT32U at, last = 0, powered, first, cpu;
+    INT8U step;
+
+    for(step = 0; step < BT_ORDER; step++) {
+        at = btFind(btOrder[step]);
+        if(HOST_CHECK(at < btNumMarks, "no \"%s\" mark", btOrder[step])) {
+            HOST_CHECK(btMarks[at].us >= last, "\"%s\" at %uus, before the stage ahead of it",
+                       btOrder[step], btMarks[at].us);
+            last = btMarks[at].us;
+        }else{
+        }
+    }
+    powered = btFind("LCD powered up");
+    first = btFind("LCD first frame");
+    cpu = btFind("CPU usage");
+    if(HOST_CHECK((powered < btNumMarks) && (first < btNumMarks) && (cpu < btNumMarks),
+                  "LCD or CPU usage marks missing")) {
+        HOST_CHECK(btMarks[powered].us >= btMarks[btFind("LCD")].us,
+                   "LCD powered up at %uus, before the LCD stage", btMarks[powered].us);
+        HOST_CHECK(btMarks[first].us >= btMarks[powered].us,
+                   "LCD first frame at %uus, before the power up", btMarks[first].us);
+        HOST_CHECK(btMarks[first].us < btMarks[cpu].us,
+                   "LCD first frame at %uus, after CPU usage ended at %uus", btMarks[first].us,
+                   btMarks[cpu].us);
+        HOST_CHECK((btDigitUs >= btMarks[first].us)
+                   && (btDigitUs <= (btMarks[first].us + BT_TICK_US)),
+                   "first digit seen at %uus, first frame at %uus", btDigitUs,
+                   btMarks[first].us);
+    }else{
+    }
+    HOST_CHECK(btLcd.dlys >= BT_POWER_DLYS, "LCD task made %u delays", btLcd.dlys);
+}
@@ -0,0 +1,77 @@
+/*************************************************************************
+* HostBench.c - Host cycle counts for the benchmarks
+*
+*            The x86 time stamp counter, fenced so the code being timed
+*            cannot move across the read. Other hosts fall back to the
+*            monotonic clock in ns.
+*
+* 10/18/2026 Initial version
+*************************************************************************/
+#include <stdlib.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "MCUType.h"
+#include "HostBench.h"
+
+#define HOST_BENCH_INIT_READS 1000u
+
+static INT64U hostBenchOverhead;
+
+static int hostBenchCmp(const void *a, const void *b);
+
+/*************************************************************************
+  HostBenchInit() - The cheapest of a run of back to back reads is taken
+                    off every HostBenchSince()
+*************************************************************************/
+void HostBenchInit(void) {
+    INT64U start, cyc;
+    INT64U least = ~(INT64U)0;
+    INT32U cnt;
+
+    hostBenchOverhead = 0;
+    for(cnt = 0; cnt < HOST_BENCH_INIT_READS; cnt++) {
+        start = HostBenchCyc();
+        cyc = HostBenchCyc() - start;
+        if(cyc < least) {
+            least = cyc;
+        }else{
+        }
+    }
+    hostBenchOverhead = least;
+}
+
+INT64U HostBenchCyc(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_lfence();
+    return(__rdtsc());
+#else
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return((INT64U)ts.tv_sec * 1000000000u + (INT64U)ts.tv_nsec);
+#endif
+}
+
+INT64U HostBenchSince(INT64U start) {
+    INT64U cyc = HostBenchCyc() - start;
+
+    return((cyc > hostBenchOverhead) ? (cyc - hostBenchOverhead) : 0);
+}
+
+INT64U HostBenchPct(INT64U *samples, INT32U num, INT8U pct) {
+    if(num == 0) {
+        return(0);
+    }else{
+    }
+    qsort(samples, num, sizeof(samples[0]), hostBenchCmp);
+    return(samples[((INT64U)num * pct) / 100u]);
+}
+
+static int hostBenchCmp(const void *a, const void *b) {
+    INT64U x = *(const INT64U *)a;
+    INT64U y = *(const INT64U *)b;
+
+    return((x < y) ? -1 : (x > y));
+}
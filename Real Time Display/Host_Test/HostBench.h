@@ -0,0 +1,23 @@
+/*************************************************************************
+* HostBench.h - Host cycle counts for the benchmarks
+*
+*            Real cycles of the host CPU, for comparing two builds of
+*            the same code on the same machine. They are not K65
+*            cycles, and unlike HostCycGet() they change from run to
+*            run, so only the benchmark reports use them and no test
+*            checks them.
+*
+* 10/18/2026 Initial version
+*************************************************************************/
+#ifndef HOST_BENCH_DEF
+#define HOST_BENCH_DEF
+
+void HostBenchInit(void);       /* Measures the cost of a read, call first */
+
+INT64U HostBenchCyc(void);      /* Host cycle counter now */
+
+INT64U HostBenchSince(INT64U start);
+                                /* Cycles since start, read cost removed */
+INT64U HostBenchPct(INT64U *samples, INT32U num, INT8U pct);
+                                /* Sorts samples, returns the pct'th    */
+#endif
@@ -0,0 +1,593 @@
+/*************************************************************************
+* HostOs.c - A uC/OS-III stand-in for host tests
+*
+*            Tasks are ucontext coroutines on one Linux thread. The
+*            highest priority ready task always runs, and a post that
+*            readies a higher priority task switches to it at once, so
+*            the application sees the same order of events as on the
+*            target. There is no time slicing and no priority
+*            inheritance.
+*
+*            OSTimeDly() follows OS_TickListInsertDly() in os_tick.c,
+*            including the periodic base (TickCtrPrev) that relative
+*            delays leave alone and OS_ERR_TIME_ZERO_DLY for a period
+*            that has already passed.
+*
+*            Also defines the registers and system clock that
+*            Include/MCUType.h declares.
+*
+* 10/18/2026 Initial version
+* 10/18/2026 Added the test checks
+* 10/18/2026 Added the task stats
+* 10/18/2026 Added HostTaskPendOn()
+*************************************************************************/
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <ucontext.h>
+#include "MCUType.h"
+#include "os.h"
+#include "HostOs.h"
+
+#define HOST_MAX_TASKS  16u
+#define HOST_STK_SIZE   (256u * 1024u)
+#define HOST_NS_PER_TICK (1000000000ull / OS_CFG_TICK_RATE_HZ)
+
+typedef enum{HOST_RDY, HOST_DLY, HOST_PEND, HOST_SUSPENDED}HOST_STATE;
+
+typedef struct{
+    ucontext_t ctx;
+    OS_TCB *tcb;
+    OS_TASK_PTR task;
+    void *arg;
+    OS_PRIO prio;
+    HOST_STATE state;
+    const void *pend_on;        /* Object pended on                     */
+    INT32U wake;                /* Tick to wake at, 0 to wait forever   */
+    INT8U timed_out;
+    OS_SEM_CTR sem_ctr;         /* Task semaphore                       */
+    OS_TICK tick_ctr_prev;      /* Periodic delay base                  */
+    HOST_TASK_STATS stats;
+}HOST_TASK;
+
+volatile INT32U HostReg[HOST_REG_NUM];
+INT32U SystemCoreClock = DEFAULT_SYSTEM_CLOCK;
+OS_CPU_USAGE OSStatTaskCPUUsage;
+
+static HOST_TASK hostTasks[HOST_MAX_TASKS];
+static INT8U hostNumTasks;
+static INT8S hostCur = -1;          /* Running task, -1 in the scheduler */
+static ucontext_t hostSchedCtx;
+static INT32U hostTick;
+static INT64U hostNs;               /* Virtual clock                     */
+static INT64U hostBusSeen;          /* Bus time already on the clock     */
+static INT8U hostStopped;
+static void (*hostTickHook)(void);
+static INT64U (*hostBusNs)(void);
+static INT32U hostFails;
+
+static void hostSwitchOut(void);
+static void hostTaskEntry(int idx);
+static void hostPreempt(void);
+static void hostBlock(const void *obj, OS_TICK timeout);
+static INT8S hostWaiter(const void *obj);
+static void hostReady(INT8U idx);
+static INT8U hostTaskIdx(const OS_TCB *p_tcb);
+static void hostTickRun(void);
+
+/*************************************************************************
+  Host control, see HostOs.h
+*************************************************************************/
+void HostTickHookSet(void (*hook)(void)) {
+    hostTickHook = hook;
+}
+
+void HostBusHookSet(INT64U (*bus_ns)(void)) {
+    hostBusNs = bus_ns;
+    hostBusSeen = (bus_ns != 0) ? bus_ns() : 0;
+}
+
+void HostStop(void) {
+    hostStopped = TRUE;
+}
+
+INT32U HostTickGet(void) {
+    return(hostTick);
+}
+
+/*************************************************************************
+  HostNsGet() - Virtual time, takes in any bus time since the last read
+*************************************************************************/
+INT64U HostNsGet(void) {
+    INT64U bus;
+
+    if(hostBusNs != 0) {
+        bus = hostBusNs();
+        if(bus > hostBusSeen) {         /* The bus model can be cleared */
+            hostNs += bus - hostBusSeen;
+        }else{
+        }
+        hostBusSeen = bus;
+    }else{
+    }
+    return(hostNs);
+}
+
+INT32U HostCycGet(void) {
+    return((INT32U)((HostNsGet() * (HOST_CPU_HZ / 1000000u)) / 1000u));
+}
+
+INT8U HostTaskStatsGet(INT8U prio, HOST_TASK_STATS *stats) {
+    INT8U idx;
+
+    for(idx = 0; idx < hostNumTasks; idx++) {
+        if(hostTasks[idx].prio == prio) {
+            *stats = hostTasks[idx].stats;
+            return(TRUE);
+        }else{
+        }
+    }
+    return(FALSE);
+}
+
+const void *HostTaskPendOn(INT8U prio) {
+    INT8U idx;
+
+    for(idx = 0; idx < hostNumTasks; idx++) {
+        if((hostTasks[idx].prio == prio) && (hostTasks[idx].state == HOST_PEND)) {
+            return(hostTasks[idx].pend_on);
+        }else{
+        }
+    }
+    return(0);
+}
+
+/*************************************************************************
+  HostCheck() - Prints a failed check with the tick it failed at
+*************************************************************************/
+INT8U HostCheck(INT8U ok, const char *file, int line, const char *fmt, ...) {
+    va_list args;
+
+    if(ok == FALSE) {
+        hostFails++;
+        printf("%s:%d: tick %u: ", file, line, hostTick);
+        va_start(args, fmt);
+        (void)vprintf(fmt, args);
+        va_end(args);
+        printf("\n");
+    }else{
+    }
+    return(ok);
+}
+
+INT32U HostFails(void) {
+    return(hostFails);
+}
+
+/*************************************************************************
+  Kernel and port
+*************************************************************************/
+void OSInit(OS_ERR *p_err) {
+    *p_err = OS_ERR_NONE;
+}
+
+void OS_CPU_SysTickInitFreq(CPU_INT32U cpu_freq) {
+    (void)cpu_freq;
+}
+
+void CPU_IntDis(void) {
+}
+
+void OSIntEnter(void) {
+}
+
+void OSIntExit(void) {
+}
+
+/*************************************************************************
+  OSStart() - Runs the highest priority ready task until HostStop()
+
+        With no task ready, time moves to the next tick. Ticks that
+        passed while a task was on the bus are taken first.
+*************************************************************************/
+void OSStart(OS_ERR *p_err) {
+    INT8U idx;
+    INT8S best;
+
+    *p_err = OS_ERR_NONE;
+    while(hostStopped == FALSE) {
+        while(HostNsGet() >= ((INT64U)(hostTick + 1u) * HOST_NS_PER_TICK)) {
+            hostTickRun();
+        }
+        best = -1;
+        for(idx = 0; idx < hostNumTasks; idx++) {
+            if((hostTasks[idx].state == HOST_RDY)
+               && ((best < 0) || (hostTasks[idx].prio < hostTasks[best].prio))) {
+                best = (INT8S)idx;
+            }else{
+            }
+        }
+        if(best < 0) {
+            hostNs = (INT64U)(hostTick + 1u) * HOST_NS_PER_TICK;
+        }else{
+            hostCur = best;
+            (void)swapcontext(&hostSchedCtx, &hostTasks[best].ctx);
+            hostCur = -1;
+        }
+    }
+}
+
+/*************************************************************************
+  hostTickRun() - One tick: the hook, then delays and timeouts
+*************************************************************************/
+static void hostTickRun(void) {
+    INT8U idx;
+    HOST_TASK *pt;
+
+    hostTick++;
+    if(hostNs < ((INT64U)hostTick * HOST_NS_PER_TICK)) {
+        hostNs = (INT64U)hostTick * HOST_NS_PER_TICK;
+    }else{
+    }
+    if(hostTickHook != 0) {
+        hostTickHook();
+    }else{
+    }
+    for(idx = 0; idx < hostNumTasks; idx++) {
+        pt = &hostTasks[idx];
+        if((pt->state == HOST_DLY) && (pt->wake == hostTick)) {
+            hostReady(idx);
+        }else if((pt->state == HOST_PEND) && (pt->wake != 0) && (pt->wake == hostTick)) {
+            pt->timed_out = TRUE;
+            hostReady(idx);
+        }else{
+        }
+    }
+}
+
+/*************************************************************************
+  Scheduling helpers
+*************************************************************************/
+static void hostSwitchOut(void) {
+    (void)swapcontext(&hostTasks[hostCur].ctx, &hostSchedCtx);
+}
+
+static void hostTaskEntry(int idx) {
+    hostTasks[idx].task(hostTasks[idx].arg);
+    hostTasks[idx].state = HOST_SUSPENDED;      /* Tasks must not return */
+    hostSwitchOut();
+}
+
+/* Switches away if a higher priority task is ready, not from the hook */
+static void hostPreempt(void) {
+    INT8U idx;
+
+    if(hostCur >= 0) {
+        for(idx = 0; idx < hostNumTasks; idx++) {
+            if((hostTasks[idx].state == HOST_RDY)
+               && (hostTasks[idx].prio < hostTasks[hostCur].prio)) {
+                hostSwitchOut();
+                return;
+            }else{
+            }
+        }
+    }else{
+    }
+}
+
+static void hostBlock(const void *obj, OS_TICK timeout) {
+    HOST_TASK *pt = &hostTasks[hostCur];
+
+    pt->state = HOST_PEND;
+    pt->pend_on = obj;
+    pt->timed_out = FALSE;
+    pt->wake = (timeout != 0) ? (hostTick + timeout) : 0;
+    hostSwitchOut();
+}
+
+/* Highest priority task pending on obj, -1 for none */
+static INT8S hostWaiter(const void *obj) {
+    INT8U idx;
+    INT8S best = -1;
+
+    for(idx = 0; idx < hostNumTasks; idx++) {
+        if((hostTasks[idx].state == HOST_PEND) && (hostTasks[idx].pend_on == obj)
+           && ((best < 0) || (hostTasks[idx].prio < hostTasks[best].prio))) {
+            best = (INT8S)idx;
+        }else{
+        }
+    }
+    return(best);
+}
+
+static void hostReady(INT8U idx) {
+    if(hostTasks[idx].state != HOST_RDY) {
+        hostTasks[idx].stats.wakes++;
+    }else{
+    }
+    hostTasks[idx].state = HOST_RDY;
+    hostTasks[idx].pend_on = 0;
+}
+
+/* A null TCB is the running task */
+static INT8U hostTaskIdx(const OS_TCB *p_tcb) {
+    return((p_tcb != 0) ? (INT8U)p_tcb->id : (INT8U)hostCur);
+}
+
+/*************************************************************************
+  Tasks
+*************************************************************************/
+void OSTaskCreate(OS_TCB *p_tcb, CPU_CHAR *p_name, OS_TASK_PTR p_task,
+                  void *p_arg, OS_PRIO prio, CPU_STK *p_stk_base,
+                  CPU_STK_SIZE stk_limit, CPU_STK_SIZE stk_size,
+                  OS_MSG_QTY q_size, OS_TICK time_quanta, void *p_ext,
+                  OS_OPT opt, OS_ERR *p_err) {
+    HOST_TASK *pt;
+
+    (void)p_name; (void)p_stk_base; (void)stk_limit; (void)stk_size;
+    (void)q_size; (void)time_quanta; (void)p_ext; (void)opt;
+    if(hostNumTasks >= HOST_MAX_TASKS) {
+        abort();
+    }else{
+    }
+    p_tcb->id = hostNumTasks;
+    pt = &hostTasks[hostNumTasks];
+    pt->tcb = p_tcb;
+    pt->task = p_task;
+    pt->arg = p_arg;
+    pt->prio = prio;
+    pt->state = HOST_RDY;
+    (void)getcontext(&pt->ctx);
+    pt->ctx.uc_stack.ss_sp = malloc(HOST_STK_SIZE);
+    pt->ctx.uc_stack.ss_size = HOST_STK_SIZE;
+    pt->ctx.uc_link = 0;
+    makecontext(&pt->ctx, (void (*)(void))hostTaskEntry, 1, (int)hostNumTasks);
+    hostNumTasks++;
+    *p_err = OS_ERR_NONE;
+    hostPreempt();
+}
+
+void OSTaskSuspend(OS_TCB *p_tcb, OS_ERR *p_err) {
+    INT8U idx = hostTaskIdx(p_tcb);
+
+    hostTasks[idx].state = HOST_SUSPENDED;
+    *p_err = OS_ERR_NONE;
+    if((INT8S)idx == hostCur) {
+        hostSwitchOut();
+    }else{
+    }
+}
+
+OS_SEM_CTR OSTaskSemPend(OS_TICK timeout, OS_OPT opt, CPU_TS *p_ts,
+                         OS_ERR *p_err) {
+    HOST_TASK *pt = &hostTasks[hostCur];
+
+    (void)p_ts;
+    *p_err = OS_ERR_NONE;
+    if(pt->sem_ctr != 0) {
+        pt->sem_ctr--;
+    }else if((opt & OS_OPT_PEND_NON_BLOCKING) != 0) {
+        *p_err = OS_ERR_PEND_WOULD_BLOCK;
+    }else{
+        hostBlock(pt, timeout);
+        if(pt->timed_out) {
+            *p_err = OS_ERR_TIMEOUT;
+        }else{
+        }
+    }
+    return(pt->sem_ctr);
+}
+
+OS_SEM_CTR OSTaskSemPost(OS_TCB *p_tcb, OS_OPT opt, OS_ERR *p_err) {
+    HOST_TASK *pt = &hostTasks[hostTaskIdx(p_tcb)];
+
+    (void)opt;
+    *p_err = OS_ERR_NONE;
+    pt->stats.sem_posts++;
+    if((pt->state == HOST_PEND) && (pt->pend_on == pt)) {
+        hostReady((INT8U)(pt - hostTasks));
+        hostPreempt();
+    }else{
+        pt->sem_ctr++;
+    }
+    return(pt->sem_ctr);
+}
+
+OS_SEM_CTR OSTaskSemSet(OS_TCB *p_tcb, OS_SEM_CTR cnt, OS_ERR *p_err) {
+    HOST_TASK *pt = &hostTasks[hostTaskIdx(p_tcb)];
+    OS_SEM_CTR prev = pt->sem_ctr;
+
+    pt->sem_ctr = cnt;
+    *p_err = OS_ERR_NONE;
+    return(prev);
+}
+
+/*************************************************************************
+  OSTimeDly() - Relative and periodic delays, as os_tick.c
+*************************************************************************/
+void OSTimeDly(OS_TICK dly, OS_OPT opt, OS_ERR *p_err) {
+    HOST_TASK *pt = &hostTasks[hostCur];
+    OS_TICK remain;
+
+    if(dly == 0) {
+        *p_err = OS_ERR_TIME_ZERO_DLY;
+        return;
+    }else{
+    }
+    if(opt == OS_OPT_TIME_PERIODIC) {
+        if((hostTick - pt->tick_ctr_prev) > dly) {
+            remain = dly;                       /* First time, load the base */
+            pt->tick_ctr_prev = hostTick + dly;
+        }else{
+            remain = dly - (hostTick - pt->tick_ctr_prev);
+            if((remain > OS_TICK_TH_RDY) || (remain == 0)) {
+                pt->tick_ctr_prev += dly + (dly * ((hostTick - pt->tick_ctr_prev) / dly));
+                *p_err = OS_ERR_TIME_ZERO_DLY;
+                return;
+            }else{
+            }
+            pt->tick_ctr_prev += dly;
+        }
+    }else{
+        remain = dly;
+    }
+    *p_err = OS_ERR_NONE;
+    pt->stats.dlys++;
+    pt->state = HOST_DLY;
+    pt->wake = hostTick + remain;
+    hostSwitchOut();
+}
+
+OS_TICK OSTimeGet(OS_ERR *p_err) {
+    *p_err = OS_ERR_NONE;
+    return(hostTick);
+}
+
+/*************************************************************************
+  Semaphores
+*************************************************************************/
+void OSSemCreate(OS_SEM *p_sem, CPU_CHAR *p_name, OS_SEM_CTR cnt,
+                 OS_ERR *p_err) {
+    (void)p_name;
+    p_sem->ctr = cnt;
+    *p_err = OS_ERR_NONE;
+}
+
+OS_SEM_CTR OSSemPend(OS_SEM *p_sem, OS_TICK timeout, OS_OPT opt,
+                     CPU_TS *p_ts, OS_ERR *p_err) {
+    (void)p_ts;
+    *p_err = OS_ERR_NONE;
+    if(p_sem->ctr != 0) {
+        p_sem->ctr--;
+    }else if((opt & OS_OPT_PEND_NON_BLOCKING) != 0) {
+        *p_err = OS_ERR_PEND_WOULD_BLOCK;
+    }else{
+        hostBlock(p_sem, timeout);
+        if(hostTasks[hostCur].timed_out) {
+            *p_err = OS_ERR_TIMEOUT;
+        }else{
+        }
+    }
+    return(p_sem->ctr);
+}
+
+OS_SEM_CTR OSSemPost(OS_SEM *p_sem, OS_OPT opt, OS_ERR *p_err) {
+    INT8S waiter = hostWaiter(p_sem);
+
+    (void)opt;
+    *p_err = OS_ERR_NONE;
+    if(waiter >= 0) {
+        hostReady((INT8U)waiter);
+        hostPreempt();
+    }else{
+        p_sem->ctr++;
+    }
+    return(p_sem->ctr);
+}
+
+void OSSemSet(OS_SEM *p_sem, OS_SEM_CTR cnt, OS_ERR *p_err) {
+    p_sem->ctr = cnt;
+    *p_err = OS_ERR_NONE;
+}
+
+/*************************************************************************
+  Mutexes, nested by the owner, handed to the highest waiter on release
+*************************************************************************/
+void OSMutexCreate(OS_MUTEX *p_mutex, CPU_CHAR *p_name, OS_ERR *p_err) {
+    (void)p_name;
+    p_mutex->owner = 0;
+    p_mutex->nesting = 0;
+    *p_err = OS_ERR_NONE;
+}
+
+void OSMutexPend(OS_MUTEX *p_mutex, OS_TICK timeout, OS_OPT opt,
+                 CPU_TS *p_ts, OS_ERR *p_err) {
+    HOST_TASK *pt = &hostTasks[hostCur];
+
+    (void)opt; (void)p_ts;
+    *p_err = OS_ERR_NONE;
+    if((p_mutex->owner == 0) || (p_mutex->owner == pt->tcb)) {
+        p_mutex->owner = pt->tcb;
+        p_mutex->nesting++;
+    }else{
+        hostBlock(p_mutex, timeout);    /* OSMutexPost() makes it the owner */
+        if(pt->timed_out) {
+            *p_err = OS_ERR_TIMEOUT;
+        }else{
+        }
+    }
+}
+
+void OSMutexPost(OS_MUTEX *p_mutex, OS_OPT opt, OS_ERR *p_err) {
+    INT8S waiter;
+
+    (void)opt;
+    *p_err = OS_ERR_NONE;
+    p_mutex->nesting--;
+    if(p_mutex->nesting == 0) {
+        waiter = hostWaiter(p_mutex);
+        if(waiter >= 0) {
+            p_mutex->owner = hostTasks[waiter].tcb;
+            p_mutex->nesting = 1;
+            hostReady((INT8U)waiter);
+            hostPreempt();
+        }else{
+            p_mutex->owner = 0;
+        }
+    }else{
+    }
+}
+
+/*************************************************************************
+  Event flags, only OS_OPT_PEND_FLAG_SET_ALL is used
+*************************************************************************/
+void OSFlagCreate(OS_FLAG_GRP *p_grp, CPU_CHAR *p_name, OS_FLAGS flags,
+                  OS_ERR *p_err) {
+    (void)p_name;
+    p_grp->flags = flags;
+    *p_err = OS_ERR_NONE;
+}
+
+OS_FLAGS OSFlagPend(OS_FLAG_GRP *p_grp, OS_FLAGS flags, OS_TICK timeout,
+                    OS_OPT opt, CPU_TS *p_ts, OS_ERR *p_err) {
+    (void)opt; (void)p_ts;
+    *p_err = OS_ERR_NONE;
+    while((p_grp->flags & flags) != flags) {
+        hostBlock(p_grp, timeout);
+        if(hostTasks[hostCur].timed_out) {
+            *p_err = OS_ERR_TIMEOUT;
+            return(0);
+        }else{
+        }
+    }
+    return(p_grp->flags & flags);
+}
+
+OS_FLAGS OSFlagPost(OS_FLAG_GRP *p_grp, OS_FLAGS flags, OS_OPT opt,
+                    OS_ERR *p_err) {
+    INT8U idx;
+
+    *p_err = OS_ERR_NONE;
+    if(opt == OS_OPT_POST_FLAG_CLR) {
+        p_grp->flags &= ~flags;
+    }else{
+        p_grp->flags |= flags;
+    }
+    for(idx = 0; idx < hostNumTasks; idx++) {   /* Pending tasks re-check */
+        if((hostTasks[idx].state == HOST_PEND) && (hostTasks[idx].pend_on == p_grp)) {
+            hostReady(idx);
+        }else{
+        }
+    }
+    hostPreempt();
+    return(p_grp->flags);
+}
+
+/*************************************************************************
+  OSStatTaskCPUUsageInit() - Takes the time the kernel's does, 2 ticks
+                             then a tenth of a second
+*************************************************************************/
+void OSStatTaskCPUUsageInit(OS_ERR *p_err) {
+    OSTimeDly(2u, OS_OPT_TIME_DLY, p_err);
+    OSTimeDly(OS_CFG_TICK_RATE_HZ / 10u, OS_OPT_TIME_DLY, p_err);
+}
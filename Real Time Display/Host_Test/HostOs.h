@@ -0,0 +1,68 @@
+/*************************************************************************
+* HostOs.h - Host test control of the HostOs.c kernel stand-in
+*
+*            HostOs.c runs the application's tasks on one Linux thread
+*            with uC/OS-III priority preemption and a virtual 1ms tick.
+*            A test sets a tick hook, creates its tasks and calls
+*            OSStart(), which returns once the test calls HostStop().
+*
+*            The hook is called at every tick before delayed tasks are
+*            readied, with no task running, the way a tick-rate timer
+*            interrupt would be. It is where a test plays scripted key
+*            presses and fires the RTC seconds interrupt. Services
+*            called from the hook ready tasks but never switch to them.
+*
+*            Time is virtual. The cycle counter, HostCycGet(), runs at
+*            180MHz and only advances with the ticks and with the bus
+*            time reported through the bus hook, so a run gives the
+*            same numbers every time on any host.
+*
+*            HostTaskStatsGet() returns the posts to a task's semaphore,
+*            the times it was readied after blocking and the delays it
+*            made, so a test can count wake-ups. HostTaskPendOn() gives
+*            the object a task is blocked on.
+*
+*            HostCheck() reports a failed test check and counts it, a
+*            test's main() returns HostFails() != 0.
+*
+* 10/18/2026 Initial version
+* 10/18/2026 Added the test checks
+* 10/18/2026 Added the task stats
+* 10/18/2026 Added HostTaskPendOn()
+*************************************************************************/
+#ifndef HOST_OS_DEF
+#define HOST_OS_DEF
+
+#define HOST_CPU_HZ 180000000u
+
+typedef struct{
+    INT32U sem_posts;           /* OSTaskSemPost() calls to the task    */
+    INT32U wakes;               /* Readied after a delay or a pend      */
+    INT32U dlys;                /* OSTimeDly() calls that blocked       */
+}HOST_TASK_STATS;
+
+void HostTickHookSet(void (*hook)(void));   /* Called at every tick      */
+
+void HostBusHookSet(INT64U (*bus_ns)(void)); /* Total bus time so far, ns */
+
+void HostStop(void);            /* OSStart() returns before the next task */
+
+INT32U HostTickGet(void);
+
+INT64U HostNsGet(void);         /* Virtual time, ns */
+
+INT32U HostCycGet(void);        /* Virtual cycle counter, HOST_CPU_HZ */
+
+INT8U HostTaskStatsGet(INT8U prio, HOST_TASK_STATS *stats);
+                                /* FALSE if no task has prio            */
+const void *HostTaskPendOn(INT8U prio);
+                                /* The semaphore, mutex, flag group or   */
+                                /* TCB task prio is blocked on, else 0  */
+
+#define HOST_CHECK(ok, ...) HostCheck((INT8U)((ok) != 0), __FILE__, __LINE__, __VA_ARGS__)
+
+INT8U HostCheck(INT8U ok, const char *file, int line, const char *fmt, ...);
+                                /* Prints fmt on failure, returns ok    */
+INT32U HostFails(void);         /* Failed checks so far */
+
+#endif
@@ -0,0 +1,143 @@
+/*************************************************************************
+* MCUType.h - Host stand-in for Sources/MCUType.h
+*
+*            The WWU types sized for a Linux host, and in place of
+*            MK65F18.h the few K65 registers and CMSIS calls that the
+*            host build of the board code touches. Registers are words
+*            in HostReg[] so the init code has somewhere to write.
+*
+*            The Makefile force-includes this file, so it is in before
+*            Sources/MCUType.h and that one compiles to nothing. For the
+*            same reason it stands in for CycCnt.h: the cycle counter
+*            is HostCycGet(), the HostOs.c virtual clock at 180MHz.
+*
+* 10/18/2026 Initial version
+* 10/18/2026 Added the keypad's PORTC registers
+*************************************************************************/
+#ifndef MCU_TYPE_PRESENT
+#define MCU_TYPE_PRESENT
+
+/*************************************************************************
+* Standard WWU type definitions
+*************************************************************************/
+typedef char                INT8C;
+typedef unsigned char       INT8U;
+typedef signed char         INT8S;
+typedef unsigned short      INT16U;
+typedef signed short        INT16S;
+typedef unsigned int        INT32U;
+typedef signed int          INT32S;
+typedef unsigned long long  INT64U;
+typedef signed long long    INT64S;
+typedef float               FP32;
+typedef double              FP64;
+
+#define FALSE    0
+#define TRUE     1
+
+/*************************************************************************
+* K65 registers used by K65TWR_GPIO.c, Time.c, KeyPortVirtual.c and
+* KeyPortK65.c
+*************************************************************************/
+typedef enum{
+    HOST_GPIOA_PSOR, HOST_GPIOA_PCOR, HOST_GPIOA_PTOR, HOST_GPIOA_PDDR,
+    HOST_GPIOA_PDIR, HOST_GPIOB_PSOR, HOST_GPIOB_PCOR, HOST_GPIOB_PTOR,
+    HOST_GPIOB_PDDR, HOST_GPIOC_PSOR, HOST_GPIOC_PCOR, HOST_GPIOC_PTOR,
+    HOST_GPIOC_PDDR, HOST_GPIOC_PDOR, HOST_GPIOC_PDIR, HOST_PORTA_ISFR, HOST_PORTA_PCR4, HOST_PORTA_PCR10,
+    HOST_PORTA_PCR26, HOST_PORTA_PCR28, HOST_PORTA_PCR29, HOST_PORTB_PCR20,
+    HOST_PORTB_PCR21, HOST_PORTB_PCR22, HOST_PORTB_PCR23, HOST_PORTC_PCR3,
+    HOST_PORTC_PCR4, HOST_PORTC_PCR5, HOST_PORTC_PCR6, HOST_PORTC_PCR7,
+    HOST_PORTC_PCR8, HOST_PORTC_PCR9, HOST_PORTC_PCR10, HOST_PORTC_PCR12,
+    HOST_PORTC_PCR13, HOST_PORTC_PCR14, HOST_PORTC_PCR15, HOST_PORTC_ISFR,
+    HOST_SIM_SCGC5, HOST_RTC_CR, HOST_RTC_IER, HOST_RTC_SR, HOST_RTC_TSR,
+    HOST_REG_NUM
+}HOST_REG;
+
+extern volatile INT32U HostReg[HOST_REG_NUM];
+
+#define GPIOA_PSOR  HostReg[HOST_GPIOA_PSOR]
+#define GPIOA_PCOR  HostReg[HOST_GPIOA_PCOR]
+#define GPIOA_PTOR  HostReg[HOST_GPIOA_PTOR]
+#define GPIOA_PDDR  HostReg[HOST_GPIOA_PDDR]
+#define GPIOA_PDIR  HostReg[HOST_GPIOA_PDIR]
+#define GPIOB_PSOR  HostReg[HOST_GPIOB_PSOR]
+#define GPIOB_PCOR  HostReg[HOST_GPIOB_PCOR]
+#define GPIOB_PTOR  HostReg[HOST_GPIOB_PTOR]
+#define GPIOB_PDDR  HostReg[HOST_GPIOB_PDDR]
+#define GPIOC_PSOR  HostReg[HOST_GPIOC_PSOR]
+#define GPIOC_PCOR  HostReg[HOST_GPIOC_PCOR]
+#define GPIOC_PTOR  HostReg[HOST_GPIOC_PTOR]
+#define GPIOC_PDDR  HostReg[HOST_GPIOC_PDDR]
+#define GPIOC_PDOR  HostReg[HOST_GPIOC_PDOR]
+#define GPIOC_PDIR  HostReg[HOST_GPIOC_PDIR]
+#define PORTA_ISFR  HostReg[HOST_PORTA_ISFR]
+#define PORTA_PCR4  HostReg[HOST_PORTA_PCR4]
+#define PORTA_PCR10 HostReg[HOST_PORTA_PCR10]
+#define PORTA_PCR26 HostReg[HOST_PORTA_PCR26]
+#define PORTA_PCR28 HostReg[HOST_PORTA_PCR28]
+#define PORTA_PCR29 HostReg[HOST_PORTA_PCR29]
+#define PORTB_PCR20 HostReg[HOST_PORTB_PCR20]
+#define PORTB_PCR21 HostReg[HOST_PORTB_PCR21]
+#define PORTB_PCR22 HostReg[HOST_PORTB_PCR22]
+#define PORTB_PCR23 HostReg[HOST_PORTB_PCR23]
+#define PORTC_PCR3  HostReg[HOST_PORTC_PCR3]
+#define PORTC_PCR4  HostReg[HOST_PORTC_PCR4]
+#define PORTC_PCR5  HostReg[HOST_PORTC_PCR5]
+#define PORTC_PCR6  HostReg[HOST_PORTC_PCR6]
+#define PORTC_PCR7  HostReg[HOST_PORTC_PCR7]
+#define PORTC_PCR8  HostReg[HOST_PORTC_PCR8]
+#define PORTC_PCR9  HostReg[HOST_PORTC_PCR9]
+#define PORTC_PCR10 HostReg[HOST_PORTC_PCR10]
+#define PORTC_PCR12 HostReg[HOST_PORTC_PCR12]
+#define PORTC_PCR13 HostReg[HOST_PORTC_PCR13]
+#define PORTC_PCR14 HostReg[HOST_PORTC_PCR14]
+#define PORTC_PCR15 HostReg[HOST_PORTC_PCR15]
+#define PORTC_ISFR  HostReg[HOST_PORTC_ISFR]
+#define SIM_SCGC5   HostReg[HOST_SIM_SCGC5]
+#define RTC_CR      HostReg[HOST_RTC_CR]
+#define RTC_IER     HostReg[HOST_RTC_IER]
+#define RTC_SR      HostReg[HOST_RTC_SR]
+#define RTC_TSR     HostReg[HOST_RTC_TSR]
+
+#define SIM_SCGC5_PORTA_MASK    0x0200u
+#define SIM_SCGC5_PORTB(x)      (((INT32U)(x) & 1u) << 10)
+#define SIM_SCGC5_PORTC(x)      (((INT32U)(x) & 1u) << 11)
+#define SIM_SCGC5_PORTC_MASK    0x0800u
+#define PORT_PCR_MUX(x)         (((INT32U)(x) & 7u) << 8)
+#define PORT_PCR_IRQC(x)        (((INT32U)(x) & 0xFu) << 16)
+#define PORT_PCR_IRQC_MASK      0xF0000u
+#define PORT_PCR_PE(x)          (((INT32U)(x) & 1u) << 1)
+#define PORT_PCR_PE_MASK        0x2u
+#define PORT_PCR_PS(x)          ((INT32U)(x) & 1u)
+#define PORT_PCR_PS_MASK        0x1u
+#define PORT_DFCR_CS_MASK       0x1u
+#define PORT_DFWR_FILT(x)       ((INT32U)(x) & 0x1Fu)
+#define RTC_CR_OSCE(x)          (((INT32U)(x) & 1u) << 8)
+#define RTC_IER_TSIE(x)         (((INT32U)(x) & 1u) << 4)
+#define RTC_SR_TCE_MASK         0x10u
+
+/*************************************************************************
+* CMSIS core and system calls. Interrupts are never masked on the host,
+* the tick hook only runs between tasks.
+*************************************************************************/
+#define RTC_Seconds_IRQn        0
+#define PORTC_IRQn              1
+#define NVIC_ClearPendingIRQ(irq)   ((void)(irq))
+#define NVIC_EnableIRQ(irq)         ((void)(irq))
+#define __get_PRIMASK()         0u
+#define __set_PRIMASK(x)        ((void)(x))
+#define __disable_irq()         do{}while(0)
+#define __CLZ(x)                ((INT8U)__builtin_clz(x))
+
+#define DEFAULT_SYSTEM_CLOCK    180000000u
+extern INT32U SystemCoreClock;
+
+/*************************************************************************
+* CycCnt.h - the cycle counter is the host's virtual clock
+*************************************************************************/
+#define CYC_CNT_H_
+INT32U HostCycGet(void);
+#define CYC_CNT_INIT() do{}while(0)
+#define CYC_CNT_GET() HostCycGet()
+
+#endif
@@ -0,0 +1,3 @@
+/* uCOSKey.c includes the board header as "k65TWR_GPIO.h", which only */
+/* finds Board/K65TWR_GPIO.h on a case-insensitive file system.       */
+#include "../../Board/K65TWR_GPIO.h"
@@ -0,0 +1,141 @@
+/*************************************************************************
+* os.h - Host stand-in for the uC/OS-III API used by the application
+*
+*            Only the types, options, error codes and services that the
+*            Board and Sources modules call. The values match
+*            uCOS-III/os.h where the code can see them. HostOs.c
+*            implements the services.
+*
+* 10/18/2026 Initial version
+*************************************************************************/
+#ifndef OS_H
+#define OS_H
+
+/*************************************************************************
+* uC/CPU and uC/LIB
+*************************************************************************/
+typedef char            CPU_CHAR;
+typedef unsigned short  CPU_INT16U;
+typedef unsigned int    CPU_INT32U;
+typedef CPU_INT32U      CPU_STK;
+typedef CPU_INT32U      CPU_STK_SIZE;
+typedef CPU_INT32U      CPU_TS;
+typedef CPU_INT32U      CPU_SR;
+
+#define DEF_DISABLED    0u
+#define DEF_ENABLED     1u
+
+/* Tasks never run during the tick hook, so there is nothing to mask */
+#define CPU_SR_ALLOC()          CPU_SR cpu_sr = 0u
+#define CPU_CRITICAL_ENTER()    ((void)cpu_sr)
+#define CPU_CRITICAL_EXIT()     ((void)cpu_sr)
+void CPU_IntDis(void);
+
+/*************************************************************************
+* Configuration, as os_cfg.h and os_cfg_app.h
+*************************************************************************/
+#define OS_CFG_TICK_RATE_HZ     1000u
+#define OS_CFG_STAT_TASK_EN     DEF_ENABLED
+#define OS_CFG_DBG_EN           DEF_ENABLED
+#define OS_CFG_STK_SIZE_MIN     64u
+
+/*************************************************************************
+* Types
+*************************************************************************/
+typedef CPU_INT16U      OS_OPT;
+typedef unsigned char   OS_PRIO;
+typedef CPU_INT32U      OS_TICK;
+typedef CPU_INT32U      OS_SEM_CTR;
+typedef CPU_INT32U      OS_FLAGS;
+typedef CPU_INT16U      OS_MSG_QTY;
+typedef CPU_INT16U      OS_CPU_USAGE;
+typedef CPU_INT32U      OS_RATE_HZ;
+typedef void (*OS_TASK_PTR)(void *p_arg);
+
+typedef enum{
+    OS_ERR_NONE             =     0u,
+    OS_ERR_PEND_WOULD_BLOCK = 25008u,
+    OS_ERR_TIME_ZERO_DLY    = 29310u,
+    OS_ERR_TIMEOUT          = 29401u
+}OS_ERR;
+
+typedef struct{                 /* Index into the HostOs.c task table   */
+    CPU_INT32U id;
+}OS_TCB;
+
+typedef struct{
+    OS_SEM_CTR ctr;
+}OS_SEM;
+
+typedef struct{
+    OS_TCB *owner;
+    CPU_INT32U nesting;
+}OS_MUTEX;
+
+typedef struct{
+    OS_FLAGS flags;
+}OS_FLAG_GRP;
+
+/*************************************************************************
+* Options
+*************************************************************************/
+#define OS_OPT_PEND_BLOCKING        (OS_OPT)(0x0000u)
+#define OS_OPT_PEND_NON_BLOCKING    (OS_OPT)(0x8000u)
+#define OS_OPT_PEND_FLAG_SET_ALL    (OS_OPT)(0x0004u)
+#define OS_OPT_POST_NONE            (OS_OPT)(0x0000u)
+#define OS_OPT_POST_1               (OS_OPT)(0x0000u)
+#define OS_OPT_POST_FLAG_SET        (OS_OPT)(0x0000u)
+#define OS_OPT_POST_FLAG_CLR        (OS_OPT)(0x0001u)
+#define OS_OPT_TASK_STK_CHK         (OS_OPT)(0x0001u)
+#define OS_OPT_TASK_STK_CLR         (OS_OPT)(0x0002u)
+#define OS_OPT_TIME_DLY             (OS_OPT)(0x0000u)
+#define OS_OPT_TIME_PERIODIC        (OS_OPT)(0x0008u)
+
+#define OS_TICK_TH_RDY              (OS_TICK)(0xFFFF0000u)
+
+/*************************************************************************
+* Services
+*************************************************************************/
+void OSInit(OS_ERR *p_err);
+void OSStart(OS_ERR *p_err);
+void OS_CPU_SysTickInitFreq(CPU_INT32U cpu_freq);
+void OSIntEnter(void);
+void OSIntExit(void);
+
+void OSTaskCreate(OS_TCB *p_tcb, CPU_CHAR *p_name, OS_TASK_PTR p_task,
+                  void *p_arg, OS_PRIO prio, CPU_STK *p_stk_base,
+                  CPU_STK_SIZE stk_limit, CPU_STK_SIZE stk_size,
+                  OS_MSG_QTY q_size, OS_TICK time_quanta, void *p_ext,
+                  OS_OPT opt, OS_ERR *p_err);
+void OSTaskSuspend(OS_TCB *p_tcb, OS_ERR *p_err);
+OS_SEM_CTR OSTaskSemPend(OS_TICK timeout, OS_OPT opt, CPU_TS *p_ts,
+                         OS_ERR *p_err);
+OS_SEM_CTR OSTaskSemPost(OS_TCB *p_tcb, OS_OPT opt, OS_ERR *p_err);
+OS_SEM_CTR OSTaskSemSet(OS_TCB *p_tcb, OS_SEM_CTR cnt, OS_ERR *p_err);
+
+void OSTimeDly(OS_TICK dly, OS_OPT opt, OS_ERR *p_err);
+OS_TICK OSTimeGet(OS_ERR *p_err);
+
+void OSSemCreate(OS_SEM *p_sem, CPU_CHAR *p_name, OS_SEM_CTR cnt,
+                 OS_ERR *p_err);
+OS_SEM_CTR OSSemPend(OS_SEM *p_sem, OS_TICK timeout, OS_OPT opt,
+                     CPU_TS *p_ts, OS_ERR *p_err);
+OS_SEM_CTR OSSemPost(OS_SEM *p_sem, OS_OPT opt, OS_ERR *p_err);
+void OSSemSet(OS_SEM *p_sem, OS_SEM_CTR cnt, OS_ERR *p_err);
+
+void OSMutexCreate(OS_MUTEX *p_mutex, CPU_CHAR *p_name, OS_ERR *p_err);
+void OSMutexPend(OS_MUTEX *p_mutex, OS_TICK timeout, OS_OPT opt,
+                 CPU_TS *p_ts, OS_ERR *p_err);
+void OSMutexPost(OS_MUTEX *p_mutex, OS_OPT opt, OS_ERR *p_err);
+
+void OSFlagCreate(OS_FLAG_GRP *p_grp, CPU_CHAR *p_name, OS_FLAGS flags,
+                  OS_ERR *p_err);
+OS_FLAGS OSFlagPend(OS_FLAG_GRP *p_grp, OS_FLAGS flags, OS_TICK timeout,
+                    OS_OPT opt, CPU_TS *p_ts, OS_ERR *p_err);
+OS_FLAGS OSFlagPost(OS_FLAG_GRP *p_grp, OS_FLAGS flags, OS_OPT opt,
+                    OS_ERR *p_err);
+
+extern OS_CPU_USAGE OSStatTaskCPUUsage;
+void OSStatTaskCPUUsageInit(OS_ERR *p_err);
+
+#endif
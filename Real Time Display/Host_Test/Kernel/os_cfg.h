@@ -0,0 +1,20 @@
+/*************************************************************************
+* os_cfg.h - The kernel configuration for the host kernel benchmarks
+*
+*            The benchmarks build the real uC/OS-III files against the
+*            real headers, with this directory ahead of uC-CFG so the
+*            options under test can be set from the command line. All
+*            other options are the target's.
+*
+* 10/18/2026 Initial version
+*************************************************************************/
+#include "../../Project_uCOS/uC-CFG/os_cfg.h"
+
+#ifdef HOST_TICK_WHEEL_EN
+#undef  OS_CFG_TICK_WHEEL_EN
+#define OS_CFG_TICK_WHEEL_EN HOST_TICK_WHEEL_EN
+#endif
+#ifdef HOST_TMR_WHEEL_EN
+#undef  OS_CFG_TMR_WHEEL_EN
+#define OS_CFG_TMR_WHEEL_EN HOST_TMR_WHEEL_EN
+#endif
@@ -0,0 +1,309 @@
+/*************************************************************************
+* KeyDebounceTest.c - Vertical counter debounce against scripted bounce
+*
+*            Runs uCOSKey.c under HostOs.c with KeyPortVirtual playing
+*            three scenes through KeyVirtScript():
+*
+*              5      a 2ms glitch, then a press and a release that
+*                     bounce for longer than a scan period
+*              * 6    * held clean while 6 bounces down and up
+*              1 2    1 and 2 held, then 4 goes down with them. The
+*                     scan reads 1 2 4 5, the ghost of a keypad with no
+*                     diodes, until 4 goes up again.
+*
+*            The tick hook logs every scan the key task makes, with the
+*            keys the script had down at that tick. Each event has to
+*            come from a scan that ends a run of exactly
+*            KEY_DEBOUNCE_SAMPLES scans agreeing with it, ghost scans
+*            left out, and the events have to be exactly the expected
+*            ones: no glitch press, nothing extra for * while 6 bounces
+*            and nothing for 4 or 5.
+*
+*            Built with the defaults. A scan after a wake through the
+*            column filter (KEY_HW_FILTER_MS) is taken as is, so that
+*            build would not pass.
+*
+* 10/18/2026 Initial version
+*************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "MCUType.h"
+#include "os.h"
+#include "app_cfg.h"
+#include "HostOs.h"
+#include "uCOSKey.h"
+#include "KeyPortVirtual.h"
+
+#define KD_START_MS     100u        /* Script loaded, key task idle       */
+#define KD_SCENE_GAP_MS 200u        /* All keys up between scenes         */
+#define KD_TAIL_MS      300u
+#define KD_MAX_STEPS    256u
+#define KD_MAX_SCANS    4096u
+#define KD_MAX_EVENTS   64u
+
+typedef struct{
+    INT32U tick;
+    INT16U keys;                    /* Keys the script had down           */
+    INT8U ghost;                    /* Counted in the ghosts stat         */
+}KD_SCAN;
+
+typedef struct{
+    INT8U code;
+    INT8U type;
+    INT16U keys;
+}KD_EXPECT;
+
+static const INT8C kdKeys[] = "123A456B789C*0#D";
+
+#define KD_BIT(c) ((INT16U)(1u << (strchr(kdKeys, (c)) - kdKeys)))
+#define KD_GHOST  (KD_BIT('1') | KD_BIT('2') | KD_BIT('4') | KD_BIT('5'))
+
+static KEY_VIRT_STEP kdScript[KD_MAX_STEPS];
+static INT32U kdStepTick[KD_MAX_STEPS];
+static INT16U kdNumSteps;
+static INT32U kdMs = KD_START_MS;
+static INT16U kdKeysDown;
+static INT32U kdEndMs;
+
+static KD_SCAN kdScans[KD_MAX_SCANS];
+static INT32U kdNumScans;
+static INT32U kdScansSeen;
+static INT32U kdGhostsSeen;
+static KEY_EVENT kdEvents[KD_MAX_EVENTS];
+static INT16U kdNumEvents;
+
+static OS_TCB kdTaskTCB;
+static CPU_STK kdTaskStk[APP_CFG_UITASK_STK_SIZE];
+
+static void kdBuild(void);
+static void kdBounce(INT16U gap, INT8U code, const char *contact);
+static void kdSet(INT16U gap, INT16U keys);
+static INT16U kdKeysAt(INT32U tick);
+static void kdTickHook(void);
+static void kdTask(void *p_arg);
+static void kdCheckEvents(void);
+static void kdCheckRun(const KEY_EVENT *event);
+
+/*************************************************************************
+  main() - Runs the script, then checks the events against the scans
+*************************************************************************/
+int main(void) {
+    OS_ERR os_err;
+
+    kdBuild();
+    OSInit(&os_err);
+    OSTaskCreate(&kdTaskTCB, "Key Debounce Test Task", kdTask, (void *)0,
+                 APP_CFG_UITASK_PRIO, &kdTaskStk[0], APP_CFG_UITASK_STK_SIZE / 10u,
+                 APP_CFG_UITASK_STK_SIZE, 0, 0, (void *)0,
+                 (OS_OPT)(OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR), &os_err);
+    HostTickHookSet(kdTickHook);
+    OSStart(&os_err);                   /* Returns once the hook stops it */
+
+    kdCheckEvents();
+    printf("KeyDebounceTest: %u scans, %u events, %u failed checks\n", kdNumScans,
+           kdNumEvents, HostFails());
+    return((HostFails() == 0) ? 0 : 1);
+}
+
+/*************************************************************************
+  kdBuild() - The three scenes. A contact string is the key's state,
+              1 closed or 0 open, for each ms, and ends settled.
+*************************************************************************/
+static void kdBuild(void) {
+    /* 5: a glitch, then bounce longer than a scan period each way */
+    kdBounce(KD_SCENE_GAP_MS, '5', "110");
+    kdBounce(100u, '5', "1101000000110111");
+    kdBounce(80u, '5', "0010000001101000");
+
+    /* * held through 6's bounce */
+    kdBounce(KD_SCENE_GAP_MS, '*', "1");
+    kdBounce(60u, '6', "1011000000011010001");
+    kdBounce(60u, '6', "0100000000110110");
+    kdBounce(60u, '*', "0");
+
+    /* 1 and 2 held, then the ghost while 4 is down */
+    kdBounce(KD_SCENE_GAP_MS, '1', "1");
+    kdBounce(60u, '2', "1");
+    kdSet(60u, KD_GHOST);
+    kdSet(60u, KD_BIT('1') | KD_BIT('2'));
+    kdSet(60u, 0);
+    kdEndMs = kdMs + KD_TAIL_MS;
+}
+
+/*************************************************************************
+  kdBounce() - code's contact, a ms per character, the first gap ms
+               after the last step. The other keys stay as they are.
+*************************************************************************/
+static void kdBounce(INT16U gap, INT8U code, const char *contact) {
+    INT8U cnt;
+    INT16U keys;
+
+    for(cnt = 0; contact[cnt] != '\0'; cnt++) {
+        if(contact[cnt] == '1') {
+            keys = kdKeysDown | KD_BIT(code);
+        }else{
+            keys = kdKeysDown & (INT16U)~KD_BIT(code);
+        }
+        kdSet((cnt == 0) ? gap : 1u, keys);
+    }
+}
+
+static void kdSet(INT16U gap, INT16U keys) {
+    kdMs += gap;
+    kdScript[kdNumSteps].ms = gap;
+    kdScript[kdNumSteps].keys = keys;
+    kdStepTick[kdNumSteps] = kdMs;
+    kdNumSteps++;
+    kdKeysDown = keys;
+}
+
+/*************************************************************************
+  kdKeysAt() - The keys the script has down at tick
+*************************************************************************/
+static INT16U kdKeysAt(INT32U tick) {
+    INT16U step;
+    INT16U keys = 0;
+
+    for(step = 0; (step < kdNumSteps) && (kdStepTick[step] <= tick); step++) {
+        keys = kdScript[step].keys;
+    }
+    return(keys);
+}
+
+/*************************************************************************
+  kdTickHook() - Logs the scans of the last tick, plays the script
+
+        The hook runs before any task at a tick, so scans it sees for
+        the first time were made at the tick before.
+*************************************************************************/
+static void kdTickHook(void) {
+    INT32U tick = HostTickGet();
+    KEY_STATS stats;
+    INT32U ghosts;
+
+    KeyStatsGet(&stats);
+    ghosts = stats.ghosts - kdGhostsSeen;
+    while((kdScansSeen < stats.scans) && (kdNumScans < KD_MAX_SCANS)) {
+        kdScans[kdNumScans].tick = tick - 1u;
+        kdScans[kdNumScans].keys = kdKeysAt(tick - 1u);
+        kdScans[kdNumScans].ghost = (INT8U)(ghosts != 0);
+        if(ghosts != 0) {
+            ghosts--;
+        }else{
+        }
+        kdNumScans++;
+        kdScansSeen++;
+    }
+    kdGhostsSeen = stats.ghosts;
+    if(tick == KD_START_MS) {
+        KeyVirtScript(kdScript, kdNumSteps);
+    }else if(tick > KD_START_MS) {
+        (void)KeyVirtScriptTick();
+    }else{
+    }
+    if(tick >= kdEndMs) {
+        HostStop();
+    }else{
+    }
+}
+
+/*************************************************************************
+  kdTask() - Reads every event
+*************************************************************************/
+static void kdTask(void *p_arg) {
+    OS_ERR os_err;
+    KEY_EVENT event;
+    (void)p_arg;
+
+    KeyInit();
+    while(1) {
+        KeyPendEvent(&event, 0, &os_err);
+        if((os_err == OS_ERR_NONE) && (kdNumEvents < KD_MAX_EVENTS)) {
+            kdEvents[kdNumEvents] = event;
+            kdNumEvents++;
+        }else{
+        }
+    }
+}
+
+/*************************************************************************
+  kdCheckEvents() - The events against the expected list, and each
+                    against the scans before it
+*************************************************************************/
+static void kdCheckEvents(void) {
+    static const KD_EXPECT expect[] = {
+        {'5', KEY_PRESS, 0x0020}, {'5', KEY_RELEASE, 0x0000},
+        {'*', KEY_PRESS, 0x1000}, {'6', KEY_PRESS, 0x1040},
+        {'6', KEY_RELEASE, 0x1000}, {'*', KEY_RELEASE, 0x0000},
+        {'1', KEY_PRESS, 0x0001}, {'2', KEY_PRESS, 0x0003},
+        {'1', KEY_RELEASE, 0x0002}, {'2', KEY_RELEASE, 0x0000}};
+    const INT16U num = sizeof(expect) / sizeof(expect[0]);
+    KEY_STATS stats;
+    INT32U scan, ghost_scans = 0;
+    INT16U cnt;
+
+    HOST_CHECK(kdNumScans < KD_MAX_SCANS, "scan log full");
+    HOST_CHECK(kdNumEvents == num, "%u events, expected %u", kdNumEvents, num);
+    for(cnt = 0; cnt < kdNumEvents; cnt++) {
+        if(cnt < num) {
+            HOST_CHECK((kdEvents[cnt].code == expect[cnt].code)
+                       && (kdEvents[cnt].type == expect[cnt].type)
+                       && (kdEvents[cnt].keys == expect[cnt].keys),
+                       "event %u: '%c' type %u keys 0x%04x at %u, expected '%c' type %u keys 0x%04x",
+                       cnt, kdEvents[cnt].code, kdEvents[cnt].type, kdEvents[cnt].keys,
+                       kdEvents[cnt].ts, expect[cnt].code, expect[cnt].type, expect[cnt].keys);
+        }else{
+        }
+        kdCheckRun(&kdEvents[cnt]);
+    }
+
+    /* Every scan of the ghost pattern ignored, and no other */
+    for(scan = 0; scan < kdNumScans; scan++) {
+        if(kdScans[scan].keys == KD_GHOST) {
+            ghost_scans++;
+            HOST_CHECK(kdScans[scan].ghost, "ghost scan at %u taken as a sample",
+                       kdScans[scan].tick);
+        }else{
+            HOST_CHECK(kdScans[scan].ghost == FALSE, "scan 0x%04x at %u taken for a ghost",
+                       kdScans[scan].keys, kdScans[scan].tick);
+        }
+    }
+    KeyStatsGet(&stats);
+    HOST_CHECK((ghost_scans != 0) && (stats.ghosts == ghost_scans),
+               "%u ghosts counted, %u ghost scans", stats.ghosts, ghost_scans);
+}
+
+/*************************************************************************
+  kdCheckRun() - The scan that made event has to end a run of exactly
+                 KEY_DEBOUNCE_SAMPLES scans with the key in its new
+                 state. Ghost scans are not samples and are skipped.
+*************************************************************************/
+static void kdCheckRun(const KEY_EVENT *event) {
+    INT16U bit = KD_BIT(event->code);
+    INT16U state = (event->type == KEY_PRESS) ? bit : 0;
+    INT32U scan = kdNumScans;
+    INT8U run = 0;
+    INT8U ended = FALSE;
+
+    while((scan != 0) && (kdScans[scan - 1u].tick > event->ts)) {
+        scan--;
+    }
+    if(!HOST_CHECK((scan != 0) && (kdScans[scan - 1u].tick == event->ts),
+                   "'%c' type %u at %u: no scan at that tick", event->code,
+                   event->type, event->ts)) {
+        return;
+    }else{
+    }
+    while((scan != 0) && (ended == FALSE)) {
+        scan--;
+        if(kdScans[scan].ghost) {
+        }else if((kdScans[scan].keys & bit) == state) {
+            run++;
+        }else{
+            ended = TRUE;
+        }
+    }
+    HOST_CHECK(run == KEY_DEBOUNCE_SAMPLES,
+               "'%c' type %u at %u: after %u stable scans, expected %u", event->code,
+               event->type, event->ts, run, KEY_DEBOUNCE_SAMPLES);
+}
@@ -0,0 +1,346 @@
+/*************************************************************************
+* KeyFilterTest.c - The column glitch filter against software debounce
+*
+*            Runs uCOSKey.c under HostOs.c with KeyPortVirtual playing
+*            three scenes on the 5 key:
+*
+*              glitch  pulses of 1 to KF_WIDTH_MS ms, all keys up
+*              clean   a press and a release with no bounce
+*              bounce  a press and a release that bounce for 7ms
+*
+*            With KEY_HW_FILTER_MS the port's DFER/DFCR/DFWR model has
+*            to be set up while the key task waits: every column enabled,
+*            the LPO clock and the width in DFWR, and DFER clear again
+*            while it scans. A glitch no longer than the width must not
+*            reach the column interrupt, so the key task does not wake,
+*            and a press sends its event the filter width after the
+*            contact settles.
+*
+*            Built with the defaults the filter stays off. Each glitch
+*            wakes the key task once and the scans throw it away, and a
+*            press takes KEY_DEBOUNCE_SAMPLES scans.
+*
+*            Both builds play the same script, "make test" runs both, so
+*            their press to event times can be read side by side.
+*
+* 10/18/2026 Initial version
+*************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "MCUType.h"
+#include "os.h"
+#include "app_cfg.h"
+#include "HostOs.h"
+#include "uCOSKey.h"
+#include "KeyPort.h"
+#include "KeyPortVirtual.h"
+
+#define KF_START_MS     100u        /* Script loaded, key task idle       */
+#define KF_SCENE_GAP_MS 200u        /* All keys up between scenes         */
+#define KF_GLITCH_GAP_MS 50u
+#define KF_HOLD_MS      200u
+#define KF_MAX_STEPS    64u
+#define KF_MAX_EVENTS   16u
+#define KF_NUM_SCENES   3u
+
+/* The longest glitch, the same in both builds */
+#if KEY_HW_FILTER_MS
+#define KF_WIDTH_MS     KEY_HW_FILTER_MS
+#else
+#define KF_WIDTH_MS     4u
+#endif
+
+/* A clean press without the filter, the first scan and the rest */
+#define KF_SOFT_MS      ((KEY_DEBOUNCE_SAMPLES - 1u) * KEY_RATE_ACTIVE_MS)
+
+#define KF_ALL_COLS     ((INT32U)((1u << KEY_NUM_COLS) - 1u))
+#define KF_NUM_EVENTS   4u          /* A press and a release, twice       */
+
+static const INT8C kfKeys[] = "123A456B789C*0#D";
+
+#define KF_BIT(c) ((INT16U)(1u << (strchr(kfKeys, (c)) - kfKeys)))
+
+typedef struct{
+    const char *name;
+    INT32U start;                   /* All keys up, the key task waiting  */
+    INT32U end;
+    INT32U press;                   /* First edge of the press, 0 if none */
+    INT32U closed;                  /* Contact settled closed             */
+    INT32U release;                 /* First edge of the release          */
+    INT32U opened;                  /* Contact settled open               */
+    INT8U glitches;
+    KEY_VIRT_STATS port;            /* Counted over the scene             */
+    INT32U wakes;                   /* Key task wake-ups over the scene   */
+}KF_SCENE;
+
+static KF_SCENE kfScenes[KF_NUM_SCENES];
+static KEY_VIRT_STEP kfScript[KF_MAX_STEPS];
+static INT16U kfNumSteps;
+static INT32U kfMs = KF_START_MS;
+static INT32U kfEndMs;
+
+static KEY_EVENT kfEvents[KF_MAX_EVENTS];
+static INT16U kfNumEvents;
+
+static OS_TCB kfTaskTCB;
+static CPU_STK kfTaskStk[APP_CFG_UITASK_STK_SIZE];
+
+static void kfBuild(void);
+static INT32U kfContact(INT16U gap, const char *contact);
+static void kfTickHook(void);
+static void kfCheckRegs(const char *name, INT8U waiting);
+static void kfTask(void *p_arg);
+static void kfCheckScene(const KF_SCENE *ps);
+static const KEY_EVENT *kfEventIn(const KF_SCENE *ps, INT8U type, INT16U *num);
+
+/*************************************************************************
+  main() - Runs the script, then checks each scene
+*************************************************************************/
+int main(void) {
+    OS_ERR os_err;
+    INT8U scene;
+
+    kfBuild();
+    OSInit(&os_err);
+    OSTaskCreate(&kfTaskTCB, "Key Filter Test Task", kfTask, (void *)0,
+                 APP_CFG_UITASK_PRIO, &kfTaskStk[0], APP_CFG_UITASK_STK_SIZE / 10u,
+                 APP_CFG_UITASK_STK_SIZE, 0, 0, (void *)0,
+                 (OS_OPT)(OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR), &os_err);
+    HostTickHookSet(kfTickHook);
+    OSStart(&os_err);                   /* Returns once the hook stops it */
+
+#if KEY_HW_FILTER_MS
+    printf("  column filter, %u LPO clocks\n", (INT32U)KEY_HW_FILTER_MS);
+#else
+    printf("  software debounce, %u scans %ums apart\n", (INT32U)KEY_DEBOUNCE_SAMPLES,
+           (INT32U)KEY_RATE_ACTIVE_MS);
+#endif
+    printf("  scene   press ms  release ms  irqs  wakes  glitches\n");
+    for(scene = 0; scene < KF_NUM_SCENES; scene++) {
+        kfCheckScene(&kfScenes[scene]);
+    }
+    HOST_CHECK(kfNumEvents == KF_NUM_EVENTS, "%u events, expected %u", kfNumEvents,
+               KF_NUM_EVENTS);
+    printf("KeyFilterTest: %u events, %u failed checks\n", kfNumEvents, HostFails());
+    return((HostFails() == 0) ? 0 : 1);
+}
+
+/*************************************************************************
+  kfBuild() - The three scenes. A contact string is the 5 key, 1 closed
+              or 0 open, for each ms, and ends settled.
+*************************************************************************/
+static void kfBuild(void) {
+    KF_SCENE *ps;
+    INT8U width;
+
+    ps = &kfScenes[0];
+    ps->name = "glitch";
+    ps->start = kfMs;
+    for(width = 1; width <= KF_WIDTH_MS; width++) {
+        (void)kfContact((width == 1) ? KF_SCENE_GAP_MS : KF_GLITCH_GAP_MS, "1");
+        (void)kfContact(width, "0");
+        ps->glitches++;
+    }
+
+    ps->end = kfMs + KF_SCENE_GAP_MS / 2u;
+    ps++;
+    ps->name = "clean";
+    ps->start = ps[-1].end;
+    ps->press = kfMs + KF_SCENE_GAP_MS;
+    ps->closed = kfContact(KF_SCENE_GAP_MS, "1");
+    ps->release = kfMs + KF_HOLD_MS;
+    ps->opened = kfContact(KF_HOLD_MS, "0");
+
+    ps->end = kfMs + KF_SCENE_GAP_MS / 2u;
+    ps++;
+    ps->name = "bounce";
+    ps->start = ps[-1].end;
+    ps->press = kfMs + KF_SCENE_GAP_MS;
+    ps->closed = kfContact(KF_SCENE_GAP_MS, "1101001");
+    ps->release = kfMs + KF_HOLD_MS;
+    ps->opened = kfContact(KF_HOLD_MS, "0010110");
+    ps->end = kfMs + KF_SCENE_GAP_MS / 2u;
+    kfEndMs = ps->end + 1u;
+}
+
+/*************************************************************************
+  kfContact() - The 5 key's contact, a ms per character, the first gap
+                ms after the last step. Returns the tick it settles.
+*************************************************************************/
+static INT32U kfContact(INT16U gap, const char *contact) {
+    INT8U cnt;
+    INT32U settled = 0;
+
+    for(cnt = 0; contact[cnt] != '\0'; cnt++) {
+        kfMs += (cnt == 0) ? gap : 1u;
+        kfScript[kfNumSteps].ms = (cnt == 0) ? gap : 1u;
+        kfScript[kfNumSteps].keys = (contact[cnt] == '1') ? KF_BIT('5') : 0;
+        if((cnt == 0) || (contact[cnt] != contact[cnt - 1u])) {
+            settled = kfMs;
+        }else{
+        }
+        kfNumSteps++;
+    }
+    return(settled);
+}
+
+/*************************************************************************
+  kfTickHook() - Plays the script, counts each scene and checks the
+                 filter registers while the key task waits and scans
+
+        A step is set and the LPO clocked at its tick before any task
+        runs, so an event at the tick a key settled took no time.
+*************************************************************************/
+static void kfTickHook(void) {
+    INT32U tick = HostTickGet();
+    HOST_TASK_STATS task;
+    KEY_VIRT_STATS port;
+    KF_SCENE *ps;
+
+    if(tick == KF_START_MS) {
+        KeyVirtScript(kfScript, kfNumSteps);
+    }else if(tick > KF_START_MS) {
+        (void)KeyVirtScriptTick();
+    }else{
+    }
+    (void)HostTaskStatsGet(APP_CFG_KEY_TASK_PRIO, &task);
+    KeyVirtStatsGet(&port);
+    for(ps = &kfScenes[0]; ps < &kfScenes[KF_NUM_SCENES]; ps++) {
+        if(tick == ps->start) {
+            kfCheckRegs(ps->name, TRUE);
+            ps->port = port;
+            ps->wakes = task.wakes;
+        }else if(tick == ps->end) {
+            ps->port.irqs = port.irqs - ps->port.irqs;
+            ps->port.glitches = port.glitches - ps->port.glitches;
+            ps->wakes = task.wakes - ps->wakes;
+        }else if((ps->press != 0) && (tick == (ps->closed + KF_HOLD_MS / 2u))) {
+            kfCheckRegs(ps->name, FALSE);
+        }else{
+        }
+    }
+    if(tick >= kfEndMs) {
+        HostStop();
+    }else{
+    }
+}
+
+/*************************************************************************
+  kfCheckRegs() - The filter is set up while the task waits for a key
+                  and off while it scans
+*************************************************************************/
+static void kfCheckRegs(const char *name, INT8U waiting) {
+    KEY_VIRT_REGS regs;
+
+    KeyVirtRegsGet(&regs);
+#if KEY_HW_FILTER_MS
+    HOST_CHECK(((regs.dfcr & PORT_DFCR_CS_MASK) != 0)
+               && (regs.dfwr == PORT_DFWR_FILT(KEY_HW_FILTER_MS)),
+               "%s: DFCR 0x%x DFWR %u, expected the LPO and %u", name, regs.dfcr, regs.dfwr,
+               (INT32U)KEY_HW_FILTER_MS);
+    if(waiting) {
+        HOST_CHECK(regs.dfer == KF_ALL_COLS, "%s: DFER 0x%x waiting, expected 0x%x", name,
+                   regs.dfer, KF_ALL_COLS);
+    }else{
+        HOST_CHECK(regs.dfer == 0, "%s: DFER 0x%x scanning, expected 0", name, regs.dfer);
+    }
+#else
+    (void)waiting;
+    HOST_CHECK(regs.dfer == 0, "%s: DFER 0x%x with no filter", name, regs.dfer);
+#endif
+}
+
+/*************************************************************************
+  kfTask() - Reads every event
+*************************************************************************/
+static void kfTask(void *p_arg) {
+    OS_ERR os_err;
+    KEY_EVENT event;
+    (void)p_arg;
+
+    KeyInit();
+    while(1) {
+        KeyPendEvent(&event, 0, &os_err);
+        if((os_err == OS_ERR_NONE) && (kfNumEvents < KF_MAX_EVENTS)) {
+            kfEvents[kfNumEvents] = event;
+            kfNumEvents++;
+        }else{
+        }
+    }
+}
+
+/*************************************************************************
+  kfCheckScene() - The scene's events, their latency and the wake-ups
+*************************************************************************/
+static void kfCheckScene(const KF_SCENE *ps) {
+    const KEY_EVENT *press;
+    const KEY_EVENT *release;
+    INT16U presses, releases;
+    INT32U press_ms = 0;
+    INT32U release_ms = 0;
+
+    press = kfEventIn(ps, KEY_PRESS, &presses);
+    release = kfEventIn(ps, KEY_RELEASE, &releases);
+    if(ps->press == 0) {
+        HOST_CHECK((presses == 0) && (releases == 0), "%s: %u presses %u releases", ps->name,
+                   presses, releases);
+#if KEY_HW_FILTER_MS
+        HOST_CHECK((ps->port.irqs == 0) && (ps->wakes == 0),
+                   "%s: %u interrupts %u wake-ups through the filter", ps->name,
+                   ps->port.irqs, ps->wakes);
+        HOST_CHECK(ps->port.glitches == ps->glitches, "%s: %u glitches filtered, expected %u",
+                   ps->name, ps->port.glitches, ps->glitches);
+#else
+        HOST_CHECK(ps->port.irqs == ps->glitches, "%s: %u interrupts, expected %u", ps->name,
+                   ps->port.irqs, ps->glitches);
+#endif
+    }else if(HOST_CHECK((presses == 1) && (releases == 1) && (press->ts < release->ts),
+                        "%s: %u presses %u releases", ps->name, presses, releases)) {
+        press_ms = press->ts - ps->press;
+        release_ms = release->ts - ps->release;
+#if KEY_HW_FILTER_MS
+        HOST_CHECK(press->ts == (ps->closed + KEY_HW_FILTER_MS),
+                   "%s: press at %u, expected the filter width after %u", ps->name,
+                   press->ts, ps->closed);
+        HOST_CHECK((press_ms - (ps->closed - ps->press)) < KF_SOFT_MS,
+                   "%s: press after %ums, no faster than software debounce", ps->name,
+                   press_ms);
+#else
+        if(ps->closed == ps->press) {
+            HOST_CHECK(press_ms == KF_SOFT_MS, "%s: press after %ums, expected %u", ps->name,
+                       press_ms, (INT32U)KF_SOFT_MS);
+        }else{
+        }
+#endif
+        HOST_CHECK(press->ts <= (ps->closed + KEY_DEBOUNCE_SAMPLES * KEY_RATE_ACTIVE_MS),
+                   "%s: press at %u, settled at %u", ps->name, press->ts, ps->closed);
+        HOST_CHECK(release->ts <= (ps->opened + KEY_RATE_HELD_MS
+                                   + KEY_DEBOUNCE_SAMPLES * KEY_RATE_ACTIVE_MS),
+                   "%s: release at %u, settled at %u", ps->name, release->ts, ps->opened);
+    }else{
+    }
+    printf("  %-6s  %8u  %10u  %4u  %5u  %8u\n", ps->name, press_ms, release_ms,
+           ps->port.irqs, ps->wakes, ps->port.glitches);
+}
+
+/*************************************************************************
+  kfEventIn() - The first event of type in the scene, and how many
+*************************************************************************/
+static const KEY_EVENT *kfEventIn(const KF_SCENE *ps, INT8U type, INT16U *num) {
+    const KEY_EVENT *first = (const KEY_EVENT *)0;
+    INT16U cnt;
+
+    *num = 0;
+    for(cnt = 0; cnt < kfNumEvents; cnt++) {
+        if((kfEvents[cnt].ts >= ps->start) && (kfEvents[cnt].ts < ps->end)
+           && (kfEvents[cnt].type == type) && (kfEvents[cnt].code == '5')) {
+            if(*num == 0) {
+                first = &kfEvents[cnt];
+            }else{
+            }
+            (*num)++;
+        }else{
+        }
+    }
+    return(first);
+}
@@ -0,0 +1,314 @@
+/*************************************************************************
+* KeyLatency.c - Keypress to glass latency of the whole application
+*
+*            Runs the real Lab2.c (its main() is built as AppMain()),
+*            uCOSKey.c, Screen.c, Time.c and LcdLayered.c under HostOs.c,
+*            with KeyPortVirtual playing a key script and LcdBusVirtual
+*            as the display. Each press is split into stages with the
+*            debug bit trace (DB_TRACE_EN), the same edges a scope on
+*            DB0-DB7 would show:
+*
+*              press -> key task awake    first DB1 on after the press
+*              awake -> accepting scan    last DB1 on before DB0 on
+*              scan -> UITask has key     DB0 on, KeyPend() returned
+*              UITask -> frame on glass   DB4 off, the LCD task is done
+*
+*            Usage: KeyLatency script.key
+*
+*            A script line is one press:
+*                gap key press_bounce hold release_bounce
+*            gap is the ms since the last line's key opened, key is one
+*            of "123A456B789C*0#D", and hold the ms closed. A bounce is
+*            the contact, 1 closed or 0 open, for each ms after the edge
+*            before it settles, or - for a clean edge. # starts a
+*            comment.
+*
+* 10/18/2026 Initial version
+*************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "MCUType.h"
+#include "os.h"
+#include "HostOs.h"
+#include "KeyPort.h"
+#include "KeyPortVirtual.h"
+#include "K65TWR_GPIO.h"
+#include "LcdBusVirtual.h"
+
+#define LAT_START_MS    600u        /* Boot done and the LCD powered up   */
+#define LAT_TAIL_MS     2000u       /* Run on after the last release      */
+#define LAT_MAX_PRESSES 2000u
+#define LAT_MAX_STEPS   (LAT_MAX_PRESSES * 24u)
+#define LAT_MAX_EDGES   (LAT_MAX_PRESSES * 64u)
+#define LAT_MAX_BOUNCE  8u
+#define LAT_LATE_NS     200000000ull    /* Not this press's frame         */
+
+typedef struct{
+    INT64U ns;
+    INT8U bit;
+    INT8U level;
+}LAT_EDGE;
+
+typedef enum{LAT_AWAKE, LAT_SCAN, LAT_UI, LAT_GLASS, LAT_TOTAL, LAT_STAGES}LAT_STAGE;
+
+void AppMain(void);                 /* Lab2.c main() */
+void RTC_Seconds_IRQHandler(void);
+
+static const INT8C latKeys[] = "123A456B789C*0#D";
+static const INT8C *const latStageNames[LAT_STAGES] = {
+    "press -> key task awake", "awake -> accepting scan",
+    "scan -> UITask has key", "UITask -> frame on glass", "press -> glass"};
+
+static KEY_VIRT_STEP latScript[LAT_MAX_STEPS];
+static INT16U latNumSteps;
+static INT64U latPressNs[LAT_MAX_PRESSES];
+static INT16U latNumPresses;
+static LAT_EDGE latEdges[LAT_MAX_EDGES];
+static INT32U latNumEdges;
+static INT32U latEdgesLost;         /* Past the end of latEdges[]         */
+static INT32U latEndMs;
+static INT64S latStage[LAT_STAGES][LAT_MAX_PRESSES];
+
+static INT8U latLoad(const char *path);
+static INT8U latAddBounce(const char *bounce, INT16U key_bit, INT16U settled);
+static void latAddStep(INT16U ms, INT16U keys);
+static void latTickHook(void);
+static void latDrain(void);
+static INT64U latBusNs(void);
+static INT16U latMeasure(INT16U *missed);
+static int latCmp(const void *a, const void *b);
+static void latReport(const char *name, INT64S *vals, INT16U num);
+
+/*************************************************************************
+  main() - Loads the script, runs the application over it and reports
+*************************************************************************/
+int main(int argc, char **argv) {
+    INT16U num, missed, stage;
+    INT8C glass[LCD_VIRT_ROWS][LCD_VIRT_COLS];
+
+    if((argc != 2) || (latLoad(argv[1]) == FALSE)) {
+        fprintf(stderr, "usage: KeyLatency script.key\n");
+        return(2);
+    }else{
+    }
+    HostBusHookSet(latBusNs);
+    HostTickHookSet(latTickHook);
+    AppMain();                          /* Returns once the hook stops it */
+
+    latEdgesLost += GpioDBugTraceLost();
+    num = latMeasure(&missed);
+    printf("%u presses, %u without a glass update, %u trace edges lost\n",
+           latNumPresses, missed, latEdgesLost);
+    if(num != 0) {
+        for(stage = 0; stage < LAT_STAGES; stage++) {
+            latReport(latStageNames[stage], latStage[stage], num);
+        }
+    }else{
+    }
+    LcdVirtGlassGet(glass);
+    printf("  glass at the end: [%.16s] [%.16s]\n", glass[0], glass[1]);
+    return(((num == latNumPresses) && (latEdgesLost == 0)) ? 0 : 1);
+}
+
+/*************************************************************************
+  latLoad() - Turns a key script into KeyVirtScript() steps
+*************************************************************************/
+static INT8U latLoad(const char *path) {
+    FILE *fp;
+    char line[128];
+    char key[4], press_bounce[LAT_MAX_BOUNCE + 2], release_bounce[LAT_MAX_BOUNCE + 2];
+    unsigned gap, hold;
+    const char *pos;
+    INT16U key_bit;
+    INT64U ms = LAT_START_MS;
+    INT8U ok = TRUE;
+
+    fp = fopen(path, "r");
+    if(fp == NULL) {
+        return(FALSE);
+    }else{
+    }
+    while(ok && (fgets(line, sizeof(line), fp) != NULL)) {
+        if((line[strspn(line, " \t\r\n")] == '\0') || (line[strspn(line, " \t")] == '#')) {
+            continue;
+        }else{
+        }
+        pos = NULL;
+        if(sscanf(line, "%u %3s %9s %u %9s", &gap, key, press_bounce, &hold, release_bounce) == 5) {
+            pos = strchr(latKeys, key[0]);
+        }else{
+        }
+        if((pos == NULL) || (key[1] != '\0') || (hold == 0) || (gap == 0)
+           || (latNumPresses >= LAT_MAX_PRESSES)) {
+            fprintf(stderr, "%s: bad line: %s", path, line);
+            ok = FALSE;
+        }else{
+            key_bit = (INT16U)(1u << (pos - latKeys));
+            ms += gap;
+            latPressNs[latNumPresses] = ms * 1000000ull;
+            latNumPresses++;
+            latAddStep((INT16U)gap, key_bit);
+            ms += latAddBounce(press_bounce, key_bit, key_bit);
+            latAddStep((INT16U)hold, 0);
+            ms += hold;
+            ms += latAddBounce(release_bounce, key_bit, 0);
+        }
+    }
+    (void)fclose(fp);
+    latEndMs = (INT32U)ms + LAT_TAIL_MS;
+    return(ok && (latNumPresses != 0));
+}
+
+/*************************************************************************
+  latAddBounce() - One step per bounce sample, then the settled state
+
+        Returns the ms added.
+*************************************************************************/
+static INT8U latAddBounce(const char *bounce, INT16U key_bit, INT16U settled) {
+    INT8U cnt = 0;
+
+    if(strcmp(bounce, "-") != 0) {
+        while(bounce[cnt] != '\0') {
+            latAddStep(1, (bounce[cnt] == '1') ? key_bit : 0);
+            cnt++;
+        }
+        latAddStep(1, settled);
+        cnt++;
+    }else{
+    }
+    return(cnt);
+}
+
+static void latAddStep(INT16U ms, INT16U keys) {
+    latScript[latNumSteps].ms = ms;
+    latScript[latNumSteps].keys = keys;
+    latNumSteps++;
+}
+
+/*************************************************************************
+  latTickHook() - The script, the RTC seconds interrupt and the trace
+*************************************************************************/
+static void latTickHook(void) {
+    INT32U tick = HostTickGet();
+
+    if(tick == LAT_START_MS) {
+        KeyVirtScript(latScript, latNumSteps);
+    }else if(tick > LAT_START_MS) {
+        (void)KeyVirtScriptTick();
+    }else{
+    }
+    if((tick % 1000u) == 0) {
+        RTC_Seconds_IRQHandler();
+    }else{
+    }
+    latDrain();
+    if(tick >= latEndMs) {
+        HostStop();
+    }else{
+    }
+}
+
+/*************************************************************************
+  latDrain() - Moves the trace into latEdges[], unwrapping the 32-bit
+               cycle count
+*************************************************************************/
+static void latDrain(void) {
+    static INT64U cyc_hi;
+    static INT32U cyc_last;
+    DB_TRACE_REC rec;
+
+    while(GpioDBugTraceRead(&rec)) {
+        if(rec.cyc < cyc_last) {
+            cyc_hi += 1ull << 32;
+        }else{
+        }
+        cyc_last = rec.cyc;
+        if(latNumEdges < LAT_MAX_EDGES) {
+            latEdges[latNumEdges].ns = ((cyc_hi | rec.cyc) * 1000u) / (HOST_CPU_HZ / 1000000u);
+            latEdges[latNumEdges].bit = rec.bit;
+            latEdges[latNumEdges].level = rec.level;
+            latNumEdges++;
+        }else{
+            latEdgesLost++;
+        }
+    }
+}
+
+static INT64U latBusNs(void) {
+    LCD_VIRT_STATS stats;
+
+    LcdVirtStatsGet(&stats);
+    return(stats.bus_ns);
+}
+
+/*************************************************************************
+  latMeasure() - Splits each press into stages from the edges
+
+        Returns the presses measured, *missed gets the ones with no
+        frame on the glass within LAT_LATE_NS.
+*************************************************************************/
+static INT16U latMeasure(INT16U *missed) {
+    INT16U press, num = 0;
+    INT32U edge = 0, cnt;
+    INT64U awake, scan, ui, glass, ns;
+
+    *missed = 0;
+    for(press = 0; press < latNumPresses; press++) {
+        ns = latPressNs[press];
+        awake = scan = ui = glass = 0;
+        while((edge < latNumEdges) && (latEdges[edge].ns < ns)) {
+            edge++;
+        }
+        for(cnt = edge; (cnt < latNumEdges) && (ui == 0); cnt++) {
+            if((latEdges[cnt].bit == 1u) && (latEdges[cnt].level == DB_TRACE_ON)) {
+                if(awake == 0) {
+                    awake = latEdges[cnt].ns;
+                }else{
+                }
+                scan = latEdges[cnt].ns;
+            }else if((latEdges[cnt].bit == 0u) && (latEdges[cnt].level == DB_TRACE_ON)
+                     && (awake != 0)) {
+                ui = latEdges[cnt].ns;
+            }else{
+            }
+        }
+        for(; (cnt < latNumEdges) && (glass == 0); cnt++) {
+            if((latEdges[cnt].bit == 4u) && (latEdges[cnt].level == DB_TRACE_OFF)) {
+                glass = latEdges[cnt].ns;
+            }else{
+            }
+        }
+        if((ui == 0) || (glass == 0) || ((glass - ns) > LAT_LATE_NS)) {
+            (*missed)++;
+        }else{
+            latStage[LAT_AWAKE][num] = (INT64S)(awake - ns);
+            latStage[LAT_SCAN][num] = (INT64S)(scan - awake);
+            latStage[LAT_UI][num] = (INT64S)(ui - scan);
+            latStage[LAT_GLASS][num] = (INT64S)(glass - ui);
+            latStage[LAT_TOTAL][num] = (INT64S)(glass - ns);
+            num++;
+        }
+    }
+    return(num);
+}
+
+static int latCmp(const void *a, const void *b) {
+    INT64S x = *(const INT64S *)a;
+    INT64S y = *(const INT64S *)b;
+
+    return((x < y) ? -1 : (x > y));
+}
+
+static void latReport(const char *name, INT64S *vals, INT16U num) {
+    INT64S sum = 0;
+    INT16U cnt;
+
+    qsort(vals, num, sizeof(vals[0]), latCmp);
+    for(cnt = 0; cnt < num; cnt++) {
+        sum += vals[cnt];
+    }
+    printf("  %-26s min %6.2f  mean %6.2f  p50 %6.2f  p95 %6.2f  max %6.2f ms\n",
+           name, vals[0] / 1e6, (sum / (double)num) / 1e6, vals[num / 2] / 1e6,
+           vals[(num * 95u) / 100u] / 1e6, vals[num - 1] / 1e6);
+}
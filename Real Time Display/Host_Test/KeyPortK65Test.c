@@ -0,0 +1,208 @@
+/*************************************************************************
+* KeyPortK65Test.c - The K65 key port's settle delay against a PORTC model
+*
+*            Runs KeyPortK65.c itself, on the host registers, with a
+*            model of the keypad behind GPIOC. The cycle counter is the
+*            HostOs.c virtual clock, and every read of it is one pass of
+*            a wait loop, KP_PASS_NS. A column pulled low falls straight
+*            away, a column let go by its row rises over the phase's
+*            rise time, so the row scanned after the key's row reads the
+*            key until it has.
+*
+*            Each phase scans like keyScan(), a key in row 1 then row 2
+*            then row 1 and so on, and counts the scans that read wrong:
+*
+*              fast   100ns rise
+*              slow   600ns, slower than the fast wait, still under
+*                     KEY_SETTLE_NS
+*              fast   100ns again
+*
+*            Built with the defaults the wait is always KEY_SETTLE_NS
+*            and no scan may read wrong. With KEY_SETTLE_ADAPT_EN the
+*            wait has to come down in the first phase, find the slower
+*            column at the next full width round and go back up, and
+*            only come down again after a round of KEY_SETTLE_SEEN
+*            changes.
+*
+* 10/18/2026 Initial version
+*************************************************************************/
+#include <stdio.h>
+#include "MCUType.h"
+#include "os.h"
+#include "HostOs.h"
+#include "KeyPort.h"
+
+#define KP_PASS_NS      33u         /* One wait loop pass, 6 clocks       */
+#define KP_GAP_NS       2000u       /* Between scans, rows released       */
+#define KP_SCANS        600u        /* Per phase                          */
+#define KP_COLS_SHIFT   3           /* COL1 is PTC3, ROW1 is PTC7         */
+#define KP_ROWS_SHIFT   7
+
+/* KeyPortK65.c's KEY_SETTLE_SEEN and KEY_SETTLE_RECHECK, one change is
+   seen per scan here and a scan is a settle per row */
+#define KP_SEEN_SCANS   32u
+#define KP_RECHECK_SCANS (1024u / KEY_NUM_ROWS)
+
+#define KP_SCAN_NS      (KEY_NUM_ROWS * KEY_SETTLE_NS)  /* A full width scan */
+
+typedef struct{
+    const char *name;
+    INT32U rise_ns;
+    INT32U bad;                     /* Scans that read the wrong keys     */
+    INT32U last_bad;                /* Scans up to the last bad one       */
+    INT32U full;                    /* Scans that waited the full width   */
+    INT32U first_low;               /* First scan under the full width    */
+    INT64U settle_ns;
+    INT32U min_ns;                  /* Settle time of the quickest scan   */
+    INT32U last_ns;                 /* and of the last one                */
+}KP_PHASE;
+
+static KP_PHASE kpPhases[] = {
+    {"fast", 100u}, {"slow", 600u}, {"fast", 100u}};
+
+#define KP_NUM_PHASES (sizeof(kpPhases) / sizeof(kpPhases[0]))
+
+static INT64U kpNs;                 /* Model time                         */
+static INT32U kpRiseNs;
+static INT16U kpKeys;               /* Bit (row * 4) + col, as KeyVirtSet */
+static INT8U kpRows;                /* Rows driven at the last change     */
+static INT8U kpCols;                /* Columns low now                    */
+static INT8U kpColsWas;             /* Columns low at the last row change */
+static INT64U kpChangeNs;
+
+static void kpPhase(KP_PHASE *pp);
+static void kpCheck(const KP_PHASE *pp, INT8U phase);
+static void kpUpdate(void);
+static INT64U kpBusNs(void);
+
+/*************************************************************************
+  main() - Runs the phases against the model
+*************************************************************************/
+int main(void) {
+    INT8U phase;
+
+    HostBusHookSet(kpBusNs);
+    KeyPortK65.Init();
+    printf("  KEY_SETTLE_ADAPT_EN %u, KEY_SETTLE_NS %u\n", (INT32U)KEY_SETTLE_ADAPT_EN,
+           (INT32U)KEY_SETTLE_NS);
+    printf("  phase  rise ns  bad scans  full scans  ns per scan  quickest scan ns\n");
+    for(phase = 0; phase < KP_NUM_PHASES; phase++) {
+        kpPhase(&kpPhases[phase]);
+        kpCheck(&kpPhases[phase], phase);
+    }
+    printf("KeyPortK65Test: %u scans, %u failed checks\n",
+           (INT32U)(KP_NUM_PHASES * KP_SCANS), HostFails());
+    return((HostFails() == 0) ? 0 : 1);
+}
+
+/*************************************************************************
+  kpPhase() - KP_SCANS scans the way keyScan() makes them
+*************************************************************************/
+static void kpPhase(KP_PHASE *pp) {
+    INT32U scan, settle;
+    INT16U keys;
+    INT8U row;
+
+    kpRiseNs = pp->rise_ns;
+    pp->first_low = KP_SCANS;
+    pp->min_ns = KP_SCAN_NS;
+    for(scan = 0; scan < KP_SCANS; scan++) {
+        kpKeys = ((scan & 1u) == 0) ? 0x0001u : 0x0010u;
+        keys = 0;
+        settle = 0;
+        for(row = 0; row < KEY_NUM_ROWS; row++) {
+            KeyPortK65.Rows((INT8U)(1u << row));
+            settle += KeyPortK65.Settle();
+            keys |= (INT16U)(KeyPortK65.Cols() << (row * KEY_NUM_COLS));
+        }
+        KeyPortK65.Rows(0);
+        kpNs += KP_GAP_NS;
+        kpUpdate();
+        if(keys != kpKeys) {
+            pp->bad++;
+            pp->last_bad = scan + 1u;
+        }else{
+        }
+        if(settle >= KP_SCAN_NS) {
+            pp->full++;
+        }else if(pp->first_low == KP_SCANS) {
+            pp->first_low = scan;
+        }else{
+        }
+        if(settle < pp->min_ns) {
+            pp->min_ns = settle;
+        }else{
+        }
+        pp->settle_ns += settle;
+        pp->last_ns = settle;
+    }
+    printf("  %-5s  %7u  %9u  %10u  %11u  %16u\n", pp->name, pp->rise_ns, pp->bad, pp->full,
+           (INT32U)(pp->settle_ns / KP_SCANS), pp->min_ns);
+}
+
+/*************************************************************************
+  kpCheck() - What each phase has to come to
+*************************************************************************/
+static void kpCheck(const KP_PHASE *pp, INT8U phase) {
+#if KEY_SETTLE_ADAPT_EN
+    if(phase == 1u) {
+        HOST_CHECK(pp->last_bad <= KP_RECHECK_SCANS,
+                   "%s %u: bad scans up to scan %u, the wait was widened by %u", pp->name,
+                   phase, pp->last_bad, KP_RECHECK_SCANS);
+        HOST_CHECK(pp->last_ns >= KP_SCAN_NS, "%s %u: last scan %uns, expected the full %u",
+                   pp->name, phase, pp->last_ns, KP_SCAN_NS);
+    }else{
+        HOST_CHECK(pp->bad == 0, "%s %u: %u bad scans", pp->name, phase, pp->bad);
+        HOST_CHECK(pp->min_ns < (KP_SCAN_NS / 2u), "%s %u: quickest scan %uns, no wait came down",
+                   pp->name, phase, pp->min_ns);
+        HOST_CHECK(pp->first_low >= (KP_SEEN_SCANS - 1u),
+                   "%s %u: came down at scan %u, before a round of %u changes", pp->name,
+                   phase, pp->first_low, KP_SEEN_SCANS);
+    }
+#else
+    HOST_CHECK(pp->bad == 0, "%s %u: %u bad scans", pp->name, phase, pp->bad);
+    HOST_CHECK(pp->full == KP_SCANS, "%s %u: %u of %u scans waited KEY_SETTLE_NS", pp->name,
+               phase, pp->full, KP_SCANS);
+#endif
+}
+
+/*************************************************************************
+  kpUpdate() - Sets GPIOC_PDIR from the rows driven and the keys down
+
+        Columns let go by a row change stay low for the rise time.
+*************************************************************************/
+static void kpUpdate(void) {
+    INT8U rows, row, want;
+
+    rows = (INT8U)((GPIOC_PDDR >> KP_ROWS_SHIFT) & KEY_ALL_ROWS);
+    if(rows != kpRows) {
+        kpRows = rows;
+        kpColsWas = kpCols;
+        kpChangeNs = kpNs;
+    }else{
+    }
+    want = 0;
+    for(row = 0; row < KEY_NUM_ROWS; row++) {
+        if((rows & (1u << row)) != 0) {
+            want |= (INT8U)((kpKeys >> (row * KEY_NUM_COLS)) & 0x0f);
+        }else{
+        }
+    }
+    kpCols = want;
+    if((kpNs - kpChangeNs) < kpRiseNs) {
+        kpCols |= kpColsWas;
+    }else{
+    }
+    GPIOC_PDIR = ~((INT32U)kpCols << KP_COLS_SHIFT);
+}
+
+/* Each cycle counter read is a loop pass */
+static INT64U kpBusNs(void) {
+    kpNs += KP_PASS_NS;
+    kpUpdate();
+    return(kpNs);
+}
+
+/* KeyPortK65.c's interrupt handler calls it, the test never arms it */
+void KeyColIrq(void) {
+}
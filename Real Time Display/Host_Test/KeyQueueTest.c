@@ -0,0 +1,309 @@
+/*************************************************************************
+* KeyQueueTest.c - Key event queue under bursts the reader can't keep up
+*                  with
+*
+*            Runs uCOSKey.c under HostOs.c with KeyPortVirtual playing
+*            three bursts of bouncing presses, each key a different one
+*            so the order can be checked:
+*
+*              A  the reader takes one event every KQ_READ_MS, slower
+*                 than the keys come, but the queue never fills
+*              B  the reader sleeps through more presses than the queue
+*                 holds, then drains it
+*              C  one press once the queue is empty again
+*
+*            Every event has to come out of KeyPendEvent() in press
+*            order, a press before its release, with the keys down and
+*            a timestamp between the scripted edge and KQ_LATE_MS after
+*            it. In B the presses past a full queue are dropped with no
+*            release, and the stats have to count them.
+*
+* 10/18/2026 Initial version
+*************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "MCUType.h"
+#include "os.h"
+#include "app_cfg.h"
+#include "HostOs.h"
+#include "uCOSKey.h"
+#include "KeyPortVirtual.h"
+
+#define KQ_START_MS     100u        /* Script loaded, key task idle       */
+#define KQ_GAP_MS       30u         /* Open between presses               */
+#define KQ_HOLD_MS      30u         /* Closed after the bounce            */
+#define KQ_BURST_GAP_MS 1500u       /* Between bursts                     */
+#define KQ_READ_MS      50u         /* Reader's pace in burst A           */
+#define KQ_TOUT_MS      (2u * KQ_BURST_GAP_MS)  /* An event that never comes */
+#define KQ_A_PRESSES    8u
+#define KQ_B_PRESSES    ((KEY_QUEUE_SIZE / 2u) + 4u)
+#define KQ_B_KEPT       (KEY_QUEUE_SIZE / 2u)   /* Press and release pairs */
+#define KQ_MAX_PRESSES  (KQ_A_PRESSES + KQ_B_PRESSES + 1u)
+#define KQ_MAX_STEPS    (KQ_MAX_PRESSES * 8u)
+
+/* Contact bounce after each edge, 1 closed, 0 open, a ms each */
+#define KQ_PRESS_BOUNCE   "010"
+#define KQ_RELEASE_BOUNCE "1"
+#define KQ_BOUNCE_MS    4u          /* Longest bounce plus its settle ms  */
+
+/* Latest scan that can verify an edge: a held scan period to see it,  */
+/* then the debounce                                                   */
+#define KQ_LATE_MS      (KQ_BOUNCE_MS + KEY_RATE_HELD_MS \
+                         + (KEY_DEBOUNCE_SAMPLES * KEY_RATE_ACTIVE_MS))
+
+typedef struct{
+    INT8U code;
+    INT32U press_ms;                /* Ticks of the first closed and open */
+    INT32U release_ms;
+}KQ_PRESS;
+
+typedef enum{KQ_BURST_A, KQ_BURST_B, KQ_BURST_C, KQ_BURSTS}KQ_BURST;
+
+static const INT8C kqKeys[] = "123A456B789C*0#D";
+static const INT8C kqOrder[] = "1234567890*#";   /* Keys pressed, in turn */
+
+static KEY_VIRT_STEP kqScript[KQ_MAX_STEPS];
+static INT16U kqNumSteps;
+static KQ_PRESS kqPresses[KQ_MAX_PRESSES];
+static INT16U kqNumPresses;
+static INT16U kqFirst[KQ_BURSTS + 1];   /* First press of each burst      */
+static INT32U kqEnd[KQ_BURSTS];         /* Tick the last key of a burst settles */
+static INT32U kqTimeoutMs;
+static INT8U kqDone;
+
+static OS_TCB kqTaskTCB;
+static CPU_STK kqTaskStk[APP_CFG_UITASK_STK_SIZE];
+
+static void kqBuild(void);
+static INT32U kqAddPress(INT32U ms, INT16U gap);
+static INT8U kqAddBounce(const char *bounce, INT16U key_bit, INT16U settled);
+static void kqAddStep(INT16U ms, INT16U keys);
+static void kqTickHook(void);
+static void kqTask(void *p_arg);
+static void kqSleepPast(INT32U tick);
+static INT8U kqRead(INT16U press, INT8U type);
+static INT16U kqBit(INT8U code);
+
+/*************************************************************************
+  main() - Builds the script and runs the reader until it is done
+*************************************************************************/
+int main(void) {
+    OS_ERR os_err;
+
+    kqBuild();
+    OSInit(&os_err);
+    OSTaskCreate(&kqTaskTCB, "Key Queue Test Task", kqTask, (void *)0,
+                 APP_CFG_UITASK_PRIO, &kqTaskStk[0], APP_CFG_UITASK_STK_SIZE / 10u,
+                 APP_CFG_UITASK_STK_SIZE, 0, 0, (void *)0,
+                 (OS_OPT)(OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR), &os_err);
+    HostTickHookSet(kqTickHook);
+    OSStart(&os_err);                   /* Returns once the test stops it */
+
+    HOST_CHECK(kqDone, "reader did not finish by tick %u", kqTimeoutMs);
+    printf("KeyQueueTest: %u presses, %u failed checks\n", kqNumPresses, HostFails());
+    return((HostFails() == 0) ? 0 : 1);
+}
+
+/*************************************************************************
+  kqBuild() - The three bursts, KQ_BURST_GAP_MS apart
+*************************************************************************/
+static void kqBuild(void) {
+    INT32U ms = KQ_START_MS;
+    INT16U press;
+    INT16U num[KQ_BURSTS] = {KQ_A_PRESSES, KQ_B_PRESSES, 1u};
+    KQ_BURST burst;
+
+    for(burst = KQ_BURST_A; burst < KQ_BURSTS; burst++) {
+        kqFirst[burst] = kqNumPresses;
+        for(press = 0; press < num[burst]; press++) {
+            ms = kqAddPress(ms, (press == 0) ? KQ_BURST_GAP_MS : KQ_GAP_MS);
+        }
+        kqEnd[burst] = ms;
+    }
+    kqFirst[KQ_BURSTS] = kqNumPresses;
+    kqTimeoutMs = ms + KQ_BURST_GAP_MS;
+}
+
+/*************************************************************************
+  kqAddPress() - One press of the next key in kqOrder[], gap ms after
+                 ms, with bounce on both edges
+
+        Returns the tick the release settles.
+*************************************************************************/
+static INT32U kqAddPress(INT32U ms, INT16U gap) {
+    KQ_PRESS *pp = &kqPresses[kqNumPresses];
+    INT16U key_bit;
+
+    pp->code = (INT8U)kqOrder[kqNumPresses % (sizeof(kqOrder) - 1u)];
+    key_bit = kqBit(pp->code);
+    ms += gap;
+    pp->press_ms = ms;
+    kqAddStep(gap, key_bit);
+    ms += kqAddBounce(KQ_PRESS_BOUNCE, key_bit, key_bit);
+    ms += KQ_HOLD_MS;
+    pp->release_ms = ms;
+    kqAddStep(KQ_HOLD_MS, 0);
+    ms += kqAddBounce(KQ_RELEASE_BOUNCE, key_bit, 0);
+    kqNumPresses++;
+    return(ms);
+}
+
+/*************************************************************************
+  kqAddBounce() - One step per bounce ms, then the settled state
+
+        Returns the ms added.
+*************************************************************************/
+static INT8U kqAddBounce(const char *bounce, INT16U key_bit, INT16U settled) {
+    INT8U cnt;
+
+    for(cnt = 0; bounce[cnt] != '\0'; cnt++) {
+        kqAddStep(1, (bounce[cnt] == '1') ? key_bit : 0);
+    }
+    kqAddStep(1, settled);
+    return((INT8U)(cnt + 1u));
+}
+
+static void kqAddStep(INT16U ms, INT16U keys) {
+    kqScript[kqNumSteps].ms = ms;
+    kqScript[kqNumSteps].keys = keys;
+    kqNumSteps++;
+}
+
+/*************************************************************************
+  kqTickHook() - Plays the script, stops the run when the reader is
+                 done or stuck
+*************************************************************************/
+static void kqTickHook(void) {
+    INT32U tick = HostTickGet();
+
+    if(tick == KQ_START_MS) {
+        KeyVirtScript(kqScript, kqNumSteps);
+    }else if(tick > KQ_START_MS) {
+        (void)KeyVirtScriptTick();
+    }else{
+    }
+    if(kqDone || (tick >= kqTimeoutMs)) {
+        HostStop();
+    }else{
+    }
+}
+
+/*************************************************************************
+  kqTask() - The reader
+*************************************************************************/
+static void kqTask(void *p_arg) {
+    OS_ERR os_err;
+    KEY_STATS stats;
+    KEY_EVENT event;
+    INT16U press;
+    INT8U ok = TRUE;
+    (void)p_arg;
+
+    KeyInit();
+
+    /* A: reads slower than the keys come, nothing is dropped */
+    for(press = kqFirst[KQ_BURST_A]; ok && (press < kqFirst[KQ_BURST_B]); press++) {
+        ok = kqRead(press, KEY_PRESS);
+        OSTimeDly(KQ_READ_MS, OS_OPT_TIME_DLY, &os_err);
+        ok = ok && kqRead(press, KEY_RELEASE);
+        OSTimeDly(KQ_READ_MS, OS_OPT_TIME_DLY, &os_err);
+    }
+    KeyStatsGet(&stats);
+    HOST_CHECK(stats.events == (2u * KQ_A_PRESSES), "A: %u events queued", stats.events);
+    HOST_CHECK(stats.overflows == 0, "A: %u overflows", stats.overflows);
+    HOST_CHECK((stats.max_depth > 1u) && (stats.max_depth < KEY_QUEUE_SIZE),
+               "A: max depth %u, the reader should fall behind without a drop",
+               stats.max_depth);
+    printf("A: %u presses, reader %u events behind at most\n", KQ_A_PRESSES,
+           stats.max_depth);
+
+    /* B: nothing read until the burst is over, the first presses are */
+    /* kept whole and the rest dropped with no release                */
+    if(ok) {
+        kqSleepPast(kqEnd[KQ_BURST_B] + KQ_LATE_MS);
+        KeyStatsGet(&stats);
+        HOST_CHECK(stats.events == ((2u * KQ_A_PRESSES) + KEY_QUEUE_SIZE),
+                   "B: %u events queued", stats.events);
+        HOST_CHECK(stats.overflows == (KQ_B_PRESSES - KQ_B_KEPT),
+                   "B: %u overflows, %u presses had no room", stats.overflows,
+                   KQ_B_PRESSES - KQ_B_KEPT);
+        HOST_CHECK(stats.max_depth == KEY_QUEUE_SIZE, "B: max depth %u", stats.max_depth);
+        printf("B: %u presses unread, %u events queued, %u dropped\n", KQ_B_PRESSES,
+               stats.events - (2u * KQ_A_PRESSES), stats.overflows);
+        for(press = kqFirst[KQ_BURST_B]; ok && (press < (kqFirst[KQ_BURST_B] + KQ_B_KEPT)); press++) {
+            ok = kqRead(press, KEY_PRESS) && kqRead(press, KEY_RELEASE);
+        }
+        KeyPendEvent(&event, 100u, &os_err);
+        HOST_CHECK(os_err == OS_ERR_TIMEOUT, "B: '%c' type %u read past the kept presses",
+                   event.code, event.type);
+    }else{
+    }
+
+    /* C: the queue takes events again */
+    if(ok) {
+        press = kqFirst[KQ_BURST_C];
+        ok = kqRead(press, KEY_PRESS) && kqRead(press, KEY_RELEASE);
+        KeyStatsGet(&stats);
+        HOST_CHECK(stats.events == ((2u * KQ_A_PRESSES) + KEY_QUEUE_SIZE + 2u),
+                   "C: %u events queued", stats.events);
+        HOST_CHECK(stats.overflows == (KQ_B_PRESSES - KQ_B_KEPT), "C: %u overflows",
+                   stats.overflows);
+    }else{
+    }
+    kqDone = TRUE;
+    while(1) {
+        OSTimeDly(1000u, OS_OPT_TIME_DLY, &os_err);
+    }
+}
+
+/*************************************************************************
+  kqSleepPast() - Delays until after tick
+*************************************************************************/
+static void kqSleepPast(INT32U tick) {
+    OS_ERR os_err;
+    INT32U now = (INT32U)OSTimeGet(&os_err);
+
+    if(tick >= now) {
+        OSTimeDly(tick - now + 1u, OS_OPT_TIME_DLY, &os_err);
+    }else{
+    }
+}
+
+/*************************************************************************
+  kqRead() - Reads one event and checks it is the press or release of
+             kqPresses[press]
+
+        Returns FALSE if no event came, the rest of the test would only
+        repeat the failure.
+*************************************************************************/
+static INT8U kqRead(INT16U press, INT8U type) {
+    static INT32U last_ts;
+    OS_ERR os_err;
+    KEY_EVENT event;
+    const KQ_PRESS *pp = &kqPresses[press];
+    INT32U edge = (type == KEY_PRESS) ? pp->press_ms : pp->release_ms;
+    INT16U keys = (type == KEY_PRESS) ? kqBit(pp->code) : 0;
+
+    KeyPendEvent(&event, KQ_TOUT_MS, &os_err);
+    if(!HOST_CHECK(os_err == OS_ERR_NONE, "press %u '%c': no %s", press, pp->code,
+                   (type == KEY_PRESS) ? "press" : "release")) {
+        return(FALSE);
+    }else{
+    }
+    HOST_CHECK((event.code == pp->code) && (event.type == type),
+               "press %u: got '%c' type %u, expected '%c' type %u", press,
+               event.code, event.type, pp->code, type);
+    HOST_CHECK(event.keys == keys, "press %u '%c': keys 0x%04x, expected 0x%04x",
+               press, pp->code, event.keys, keys);
+    HOST_CHECK((event.ts >= edge) && (event.ts <= (edge + KQ_LATE_MS)),
+               "press %u '%c' type %u: ts %u, edge at %u", press, pp->code,
+               event.type, event.ts, edge);
+    HOST_CHECK(event.ts >= last_ts, "press %u '%c' type %u: ts %u before %u", press,
+               pp->code, event.type, event.ts, last_ts);
+    last_ts = event.ts;
+    return(TRUE);
+}
+
+static INT16U kqBit(INT8U code) {
+    return((INT16U)(1u << (strchr(kqKeys, code) - kqKeys)));
+}
@@ -0,0 +1,255 @@
+/*************************************************************************
+* KeyRateTest.c - Key task wake-ups per hour, idle and busy
+*
+*            Runs uCOSKey.c under HostOs.c with KeyPortVirtual for two
+*            simulated hours:
+*
+*              idle   an hour with every key up
+*              busy   an hour of KRT_PRESSES presses, one every
+*                     KRT_PERIOD_MS, going round the keypad. Each press
+*                     and release bounces, and one press in KRT_LONG_EVERY
+*                     is held KRT_LONG_MS so the key repeats.
+*
+*            The tick hook plays the script and takes the key task's
+*            HostOs.c stats and KEY_STATS at the start and end of each
+*            hour. The report gives the wake-ups, delays and scans per
+*            hour, the scans at each KEY_RATE_TABLE level, and what a
+*            fixed KEY_RATE_ACTIVE_MS scan would have made.
+*
+*            Every press and release has to be reported, with the right
+*            code. Idle, the key task may not wake at all with
+*            KEY_IRQ_EN, and no more than its quiet time and sleep
+*            period allow without. Busy, it may not wake more than
+*            KRT_PRESSES times the scans a press needs at each level,
+*            worked out from the script, and less than the fixed scan.
+*
+*            Built with the defaults and with KEY_IRQ_EN 0.
+*
+* 10/18/2026 Initial version
+*************************************************************************/
+#include <stdio.h>
+#include "MCUType.h"
+#include "os.h"
+#include "app_cfg.h"
+#include "HostOs.h"
+#include "uCOSKey.h"
+#include "KeyPortVirtual.h"
+
+#define KRT_START_MS    100u        /* Key task idle from here            */
+#define KRT_HOUR_MS     3600000u
+#define KRT_PRESSES     2400u
+#define KRT_PERIOD_MS   (KRT_HOUR_MS / KRT_PRESSES)
+#define KRT_SHORT_MS    120u        /* Held clean, most presses           */
+#define KRT_LONG_MS     1200u       /* Held past the repeat delay         */
+#define KRT_LONG_EVERY  20u
+#define KRT_STEPS       8u          /* Script steps per press             */
+#define KRT_BOUNCE_MS   5u          /* Press bounce, then held            */
+#define KRT_REL_MS      2u          /* Release bounce                     */
+
+#define KRT_IDLE        0u
+#define KRT_BUSY        1u
+#define KRT_SESSIONS    2u
+
+typedef struct{
+    const char *name;
+    HOST_TASK_STATS start;
+    HOST_TASK_STATS end;
+    KEY_STATS kstart;
+    KEY_STATS kend;
+    INT32U max_wakes;               /* From the script and the rates      */
+}KRT_SESSION;
+
+/* Keypad order, the codes the key task sends */
+static const INT8U krtCodes[] = {'1', '2', '3', 0x11u, '4', '5', '6', 0x12u,
+                                 '7', '8', '9', 0x13u, '*', '0', '#', 0x14u};
+
+static KRT_SESSION krtSessions[KRT_SESSIONS] = {{"idle"}, {"busy"}};
+static KEY_VIRT_STEP krtScript[KRT_PRESSES * KRT_STEPS];
+static INT16U krtNumSteps;
+static INT32U krtBusyMs;            /* Start of the busy hour             */
+static INT32U krtEndMs;
+
+static INT32U krtPresses;
+static INT32U krtReleases;
+static INT32U krtBadCodes;
+
+static OS_TCB krtTaskTCB;
+static CPU_STK krtTaskStk[APP_CFG_UITASK_STK_SIZE];
+
+static void krtBuild(void);
+static void krtStep(INT16U ms, INT16U keys);
+static void krtTickHook(void);
+static void krtTask(void *p_arg);
+static void krtCheck(void);
+static void krtReport(void);
+
+/*************************************************************************
+  main() - Runs the idle hour, then the busy hour
+*************************************************************************/
+int main(void) {
+    OS_ERR os_err;
+
+    krtBuild();
+    OSInit(&os_err);
+    OSTaskCreate(&krtTaskTCB, "Key Rate Test Task", krtTask, (void *)0,
+                 APP_CFG_UITASK_PRIO, &krtTaskStk[0], APP_CFG_UITASK_STK_SIZE / 10u,
+                 APP_CFG_UITASK_STK_SIZE, 0, 0, (void *)0,
+                 (OS_OPT)(OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR), &os_err);
+    HostTickHookSet(krtTickHook);
+    OSStart(&os_err);                   /* Returns once the hook stops it */
+
+    krtCheck();
+    krtReport();
+    printf("KeyRateTest: %u presses, %u failed checks\n", krtPresses, HostFails());
+    return((HostFails() == 0) ? 0 : 1);
+}
+
+/*************************************************************************
+  krtBuild() - The busy hour's script and the wake-ups each hour may take
+
+        A press needs scans at the active rate through its bounce and
+        the debounce samples, at the held rate while it is down, the
+        same again for the release, then at the up rate for the quiet
+        time, or the rest of the period if that is shorter, and at the
+        sleep rate, if it has one, after it. One more at each change of
+        level.
+*************************************************************************/
+static void krtBuild(void) {
+    INT32U press, held, rest = 0, quiet, per_press, total = 0;
+    INT16U key;
+
+    for(press = 0; press < KRT_PRESSES; press++) {
+        key = (INT16U)(1u << (press % 16u));
+        held = ((press % KRT_LONG_EVERY) == (KRT_LONG_EVERY - 1u)) ? KRT_LONG_MS : KRT_SHORT_MS;
+        krtStep((INT16U)rest, key);     /* After the last one's rest */
+        krtStep(1u, 0);
+        krtStep(1u, key);
+        krtStep(2u, 0);
+        krtStep(1u, key);
+        krtStep((INT16U)held, 0);
+        krtStep(1u, key);
+        krtStep(1u, 0);
+        rest = KRT_PERIOD_MS - KRT_BOUNCE_MS - held - KRT_REL_MS;
+        per_press = 2u * (((KRT_BOUNCE_MS + KEY_RATE_ACTIVE_MS - 1u) / KEY_RATE_ACTIVE_MS)
+                          + KEY_DEBOUNCE_SAMPLES + 1u)
+                    + (held / KEY_RATE_HELD_MS) + 1u;
+        quiet = (rest < KEY_RATE_QUIET_MS) ? rest : KEY_RATE_QUIET_MS;
+        per_press += (quiet / KEY_RATE_UP_MS) + 1u;
+#if (KEY_RATE_SLEEP_MS != 0)
+        per_press += ((rest - quiet) / KEY_RATE_SLEEP_MS) + 1u;
+#endif
+        total += per_press;
+    }
+    krtSessions[KRT_BUSY].max_wakes = total;
+#if (KEY_RATE_SLEEP_MS == 0)
+    krtSessions[KRT_IDLE].max_wakes = 0;
+#else
+    krtSessions[KRT_IDLE].max_wakes = (KEY_RATE_QUIET_MS / KEY_RATE_UP_MS)
+                                      + (KRT_HOUR_MS / KEY_RATE_SLEEP_MS) + 2u;
+#endif
+    krtBusyMs = KRT_START_MS + KRT_HOUR_MS;
+    krtEndMs = krtBusyMs + KRT_HOUR_MS;
+}
+
+static void krtStep(INT16U ms, INT16U keys) {
+    krtScript[krtNumSteps].ms = ms;
+    krtScript[krtNumSteps].keys = keys;
+    krtNumSteps++;
+}
+
+/*************************************************************************
+  krtTickHook() - Takes the stats at each hour's edges and plays the
+                  busy hour's script
+*************************************************************************/
+static void krtTickHook(void) {
+    INT32U tick = HostTickGet();
+
+    if(tick == KRT_START_MS) {
+        (void)HostTaskStatsGet(APP_CFG_KEY_TASK_PRIO, &krtSessions[KRT_IDLE].start);
+        KeyStatsGet(&krtSessions[KRT_IDLE].kstart);
+    }else if(tick == krtBusyMs) {
+        (void)HostTaskStatsGet(APP_CFG_KEY_TASK_PRIO, &krtSessions[KRT_IDLE].end);
+        KeyStatsGet(&krtSessions[KRT_IDLE].kend);
+        krtSessions[KRT_BUSY].start = krtSessions[KRT_IDLE].end;
+        krtSessions[KRT_BUSY].kstart = krtSessions[KRT_IDLE].kend;
+        KeyVirtScript(krtScript, krtNumSteps);
+    }else if(tick >= krtEndMs) {
+        (void)HostTaskStatsGet(APP_CFG_KEY_TASK_PRIO, &krtSessions[KRT_BUSY].end);
+        KeyStatsGet(&krtSessions[KRT_BUSY].kend);
+        HostStop();
+    }else{
+    }
+    if(tick > krtBusyMs) {
+        (void)KeyVirtScriptTick();
+    }else{
+    }
+}
+
+/*************************************************************************
+  krtTask() - Counts the presses and releases, and checks their codes
+*************************************************************************/
+static void krtTask(void *p_arg) {
+    OS_ERR os_err;
+    KEY_EVENT event;
+    (void)p_arg;
+
+    KeyInit();
+    while(1) {
+        KeyPendEvent(&event, 0, &os_err);
+        if(os_err != OS_ERR_NONE) {
+        }else if(event.type == KEY_PRESS) {
+            if(event.code != krtCodes[krtPresses % 16u]) {
+                krtBadCodes++;
+            }else{
+            }
+            krtPresses++;
+        }else if(event.type == KEY_RELEASE) {
+            krtReleases++;
+        }else{
+        }
+    }
+}
+
+/*************************************************************************
+  krtCheck() - Every press reported, and the wake-ups each hour
+*************************************************************************/
+static void krtCheck(void) {
+    INT8U session;
+    INT32U wakes;
+
+    HOST_CHECK(krtPresses == KRT_PRESSES, "%u presses, expected %u", krtPresses, KRT_PRESSES);
+    HOST_CHECK(krtReleases == KRT_PRESSES, "%u releases, expected %u", krtReleases,
+               KRT_PRESSES);
+    HOST_CHECK(krtBadCodes == 0, "%u presses with the wrong code", krtBadCodes);
+    for(session = 0; session < KRT_SESSIONS; session++) {
+        wakes = krtSessions[session].end.wakes - krtSessions[session].start.wakes;
+        HOST_CHECK(wakes <= krtSessions[session].max_wakes, "%s: %u wake-ups, at most %u",
+                   krtSessions[session].name, wakes, krtSessions[session].max_wakes);
+        HOST_CHECK(wakes < (KRT_HOUR_MS / KEY_RATE_ACTIVE_MS),
+                   "%s: %u wake-ups, no fewer than a fixed %ums scan",
+                   krtSessions[session].name, wakes, (INT32U)KEY_RATE_ACTIVE_MS);
+    }
+}
+
+/*************************************************************************
+  krtReport() - Per hour: wake-ups, delays, scans at each level
+*************************************************************************/
+static void krtReport(void) {
+    INT8U session, level;
+    const KRT_SESSION *ps;
+
+    printf("  KEY_IRQ_EN %u, rates %u/%u/%u/%u ms, quiet %u ms\n", (INT32U)KEY_IRQ_EN,
+           (INT32U)KEY_RATE_ACTIVE_MS, (INT32U)KEY_RATE_HELD_MS, (INT32U)KEY_RATE_UP_MS,
+           (INT32U)KEY_RATE_SLEEP_MS, (INT32U)KEY_RATE_QUIET_MS);
+    printf("  session  wake-ups/hour  delays  scans  active    held      up   sleep"
+           "  fixed %ums\n", (INT32U)KEY_RATE_ACTIVE_MS);
+    for(session = 0; session < KRT_SESSIONS; session++) {
+        ps = &krtSessions[session];
+        printf("  %-7s  %13u  %6u  %5u", ps->name, ps->end.wakes - ps->start.wakes,
+               ps->end.dlys - ps->start.dlys, ps->kend.scans - ps->kstart.scans);
+        for(level = 0; level < KEY_RATE_LEVELS; level++) {
+            printf("  %6u", ps->kend.rate_scans[level] - ps->kstart.rate_scans[level]);
+        }
+        printf("  %9u\n", (INT32U)(KRT_HOUR_MS / KEY_RATE_ACTIVE_MS));
+    }
+}
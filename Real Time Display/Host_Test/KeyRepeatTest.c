@@ -0,0 +1,392 @@
+/*************************************************************************
+* KeyRepeatTest.c - Auto-repeat and long-press events of held keys
+*
+*            Runs uCOSKey.c under HostOs.c with KeyPortVirtual playing
+*            clean presses held for a while:
+*
+*              5      the default digit timing
+*              #      a faster timing set with KeyRepeatSet()
+*              A      a long-press and no repeat
+*              0      neither
+*              1 2    1 held long enough to repeat, then 2 pressed over
+*                     it and released while 1 stays down
+*
+*            followed by KR_IDLE_MS with every key up.
+*
+*            The tick hook logs every scan the key task makes. From the
+*            scans and the presses and releases, the test works out the
+*            KEY_HOLD and KEY_REPEAT events the key task has to send:
+*            a hold on the first scan at least the key's hold time after
+*            its press, the first repeat on the first scan at least the
+*            repeat delay after it, and each next one on the first scan
+*            a period after the last one was due, only for the last key
+*            pressed and never on a scan that changed the keys. The
+*            events have to be exactly those.
+*
+*            The key task may not wake more often while a key is held
+*            than its held scan rate makes it, and not at all with every
+*            key up, the repeats come from the scans it makes anyway.
+*
+*            Built with the defaults. With KEY_IRQ_EN 0 the key task
+*            keeps scanning with no key held.
+*
+* 10/18/2026 Initial version
+*************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "MCUType.h"
+#include "os.h"
+#include "app_cfg.h"
+#include "HostOs.h"
+#include "uCOSKey.h"
+#include "KeyPortVirtual.h"
+
+#define KR_START_MS     100u        /* Script loaded, key task idle       */
+#define KR_SCENE_GAP_MS 300u        /* All keys up between scenes         */
+#define KR_IDLE_MS      3000u       /* All keys up after the last scene   */
+#define KR_IDLE_SETTLE_MS 100u      /* Last release verified by then      */
+#define KR_MAX_STEPS    32u
+#define KR_MAX_SCANS    4096u
+#define KR_MAX_EVENTS   256u
+
+#define KR_DC1 0x11u                /* ASCII control codes of A to D     */
+#define KR_DC2 0x12u
+#define KR_DC3 0x13u
+#define KR_DC4 0x14u
+
+typedef struct{
+    INT8U code;
+    INT16U dly_ms;                  /* As KeyRepeatSet()                  */
+    INT16U period_ms;
+    INT16U hold_ms;
+}KR_TIMING;
+
+/* Keys with timing of their own, the rest keep the default */
+static const KR_TIMING krTimings[] = {
+    {'#', 300u, 100u, 800u},
+    {KR_DC1, 0u, 0u,  600u},
+    {'0', 200u, 0u,   0u},
+};
+static const KR_TIMING krDefault = {0, 500u, 150u, 1000u};
+
+/* Keypad order, the labels and the codes the key task sends */
+static const INT8C krKeys[] = "123A456B789C*0#D";
+static const INT8U krCodes[] = {'1', '2', '3', KR_DC1, '4', '5', '6', KR_DC2,
+                                '7', '8', '9', KR_DC3, '*', '0', '#', KR_DC4};
+
+#define KR_BIT(c) ((INT16U)(1u << (strchr(krKeys, (c)) - krKeys)))
+
+static KEY_VIRT_STEP krScript[KR_MAX_STEPS];
+static INT16U krNumSteps;
+static INT32U krMs = KR_START_MS;
+static INT32U krIdleMs;             /* The idle window                    */
+static INT32U krEndMs;
+
+static INT32U krScans[KR_MAX_SCANS];
+static INT32U krNumScans;
+static INT32U krScansSeen;
+static KEY_EVENT krEvents[KR_MAX_EVENTS];
+static INT16U krNumEvents;
+static KEY_EVENT krExpect[KR_MAX_EVENTS];
+static INT16U krNumExpect;
+static HOST_TASK_STATS krIdleStart;
+static HOST_TASK_STATS krIdleEnd;
+
+static OS_TCB krTaskTCB;
+static CPU_STK krTaskStk[APP_CFG_UITASK_STK_SIZE];
+
+static void krBuild(void);
+static void krSet(INT16U gap, INT16U keys);
+static void krTickHook(void);
+static void krTask(void *p_arg);
+static void krPredict(void);
+static void krExpectAdd(INT8U code, INT8U type, INT32U ts);
+static const KR_TIMING *krTiming(INT8U code);
+static INT8C krLabel(INT8U code);
+static void krCheckEvents(void);
+static void krReport(void);
+
+/*************************************************************************
+  main() - Runs the script, then checks the events against the scans
+*************************************************************************/
+int main(void) {
+    OS_ERR os_err;
+
+    krBuild();
+    OSInit(&os_err);
+    OSTaskCreate(&krTaskTCB, "Key Repeat Test Task", krTask, (void *)0,
+                 APP_CFG_UITASK_PRIO, &krTaskStk[0], APP_CFG_UITASK_STK_SIZE / 10u,
+                 APP_CFG_UITASK_STK_SIZE, 0, 0, (void *)0,
+                 (OS_OPT)(OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR), &os_err);
+    HostTickHookSet(krTickHook);
+    OSStart(&os_err);                   /* Returns once the hook stops it */
+
+    HOST_CHECK(krNumScans < KR_MAX_SCANS, "scan log full");
+    HOST_CHECK(krNumEvents < KR_MAX_EVENTS, "event log full");
+    krPredict();
+    krCheckEvents();
+    krReport();
+    printf("KeyRepeatTest: %u scans, %u events, %u failed checks\n", krNumScans,
+           krNumEvents, HostFails());
+    return((HostFails() == 0) ? 0 : 1);
+}
+
+/*************************************************************************
+  krBuild() - The scenes, then the idle window
+*************************************************************************/
+static void krBuild(void) {
+    krSet(KR_SCENE_GAP_MS, KR_BIT('5'));
+    krSet(2000u, 0);
+    krSet(KR_SCENE_GAP_MS, KR_BIT('#'));
+    krSet(1000u, 0);
+    krSet(KR_SCENE_GAP_MS, KR_BIT('A'));
+    krSet(900u, 0);
+    krSet(KR_SCENE_GAP_MS, KR_BIT('0'));
+    krSet(700u, 0);
+
+    /* 1 repeats until 2 goes down, then 2 does, then nothing */
+    krSet(KR_SCENE_GAP_MS, KR_BIT('1'));
+    krSet(700u, KR_BIT('1') | KR_BIT('2'));
+    krSet(800u, KR_BIT('1'));
+    krSet(600u, 0);
+
+    krIdleMs = krMs + KR_IDLE_SETTLE_MS;
+    krEndMs = krIdleMs + KR_IDLE_MS;
+}
+
+static void krSet(INT16U gap, INT16U keys) {
+    krMs += gap;
+    krScript[krNumSteps].ms = gap;
+    krScript[krNumSteps].keys = keys;
+    krNumSteps++;
+}
+
+/*************************************************************************
+  krTickHook() - Logs the scans of the last tick, plays the script and
+                 takes the key task's stats over the idle window
+*************************************************************************/
+static void krTickHook(void) {
+    INT32U tick = HostTickGet();
+    KEY_STATS stats;
+
+    KeyStatsGet(&stats);
+    while((krScansSeen < stats.scans) && (krNumScans < KR_MAX_SCANS)) {
+        krScans[krNumScans] = tick - 1u;
+        krNumScans++;
+        krScansSeen++;
+    }
+    if(tick == KR_START_MS) {
+        KeyVirtScript(krScript, krNumSteps);
+    }else if(tick > KR_START_MS) {
+        (void)KeyVirtScriptTick();
+    }else{
+    }
+    if(tick == krIdleMs) {
+        (void)HostTaskStatsGet(APP_CFG_KEY_TASK_PRIO, &krIdleStart);
+    }else{
+    }
+    if(tick >= krEndMs) {
+        (void)HostTaskStatsGet(APP_CFG_KEY_TASK_PRIO, &krIdleEnd);
+        HostStop();
+    }else{
+    }
+}
+
+/*************************************************************************
+  krTask() - Sets the key timings, then reads every event
+*************************************************************************/
+static void krTask(void *p_arg) {
+    OS_ERR os_err;
+    KEY_EVENT event;
+    INT8U cnt;
+    (void)p_arg;
+
+    KeyInit();
+    for(cnt = 0; cnt < (sizeof(krTimings) / sizeof(krTimings[0])); cnt++) {
+        HOST_CHECK(KeyRepeatSet(krTimings[cnt].code, krTimings[cnt].dly_ms,
+                                krTimings[cnt].period_ms, krTimings[cnt].hold_ms),
+                   "KeyRepeatSet('%c') failed", krLabel(krTimings[cnt].code));
+    }
+    HOST_CHECK(KeyRepeatSet('x', 1u, 1u, 1u) == FALSE, "KeyRepeatSet('x') took a bad code");
+    while(1) {
+        KeyPendEvent(&event, 0, &os_err);
+        if((os_err == OS_ERR_NONE) && (krNumEvents < KR_MAX_EVENTS)) {
+            krEvents[krNumEvents] = event;
+            krNumEvents++;
+        }else{
+        }
+    }
+}
+
+/*************************************************************************
+  krPredict() - The events the key task has to send, from the scans
+
+        The presses and releases are taken as they came, the debounce
+        test checks those. At each scan that made none, the key last
+        pressed, while it is still down, gets its hold and repeats.
+*************************************************************************/
+static void krPredict(void) {
+    const KR_TIMING *pt = &krDefault;
+    INT32U scan;
+    INT16U event = 0;
+    INT8U held = 0;                 /* Code of the key that repeats, 0 none */
+    INT8U changed, hold_sent = TRUE;
+    INT32U press_ts = 0, repeat_ts = 0;
+    INT32U dly = 0, period = 0, hold = 0;
+
+    for(scan = 0; scan < krNumScans; scan++) {
+        changed = FALSE;
+        while((event < krNumEvents) && (krEvents[event].ts <= krScans[scan])) {
+            if((krEvents[event].type == KEY_PRESS) || (krEvents[event].type == KEY_RELEASE)) {
+                krExpectAdd(krEvents[event].code, krEvents[event].type, krEvents[event].ts);
+                changed = TRUE;
+                if(krEvents[event].type == KEY_PRESS) {
+                    held = krEvents[event].code;
+                    pt = krTiming(held);
+                    press_ts = krEvents[event].ts;
+                    dly = pt->dly_ms * OS_CFG_TICK_RATE_HZ / 1000u;
+                    period = pt->period_ms * OS_CFG_TICK_RATE_HZ / 1000u;
+                    hold = pt->hold_ms * OS_CFG_TICK_RATE_HZ / 1000u;
+                    repeat_ts = press_ts + dly;
+                    hold_sent = (INT8U)(hold == 0);
+                }else if(krEvents[event].code == held) {
+                    held = 0;
+                }else{
+                }
+            }else{
+            }
+            event++;
+        }
+        if((changed == FALSE) && (held != 0)) {
+            if((hold_sent == FALSE) && ((krScans[scan] - press_ts) >= hold)) {
+                hold_sent = TRUE;
+                krExpectAdd(held, KEY_HOLD, krScans[scan]);
+            }else{
+            }
+            if((period != 0) && (krScans[scan] >= repeat_ts)) {
+                krExpectAdd(held, KEY_REPEAT, krScans[scan]);
+                repeat_ts += period;
+                if(krScans[scan] >= repeat_ts) {
+                    repeat_ts = krScans[scan] + period;
+                }else{
+                }
+            }else{
+            }
+        }else{
+        }
+    }
+}
+
+static void krExpectAdd(INT8U code, INT8U type, INT32U ts) {
+    if(krNumExpect < KR_MAX_EVENTS) {
+        krExpect[krNumExpect].code = code;
+        krExpect[krNumExpect].type = type;
+        krExpect[krNumExpect].ts = ts;
+        krNumExpect++;
+    }else{
+    }
+}
+
+static const KR_TIMING *krTiming(INT8U code) {
+    INT8U cnt;
+
+    for(cnt = 0; cnt < (sizeof(krTimings) / sizeof(krTimings[0])); cnt++) {
+        if(krTimings[cnt].code == code) {
+            return(&krTimings[cnt]);
+        }else{
+        }
+    }
+    return(&krDefault);
+}
+
+static INT8C krLabel(INT8U code) {
+    INT8U key;
+
+    for(key = 0; (key < sizeof(krCodes)) && (krCodes[key] != code); key++) {
+    }
+    return((key < sizeof(krCodes)) ? krKeys[key] : '?');
+}
+
+/*************************************************************************
+  krCheckEvents() - The events against the prediction, and the key
+                    task's wake-ups with the keys held and up
+*************************************************************************/
+static void krCheckEvents(void) {
+    INT16U cnt;
+    INT32U wakes = krIdleEnd.wakes - krIdleStart.wakes;
+
+    HOST_CHECK(krNumEvents == krNumExpect, "%u events, expected %u", krNumEvents, krNumExpect);
+    for(cnt = 0; (cnt < krNumEvents) && (cnt < krNumExpect); cnt++) {
+        HOST_CHECK((krEvents[cnt].code == krExpect[cnt].code)
+                   && (krEvents[cnt].type == krExpect[cnt].type)
+                   && (krEvents[cnt].ts == krExpect[cnt].ts),
+                   "event %u: '%c' type %u at %u, expected '%c' type %u at %u", cnt,
+                   krLabel(krEvents[cnt].code), krEvents[cnt].type, krEvents[cnt].ts,
+                   krLabel(krExpect[cnt].code), krExpect[cnt].type, krExpect[cnt].ts);
+    }
+#if (KEY_RATE_SLEEP_MS == 0)
+    HOST_CHECK(wakes == 0, "%u key task wake-ups with every key up", wakes);
+#else
+    HOST_CHECK(wakes <= ((KR_IDLE_MS / KEY_RATE_SLEEP_MS) + 1u),
+               "%u key task wake-ups with every key up", wakes);
+#endif
+}
+
+/*************************************************************************
+  krReport() - Per press: the first repeat and hold after it, the mean
+               period, and the scans made while the key was held
+*************************************************************************/
+static void krReport(void) {
+    INT16U cnt, next;
+    INT32U first, last, repeats, hold, scans, scan, end;
+    INT8U code;
+
+    printf("  key  first repeat  repeats  mean period  hold  held  scans  scans/s\n");
+    for(cnt = 0; cnt < krNumEvents; cnt++) {
+        if(krEvents[cnt].type != KEY_PRESS) {
+            continue;
+        }else{
+        }
+        code = krEvents[cnt].code;
+        first = 0;
+        last = 0;
+        repeats = 0;
+        hold = 0;
+        end = krEvents[cnt].ts;
+        for(next = (INT16U)(cnt + 1u); next < krNumEvents; next++) {
+            if(krEvents[next].code != code) {
+            }else if(krEvents[next].type == KEY_RELEASE) {
+                end = krEvents[next].ts;
+                break;
+            }else if(krEvents[next].type == KEY_REPEAT) {
+                if(repeats == 0) {
+                    first = krEvents[next].ts;
+                }else{
+                }
+                last = krEvents[next].ts;
+                repeats++;
+            }else if(krEvents[next].type == KEY_HOLD) {
+                hold = krEvents[next].ts;
+            }else{
+            }
+        }
+        scans = 0;
+        for(scan = 0; scan < krNumScans; scan++) {
+            if((krScans[scan] > krEvents[cnt].ts) && (krScans[scan] < end)) {
+                scans++;
+            }else{
+            }
+        }
+        /* A scan per held period, and the scans that verify the release */
+        HOST_CHECK(scans <= (((end - krEvents[cnt].ts) / KEY_RATE_HELD_MS) + KEY_DEBOUNCE_SAMPLES + 1u),
+                   "'%c': %u scans in %u ms held", krLabel(code), scans,
+                   end - krEvents[cnt].ts);
+        printf("  '%c'  %9u ms  %7u  %8.1f ms  %4u  %4u  %5u  %7.1f\n", krLabel(code),
+               (repeats != 0) ? (first - krEvents[cnt].ts) : 0u, repeats,
+               (repeats > 1u) ? ((double)(last - first) / (repeats - 1u)) : 0.0,
+               (hold != 0) ? (hold - krEvents[cnt].ts) : 0u, end - krEvents[cnt].ts, scans,
+               (double)scans * 1000.0 / (end - krEvents[cnt].ts));
+    }
+    printf("  idle %u ms: %u key task wake-ups\n", KR_IDLE_MS,
+           krIdleEnd.wakes - krIdleStart.wakes);
+}
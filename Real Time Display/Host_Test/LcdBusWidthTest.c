@@ -0,0 +1,217 @@
+/*************************************************************************
+* LcdBusWidthTest.c - The same layer sequence over the 4-bit and 8-bit
+*                     bus
+*
+*            Runs LcdLayered.c under HostOs.c against the LcdBusVirtual
+*            HD44780 model. The test task draws text, a time, an overlay
+*            layer, the cursor and a marquee on each row, which scroll
+*            with the display shift, and waits for the frame after each
+*            step. At every checkpoint it writes the model's
+*            state to the file named on the command line: DDRAM, CGRAM,
+*            the address counter, display shift, entry mode and display
+*            control. Only the interface width is left out.
+*
+*            The Makefile builds it with LCD_BUS_8BIT_EN 0 and 1 and
+*            compares the two files, so the 8-bit path has to leave the
+*            controller exactly where the 4-bit one does. Each build
+*            also checks the glass against the expected text, that no
+*            instruction was sent while the controller was busy and
+*            that no DDRAM read followed a write without an address set.
+*
+*            The scrub is off. Its slices fall on ticks that depend on
+*            the bus time, which differs with the width, and it moves
+*            the address counter. With no scrub the display is powered
+*            up by the first frame.
+*
+*            Usage: LcdBusWidthTest state.txt
+*
+* 10/18/2026 Initial version
+*************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "MCUType.h"
+#include "os.h"
+#include "app_cfg.h"
+#include "HostOs.h"
+#include "LcdLayered.h"
+#include "LcdBusVirtual.h"
+
+#define LW_FRAME_MS     100u        /* Frame written and the task idle    */
+#define LW_TIMEOUT_MS   10000u
+#define LW_MARQUEE_STEPS 4u
+
+/* No spaces, a space is transparent and would show the layer below */
+static const INT8C lwMarquee1[] = "A-marquee-wider-than-the-glass-";
+static const INT8C lwMarquee2[] = "0123456789abcdefghijklmnopqrstu";
+
+static FILE *lwOut;
+static INT16U lwCheckpoints;
+static INT8U lwDone;
+
+static OS_TCB lwTaskTCB;
+static CPU_STK lwTaskStk[APP_CFG_TASK_START_STK_SIZE];
+
+static void lwTask(void *p_arg);
+static void lwCheckpoint(const char *name, const char *row1, const char *row2);
+static void lwTickHook(void);
+static INT64U lwBusNs(void);
+
+/*************************************************************************
+  main() - Runs the sequence, then checks the bus stats
+*************************************************************************/
+int main(int argc, char **argv) {
+    OS_ERR os_err;
+    LCD_VIRT_STATS stats;
+    LCD_STATS lcd_stats;
+
+    if(argc != 2) {
+        fprintf(stderr, "usage: LcdBusWidthTest state.txt\n");
+        return(2);
+    }else{
+    }
+    lwOut = fopen(argv[1], "w");
+    if(lwOut == NULL) {
+        perror(argv[1]);
+        return(2);
+    }else{
+    }
+    OSInit(&os_err);
+    /* Above the LCD task, as the start task is, so the changes made   */
+    /* between two delays go out in one frame                          */
+    OSTaskCreate(&lwTaskTCB, "LCD Bus Width Test Task", lwTask, (void *)0,
+                 APP_CFG_TASK_START_PRIO, &lwTaskStk[0], APP_CFG_TASK_START_STK_SIZE / 10u,
+                 APP_CFG_TASK_START_STK_SIZE, 0, 0, (void *)0,
+                 (OS_OPT)(OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR), &os_err);
+    HostBusHookSet(lwBusNs);
+    HostTickHookSet(lwTickHook);
+    OSStart(&os_err);                   /* Returns once the test stops it */
+    (void)fclose(lwOut);
+
+    LcdVirtStatsGet(&stats);
+    (void)LcdStatsGet(0, &lcd_stats);
+    HOST_CHECK(lwDone, "sequence did not finish by tick %u", LW_TIMEOUT_MS);
+    HOST_CHECK(stats.busy_drops == 0, "%u instructions sent while busy", stats.busy_drops);
+    HOST_CHECK(stats.stale_reads == 0, "%u stale DDRAM reads", stats.stale_reads);
+    printf("LcdBusWidthTest, %u-bit bus: %u checkpoints, %u frames, %u shifts, %u strobes, %u.%03u ms on the bus, %u failed checks\n",
+           LCD_BUS_DB_PINS, lwCheckpoints, lcd_stats.frames, lcd_stats.shifts, stats.strobes,
+           (INT32U)(stats.bus_ns / 1000000u), (INT32U)((stats.bus_ns / 1000u) % 1000u),
+           HostFails());
+    return((HostFails() == 0) ? 0 : 1);
+}
+
+/*************************************************************************
+  lwTask() - The layer sequence, a checkpoint after every frame
+*************************************************************************/
+static void lwTask(void *p_arg) {
+    OS_ERR os_err;
+    INT8U step;
+    char name[16];
+    (void)p_arg;
+
+    LcdInit();
+    LcdDispString(1, 1, TIMEDISPLAYER, "Bus width test");
+    LcdDispTime(2, 5, TIMEDISPLAYER, 12, 34, 56);
+    OSTimeDly(LW_FRAME_MS, OS_OPT_TIME_DLY, &os_err);
+    lwCheckpoint("time", "Bus width test  ", "    12:34:56    ");
+
+    LcdDispString(2, 1, SWATCHLAYER, "SW");
+    (void)LcdPrintf(2, 14, SWATCHLAYER, "%u.%u", 7u, 3u);
+    OSTimeDly(LW_FRAME_MS, OS_OPT_TIME_DLY, &os_err);
+    lwCheckpoint("overlay", "Bus width test  ", "SW  12:34:56 7.3");
+
+    LcdToggleLayer(SWATCHLAYER);
+    OSTimeDly(LW_FRAME_MS, OS_OPT_TIME_DLY, &os_err);
+    lwCheckpoint("hidden", "Bus width test  ", "    12:34:56    ");
+
+    LcdToggleLayer(SWATCHLAYER);
+    OSTimeDly(LW_FRAME_MS, OS_OPT_TIME_DLY, &os_err);
+    lwCheckpoint("shown", "Bus width test  ", "SW  12:34:56 7.3");
+
+    (void)LcdCursor(2, 7, TIMESETLAYER, TRUE, TRUE);   /* The top layer's */
+    OSTimeDly(LW_FRAME_MS, OS_OPT_TIME_DLY, &os_err);
+    lwCheckpoint("cursor", "Bus width test  ", "SW  12:34:56 7.3");
+
+    /* Both rows scroll together, so each step is a display shift and */
+    /* the cursor address has to follow it                           */
+    (void)LcdMarqueeStart(1, STATSLAYER, lwMarquee1);
+    (void)LcdMarqueeStart(2, TIMESETLAYER, lwMarquee2);
+    (void)LcdCursor(1, 3, TIMESETLAYER, TRUE, FALSE);
+    OSTimeDly(LW_FRAME_MS, OS_OPT_TIME_DLY, &os_err);
+    lwCheckpoint("marquee", lwMarquee1, lwMarquee2);
+    for(step = 1; step <= LW_MARQUEE_STEPS; step++) {
+        LcdMarqueeStep(STATSLAYER);
+        LcdMarqueeStep(TIMESETLAYER);
+        OSTimeDly(LW_FRAME_MS, OS_OPT_TIME_DLY, &os_err);
+        (void)snprintf(name, sizeof(name), "marquee %u", step);
+        lwCheckpoint(name, &lwMarquee1[step], &lwMarquee2[step]);
+    }
+
+    LcdMarqueeStop(STATSLAYER);
+    LcdMarqueeStop(TIMESETLAYER);
+    LcdDispClear(STATSLAYER);
+    LcdDispClear(TIMESETLAYER);
+    OSTimeDly(LW_FRAME_MS, OS_OPT_TIME_DLY, &os_err);
+    lwCheckpoint("marquee off", "Bus width test  ", "SW  12:34:56 7.3");
+
+    LcdDispClear(SWATCHLAYER);
+    LcdDispClrLine(1, TIMEDISPLAYER);
+    OSTimeDly(LW_FRAME_MS, OS_OPT_TIME_DLY, &os_err);
+    lwCheckpoint("cleared", "                ", "    12:34:56    ");
+
+    lwDone = TRUE;
+    while(1) {
+        OSTimeDly(1000u, OS_OPT_TIME_DLY, &os_err);
+    }
+}
+
+/*************************************************************************
+  lwCheckpoint() - Checks the first 16 characters of row1 and row2 are
+                   on the glass and writes the model's state
+*************************************************************************/
+static void lwCheckpoint(const char *name, const char *row1, const char *row2) {
+    const LCD_VIRT_STATE *ps = LcdVirtState();
+    INT8C glass[LCD_VIRT_ROWS][LCD_VIRT_COLS];
+    const char *expect[LCD_VIRT_ROWS] = {row1, row2};
+    INT8U row, col;
+    INT16U cnt;
+
+    lwCheckpoints++;
+    LcdVirtGlassGet(glass);
+    for(row = 0; row < LCD_VIRT_ROWS; row++) {
+        HOST_CHECK(memcmp(glass[row], expect[row], LCD_VIRT_COLS) == 0,
+                   "%s: row %u [%.16s], expected [%.16s]", name, row + 1u,
+                   glass[row], expect[row]);
+    }
+    HOST_CHECK(ps->four_bit == !LCD_BUS_8BIT_EN, "%s: four_bit %u", name, ps->four_bit);
+
+    fprintf(lwOut, "%s\n", name);
+    for(row = 0; row < LCD_VIRT_ROWS; row++) {
+        fprintf(lwOut, "  ddram %u ", row);
+        for(col = 0; col < LCD_VIRT_DDRAM_COLS; col++) {
+            fprintf(lwOut, "%02x", ps->ddram[row][col]);
+        }
+        fprintf(lwOut, "\n");
+    }
+    fprintf(lwOut, "  cgram ");
+    for(cnt = 0; cnt < LCD_VIRT_CGRAM_SIZE; cnt++) {
+        fprintf(lwOut, "%02x", ps->cgram[cnt]);
+    }
+    fprintf(lwOut, "\n  addr %02x cgram_sel %u shift %u increment %u shift_on_write %u\n",
+            ps->addr, ps->cgram_sel, ps->shift, ps->increment, ps->shift_on_write);
+    fprintf(lwOut, "  disp_on %u cursor_on %u blink_on %u two_line %u\n",
+            ps->disp_on, ps->cursor_on, ps->blink_on, ps->two_line);
+}
+
+static void lwTickHook(void) {
+    if(lwDone || (HostTickGet() >= LW_TIMEOUT_MS)) {
+        HostStop();
+    }else{
+    }
+}
+
+static INT64U lwBusNs(void) {
+    LCD_VIRT_STATS stats;
+
+    LcdVirtStatsGet(&stats);
+    return(stats.bus_ns);
+}
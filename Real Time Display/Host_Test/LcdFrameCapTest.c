@@ -0,0 +1,302 @@
+/*************************************************************************
+* LcdFrameCapTest.c - The LCD frame rate cap under update storms
+*
+*            Runs LcdLayered.c under HostOs.c against the LcdBusVirtual
+*            HD44780 model, with the default LCD_FRAME_RATE_HZ cap, and
+*            posts three storms of layer writes:
+*
+*              below  a writer under the LCD task's priority writes
+*                     three counters every ms for LFC_STORM_MS. Each
+*                     write posts the LCD task, which has to hold the
+*                     frame back until the period is up.
+*              urgent the same storm, with one write to an urgent layer
+*                     LFC_URGENT_AFTER_MS after a frame. It has to reach
+*                     the glass on the tick it was made.
+*              above  a writer over the LCD task's priority writes ten
+*                     counters every LFC_BURST_MS, so the LCD task only
+*                     sees a burst once it is complete.
+*
+*            The tick hook logs the tick of every frame. In the below
+*            and above storms no LCD_FRAME_RATE_HZ + 1 frames may fall
+*            within a second. Every write counts in dropped or merged
+*            unless it started a frame, so the writes less the two
+*            counts must be at least one and no more than the frames.
+*            The below writer never sees a frame queued with its period
+*            up, so nothing is merged, and the above writer's bursts
+*            have to merge.
+*
+* 10/18/2026 Initial version
+*************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "MCUType.h"
+#include "os.h"
+#include "app_cfg.h"
+#include "HostOs.h"
+#include "LcdLayered.h"
+#include "LcdBusVirtual.h"
+
+#define LFC_IDLE_MS     200u        /* Powered up, no frame queued        */
+#define LFC_STORM_MS    2000u
+#define LFC_URGENT_STORM_MS 500u
+#define LFC_URGENT_AFTER_MS 5u      /* Well inside the frame period       */
+#define LFC_BURST_MS    5u
+#define LFC_BURST_WRITES 10u
+#define LFC_TIMEOUT_MS  10000u
+#define LFC_MAX_FRAMES  1024u
+#define LFC_PERIOD_MS   ((1000u + LCD_FRAME_RATE_HZ - 1u) / LCD_FRAME_RATE_HZ)
+
+typedef enum{LFC_BELOW, LFC_URGENT, LFC_ABOVE, LFC_STORMS}LFC_STORM;
+
+typedef struct{
+    INT32U start;                   /* Ticks of the first and last write  */
+    INT32U end;
+    INT32U writes;
+    LCD_STATS before;
+    LCD_STATS after;
+}LFC_RUN;
+
+static const char *const lfcNames[LFC_STORMS] = {"below", "urgent", "above"};
+
+static LFC_RUN lfcRuns[LFC_STORMS];
+static INT32U lfcFrameTicks[LFC_MAX_FRAMES];
+static INT32U lfcNumFrames;
+static INT32U lfcFramesSeen;
+static INT32U lfcUrgentTick;        /* Write to the urgent layer          */
+static INT32U lfcUrgentShown;       /* Tick it was first on the glass     */
+static INT8U lfcAboveGo;
+static INT8U lfcDone;
+
+static OS_TCB lfcBelowTCB;
+static CPU_STK lfcBelowStk[APP_CFG_UITASK_STK_SIZE];
+static OS_TCB lfcAboveTCB;
+static CPU_STK lfcAboveStk[APP_CFG_TASK_START_STK_SIZE];
+
+static void lfcBelowTask(void *p_arg);
+static void lfcAboveTask(void *p_arg);
+static INT32U lfcWrite(INT8U row, INT8U col, INT32U cnt);
+static void lfcTickHook(void);
+static INT64U lfcBusNs(void);
+static void lfcCheck(LFC_STORM storm);
+
+/*************************************************************************
+  main() - Runs the storms, then checks each
+*************************************************************************/
+int main(void) {
+    OS_ERR os_err;
+    LFC_STORM storm;
+
+    OSInit(&os_err);
+    OSTaskCreate(&lfcBelowTCB, "LCD Frame Cap Below Task", lfcBelowTask, (void *)0,
+                 APP_CFG_UITASK_PRIO, &lfcBelowStk[0], APP_CFG_UITASK_STK_SIZE / 10u,
+                 APP_CFG_UITASK_STK_SIZE, 0, 0, (void *)0,
+                 (OS_OPT)(OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR), &os_err);
+    OSTaskCreate(&lfcAboveTCB, "LCD Frame Cap Above Task", lfcAboveTask, (void *)0,
+                 APP_CFG_TASK_START_PRIO, &lfcAboveStk[0], APP_CFG_TASK_START_STK_SIZE / 10u,
+                 APP_CFG_TASK_START_STK_SIZE, 0, 0, (void *)0,
+                 (OS_OPT)(OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR), &os_err);
+    HostBusHookSet(lfcBusNs);
+    HostTickHookSet(lfcTickHook);
+    OSStart(&os_err);                   /* Returns once the hook stops it */
+
+    HOST_CHECK(lfcDone, "storms did not finish by tick %u", LFC_TIMEOUT_MS);
+    HOST_CHECK(lfcNumFrames < LFC_MAX_FRAMES, "frame log full");
+    for(storm = LFC_BELOW; storm < LFC_STORMS; storm++) {
+        lfcCheck(storm);
+    }
+    printf("LcdFrameCapTest: urgent write at %u on the glass at %u, %u failed checks\n",
+           lfcUrgentTick, lfcUrgentShown, HostFails());
+    return((HostFails() == 0) ? 0 : 1);
+}
+
+/*************************************************************************
+  lfcBelowTask() - Sets up the display, runs the below and urgent
+                   storms, then hands over to the above writer
+*************************************************************************/
+static void lfcBelowTask(void *p_arg) {
+    OS_ERR os_err;
+    LFC_RUN *pr;
+    INT32U frames;
+    INT8U urgent_done = FALSE;
+    (void)p_arg;
+
+    LcdInit();
+    LcdDispString(1, 1, TIMEDISPLAYER, "Frame cap test");
+    LcdLayerUrgent(TIMESETLAYER, TRUE);
+    OSTimeDly(LFC_IDLE_MS, OS_OPT_TIME_DLY, &os_err);
+
+    pr = &lfcRuns[LFC_BELOW];
+    (void)LcdStatsGet(0, &pr->before);
+    pr->start = OSTimeGet(&os_err);
+    while((OSTimeGet(&os_err) - pr->start) < LFC_STORM_MS) {
+        pr->writes += lfcWrite(1, 1, pr->writes);
+        pr->writes += lfcWrite(2, 1, pr->writes);
+        pr->writes += lfcWrite(2, 9, pr->writes);
+        pr->end = OSTimeGet(&os_err);
+        OSTimeDly(1u, OS_OPT_TIME_DLY, &os_err);
+    }
+    (void)LcdStatsGet(0, &pr->after);
+    OSTimeDly(LFC_IDLE_MS, OS_OPT_TIME_DLY, &os_err);
+
+    /* The urgent write goes in a while after a frame, with one held */
+    pr = &lfcRuns[LFC_URGENT];
+    (void)LcdStatsGet(0, &pr->before);
+    frames = pr->before.frames;
+    pr->start = OSTimeGet(&os_err);
+    while((OSTimeGet(&os_err) - pr->start) < LFC_URGENT_STORM_MS) {
+        pr->writes += lfcWrite(1, 1, pr->writes);
+        pr->end = OSTimeGet(&os_err);
+        if(urgent_done == FALSE) {
+            (void)LcdStatsGet(0, &pr->after);
+            if((pr->after.frames - frames) == 2u) {
+                /* The second frame, the first came with the period up */
+                frames = pr->after.frames;
+                urgent_done = TRUE;
+                OSTimeDly(LFC_URGENT_AFTER_MS, OS_OPT_TIME_DLY, &os_err);
+                lfcUrgentTick = OSTimeGet(&os_err);
+                LcdDispString(1, 11, TIMESETLAYER, "URGENT");
+                pr->writes++;
+            }else{
+            }
+        }else{
+        }
+        OSTimeDly(1u, OS_OPT_TIME_DLY, &os_err);
+    }
+    (void)LcdStatsGet(0, &pr->after);
+    LcdDispClear(TIMESETLAYER);
+    OSTimeDly(LFC_IDLE_MS, OS_OPT_TIME_DLY, &os_err);
+
+    lfcAboveGo = TRUE;
+    while(1) {
+        OSTimeDly(1000u, OS_OPT_TIME_DLY, &os_err);
+    }
+}
+
+/*************************************************************************
+  lfcAboveTask() - The above storm, bursts the LCD task can't split
+*************************************************************************/
+static void lfcAboveTask(void *p_arg) {
+    OS_ERR os_err;
+    LFC_RUN *pr = &lfcRuns[LFC_ABOVE];
+    INT8U cnt;
+    (void)p_arg;
+
+    while(lfcAboveGo == FALSE) {
+        OSTimeDly(1u, OS_OPT_TIME_DLY, &os_err);
+    }
+    (void)LcdStatsGet(0, &pr->before);
+    pr->start = OSTimeGet(&os_err);
+    while((OSTimeGet(&os_err) - pr->start) < LFC_STORM_MS) {
+        for(cnt = 0; cnt < LFC_BURST_WRITES; cnt++) {
+            pr->writes += lfcWrite((INT8U)(1u + (cnt & 1u)), (INT8U)(1u + ((cnt / 2u) * 3u)),
+                                   pr->writes);
+        }
+        pr->end = OSTimeGet(&os_err);
+        OSTimeDly(LFC_BURST_MS, OS_OPT_TIME_DLY, &os_err);
+    }
+    (void)LcdStatsGet(0, &pr->after);
+    OSTimeDly(LFC_IDLE_MS, OS_OPT_TIME_DLY, &os_err);
+    lfcDone = TRUE;
+    while(1) {
+        OSTimeDly(1000u, OS_OPT_TIME_DLY, &os_err);
+    }
+}
+
+/*************************************************************************
+  lfcWrite() - A counter at row, col of the bottom layer, returns the
+               layer writes made
+*************************************************************************/
+static INT32U lfcWrite(INT8U row, INT8U col, INT32U cnt) {
+    INT8C text[8];
+
+    (void)snprintf(text, sizeof(text), "%03u", (unsigned)(cnt % 1000u));
+    LcdDispString(row, col, TIMEDISPLAYER, text);
+    return(1u);
+}
+
+/*************************************************************************
+  lfcTickHook() - Logs the frames of the last tick and watches for the
+                  urgent write on the glass
+*************************************************************************/
+static void lfcTickHook(void) {
+    INT32U tick = HostTickGet();
+    INT8C glass[LCD_VIRT_ROWS][LCD_VIRT_COLS];
+    LCD_STATS stats;
+
+    if(LcdStatsGet(0, &stats)) {
+        while((lfcFramesSeen < stats.frames) && (lfcNumFrames < LFC_MAX_FRAMES)) {
+            lfcFrameTicks[lfcNumFrames] = tick - 1u;
+            lfcNumFrames++;
+            lfcFramesSeen++;
+        }
+    }else{
+    }
+    if((lfcUrgentTick != 0) && (lfcUrgentShown == 0)) {
+        LcdVirtGlassGet(glass);
+        if(memcmp(&glass[0][10], "URGENT", 6) == 0) {
+            lfcUrgentShown = tick - 1u;
+        }else{
+        }
+    }else{
+    }
+    if(lfcDone || (tick >= LFC_TIMEOUT_MS)) {
+        HostStop();
+    }else{
+    }
+}
+
+/*************************************************************************
+  lfcCheck() - The rate over the storm and the dropped and merged
+               counts against the writes
+*************************************************************************/
+static void lfcCheck(LFC_STORM storm) {
+    const LFC_RUN *pr = &lfcRuns[storm];
+    INT32U frames = pr->after.frames - pr->before.frames;
+    INT32U dropped = pr->after.dropped - pr->before.dropped;
+    INT32U merged = pr->after.merged - pr->before.merged;
+    INT32U urgent = pr->after.urgent - pr->before.urgent;
+    INT32U first, last, frame;
+    INT32U started = pr->writes - dropped - merged;
+    INT32U ms = pr->end - pr->start + 1u;
+
+    /* The frames of this storm, in the log */
+    for(first = 0; (first < lfcNumFrames) && (lfcFrameTicks[first] < pr->start); first++) {
+    }
+    for(last = first; (last < lfcNumFrames) && (lfcFrameTicks[last] <= pr->end); last++) {
+    }
+    HOST_CHECK(frames <= ((ms / LFC_PERIOD_MS) + 1u + urgent), "%s: %u frames in %u ms",
+               lfcNames[storm], frames, ms);
+    HOST_CHECK((dropped + merged) < pr->writes, "%s: %u writes, %u dropped, %u merged",
+               lfcNames[storm], pr->writes, dropped, merged);
+    HOST_CHECK(started <= frames, "%s: %u writes not dropped or merged, %u frames",
+               lfcNames[storm], started, frames);
+    if(storm == LFC_URGENT) {
+        HOST_CHECK(urgent == 1u, "%u urgent frames, expected 1", urgent);
+        HOST_CHECK((lfcUrgentTick != 0) && (lfcUrgentShown == lfcUrgentTick),
+                   "urgent write at %u on the glass at %u", lfcUrgentTick, lfcUrgentShown);
+    }else{
+        HOST_CHECK(urgent == 0, "%s: %u urgent frames", lfcNames[storm], urgent);
+        for(frame = first; (frame + LCD_FRAME_RATE_HZ) < last; frame++) {
+            HOST_CHECK((lfcFrameTicks[frame + LCD_FRAME_RATE_HZ] - lfcFrameTicks[frame]) >= 1000u,
+                       "%s: %u frames from %u to %u", lfcNames[storm], LCD_FRAME_RATE_HZ + 1u,
+                       lfcFrameTicks[frame], lfcFrameTicks[frame + LCD_FRAME_RATE_HZ]);
+        }
+    }
+    if(storm == LFC_BELOW) {
+        HOST_CHECK(merged == 0, "below: %u merged", merged);
+    }else if(storm == LFC_ABOVE) {
+        HOST_CHECK(merged >= ((frames - 1u) * (LFC_BURST_WRITES - 1u)),
+                   "above: %u merged over %u frames", merged, frames);
+    }else{
+    }
+    printf("  %-6s %5u writes over %4u ms: %3u frames, %5.1f fps, %5u dropped, %4u merged, %u urgent\n",
+           lfcNames[storm], pr->writes, ms, frames, (double)frames * 1000.0 / (double)ms,
+           dropped, merged, urgent);
+}
+
+static INT64U lfcBusNs(void) {
+    LCD_VIRT_STATS stats;
+
+    LcdVirtStatsGet(&stats);
+    return(stats.bus_ns);
+}
@@ -0,0 +1,289 @@
+/*************************************************************************
+* LcdMultiDispTest.c - Four displays serviced by the one LCD task
+*
+*            Runs LcdLayered.c under HostOs.c with four LcdBusVirtual
+*            units. Display 0 is the board LCD LcdInit() sets up, the
+*            others are added with LcdDispAdd():
+*
+*              display  glass   prio
+*              0        2 x 16  0
+*              1        1 x 16  3
+*              2        2 x 8   1
+*              3        2 x 16  2
+*
+*            The test task, over the LCD task's priority, writes two
+*            rows of text to every display at once. Each unit's glass
+*            has to show its own display's text cut to its geometry,
+*            and nothing past it. The frames have to be written one
+*            after the other in service priority order, so each one's
+*            latency, from the call to its last bus write, is the bus
+*            time of the frames before it plus its own. A second burst
+*            to displays 1 and 3 only may not write to the other two.
+*
+*            The Makefile builds LcdLayered.c with one display and with
+*            four and passes in their data and bss sizes, the RAM an
+*            added display costs is reported against the stack a task
+*            per display would need.
+*
+* 10/18/2026 Initial version
+*************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "MCUType.h"
+#include "os.h"
+#include "app_cfg.h"
+#include "HostOs.h"
+#include "LcdLayered.h"
+#include "LcdBusVirtual.h"
+
+#define LMD_POWER_MS    300u        /* Every display powered up           */
+#define LMD_FRAME_MS    100u        /* Frames written and the task idle   */
+#define LMD_TIMEOUT_MS  5000u
+#define LMD_ROWS        LCD_VIRT_ROWS
+#define LMD_COLS        LCD_VIRT_COLS
+
+#if LCD_NUM_DISPS != 4
+#error "LcdMultiDispTest needs LCD_NUM_DISPS 4"
+#endif
+
+typedef struct{
+    INT8U rows;
+    INT8U cols;
+    INT8U prio;
+}LMD_DISP;
+
+static const LMD_DISP lmdDisps[LCD_NUM_DISPS] = {
+    {2u, 16u, 0u}, {1u, 16u, 3u}, {2u, 8u, 1u}, {2u, 16u, 2u}};
+
+/* Displays in the order they have to be serviced */
+static const INT8U lmdOrder[LCD_NUM_DISPS] = {0u, 2u, 3u, 1u};
+
+static const INT8C *const lmdText[LCD_NUM_DISPS][LMD_ROWS] = {
+    {"Disp 0 row one..", "Disp 0 row two.."},
+    {"Disp 1 row one..", "Disp 1 row two.."},
+    {"Disp 2 row one..", "Disp 2 row two.."},
+    {"Disp 3 row one..", "Disp 3 row two.."},
+};
+
+static const INT8C *const lmdText2[LCD_NUM_DISPS] = {
+    (const INT8C *)0, "Second burst 1  ", (const INT8C *)0, "Second burst 3  "};
+
+static INT8U lmdDone;
+
+static OS_TCB lmdTaskTCB;
+static CPU_STK lmdTaskStk[APP_CFG_TASK_START_STK_SIZE];
+
+static void lmdTask(void *p_arg);
+static void lmdAdd(void);
+static void lmdBurst(const INT8C *const text[LCD_NUM_DISPS][LMD_ROWS]);
+static void lmdCheckGlass(INT8U disp, const INT8C *const text[LMD_ROWS]);
+static void lmdBusGet(INT64U bus_ns[LCD_NUM_DISPS]);
+static void lmdTickHook(void);
+static INT64U lmdBusNs(void);
+
+/*************************************************************************
+  main() - Runs the bursts, then reports the RAM per display
+*************************************************************************/
+int main(void) {
+    OS_ERR os_err;
+    INT32U ram_per, task_stk;
+
+    OSInit(&os_err);
+    OSTaskCreate(&lmdTaskTCB, "LCD Multi Display Test Task", lmdTask, (void *)0,
+                 APP_CFG_TASK_START_PRIO, &lmdTaskStk[0], APP_CFG_TASK_START_STK_SIZE / 10u,
+                 APP_CFG_TASK_START_STK_SIZE, 0, 0, (void *)0,
+                 (OS_OPT)(OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR), &os_err);
+    HostBusHookSet(lmdBusNs);
+    HostTickHookSet(lmdTickHook);
+    OSStart(&os_err);                   /* Returns once the test stops it */
+
+    HOST_CHECK(lmdDone, "bursts did not finish by tick %u", LMD_TIMEOUT_MS);
+    ram_per = (LMD_RAM_4 - LMD_RAM_1) / (LCD_NUM_DISPS - 1u);
+    task_stk = APP_CFG_LCD_TASK_STK_SIZE * sizeof(CPU_STK);
+    printf("  LcdLayered.c data and bss: %u bytes with 1 display, %u with 4\n",
+           (INT32U)LMD_RAM_1, (INT32U)LMD_RAM_4);
+    printf("  RAM per added display: %u bytes, a task stack alone is %u\n", ram_per,
+           task_stk);
+    HOST_CHECK(ram_per < task_stk, "%u bytes per display, a task stack is %u", ram_per,
+               task_stk);
+    printf("LcdMultiDispTest: %u displays, %u failed checks\n", (INT32U)LCD_NUM_DISPS,
+           HostFails());
+    return((HostFails() == 0) ? 0 : 1);
+}
+
+/*************************************************************************
+  lmdTask() - Adds the displays, then writes the two bursts
+*************************************************************************/
+static void lmdTask(void *p_arg) {
+    OS_ERR os_err;
+    const INT8C *text2[LCD_NUM_DISPS][LMD_ROWS];
+    INT64U bus_was[LCD_NUM_DISPS];
+    INT64U bus_now[LCD_NUM_DISPS];
+    LCD_STATS stats_was[LCD_NUM_DISPS];
+    LCD_STATS stats;
+    INT8U disp, row;
+    (void)p_arg;
+
+    LcdInit();
+    lmdAdd();
+    OSTimeDly(LMD_POWER_MS, OS_OPT_TIME_DLY, &os_err);
+
+    printf("  display  glass  prio  frame bus us  latency us\n");
+    lmdBurst(lmdText);
+
+    /* Displays 1 and 3 only, row one changes and row two stays */
+    for(disp = 0; disp < LCD_NUM_DISPS; disp++) {
+        for(row = 0; row < LMD_ROWS; row++) {
+            text2[disp][row] = (const INT8C *)0;
+        }
+        if(lmdText2[disp] != (const INT8C *)0) {
+            text2[disp][0] = lmdText2[disp];
+            text2[disp][1] = lmdText[disp][1];
+        }else{
+        }
+        (void)LcdStatsGet(disp, &stats_was[disp]);
+    }
+    lmdBusGet(bus_was);
+    for(disp = 0; disp < LCD_NUM_DISPS; disp++) {
+        if(text2[disp][0] != (const INT8C *)0) {
+            LcdDispString(1, 1, LCD_LAYER(disp, TIMEDISPLAYER), text2[disp][0]);
+        }else{
+        }
+    }
+    OSTimeDly(LMD_FRAME_MS, OS_OPT_TIME_DLY, &os_err);
+    lmdBusGet(bus_now);
+    for(disp = 0; disp < LCD_NUM_DISPS; disp++) {
+        (void)LcdStatsGet(disp, &stats);
+        if(text2[disp][0] != (const INT8C *)0) {
+            HOST_CHECK(stats.frames == (stats_was[disp].frames + 1u),
+                       "second burst: display %u wrote %u frames, expected 1", disp,
+                       stats.frames - stats_was[disp].frames);
+            lmdCheckGlass(disp, text2[disp]);
+        }else{
+            HOST_CHECK((stats.frames == stats_was[disp].frames)
+                       && (bus_now[disp] == bus_was[disp]),
+                       "second burst: display %u wrote %u frames, %u ns on its bus", disp,
+                       stats.frames - stats_was[disp].frames,
+                       (INT32U)(bus_now[disp] - bus_was[disp]));
+            lmdCheckGlass(disp, lmdText[disp]);
+        }
+    }
+    lmdDone = TRUE;
+    while(1) {
+        OSTimeDly(1000u, OS_OPT_TIME_DLY, &os_err);
+    }
+}
+
+/*************************************************************************
+  lmdAdd() - Adds displays 1 to 3, each on its own unit. A fifth one
+             and one over the largest geometry have to be refused.
+*************************************************************************/
+static void lmdAdd(void) {
+    INT8U disp, added;
+
+    for(disp = 1; disp < LCD_NUM_DISPS; disp++) {
+        added = LcdDispAdd(&LcdBusVirtualUnits[disp], lmdDisps[disp].rows,
+                           lmdDisps[disp].cols, lmdDisps[disp].prio);
+        HOST_CHECK(added == disp, "display %u added as %u", disp, added);
+    }
+    added = LcdDispAdd(&LcdBusVirtualUnits[0], 3u, 16u, 0u);
+    HOST_CHECK(added == LCD_NUM_DISPS, "3 x 16 display added as %u", added);
+    added = LcdDispAdd(&LcdBusVirtualUnits[0], 2u, 16u, 0u);
+    HOST_CHECK(added == LCD_NUM_DISPS, "fifth display added as %u", added);
+}
+
+/*************************************************************************
+  lmdBurst() - Writes every display's text at once, then checks the
+               glasses and the order and latency of the frames
+*************************************************************************/
+static void lmdBurst(const INT8C *const text[LCD_NUM_DISPS][LMD_ROWS]) {
+    OS_ERR os_err;
+    INT64U bus_was[LCD_NUM_DISPS];
+    INT64U frame_ns[LCD_NUM_DISPS];
+    INT64U before_ns = 0;
+    LCD_LATENCY lat;
+    INT32U lat_ns, cyc_per_us;
+    INT8U disp, row, cnt;
+
+    lmdBusGet(bus_was);
+    LcdLatencyReset();
+    for(disp = 0; disp < LCD_NUM_DISPS; disp++) {
+        for(row = 0; row < LMD_ROWS; row++) {
+            LcdDispString((INT8U)(row + 1u), 1, LCD_LAYER(disp, TIMEDISPLAYER), text[disp][row]);
+        }
+    }
+    OSTimeDly(LMD_FRAME_MS, OS_OPT_TIME_DLY, &os_err);
+    lmdBusGet(frame_ns);
+
+    cyc_per_us = HOST_CPU_HZ / 1000000u;
+    for(cnt = 0; cnt < LCD_NUM_DISPS; cnt++) {
+        disp = lmdOrder[cnt];
+        lmdCheckGlass(disp, text[disp]);
+        frame_ns[disp] -= bus_was[disp];
+        lat_ns = 0;
+        if(HOST_CHECK(LcdLatencyGet(LCD_LAYER(disp, TIMEDISPLAYER), &lat) && (lat.count == 1u),
+                      "display %u: no latency measured", disp)) {
+            lat_ns = (INT32U)(((INT64U)lat.max * 1000u) / cyc_per_us);
+        }else{
+        }
+        /* Within one cycle of the frames before it and its own */
+        before_ns += frame_ns[disp];
+        HOST_CHECK((lat_ns + (1000u / cyc_per_us) >= before_ns) && (lat_ns <= before_ns),
+                   "display %u: latency %u ns, the frames up to its own take %u ns", disp,
+                   lat_ns, (INT32U)before_ns);
+        printf("  %7u  %ux%-3u  %4u  %12.1f  %10.1f\n", disp, lmdDisps[disp].rows,
+               lmdDisps[disp].cols, lmdDisps[disp].prio, (double)frame_ns[disp] / 1000.0,
+               (double)lat_ns / 1000.0);
+    }
+}
+
+/*************************************************************************
+  lmdCheckGlass() - A unit's glass shows its display's text up to the
+                    display's geometry and blanks past it
+*************************************************************************/
+static void lmdCheckGlass(INT8U disp, const INT8C *const text[LMD_ROWS]) {
+    INT8C glass[LMD_ROWS][LMD_COLS];
+    INT8C expect[LMD_ROWS][LMD_COLS];
+    INT8U row;
+
+    memset(expect, ' ', sizeof(expect));
+    for(row = 0; row < lmdDisps[disp].rows; row++) {
+        memcpy(expect[row], text[row], lmdDisps[disp].cols);
+    }
+    (void)LcdVirtUnitGlassGet(disp, glass);
+    for(row = 0; row < LMD_ROWS; row++) {
+        HOST_CHECK(memcmp(glass[row], expect[row], LMD_COLS) == 0,
+                   "display %u row %u [%.16s], expected [%.16s]", disp, row + 1u, glass[row],
+                   expect[row]);
+    }
+}
+
+static void lmdBusGet(INT64U bus_ns[LCD_NUM_DISPS]) {
+    LCD_VIRT_STATS stats;
+    INT8U disp;
+
+    for(disp = 0; disp < LCD_NUM_DISPS; disp++) {
+        (void)LcdVirtUnitStatsGet(disp, &stats);
+        bus_ns[disp] = stats.bus_ns;
+    }
+}
+
+static void lmdTickHook(void) {
+    if(lmdDone || (HostTickGet() >= LMD_TIMEOUT_MS)) {
+        HostStop();
+    }else{
+    }
+}
+
+/* Every unit's bus, the LCD task drives one at a time */
+static INT64U lmdBusNs(void) {
+    INT64U bus_ns[LCD_NUM_DISPS];
+    INT64U total = 0;
+    INT8U disp;
+
+    lmdBusGet(bus_ns);
+    for(disp = 0; disp < LCD_NUM_DISPS; disp++) {
+        total += bus_ns[disp];
+    }
+    return(total);
+}
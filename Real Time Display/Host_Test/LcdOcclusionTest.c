@@ -0,0 +1,448 @@
+/*************************************************************************
+* LcdOcclusionTest.c - Layer writes covered by a higher layer
+*
+*            Runs LcdLayered.c under HostOs.c against the LcdBusVirtual
+*            HD44780 model, with the test task under the LCD task's
+*            priority, as the application's tasks are.
+*
+*            The trace is the clock screen: the time on TIMEDISPLAYER
+*            every second and a stopwatch on SWATCHLAYER every 10ms,
+*            first open, then under an opaque TIMESETLAYER overlay, then
+*            with the overlay hidden again. Under the overlay no write
+*            may post the LCD task, and the glass has to show the
+*            overlay throughout and the latest writes once it is hidden.
+*            The posts, wake-ups and frames of each phase are reported.
+*
+*            The equivalence run makes LO_OPS random writes, clears,
+*            hides, shows, toggles and swaps on all four layers, with
+*            no frame rate cap, against a plain model of the layers.
+*            After each one the glass has to match the model, the LCD
+*            task has to have been posted exactly when a write reached
+*            an uncovered cell, or a visibility change altered the glass
+*            or the top layer, and every covered write has to be counted
+*            as occluded.
+*
+* 10/18/2026 Initial version
+*************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "MCUType.h"
+#include "os.h"
+#include "app_cfg.h"
+#include "HostOs.h"
+#include "LcdLayered.h"
+#include "LcdBusVirtual.h"
+
+#define LO_PHASE_MS     3000u
+#define LO_SWATCH_MS    10u
+#define LO_FRAME_MS     100u        /* Frame written and the task idle    */
+#define LO_OPS          200000u
+#define LO_MAX_STR      6u
+#define LO_TIMEOUT_MS   100000u
+#define LO_REPORT_FAILS 10u
+#define LO_ROWS         LCD_VIRT_ROWS
+#define LO_COLS         LCD_VIRT_COLS
+
+typedef enum{LO_OPEN, LO_COVERED, LO_HIDDEN, LO_PHASES}LO_PHASE;
+
+typedef struct{
+    INT32U writes;                  /* Layer write calls                  */
+    HOST_TASK_STATS lcd;            /* LCD task, over the phase           */
+    INT32U frames;
+    INT32U occluded;
+}LO_RUN;
+
+static const char *const loNames[LO_PHASES] = {"open", "overlay", "hidden"};
+
+/* No spaces, a space is transparent and would show the layers below */
+static const INT8C loOverlay1[] = "==SET=THE=TIME==";
+static const INT8C loOverlay2[] = "<<<<12:34:56>>>>";
+
+static LO_RUN loRuns[LO_PHASES];
+static INT8C loLayers[LCD_NUM_LAYERS][LO_ROWS][LO_COLS];    /* The model  */
+static INT8U loHidden[LCD_NUM_LAYERS];
+static INT32U loRand = 0x2545F491u;
+static INT32U loOpFails;
+static INT32U loOps;
+static INT32U loOpPosts;
+static INT8U loDone;
+
+static OS_TCB loTaskTCB;
+static CPU_STK loTaskStk[APP_CFG_UITASK_STK_SIZE];
+
+static void loTask(void *p_arg);
+static void loTrace(void);
+static void loPhase(LO_PHASE phase, INT32U *swatch, INT32U *secs);
+static void loGlassCheck(const char *name, const char *row1, const char *row2);
+static void loEquivalence(void);
+static void loOp(void);
+static INT8U loCovered(INT8U layer, INT8U row, INT8U col, INT8U cnt);
+static void loCompose(INT8C glass[LO_ROWS][LO_COLS]);
+static INT8U loTopLayer(void);
+static INT8C loChar(void);
+static INT32U loNext(void);
+static INT32U loPosts(void);
+static void loTickHook(void);
+static INT64U loBusNs(void);
+
+/*************************************************************************
+  main() - Runs the trace and the equivalence run, then reports
+*************************************************************************/
+int main(void) {
+    OS_ERR os_err;
+    LO_PHASE phase;
+    LO_RUN *pr;
+
+    OSInit(&os_err);
+    OSTaskCreate(&loTaskTCB, "LCD Occlusion Test Task", loTask, (void *)0,
+                 APP_CFG_UITASK_PRIO, &loTaskStk[0], APP_CFG_UITASK_STK_SIZE / 10u,
+                 APP_CFG_UITASK_STK_SIZE, 0, 0, (void *)0,
+                 (OS_OPT)(OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR), &os_err);
+    HostBusHookSet(loBusNs);
+    HostTickHookSet(loTickHook);
+    OSStart(&os_err);                   /* Returns once the test stops it */
+
+    HOST_CHECK(loDone, "test did not finish by tick %u", LO_TIMEOUT_MS);
+    printf("  phase    writes  posts  wake-ups  wake-ups/s  frames  occluded\n");
+    for(phase = LO_OPEN; phase < LO_PHASES; phase++) {
+        pr = &loRuns[phase];
+        printf("  %-7s  %6u  %5u  %8u  %10.1f  %6u  %8u\n", loNames[phase], pr->writes,
+               pr->lcd.sem_posts, pr->lcd.wakes,
+               (double)pr->lcd.wakes * 1000.0 / LO_PHASE_MS, pr->frames, pr->occluded);
+    }
+    printf("LcdOcclusionTest: %u wake-ups avoided under the overlay, %u ops, %u posted, %u failed checks\n",
+           loRuns[LO_OPEN].lcd.wakes - loRuns[LO_COVERED].lcd.wakes, loOps, loOpPosts,
+           HostFails());
+    return((HostFails() == 0) ? 0 : 1);
+}
+
+/*************************************************************************
+  loTask() - The trace, then the equivalence run
+*************************************************************************/
+static void loTask(void *p_arg) {
+    OS_ERR os_err;
+    (void)p_arg;
+
+    LcdInit();
+    OSTimeDly(LO_FRAME_MS, OS_OPT_TIME_DLY, &os_err);
+    loTrace();
+    loEquivalence();
+    loDone = TRUE;
+    while(1) {
+        OSTimeDly(1000u, OS_OPT_TIME_DLY, &os_err);
+    }
+}
+
+/*************************************************************************
+  loTrace() - The clock screen open, under the overlay, and open again
+*************************************************************************/
+static void loTrace(void) {
+    OS_ERR os_err;
+    INT32U swatch = 0;
+    INT32U secs = (12u * 3600u) + (34u * 60u) + 50u;
+    INT8C row1[LO_COLS + 1];
+    INT8C row2[LO_COLS + 1];
+
+    loPhase(LO_OPEN, &swatch, &secs);
+
+    LcdDispString(1, 1, TIMESETLAYER, loOverlay1);
+    LcdDispString(2, 1, TIMESETLAYER, loOverlay2);
+    OSTimeDly(LO_FRAME_MS, OS_OPT_TIME_DLY, &os_err);
+    loGlassCheck("overlay shown", loOverlay1, loOverlay2);
+    loPhase(LO_COVERED, &swatch, &secs);
+    loGlassCheck("overlay", loOverlay1, loOverlay2);
+
+    LcdHideLayer(TIMESETLAYER);
+    OSTimeDly(LO_FRAME_MS, OS_OPT_TIME_DLY, &os_err);
+    (void)snprintf(row1, sizeof(row1), "SW %02u:%02u.%02u     ", (swatch / 6000u) % 60u,
+                   (swatch / 100u) % 60u, swatch % 100u);
+    (void)snprintf(row2, sizeof(row2), "    %02u:%02u:%02u    ", (secs / 3600u) % 24u,
+                   (secs / 60u) % 60u, secs % 60u);
+    loGlassCheck("overlay hidden", row1, row2);
+    loPhase(LO_HIDDEN, &swatch, &secs);
+}
+
+/*************************************************************************
+  loPhase() - LO_PHASE_MS of stopwatch and clock writes
+*************************************************************************/
+static void loPhase(LO_PHASE phase, INT32U *swatch, INT32U *secs) {
+    OS_ERR os_err;
+    LO_RUN *pr = &loRuns[phase];
+    HOST_TASK_STATS lcd_was, lcd;
+    LCD_STATS stats_was, stats;
+    INT32U ms;
+
+    (void)HostTaskStatsGet(APP_CFG_LCD_TASK_PRIO, &lcd_was);
+    (void)LcdStatsGet(0, &stats_was);
+    for(ms = 0; ms < LO_PHASE_MS; ms += LO_SWATCH_MS) {
+        if(ms != 0) {
+            (*swatch)++;
+        }else{
+        }
+        (void)LcdPrintf(1, 1, SWATCHLAYER, "SW %02u:%02u.%02u", (*swatch / 6000u) % 60u,
+                        (*swatch / 100u) % 60u, *swatch % 100u);
+        pr->writes++;
+        if((ms % 1000u) == 0) {
+            (*secs)++;
+            LcdDispTime(2, 5, TIMEDISPLAYER, (INT8U)((*secs / 3600u) % 24u),
+                        (INT8U)((*secs / 60u) % 60u), (INT8U)(*secs % 60u));
+            pr->writes++;
+        }else{
+        }
+        if(phase == LO_COVERED) {
+            HOST_CHECK(loPosts() == lcd_was.sem_posts,
+                       "overlay: a covered write posted the LCD task");
+        }else{
+        }
+        OSTimeDly(LO_SWATCH_MS, OS_OPT_TIME_DLY, &os_err);
+    }
+
+    (void)HostTaskStatsGet(APP_CFG_LCD_TASK_PRIO, &lcd);
+    (void)LcdStatsGet(0, &stats);
+    pr->lcd.sem_posts = lcd.sem_posts - lcd_was.sem_posts;
+    pr->lcd.wakes = lcd.wakes - lcd_was.wakes;
+    pr->lcd.dlys = lcd.dlys - lcd_was.dlys;
+    pr->frames = stats.frames - stats_was.frames;
+    pr->occluded = stats.occluded - stats_was.occluded;
+    if(phase == LO_COVERED) {
+        HOST_CHECK(pr->lcd.sem_posts == 0, "overlay: %u posts", pr->lcd.sem_posts);
+        HOST_CHECK(pr->occluded == pr->writes, "overlay: %u writes, %u occluded",
+                   pr->writes, pr->occluded);
+    }else{
+        HOST_CHECK(pr->lcd.sem_posts == pr->writes, "%s: %u writes, %u posts",
+                   loNames[phase], pr->writes, pr->lcd.sem_posts);
+        HOST_CHECK(pr->occluded == 0, "%s: %u occluded", loNames[phase], pr->occluded);
+    }
+}
+
+/*************************************************************************
+  loGlassCheck() - Checks row1 and row2 are on the glass
+*************************************************************************/
+static void loGlassCheck(const char *name, const char *row1, const char *row2) {
+    INT8C glass[LO_ROWS][LO_COLS];
+    const char *expect[LO_ROWS] = {row1, row2};
+    INT8U row;
+
+    LcdVirtGlassGet(glass);
+    for(row = 0; row < LO_ROWS; row++) {
+        HOST_CHECK(memcmp(glass[row], expect[row], LO_COLS) == 0,
+                   "%s: row %u [%.16s], expected [%.16s]", name, row + 1u, glass[row],
+                   expect[row]);
+    }
+}
+
+/*************************************************************************
+  loEquivalence() - LO_OPS random layer operations against the model
+*************************************************************************/
+static void loEquivalence(void) {
+    OS_ERR os_err;
+    INT8U layer;
+
+    (void)LcdFrameRateSet(0, 0);    /* Each post is a frame, at once      */
+    for(layer = 0; layer < LCD_NUM_LAYERS; layer++) {
+        LcdShowLayer(layer);
+        LcdDispClear(layer);
+    }
+    OSTimeDly(LO_FRAME_MS, OS_OPT_TIME_DLY, &os_err);
+    memset(loLayers, ' ', sizeof(loLayers));
+    memset(loHidden, 0, sizeof(loHidden));
+    for(loOps = 0; loOps < LO_OPS; loOps++) {
+        loOp();
+    }
+    HOST_CHECK(loOpFails == 0, "%u of %u ops did not match the model", loOpFails, LO_OPS);
+    (void)LcdFrameRateSet(0, LCD_FRAME_RATE_HZ);
+}
+
+/*************************************************************************
+  loOp() - One random operation, on the LCD and the model
+
+           The post and occluded counts it should make come from the
+           model as it was, the glass it should leave from the model
+           after.
+*************************************************************************/
+static void loOp(void) {
+    INT8C before[LO_ROWS][LO_COLS];
+    INT8C after[LO_ROWS][LO_COLS];
+    INT8C glass[LO_ROWS][LO_COLS];
+    INT8C str[LO_MAX_STR + 1u];
+    INT32U op = loNext() % 32u;
+    INT8U layer = (INT8U)(loNext() % LCD_NUM_LAYERS);
+    INT8U show = (INT8U)((layer + 1u + (loNext() % (LCD_NUM_LAYERS - 1u))) % LCD_NUM_LAYERS);
+    INT8U row = (INT8U)(loNext() % LO_ROWS);
+    INT8U col = (INT8U)(loNext() % LO_COLS);
+    INT8U len = (INT8U)(1u + (loNext() % LO_MAX_STR));
+    INT8U top = loTopLayer();
+    INT8U post = FALSE;
+    INT8U check_occluded = TRUE;
+    INT32U occluded = 0;
+    INT32U posts = loPosts();
+    LCD_STATS stats;
+    INT32U occluded_was;
+    INT8U cnt;
+
+    (void)LcdStatsGet(0, &stats);
+    occluded_was = stats.occluded;
+    loCompose(before);
+    if(op < 14u) {
+        str[0] = loChar();
+        post = !loCovered(layer, row, col, 1u);
+        LcdDispChar((INT8U)(row + 1u), (INT8U)(col + 1u), layer, str[0]);
+        loLayers[layer][row][col] = str[0];
+    }else if(op < 22u) {
+        for(cnt = 0; cnt < len; cnt++) {
+            str[cnt] = loChar();
+            if((col + cnt) < LO_COLS) {
+                loLayers[layer][row][col + cnt] = str[cnt];
+            }else{
+            }
+        }
+        str[len] = 0;
+        post = !loCovered(layer, row, col, len);
+        LcdDispString((INT8U)(row + 1u), (INT8U)(col + 1u), layer, str);
+    }else if(op == 22u) {
+        post = !loCovered(layer, row, 0, LO_COLS);
+        LcdDispClrLine((INT8U)(row + 1u), layer);
+        memset(loLayers[layer][row], ' ', LO_COLS);
+    }else if(op == 23u) {
+        for(row = 0; row < LO_ROWS; row++) {
+            if(loCovered(layer, row, 0, LO_COLS)) {
+                occluded++;
+            }else{
+                post = TRUE;
+            }
+        }
+        LcdDispClear(layer);
+        memset(loLayers[layer], ' ', sizeof(loLayers[layer]));
+    }else{
+        check_occluded = FALSE;
+        if(op < 26u) {
+            LcdHideLayer(layer);
+            loHidden[layer] = TRUE;
+        }else if(op < 28u) {
+            LcdShowLayer(layer);
+            loHidden[layer] = FALSE;
+        }else if(op < 30u) {
+            LcdToggleLayer(layer);
+            loHidden[layer] = !loHidden[layer];
+        }else{
+            LcdSwapLayers(layer, show);
+            loHidden[layer] = TRUE;
+            loHidden[show] = FALSE;
+        }
+    }
+    loCompose(after);
+    if(check_occluded) {
+        if((op < 23u) && (post == FALSE)) {
+            occluded = 1u;
+        }else{
+        }
+    }else{
+        post = (memcmp(before, after, sizeof(before)) != 0) || (top != loTopLayer());
+    }
+
+    (void)LcdStatsGet(0, &stats);
+    LcdVirtGlassGet(glass);
+    if((post != (loPosts() != posts)) || (loPosts() > (posts + 1u))
+       || (check_occluded && ((stats.occluded - occluded_was) != occluded))
+       || (memcmp(glass, after, sizeof(glass)) != 0)) {
+        if(loOpFails < LO_REPORT_FAILS) {
+            printf("op %u: %u on layer %u at %u,%u: %u posts, expected %u, %u occluded, expected %u, glass [%.16s][%.16s], expected [%.16s][%.16s]\n",
+                   loOps, op, layer, row, col, loPosts() - posts, post,
+                   stats.occluded - occluded_was, occluded, glass[0], glass[1], after[0],
+                   after[1]);
+        }else{
+        }
+        loOpFails++;
+    }else{
+    }
+    loOpPosts += loPosts() - posts;
+}
+
+/* TRUE if no cell of cnt from col is visible in layer, in the model */
+static INT8U loCovered(INT8U layer, INT8U row, INT8U col, INT8U cnt) {
+    INT8U above;
+
+    if(loHidden[layer]) {
+        return(TRUE);
+    }else{
+    }
+    for(; (cnt != 0) && (col < LO_COLS); cnt--, col++) {
+        for(above = (INT8U)(layer + 1u); above < LCD_NUM_LAYERS; above++) {
+            if((loHidden[above] == FALSE) && (loLayers[above][row][col] != ' ')) {
+                break;
+            }else{
+            }
+        }
+        if(above == LCD_NUM_LAYERS) {
+            return(FALSE);
+        }else{
+        }
+    }
+    return(TRUE);
+}
+
+/* The glass the model makes, the top visible character of each cell */
+static void loCompose(INT8C glass[LO_ROWS][LO_COLS]) {
+    INT8U row, col, layer;
+
+    memset(glass, ' ', LO_ROWS * LO_COLS);
+    for(row = 0; row < LO_ROWS; row++) {
+        for(col = 0; col < LO_COLS; col++) {
+            for(layer = 0; layer < LCD_NUM_LAYERS; layer++) {
+                if((loHidden[layer] == FALSE) && (loLayers[layer][row][col] != ' ')) {
+                    glass[row][col] = loLayers[layer][row][col];
+                }else{
+                }
+            }
+        }
+    }
+}
+
+static INT8U loTopLayer(void) {
+    INT8U layer = LCD_NUM_LAYERS;
+
+    while(layer != 0) {
+        layer--;
+        if(loHidden[layer] == FALSE) {
+            return(layer);
+        }else{
+        }
+    }
+    return(LCD_NUM_LAYERS);
+}
+
+/* A letter, or a transparent space one time in three */
+static INT8C loChar(void) {
+    INT32U r = loNext() % 39u;
+
+    return((r < 13u) ? ' ' : (INT8C)('A' + (r - 13u)));
+}
+
+/* xorshift32, the same sequence every run */
+static INT32U loNext(void) {
+    loRand ^= loRand << 13;
+    loRand ^= loRand >> 17;
+    loRand ^= loRand << 5;
+    return(loRand);
+}
+
+static INT32U loPosts(void) {
+    HOST_TASK_STATS lcd;
+
+    (void)HostTaskStatsGet(APP_CFG_LCD_TASK_PRIO, &lcd);
+    return(lcd.sem_posts);
+}
+
+static void loTickHook(void) {
+    if(loDone || (HostTickGet() >= LO_TIMEOUT_MS)) {
+        HostStop();
+    }else{
+    }
+}
+
+static INT64U loBusNs(void) {
+    LCD_VIRT_STATS stats;
+
+    LcdVirtStatsGet(&stats);
+    return(stats.bus_ns);
+}
@@ -0,0 +1,273 @@
+/*************************************************************************
+* LcdPrintfTest.c - The LcdPrintf() formatter, and a status line through
+*                   it and through the LcdDisp calls
+*
+*            Runs LcdLayered.c under HostOs.c against the LcdBusVirtual
+*            HD44780 model. Each case clears the layer, formats one
+*            string with LcdPrintf() and waits for the frame. The glass
+*            has to show what the host's snprintf() makes of the same
+*            format and arguments, cut off at the row end, with nothing
+*            before the column or on the other row, and LcdPrintf() has
+*            to return the characters it wrote. The cases cover %d %i %u
+*            %x %X %s %c and %%, the '0' and '-' flags and widths, the
+*            32-bit extremes and formats that run past the row end.
+*
+*            The benchmark writes LP_BENCH_LINES status lines, time and
+*            temperature, with one LcdPrintf() and with the LcdDispTime(),
+*            LcdDispString() and LcdDispDecByte() sequence that makes the
+*            same text. The test task is over the LCD task so the lines
+*            don't wait for frames. The report gives the posts to the LCD
+*            task and the host cycles per line. The cycles include the
+*            HostOs.c stand-in's pend and post, which cost more on the
+*            target, so the posts are the number that carries over.
+*
+* 10/18/2026 Initial version
+*************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "MCUType.h"
+#include "os.h"
+#include "app_cfg.h"
+#include "HostOs.h"
+#include "HostBench.h"
+#include "LcdLayered.h"
+#include "LcdBusVirtual.h"
+
+#define LP_FRAME_MS     25u         /* Longer than the frame period       */
+#define LP_TIMEOUT_MS   100000u
+#define LP_BENCH_LINES  10000u
+#define LP_ROWS         LCD_VIRT_ROWS
+#define LP_COLS         LCD_VIRT_COLS
+#define LP_LAYER        TIMEDISPLAYER
+
+/* Formats a case both ways, see lpCheck() */
+#define LP_CASE(row, col, ...) do {                                          \
+    INT8C expect_[64];                                                     \
+    INT8U ret_;                                                            \
+    (void)snprintf(expect_, sizeof(expect_), __VA_ARGS__);                 \
+    LcdDispClear(LP_LAYER);                                                \
+    ret_ = LcdPrintf(row, col, LP_LAYER, __VA_ARGS__);                     \
+    lpCheck(__LINE__, row, col, expect_, ret_);                            \
+} while(0)
+
+static INT32U lpCases;
+static INT8U lpDone;
+
+static OS_TCB lpTaskTCB;
+static CPU_STK lpTaskStk[APP_CFG_TASK_START_STK_SIZE];
+
+static void lpTask(void *p_arg);
+static void lpFormats(void);
+static void lpCheck(int line, INT8U row, INT8U col, const INT8C *expect, INT8U ret);
+static void lpBench(void);
+static void lpTickHook(void);
+static INT64U lpBusNs(void);
+
+/*************************************************************************
+  main() - Runs the cases and the benchmark
+*************************************************************************/
+int main(void) {
+    OS_ERR os_err;
+
+    HostBenchInit();
+    OSInit(&os_err);
+    OSTaskCreate(&lpTaskTCB, "LCD Printf Test Task", lpTask, (void *)0,
+                 APP_CFG_TASK_START_PRIO, &lpTaskStk[0], APP_CFG_TASK_START_STK_SIZE / 10u,
+                 APP_CFG_TASK_START_STK_SIZE, 0, 0, (void *)0,
+                 (OS_OPT)(OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR), &os_err);
+    HostBusHookSet(lpBusNs);
+    HostTickHookSet(lpTickHook);
+    OSStart(&os_err);                   /* Returns once the test stops it */
+
+    HOST_CHECK(lpDone, "test did not finish by tick %u", LP_TIMEOUT_MS);
+    printf("LcdPrintfTest: %u cases, %u failed checks\n", lpCases, HostFails());
+    return((HostFails() == 0) ? 0 : 1);
+}
+
+/*************************************************************************
+  lpTask() - The format cases, then the benchmark
+*************************************************************************/
+static void lpTask(void *p_arg) {
+    OS_ERR os_err;
+    (void)p_arg;
+
+    LcdInit();
+    OSTimeDly(LP_FRAME_MS, OS_OPT_TIME_DLY, &os_err);
+    lpFormats();
+    lpBench();
+    lpDone = TRUE;
+    while(1) {
+        OSTimeDly(1000u, OS_OPT_TIME_DLY, &os_err);
+    }
+}
+
+/*************************************************************************
+  lpFormats() - Each conversion, flag and width, and the row end
+*************************************************************************/
+static void lpFormats(void) {
+    INT8U ret;
+
+    /* Conversions */
+    LP_CASE(1, 1, "plain text");
+    LP_CASE(1, 1, "%d", 42);
+    LP_CASE(1, 1, "%d", -42);
+    LP_CASE(1, 1, "%i", -7);
+    LP_CASE(1, 1, "%u", 3000000000u);
+    LP_CASE(1, 1, "%x", 0xBEEFu);
+    LP_CASE(1, 1, "%X", 0xBEEFu);
+    LP_CASE(1, 1, "%s", "string");
+    LP_CASE(1, 1, "%c%c%c", 'a', 'B', '9');
+    LP_CASE(1, 1, "100%%");
+    LP_CASE(1, 1, "%d%%", 99);
+    LP_CASE(2, 5, "%02u:%02u:%02u", 1u, 2u, 3u);
+
+    /* Flags and widths */
+    LP_CASE(1, 1, "[%5d]", 42);
+    LP_CASE(1, 1, "[%-5d]", 42);
+    LP_CASE(1, 1, "[%05d]", 42);
+    LP_CASE(1, 1, "[%05d]", -42);
+    LP_CASE(1, 1, "[%5d]", -42);
+    LP_CASE(1, 1, "[%-5d]", -42);
+    LP_CASE(1, 1, "[%04x]", 0xAu);
+    LP_CASE(1, 1, "[%-4X]", 0xAu);
+    LP_CASE(1, 1, "[%6s]", "ab");
+    LP_CASE(1, 1, "[%-6s]", "ab");
+    LP_CASE(1, 1, "[%1s]", "abc");
+    LP_CASE(1, 1, "[%1d]", 123);
+    LP_CASE(1, 1, "[%0u]", 0u);
+
+    /* 32-bit extremes */
+    LP_CASE(1, 1, "%d", (INT32S)0x7FFFFFFF);
+    LP_CASE(1, 1, "%d", (INT32S)(-0x7FFFFFFF - 1));
+    LP_CASE(1, 1, "%u", 0xFFFFFFFFu);
+    LP_CASE(1, 1, "%x", 0xFFFFFFFFu);
+    LP_CASE(1, 1, "%X", 0u);
+    LP_CASE(2, 1, "%d %d", (INT32S)(-0x7FFFFFFF - 1), (INT32S)0x7FFFFFFF);
+
+    /* The row end, the rest is dropped and the other row left alone */
+    LP_CASE(1, 1, "0123456789abcdefXYZ");
+    LP_CASE(1, 10, "%s", "clipped-text");
+    LP_CASE(1, 14, "%05d", 123);
+    LP_CASE(1, 15, "%-6s|", "ab");
+    LP_CASE(1, 16, "%c%c", 'L', 'X');
+    LP_CASE(2, 12, "%u", 4294967295u);
+    LP_CASE(2, 1, "%20s", "right");
+    LP_CASE(2, 3, "%d", (INT32S)(-0x7FFFFFFF - 1));
+
+    /* long is INT32U on the target, wider than the host's snprintf() */
+    LcdDispClear(LP_LAYER);
+    ret = LcdPrintf(1, 1, LP_LAYER, "%lx %lu", (INT32U)0xDEADBEEFu, (INT32U)7u);
+    lpCheck(__LINE__, 1, 1, "deadbeef 7", ret);
+
+    /* Outside the layer, nothing written */
+    LcdDispClear(LP_LAYER);
+    ret = LcdPrintf(0, 1, LP_LAYER, "row 0");
+    lpCheck(__LINE__, 1, 1, "", ret);
+    ret = LcdPrintf(1, 0, LP_LAYER, "col 0");
+    lpCheck(__LINE__, 1, 1, "", ret);
+    ret = LcdPrintf(1, LP_COLS + 1u, LP_LAYER, "col 17");
+    lpCheck(__LINE__, 1, 1, "", ret);
+    ret = LcdPrintf(LP_ROWS + 1u, 1, LP_LAYER, "row 3");
+    lpCheck(__LINE__, 1, 1, "", ret);
+
+    /* An unknown conversion ends the output */
+    LcdDispClear(LP_LAYER);
+    ret = LcdPrintf(1, 1, LP_LAYER, "ab%qcd");
+    lpCheck(__LINE__, 1, 1, "ab", ret);
+}
+
+/*************************************************************************
+  lpCheck() - Waits for the frame and checks expect, clipped at the row
+              end, is at row, col and nothing else is on the glass
+*************************************************************************/
+static void lpCheck(int line, INT8U row, INT8U col, const INT8C *expect, INT8U ret) {
+    OS_ERR os_err;
+    INT8C glass[LP_ROWS][LP_COLS];
+    INT8C want[LP_ROWS][LP_COLS];
+    INT32U len = strlen(expect);
+    INT32U room = LP_COLS - (col - 1u);
+
+    lpCases++;
+    if(len > room) {
+        len = room;
+    }else{
+    }
+    memset(want, ' ', sizeof(want));
+    memcpy(&want[row - 1u][col - 1u], expect, len);
+    OSTimeDly(LP_FRAME_MS, OS_OPT_TIME_DLY, &os_err);
+    LcdVirtGlassGet(glass);
+    HOST_CHECK(ret == len, "line %d: returned %u, expected %u", line, ret, len);
+    HOST_CHECK(memcmp(glass, want, sizeof(glass)) == 0,
+               "line %d: glass [%.16s][%.16s], expected [%.16s][%.16s]", line, glass[0],
+               glass[1], want[0], want[1]);
+}
+
+/*************************************************************************
+  lpBench() - The status line both ways
+*************************************************************************/
+static void lpBench(void) {
+    OS_ERR os_err;
+    HOST_TASK_STATS lcd_was, lcd;
+    INT8C glass[LP_ROWS][LP_COLS];
+    INT8C want[LP_COLS + 1u];
+    INT64U start, cyc[2];
+    INT32U posts[2];
+    INT32U line, secs;
+    INT8U way;
+
+    for(way = 0; way < 2u; way++) {
+        LcdDispClear(LP_LAYER);
+        OSTimeDly(LP_FRAME_MS, OS_OPT_TIME_DLY, &os_err);
+        (void)HostTaskStatsGet(APP_CFG_LCD_TASK_PRIO, &lcd_was);
+        start = HostBenchCyc();
+        for(line = 0; line < LP_BENCH_LINES; line++) {
+            secs = (12u * 3600u) + line;
+            if(way == 0) {
+                (void)LcdPrintf(2, 1, LP_LAYER, "%02u:%02u:%02u T%03uC", secs / 3600u,
+                                (secs / 60u) % 60u, secs % 60u, line % 256u);
+            }else{
+                LcdDispTime(2, 1, LP_LAYER, (INT8U)(secs / 3600u), (INT8U)((secs / 60u) % 60u),
+                            (INT8U)(secs % 60u));
+                LcdDispString(2, 9, LP_LAYER, " T");
+                LcdDispDecByte(2, 11, LP_LAYER, (INT8U)(line % 256u), 1);
+                LcdDispString(2, 14, LP_LAYER, "C");
+            }
+        }
+        cyc[way] = HostBenchSince(start);
+        (void)HostTaskStatsGet(APP_CFG_LCD_TASK_PRIO, &lcd);
+        posts[way] = lcd.sem_posts - lcd_was.sem_posts;
+
+        /* Both leave the last line on the glass */
+        OSTimeDly(LP_FRAME_MS, OS_OPT_TIME_DLY, &os_err);
+        LcdVirtGlassGet(glass);
+        line--;
+        secs = (12u * 3600u) + line;
+        (void)snprintf(want, sizeof(want), "%02u:%02u:%02u T%03uC  ", secs / 3600u,
+                       (secs / 60u) % 60u, secs % 60u, line % 256u);
+        HOST_CHECK(memcmp(glass[1], want, LP_COLS) == 0, "bench %u: [%.16s], expected [%.16s]",
+                   way, glass[1], want);
+    }
+    HOST_CHECK(posts[0] == LP_BENCH_LINES, "LcdPrintf: %u posts for %u lines", posts[0],
+               LP_BENCH_LINES);
+    HOST_CHECK(posts[1] == (4u * LP_BENCH_LINES), "LcdDisp calls: %u posts for %u lines",
+               posts[1], LP_BENCH_LINES);
+    printf("  status line      calls  posts  host cycles\n");
+    printf("  LcdPrintf        %5u  %5u  %11.1f\n", 1u, posts[0] / LP_BENCH_LINES,
+           (double)cyc[0] / LP_BENCH_LINES);
+    printf("  LcdDisp calls    %5u  %5u  %11.1f\n", 4u, posts[1] / LP_BENCH_LINES,
+           (double)cyc[1] / LP_BENCH_LINES);
+}
+
+static void lpTickHook(void) {
+    if(lpDone || (HostTickGet() >= LP_TIMEOUT_MS)) {
+        HostStop();
+    }else{
+    }
+}
+
+static INT64U lpBusNs(void) {
+    LCD_VIRT_STATS stats;
+
+    LcdVirtStatsGet(&stats);
+    return(stats.bus_ns);
+}
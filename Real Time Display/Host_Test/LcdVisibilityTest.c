@@ -0,0 +1,252 @@
+/*************************************************************************
+* LcdVisibilityTest.c - Hiding, showing, toggling and swapping layers
+*
+*            Runs LcdLayered.c under HostOs.c against the LcdBusVirtual
+*            HD44780 model. The four layers hold overlapping text, some
+*            of it the same character as the layer underneath, and the
+*            test task, under the LCD task's priority, hides, shows,
+*            toggles and swaps them one step at a time.
+*
+*            After each step the glass has to match a plain model of the
+*            layers, and the model's DDRAM has to have been written once
+*            in each cell that changed and in no other. A step that
+*            changes nothing must not write a frame. The cells written,
+*            the bus time and the latency from the call to the last bus
+*            write of its frame are reported per step.
+*
+*            Built with the scrub off, it would write cells of its own,
+*            and with LCD_LATENCY_EN.
+*
+* 10/18/2026 Initial version
+*************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "MCUType.h"
+#include "os.h"
+#include "app_cfg.h"
+#include "HostOs.h"
+#include "LcdLayered.h"
+#include "LcdBusVirtual.h"
+
+#define LV_FRAME_MS     100u        /* Frame written and the task idle    */
+#define LV_TIMEOUT_MS   10000u
+#define LV_ROWS         LCD_VIRT_ROWS
+#define LV_COLS         LCD_VIRT_COLS
+
+typedef enum{LV_HIDE, LV_SHOW, LV_TOGGLE, LV_SWAP}LV_OP;
+
+typedef struct{
+    const char *name;
+    LV_OP op;
+    INT8U layer;                    /* Hidden by a swap                   */
+    INT8U show;                     /* Shown by a swap                    */
+}LV_STEP;
+
+static const LV_STEP lvSteps[] = {
+    {"hide swatch",     LV_HIDE,   SWATCHLAYER,   0},
+    {"show swatch",     LV_SHOW,   SWATCHLAYER,   0},
+    {"show swatch",     LV_SHOW,   SWATCHLAYER,   0},
+    {"show stats",      LV_SHOW,   STATSLAYER,    0},
+    {"toggle timeset",  LV_TOGGLE, TIMESETLAYER,  0},
+    {"toggle timeset",  LV_TOGGLE, TIMESETLAYER,  0},
+    {"swap to swatch",  LV_SWAP,   STATSLAYER,    SWATCHLAYER},
+    {"swap to stats",   LV_SWAP,   SWATCHLAYER,   STATSLAYER},
+    {"hide time",       LV_HIDE,   TIMEDISPLAYER, 0},
+    {"hide time",       LV_HIDE,   TIMEDISPLAYER, 0},
+    {"show time",       LV_SHOW,   TIMEDISPLAYER, 0},
+};
+
+#define LV_NUM_STEPS (sizeof(lvSteps) / sizeof(lvSteps[0]))
+
+/* Each layer's text, a space is transparent */
+static const INT8C *const lvText[LCD_NUM_LAYERS][LV_ROWS] = {
+    {"Clock 12:34:56 A", "0123456789abcdef"},
+    {"      12:00     ", "SW  4567    ab  "},
+    {"       STATS    ", "           cd99 "},
+    {"SET             ", "            ####"},
+};
+
+static INT8C lvLayers[LCD_NUM_LAYERS][LV_ROWS][LV_COLS];    /* The model  */
+static INT8U lvHidden[LCD_NUM_LAYERS];
+static INT8U lvDone;
+
+static OS_TCB lvTaskTCB;
+static CPU_STK lvTaskStk[APP_CFG_UITASK_STK_SIZE];
+
+static void lvTask(void *p_arg);
+static void lvStep(const LV_STEP *ps);
+static void lvCompose(INT8C glass[LV_ROWS][LV_COLS]);
+static INT32U lvLatency(const LV_STEP *ps);
+static void lvTickHook(void);
+static INT64U lvBusNs(void);
+
+/*************************************************************************
+  main() - Runs the steps
+*************************************************************************/
+int main(void) {
+    OS_ERR os_err;
+
+    OSInit(&os_err);
+    OSTaskCreate(&lvTaskTCB, "LCD Visibility Test Task", lvTask, (void *)0,
+                 APP_CFG_UITASK_PRIO, &lvTaskStk[0], APP_CFG_UITASK_STK_SIZE / 10u,
+                 APP_CFG_UITASK_STK_SIZE, 0, 0, (void *)0,
+                 (OS_OPT)(OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR), &os_err);
+    HostBusHookSet(lvBusNs);
+    HostTickHookSet(lvTickHook);
+    OSStart(&os_err);                   /* Returns once the test stops it */
+
+    HOST_CHECK(lvDone, "steps did not finish by tick %u", LV_TIMEOUT_MS);
+    printf("LcdVisibilityTest: %u steps, %u failed checks\n", (INT32U)LV_NUM_STEPS,
+           HostFails());
+    return((HostFails() == 0) ? 0 : 1);
+}
+
+/*************************************************************************
+  lvTask() - Draws the layers, then runs each step
+*************************************************************************/
+static void lvTask(void *p_arg) {
+    OS_ERR os_err;
+    INT8U layer, row;
+    INT8U step;
+    (void)p_arg;
+
+    LcdInit();
+    for(layer = 0; layer < LCD_NUM_LAYERS; layer++) {
+        for(row = 0; row < LV_ROWS; row++) {
+            LcdDispString((INT8U)(row + 1u), 1, layer, lvText[layer][row]);
+            memcpy(lvLayers[layer][row], lvText[layer][row], LV_COLS);
+        }
+    }
+    LcdHideLayer(STATSLAYER);
+    lvHidden[STATSLAYER] = TRUE;
+    OSTimeDly(LV_FRAME_MS, OS_OPT_TIME_DLY, &os_err);
+
+    printf("  step             changed  written  bus us  latency us\n");
+    for(step = 0; step < LV_NUM_STEPS; step++) {
+        lvStep(&lvSteps[step]);
+    }
+    lvDone = TRUE;
+    while(1) {
+        OSTimeDly(1000u, OS_OPT_TIME_DLY, &os_err);
+    }
+}
+
+/*************************************************************************
+  lvStep() - One step, on the LCD and the model, then the checks
+*************************************************************************/
+static void lvStep(const LV_STEP *ps) {
+    OS_ERR os_err;
+    INT8C before[LV_ROWS][LV_COLS];
+    INT8C after[LV_ROWS][LV_COLS];
+    INT8C glass[LV_ROWS][LV_COLS];
+    LCD_VIRT_STATS bus;
+    LCD_STATS stats;
+    INT32U frames_was;
+    INT32U changed = 0;
+    INT32U written = 0;
+    INT32U lat_cyc;
+    INT8U row, col, expect;
+
+    lvCompose(before);
+    (void)LcdStatsGet(0, &stats);
+    frames_was = stats.frames;
+    LcdVirtStatsClear();
+    LcdLatencyReset();
+    switch(ps->op) {
+    case LV_HIDE:
+        LcdHideLayer(ps->layer);
+        lvHidden[ps->layer] = TRUE;
+        break;
+    case LV_SHOW:
+        LcdShowLayer(ps->layer);
+        lvHidden[ps->layer] = FALSE;
+        break;
+    case LV_TOGGLE:
+        LcdToggleLayer(ps->layer);
+        lvHidden[ps->layer] = !lvHidden[ps->layer];
+        break;
+    default:
+        LcdSwapLayers(ps->layer, ps->show);
+        lvHidden[ps->layer] = TRUE;
+        lvHidden[ps->show] = FALSE;
+        break;
+    }
+    OSTimeDly(LV_FRAME_MS, OS_OPT_TIME_DLY, &os_err);
+    lvCompose(after);
+
+    LcdVirtGlassGet(glass);
+    LcdVirtStatsGet(&bus);
+    (void)LcdStatsGet(0, &stats);
+    for(row = 0; row < LV_ROWS; row++) {
+        HOST_CHECK(memcmp(glass[row], after[row], LV_COLS) == 0,
+                   "%s: row %u [%.16s], expected [%.16s]", ps->name, row + 1u, glass[row],
+                   after[row]);
+        for(col = 0; col < LCD_VIRT_DDRAM_COLS; col++) {
+            expect = (INT8U)((col < LV_COLS) && (before[row][col] != after[row][col]));
+            changed += expect;
+            written += bus.ddram_writes[row][col];
+            HOST_CHECK(bus.ddram_writes[row][col] == expect,
+                       "%s: cell %u,%u written %u times, expected %u", ps->name, row + 1u,
+                       col + 1u, bus.ddram_writes[row][col], expect);
+        }
+    }
+    lat_cyc = lvLatency(ps);
+    if(changed == 0) {
+        HOST_CHECK(stats.frames == frames_was, "%s: %u frames, nothing changed", ps->name,
+                   stats.frames - frames_was);
+    }else{
+        HOST_CHECK(stats.frames == (frames_was + 1u), "%s: %u frames, expected 1", ps->name,
+                   stats.frames - frames_was);
+        HOST_CHECK(lat_cyc != 0, "%s: no latency measured", ps->name);
+    }
+    printf("  %-16s  %7u  %7u  %6u  %10.1f\n", ps->name, changed, written,
+           (INT32U)(bus.bus_ns / 1000u), (double)lat_cyc / (HOST_CPU_HZ / 1000000u));
+}
+
+/* The glass the model makes, the top visible character of each cell */
+static void lvCompose(INT8C glass[LV_ROWS][LV_COLS]) {
+    INT8U row, col, layer;
+
+    memset(glass, ' ', LV_ROWS * LV_COLS);
+    for(row = 0; row < LV_ROWS; row++) {
+        for(col = 0; col < LV_COLS; col++) {
+            for(layer = 0; layer < LCD_NUM_LAYERS; layer++) {
+                if((lvHidden[layer] == FALSE) && (lvLayers[layer][row][col] != ' ')) {
+                    glass[row][col] = lvLayers[layer][row][col];
+                }else{
+                }
+            }
+        }
+    }
+}
+
+/* Call to last bus write of the step's frame, cycles, 0 for no frame */
+static INT32U lvLatency(const LV_STEP *ps) {
+    LCD_LATENCY lat;
+    INT32U max = 0;
+
+    if(LcdLatencyGet(ps->layer, &lat) && (lat.count != 0)) {
+        max = lat.max;
+    }else{
+    }
+    if((ps->op == LV_SWAP) && LcdLatencyGet(ps->show, &lat) && (lat.count != 0)
+       && (lat.max > max)) {
+        max = lat.max;
+    }else{
+    }
+    return(max);
+}
+
+static void lvTickHook(void) {
+    if(lvDone || (HostTickGet() >= LV_TIMEOUT_MS)) {
+        HostStop();
+    }else{
+    }
+}
+
+static INT64U lvBusNs(void) {
+    LCD_VIRT_STATS stats;
+
+    LcdVirtStatsGet(&stats);
+    return(stats.bus_ns);
+}
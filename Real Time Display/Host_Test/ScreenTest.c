@@ -0,0 +1,357 @@
+/*************************************************************************
+* ScreenTest.c - Screen switches through the whole application
+*
+*            Runs the real Lab2.c (its main() built as AppMain()) with
+*            KeyPortVirtual playing clean presses and LcdBusVirtual as
+*            the display. Screen.c is included here, so the test can
+*            see its event flag group. After C leaves Time Set:
+*
+*              switch  SC_SWITCHES times D then B, clock to stopwatch
+*                      and back
+*              hidden  D to the stopwatch, stopped, for SC_QUIET_MS
+*              stats   * starts the stopwatch, D to the stats screen
+*                      for SC_QUIET_MS
+*              back    D to the clock
+*
+*            Each switch is timed with the debug bit trace the way
+*            KeyLatency.c does: press -> UITask has the key (DB0 on),
+*            then -> the frame on the glass (DB4 off), within the
+*            debounce scans and a frame cap period. The glass has to
+*            show the new screen after it.
+*
+*            While the stopwatch is up and stopped nothing may reach
+*            the LCD, no posts to the LCD task and no strobes. The
+*            clock is hidden, so TimeDispTask may not wake and has to
+*            be blocked on Screen.c's flag group, in ScreenPend(), not
+*            in TimePend(). With the stats screen up the LCD task may
+*            only take the stats refresh, SC_STATS_POSTS a second, and
+*            none from the running stopwatch's 100ms ticks. UITask may
+*            only wake for the screen that is up, at its period. Back on
+*            the clock TimeDispTask has to be off the flag group and the
+*            time on ROW1 again.
+*
+*            Built with DB_TRACE_EN and without the scrub, which writes
+*            the glass on its own, see LcdVisibilityTest.c.
+*
+* 10/18/2026 Initial version
+*************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "MCUType.h"
+#include "os.h"
+#include "app_cfg.h"
+#include "HostOs.h"
+#include "uCOSKey.h"
+#include "KeyPortVirtual.h"
+#include "K65TWR_GPIO.h"
+#include "LcdBusVirtual.h"
+#include "Screen.c"
+
+#define SC_START_MS     600u        /* Boot done and the LCD powered up   */
+#define SC_HOLD_MS      60u
+#define SC_GAP_MS       300u        /* Press to press                     */
+#define SC_SWITCHES     50u         /* D and B pairs                      */
+#define SC_SHOWN_MS     200u        /* Press to the screen check          */
+#define SC_SETTLE_MS    2000u       /* Last frames of a switch done       */
+#define SC_QUIET_MS     10000u
+#define SC_STATS_POSTS  2u          /* uiStatsTick()'s LcdPrintf() lines  */
+#define SC_MAX_STEPS    512u
+#define SC_MAX_MARKS    ((2u * SC_SWITCHES) + 8u)
+#define SC_MAX_TIMED    (2u * SC_SWITCHES)
+/* A press is taken within the debounce scans, one to see it and the
+   samples, and its frame within the frame cap's period */
+#define SC_KEY_NS       ((KEY_DEBOUNCE_SAMPLES + 1u) * KEY_RATE_ACTIVE_MS * 1000000ull)
+#define SC_GLASS_NS     (1000000000ull / LCD_FRAME_RATE_HZ)
+
+#define SC_CLOCK        0u          /* Lab2.c's uiScreens[]               */
+#define SC_SWATCH       1u
+#define SC_STATS        2u
+
+typedef enum{SC_SCREEN, SC_QUIET_START, SC_QUIET_END, SC_CLOCK_BACK, SC_STOP}SC_MARK_TYPE;
+
+typedef struct{
+    INT32U tick;
+    SC_MARK_TYPE type;
+    INT32U arg;                     /* Screen, or the LCD posts allowed   */
+}SC_MARK;
+
+typedef struct{
+    INT64U press_ns;
+    INT64U ui_ns;                   /* DB0 on after the press             */
+    INT64U glass_ns;                /* DB4 off after that                 */
+}SC_TIMED;
+
+void AppMain(void);                 /* Lab2.c main() */
+void RTC_Seconds_IRQHandler(void);
+
+static const INT8C scKeys[] = "123A456B789C*0#D";
+
+static KEY_VIRT_STEP scScript[SC_MAX_STEPS];
+static INT16U scNumSteps;
+static INT32U scMs = SC_START_MS;
+static INT32U scPressMs;            /* The last press closed              */
+static INT32U scRelMs = SC_START_MS;    /* and opened                     */
+static SC_MARK scMarks[SC_MAX_MARKS];
+static INT16U scNumMarks;
+static INT16U scNextMark;
+static SC_TIMED scTimed[SC_MAX_TIMED];
+static INT16U scNumTimed;
+static INT16U scTiming;             /* Switch the trace is looking for    */
+static INT32U scEdgesLost;
+
+static HOST_TASK_STATS scLcdStart;
+static HOST_TASK_STATS scDispStart;
+static HOST_TASK_STATS scUiStart;
+static LCD_VIRT_STATS scBusStart;
+static INT8U scDone;
+
+static void scBuild(void);
+static void scPress(INT8C key, INT8U timed);
+static void scMark(INT32U after_ms, SC_MARK_TYPE type, INT32U arg);
+static void scTickHook(void);
+static void scCheckMark(const SC_MARK *pm);
+static void scDrain(void);
+static INT64U scBusNs(void);
+static void scReport(void);
+
+/*************************************************************************
+  main() - Runs the application over the script, checking as it goes
+*************************************************************************/
+int main(void) {
+    scBuild();
+    HostBusHookSet(scBusNs);
+    HostTickHookSet(scTickHook);
+    AppMain();                          /* Returns once the hook stops it */
+
+    scEdgesLost += GpioDBugTraceLost();
+    HOST_CHECK(scDone, "script did not finish");
+    HOST_CHECK(scEdgesLost == 0, "%u trace edges lost", scEdgesLost);
+    scReport();
+    printf("ScreenTest: %u switches timed, %u failed checks\n", scNumTimed, HostFails());
+    return((HostFails() == 0) ? 0 : 1);
+}
+
+/*************************************************************************
+  scBuild() - The presses and the checks after them
+*************************************************************************/
+static void scBuild(void) {
+    INT16U cnt;
+
+    scPress('C', FALSE);
+    for(cnt = 0; cnt < SC_SWITCHES; cnt++) {
+        scPress('D', TRUE);
+        scMark(SC_SHOWN_MS, SC_SCREEN, SC_SWATCH);
+        scPress('B', TRUE);
+        scMark(SC_SHOWN_MS, SC_SCREEN, SC_CLOCK);
+    }
+    scPress('D', FALSE);
+    scMark(SC_SETTLE_MS, SC_QUIET_START, 0);
+    scMark(SC_SETTLE_MS + SC_QUIET_MS, SC_QUIET_END, 0);
+    scMs += SC_SETTLE_MS + SC_QUIET_MS;
+    scPress('*', FALSE);
+    scPress('D', FALSE);
+    scMark(SC_SETTLE_MS, SC_QUIET_START, 0);
+    scMark(SC_SETTLE_MS + SC_QUIET_MS, SC_QUIET_END,
+           ((SC_QUIET_MS / 1000u) + 1u) * SC_STATS_POSTS);
+    scMs += SC_SETTLE_MS + SC_QUIET_MS;
+    scPress('D', FALSE);
+    scMark(SC_SETTLE_MS, SC_CLOCK_BACK, 0);
+    scMark(SC_SETTLE_MS + 1u, SC_STOP, 0);
+}
+
+/* A clean press, opening SC_GAP_MS after scMs, timed as a switch if timed */
+static void scPress(INT8C key, INT8U timed) {
+    INT16U bit = (INT16U)(1u << (strchr(scKeys, key) - scKeys));
+
+    scMs += SC_GAP_MS;
+    scScript[scNumSteps].ms = (INT16U)(scMs - SC_HOLD_MS - scRelMs);
+    scPressMs = scMs - SC_HOLD_MS;
+    scRelMs = scMs;
+    scScript[scNumSteps].keys = bit;
+    scScript[scNumSteps + 1u].ms = SC_HOLD_MS;
+    scScript[scNumSteps + 1u].keys = 0;
+    scNumSteps += 2u;
+    if(timed && (scNumTimed < SC_MAX_TIMED)) {
+        scTimed[scNumTimed].press_ns = (INT64U)scPressMs * 1000000ull;
+        scNumTimed++;
+    }else{
+    }
+}
+
+/* A check after_ms after the last press */
+static void scMark(INT32U after_ms, SC_MARK_TYPE type, INT32U arg) {
+    if(scNumMarks < SC_MAX_MARKS) {
+        scMarks[scNumMarks].tick = scPressMs + after_ms;
+        scMarks[scNumMarks].type = type;
+        scMarks[scNumMarks].arg = arg;
+        scNumMarks++;
+    }else{
+    }
+}
+
+/*************************************************************************
+  scTickHook() - The script, the RTC seconds interrupt, the trace and
+                 the checks that are due
+*************************************************************************/
+static void scTickHook(void) {
+    INT32U tick = HostTickGet();
+
+    if(tick == SC_START_MS) {
+        KeyVirtScript(scScript, scNumSteps);
+    }else if(tick > SC_START_MS) {
+        (void)KeyVirtScriptTick();
+    }else{
+    }
+    if((tick % 1000u) == 0) {
+        RTC_Seconds_IRQHandler();
+    }else{
+    }
+    scDrain();
+    while((scNextMark < scNumMarks) && (scMarks[scNextMark].tick == tick)) {
+        scCheckMark(&scMarks[scNextMark]);
+        scNextMark++;
+    }
+}
+
+/*************************************************************************
+  scCheckMark() - One check of the script
+*************************************************************************/
+static void scCheckMark(const SC_MARK *pm) {
+    HOST_TASK_STATS lcd, disp, ui;
+    LCD_VIRT_STATS bus;
+    INT32U ui_max;
+    INT8C glass[LCD_VIRT_ROWS][LCD_VIRT_COLS];
+    const void *pend_on = HostTaskPendOn(APP_CFG_TIMEDISPTASK_PRIO);
+
+    (void)HostTaskStatsGet(APP_CFG_LCD_TASK_PRIO, &lcd);
+    (void)HostTaskStatsGet(APP_CFG_TIMEDISPTASK_PRIO, &disp);
+    (void)HostTaskStatsGet(APP_CFG_UITASK_PRIO, &ui);
+    LcdVirtStatsGet(&bus);
+    LcdVirtGlassGet(glass);
+    switch(pm->type) {
+    case SC_SCREEN:
+        HOST_CHECK(ScreenActive() == pm->arg, "screen %u up, expected %u", ScreenActive(),
+                   pm->arg);
+        if(pm->arg == SC_SWATCH) {
+            HOST_CHECK(memcmp(glass[0], "Stopwatch", 9u) == 0, "stopwatch: glass [%.16s]",
+                       glass[0]);
+        }else{
+            HOST_CHECK((glass[0][10] == ':') && (glass[0][13] == ':'), "clock: glass [%.16s]",
+                       glass[0]);
+        }
+        break;
+    case SC_QUIET_START:
+        scLcdStart = lcd;
+        scDispStart = disp;
+        scUiStart = ui;
+        scBusStart = bus;
+        HOST_CHECK(pend_on == &screenFlags, "clock hidden, TimeDispTask not in ScreenPend()");
+        break;
+    case SC_QUIET_END:
+        HOST_CHECK((lcd.sem_posts - scLcdStart.sem_posts) <= pm->arg,
+                   "screen %u: %u LCD posts in %u ms, at most %u", ScreenActive(),
+                   lcd.sem_posts - scLcdStart.sem_posts, SC_QUIET_MS, pm->arg);
+        if(pm->arg == 0) {
+            HOST_CHECK(bus.strobes == scBusStart.strobes, "screen %u: %u strobes in %u ms",
+                       ScreenActive(), bus.strobes - scBusStart.strobes, SC_QUIET_MS);
+        }else{
+        }
+        HOST_CHECK(disp.wakes == scDispStart.wakes, "screen %u: TimeDispTask woke %u times",
+                   ScreenActive(), disp.wakes - scDispStart.wakes);
+        HOST_CHECK(pend_on == &screenFlags, "clock hidden, TimeDispTask not in ScreenPend()");
+        ui_max = (screenTable[screenCur].period_ms != 0)
+                 ? ((SC_QUIET_MS / screenTable[screenCur].period_ms) + 1u) : 0u;
+        HOST_CHECK((ui.wakes - scUiStart.wakes) <= ui_max,
+                   "screen %u: UITask woke %u times, at most %u", ScreenActive(),
+                   ui.wakes - scUiStart.wakes, ui_max);
+        printf("  screen %u for %u ms: %u LCD posts, %u strobes, %u UITask and %u"
+               " TimeDispTask wakes\n", ScreenActive(), SC_QUIET_MS,
+               lcd.sem_posts - scLcdStart.sem_posts, bus.strobes - scBusStart.strobes,
+               ui.wakes - scUiStart.wakes, disp.wakes - scDispStart.wakes);
+        break;
+    case SC_CLOCK_BACK:
+        HOST_CHECK(ScreenActive() == SC_CLOCK, "screen %u up, expected the clock",
+                   ScreenActive());
+        HOST_CHECK((pend_on != 0) && (pend_on != &screenFlags),
+                   "clock up, TimeDispTask not in TimePend()");
+        HOST_CHECK((glass[0][10] == ':') && (glass[0][13] == ':'), "clock: glass [%.16s]",
+                   glass[0]);
+        break;
+    case SC_STOP:
+    default:
+        scDone = TRUE;
+        HostStop();
+        break;
+    }
+}
+
+/*************************************************************************
+  scDrain() - Reads the trace, finding each timed switch's edges
+*************************************************************************/
+static void scDrain(void) {
+    static INT64U cyc_hi;
+    static INT32U cyc_last;
+    DB_TRACE_REC rec;
+    SC_TIMED *pt;
+    INT64U ns;
+
+    while(GpioDBugTraceRead(&rec)) {
+        if(rec.cyc < cyc_last) {
+            cyc_hi += 1ull << 32;
+        }else{
+        }
+        cyc_last = rec.cyc;
+        ns = ((cyc_hi | rec.cyc) * 1000u) / (HOST_CPU_HZ / 1000000u);
+        if(scTiming >= scNumTimed) {
+            continue;
+        }else{
+        }
+        pt = &scTimed[scTiming];
+        if(ns < pt->press_ns) {
+        }else if((pt->ui_ns == 0) && (rec.bit == 0u) && (rec.level == DB_TRACE_ON)) {
+            pt->ui_ns = ns;
+        }else if((pt->ui_ns != 0) && (rec.bit == 4u) && (rec.level == DB_TRACE_OFF)) {
+            pt->glass_ns = ns;
+            scTiming++;
+        }else{
+        }
+    }
+}
+
+static INT64U scBusNs(void) {
+    LCD_VIRT_STATS stats;
+
+    LcdVirtStatsGet(&stats);
+    return(stats.bus_ns);
+}
+
+/*************************************************************************
+  scReport() - Press to key and key to glass for each switch
+*************************************************************************/
+static void scReport(void) {
+    INT16U cnt;
+    INT64U ui, glass, ui_max = 0, glass_max = 0, ui_sum = 0, glass_sum = 0;
+
+    HOST_CHECK(scTiming == scNumTimed, "%u of %u switches reached the glass", scTiming,
+               scNumTimed);
+    for(cnt = 0; cnt < scTiming; cnt++) {
+        ui = scTimed[cnt].ui_ns - scTimed[cnt].press_ns;
+        glass = scTimed[cnt].glass_ns - scTimed[cnt].ui_ns;
+        HOST_CHECK(ui <= SC_KEY_NS, "switch %u: %u us press to UITask", cnt,
+                   (INT32U)(ui / 1000u));
+        HOST_CHECK(glass <= SC_GLASS_NS, "switch %u: %u us UITask to glass", cnt,
+                   (INT32U)(glass / 1000u));
+        ui_sum += ui;
+        glass_sum += glass;
+        ui_max = (ui > ui_max) ? ui : ui_max;
+        glass_max = (glass > glass_max) ? glass : glass_max;
+    }
+    if(scTiming != 0) {
+        printf("  switch, %u         mean ms  max ms\n", scTiming);
+        printf("  press -> UITask    %7.2f  %6.2f\n", (ui_sum / (double)scTiming) / 1e6,
+               ui_max / 1e6);
+        printf("  UITask -> glass    %7.2f  %6.2f\n", (glass_sum / (double)scTiming) / 1e6,
+               glass_max / 1e6);
+    }else{
+    }
+}
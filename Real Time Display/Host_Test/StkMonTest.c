@@ -0,0 +1,299 @@
+/*************************************************************************
+* StkMonTest.c - StkMon.c's sizes and report from synthetic fills
+*
+*            Builds StkMon.c with STK_MON_EN against the real uC/OS-III
+*            headers, included so the test can call its static
+*            stkMonRec(). The kernel is stubbed down to OSTaskStkChk(),
+*            which counts the zero words up from the stack base the way
+*            os_task.c does. No task runs, each stack is zero filled as
+*            OS_OPT_TASK_STK_CLR leaves it, then filled down from the
+*            top to a set high-water mark.
+*
+*            smStks[] has every kernel stack, the six app_cfg.h stacks
+*            and the ISR stack at the target's sizes, with marks that
+*            hit the margin minimum, the 25% margin, the rounding,
+*            OS_CFG_STK_SIZE_MIN and a full stack, and a zero word
+*            pushed at the very edge of one, which StkMon misses by a
+*            word. A task made without OS_OPT_TASK_STK_CHK and one that
+*            was deleted have to be left out.
+*
+*            stkMonRec() is checked against the rule in StkMon.h for
+*            every mark up to SM_REC_MAX. StkMonGet() has to give each
+*            stack's size, mark and recommended size, in the order
+*            added, then the ISR stack. StkMonCfgWrite()'s report has to
+*            total the RAM now and at the recommended sizes, flag only
+*            the full stack and write one #define per stack. The report
+*            is printed, it is the before/after footprint for these
+*            marks.
+*
+* 10/18/2026 Initial version
+*************************************************************************/
+#define OS_GLOBALS
+#include "StkMon.c"                     /* For the static stkMonRec()    */
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SM_REC_MAX      4096u
+#define SM_FILL         0x5A5A5A5Au
+#define SM_TEXT_SIZE    4096u
+#define SM_MAX_STK      128u
+
+/* HostOs.c's HostCheck(), which cannot link with the real kernel */
+#define SM_CHECK(ok, ...) smCheck((INT8U)((ok) != 0), __LINE__, __VA_ARGS__)
+
+typedef struct{
+    OS_TCB *tcb;                /* 0 for the ISR stack                   */
+    const INT8C *cfg;
+    INT32U size;
+    INT32U used;                /* Words filled down from the top        */
+    INT32U seen;                /* The mark StkMon has to give           */
+    INT32U rec;                 /* Worked out by hand from StkMon.h      */
+}SM_STK;
+
+static OS_TCB smTCB[6];
+static OS_TCB smNoChkTCB;
+static OS_TCB smDeletedTCB;
+
+static SM_STK smStks[] = {
+    {&OSIdleTaskTCB, "OS_CFG_IDLE_TASK_STK_SIZE", OS_CFG_IDLE_TASK_STK_SIZE,  20u,  20u,  64u},
+    {&OSTickTaskTCB, "OS_CFG_TICK_TASK_STK_SIZE", OS_CFG_TICK_TASK_STK_SIZE, 100u, 100u, 128u},
+    {&OSStatTaskTCB, "OS_CFG_STAT_TASK_STK_SIZE", OS_CFG_STAT_TASK_STK_SIZE,  60u,  60u,  80u},
+    {&OSTmrTaskTCB,  "OS_CFG_TMR_TASK_STK_SIZE",  OS_CFG_TMR_TASK_STK_SIZE,   16u,  16u,  64u},
+    {&smTCB[0], "APP_CFG_TASK_START_STK_SIZE",   APP_CFG_TASK_START_STK_SIZE,    70u,  70u,  88u},
+    {&smTCB[1], "APP_CFG_UITASK_STK_SIZE",       APP_CFG_UITASK_STK_SIZE,        96u,  96u, 120u},
+    {&smTCB[2], "APP_CFG_TIMEDISPTASK_STK_SIZE", APP_CFG_TIMEDISPTASK_STK_SIZE,  97u,  97u, 128u},
+    {&smTCB[3], "APP_CFG_KEY_TASK_STK_SIZE",     APP_CFG_KEY_TASK_STK_SIZE,      41u,  40u,  64u},
+    {&smTCB[4], "APP_CFG_LCD_TASK_STK_SIZE",     APP_CFG_LCD_TASK_STK_SIZE,     127u, 127u, 160u},
+    {&smTCB[5], "APP_CFG_TIME_TASK_STK_SIZE",    APP_CFG_TIME_TASK_STK_SIZE,     50u,  50u,  72u},
+    {(OS_TCB *)0, "OS_CFG_ISR_STK_SIZE",         OS_CFG_ISR_STK_SIZE,            33u,  33u,  56u}};
+
+#define SM_NUM_STKS ((INT8U)(sizeof(smStks) / sizeof(smStks[0])))
+#define SM_KEY_STK  7u                  /* Zero pushed at the edge        */
+#define SM_FULL_STK 1u
+
+static CPU_STK smMem[SM_NUM_STKS][SM_MAX_STK];
+static CPU_STK smSpareStk[2][APP_CFG_UITASK_STK_SIZE];
+static INT8C smText[SM_TEXT_SIZE];
+static INT32U smTextLen;
+static INT32U smFails;
+
+/* The kernel StkMon.c calls, reduced to the stacks */
+CPU_STK *const OSCfg_ISRStkBasePtr = &smMem[SM_NUM_STKS - 1u][0];
+CPU_STK_SIZE const OSCfg_ISRStkSize = OS_CFG_ISR_STK_SIZE;
+
+void OSTaskStkChk(OS_TCB *p_tcb, CPU_STK_SIZE *p_free, CPU_STK_SIZE *p_used, OS_ERR *p_err) {
+    CPU_STK_SIZE free_stk = 0;
+    CPU_STK *p_stk;
+
+    *p_free = 0u;
+    *p_used = 0u;
+    if(p_tcb->StkPtr == (CPU_STK *)0) {
+        *p_err = OS_ERR_TASK_NOT_EXIST;
+    }else if((p_tcb->Opt & OS_OPT_TASK_STK_CHK) == 0u) {
+        *p_err = OS_ERR_TASK_OPT;
+    }else{
+        p_stk = p_tcb->StkBasePtr;          /* Grows down, count up from the base */
+        while((free_stk < p_tcb->StkSize) && (*p_stk == 0u)) {
+            p_stk++;
+            free_stk++;
+        }
+        *p_free = free_stk;
+        *p_used = p_tcb->StkSize - free_stk;
+        *p_err = OS_ERR_NONE;
+    }
+}
+
+static void smFill(void);
+static void smTask(OS_TCB *p_tcb, CPU_STK *p_stk, CPU_STK_SIZE size, OS_OPT opt);
+static void smRecCheck(void);
+static void smGetCheck(void);
+static void smCfgCheck(void);
+static void smPutc(INT8C c);
+static INT8U smCheck(INT8U ok, int line, const char *fmt, ...);
+
+/*************************************************************************
+  main() - The fills, the checks, then the report
+*************************************************************************/
+int main(void) {
+    smFill();
+    StkMonInit();
+    STK_MON_ADD(&smTCB[0], APP_CFG_TASK_START_STK_SIZE);
+    STK_MON_ADD(&smTCB[1], APP_CFG_UITASK_STK_SIZE);
+    STK_MON_ADD(&smNoChkTCB, APP_CFG_UITASK_STK_SIZE);
+    STK_MON_ADD(&smTCB[2], APP_CFG_TIMEDISPTASK_STK_SIZE);
+    STK_MON_ADD(&smTCB[3], APP_CFG_KEY_TASK_STK_SIZE);
+    STK_MON_ADD(&smDeletedTCB, APP_CFG_KEY_TASK_STK_SIZE);
+    STK_MON_ADD(&smTCB[4], APP_CFG_LCD_TASK_STK_SIZE);
+    STK_MON_ADD(&smTCB[5], APP_CFG_TIME_TASK_STK_SIZE);
+
+    smRecCheck();
+    smGetCheck();
+    smCfgCheck();
+    printf("%s", smText);
+    printf("StkMonTest: %u stacks, %u failed checks\n", SM_NUM_STKS, smFails);
+    return((smFails == 0) ? 0 : 1);
+}
+
+/*************************************************************************
+  smFill() - Zero fills every stack, then marks it down from the top
+*************************************************************************/
+static void smFill(void) {
+    INT8U stk;
+    INT32U word;
+
+    for(stk = 0; stk < SM_NUM_STKS; stk++) {
+        for(word = smStks[stk].size - smStks[stk].used; word < smStks[stk].size; word++) {
+            smMem[stk][word] = (word == (smStks[stk].size - 4u)) ? 0u : SM_FILL;
+        }
+        if(smStks[stk].tcb != (OS_TCB *)0) {
+            smTask(smStks[stk].tcb, &smMem[stk][0], smStks[stk].size,
+                   (OS_OPT)(OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR));
+        }else{
+        }
+    }
+    smMem[SM_KEY_STK][smStks[SM_KEY_STK].size - smStks[SM_KEY_STK].used] = 0u;
+    smTask(&smNoChkTCB, &smSpareStk[0][0], APP_CFG_UITASK_STK_SIZE, OS_OPT_TASK_STK_CLR);
+    smTask(&smDeletedTCB, &smSpareStk[1][0], APP_CFG_KEY_TASK_STK_SIZE,
+           (OS_OPT)(OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR));
+    smDeletedTCB.StkPtr = (CPU_STK *)0;
+}
+
+/* The TCB fields OSTaskCreate() sets that a stack check reads */
+static void smTask(OS_TCB *p_tcb, CPU_STK *p_stk, CPU_STK_SIZE size, OS_OPT opt) {
+    p_tcb->StkBasePtr = p_stk;
+    p_tcb->StkPtr = &p_stk[size - 1u];
+    p_tcb->StkSize = size;
+    p_tcb->Opt = opt;
+}
+
+/*************************************************************************
+  smRecCheck() - stkMonRec() for every mark
+
+        The least multiple of STK_MON_ROUND words that is at least the
+        mark plus STK_MON_MARGIN_PCT, and at least STK_MON_MARGIN_MIN
+        words more, and not under the minimum.
+*************************************************************************/
+static void smRecCheck(void) {
+    INT32U used, want, margin;
+
+    for(used = 0; used <= SM_REC_MAX; used++) {
+        margin = (used * STK_MON_MARGIN_PCT) / 100u;
+        if(margin < STK_MON_MARGIN_MIN) {
+            margin = STK_MON_MARGIN_MIN;
+        }else{
+        }
+        for(want = STK_MON_ROUND; want < (used + margin); want += STK_MON_ROUND) {
+        }
+        SM_CHECK(stkMonRec(used, 0) == want, "stkMonRec(%u, 0) is %u, expected %u", used,
+                 stkMonRec(used, 0), want);
+        want = (want < OS_CFG_STK_SIZE_MIN) ? OS_CFG_STK_SIZE_MIN : want;
+        SM_CHECK(stkMonRec(used, OS_CFG_STK_SIZE_MIN) == want,
+                 "stkMonRec(%u, %u) is %u, expected %u", used, OS_CFG_STK_SIZE_MIN,
+                 stkMonRec(used, OS_CFG_STK_SIZE_MIN), want);
+    }
+}
+
+/*************************************************************************
+  smGetCheck() - StkMonGet() and StkMonLeastFree() against smStks[]
+*************************************************************************/
+static void smGetCheck(void) {
+    STK_MON_INFO info[STK_MON_MAX_TASKS + 1u];
+    INT8U num, stk;
+    INT32U least = 0xFFFFFFFFu;
+
+    num = StkMonGet(info, (INT8U)(STK_MON_MAX_TASKS + 1u));
+    SM_CHECK(num == SM_NUM_STKS, "StkMonGet() gave %u stacks, expected %u", num, SM_NUM_STKS);
+    for(stk = 0; (stk < num) && (stk < SM_NUM_STKS); stk++) {
+        SM_CHECK(strcmp(info[stk].cfg, smStks[stk].cfg) == 0, "stack %u is %s, expected %s",
+                 stk, info[stk].cfg, smStks[stk].cfg);
+        SM_CHECK((info[stk].size == smStks[stk].size) && (info[stk].used == smStks[stk].seen)
+                 && (info[stk].rec == smStks[stk].rec),
+                 "%s: size %u used %u rec %u, expected %u %u %u", smStks[stk].cfg,
+                 info[stk].size, info[stk].used, info[stk].rec, smStks[stk].size,
+                 smStks[stk].seen, smStks[stk].rec);
+        if((smStks[stk].size - smStks[stk].seen) < least) {
+            least = smStks[stk].size - smStks[stk].seen;
+        }else{
+        }
+    }
+    SM_CHECK(StkMonGet(info, 3u) == 3u, "StkMonGet() went past max");
+    SM_CHECK(StkMonLeastFree() == least, "StkMonLeastFree() is %u, expected %u",
+             StkMonLeastFree(), least);
+}
+
+/*************************************************************************
+  smCfgCheck() - StkMonCfgWrite()'s footprint, flags and #defines
+*************************************************************************/
+static void smCfgCheck(void) {
+    INT8C want[80];
+    INT32U size_bytes = 0, rec_bytes = 0, now = 0, at_rec = 0, saves = 0;
+    INT32U defines = 0;
+    const INT8C *line;
+    INT8U stk;
+
+    StkMonCfgWrite(smPutc);
+    for(stk = 0; stk < SM_NUM_STKS; stk++) {
+        size_bytes += smStks[stk].size * sizeof(CPU_STK);
+        rec_bytes += smStks[stk].rec * sizeof(CPU_STK);
+        if(strncmp(smStks[stk].cfg, "OS_", 3u) == 0) {       /* os_cfg_app.h */
+            snprintf(want, sizeof(want), "/* #define %s %uu */\n", smStks[stk].cfg,
+                     smStks[stk].rec);
+        }else{
+            snprintf(want, sizeof(want), "\n#define %s %uu\n", smStks[stk].cfg, smStks[stk].rec);
+        }
+        SM_CHECK(strstr(smText, want) != (INT8C *)0, "no \"%.*s\" in the report",
+                 (int)(strlen(want) - 1u), want);
+        snprintf(want, sizeof(want), " * %s", smStks[stk].cfg);
+        line = strstr(smText, want);
+        if(SM_CHECK(line != (INT8C *)0, "no report line for %s", smStks[stk].cfg)) {
+            line = strchr(line, '\n');
+            SM_CHECK((strncmp(line - 17, "Full, overflowed?", 17u) == 0)
+                     == (stk == SM_FULL_STK), "%s %s flagged full", smStks[stk].cfg,
+                     (stk == SM_FULL_STK) ? "not" : "wrongly");
+        }else{
+        }
+    }
+    for(line = strstr(smText, "#define "); line != (INT8C *)0;
+        line = strstr(line + 1, "#define ")) {
+        defines++;
+    }
+    SM_CHECK(defines == SM_NUM_STKS, "%u #defines written, expected %u", defines, SM_NUM_STKS);
+    line = strstr(smText, " * RAM bytes");
+    if(SM_CHECK(line != (INT8C *)0, "no RAM bytes line")) {
+        SM_CHECK(sscanf(line + 12, "%u %u", &now, &at_rec) == 2, "RAM bytes line unreadable");
+        SM_CHECK((now == size_bytes) && (at_rec == rec_bytes),
+                 "RAM bytes %u to %u, expected %u to %u", now, at_rec, size_bytes, rec_bytes);
+    }else{
+    }
+    line = strstr(smText, " * Saves");
+    if(SM_CHECK(line != (INT8C *)0, "no Saves line")) {
+        SM_CHECK(sscanf(line + 8, "%u", &saves) == 1, "Saves line unreadable");
+        SM_CHECK(saves == (size_bytes - rec_bytes), "saves %u bytes, expected %u", saves,
+                 size_bytes - rec_bytes);
+    }else{
+    }
+}
+
+static void smPutc(INT8C c) {
+    if(smTextLen < (SM_TEXT_SIZE - 1u)) {
+        smText[smTextLen] = c;
+        smTextLen++;
+    }else{
+    }
+}
+
+static INT8U smCheck(INT8U ok, int line, const char *fmt, ...) {
+    va_list args;
+
+    if(ok == FALSE) {
+        smFails++;
+        printf("StkMonTest.c:%d: ", line);
+        va_start(args, fmt);
+        (void)vprintf(fmt, args);
+        va_end(args);
+        printf("\n");
+    }else{
+    }
+    return(ok);
+}
@@ -0,0 +1,267 @@
+/*************************************************************************
+* TickListBench.c - The tick lists as delta lists and as timing wheels
+*
+*            Builds the real os_tick.c, with the kernel's ready and pend
+*            lists stubbed, so the tick list code runs on its own. The
+*            Makefile builds it with OS_CFG_TICK_WHEEL_EN disabled and
+*            enabled.
+*
+*            For each number of waiters, half of them are delayed with
+*            OS_TickListInsertDly() and half pend with a timeout through
+*            OS_TickListInsert(). Each tick, the tasks readied wait
+*            again, and waiters/100 of the pending ones are posted,
+*            removed with OS_TickListRemove(), and pend again. Most
+*            delays are 1-5000 ticks, every 16th waiter's up to 20000,
+*            all from a fixed hash so both builds make the same calls.
+*
+*            Every task readied has to be due on that tick and every
+*            task still waiting at the end has to be due later. The
+*            tasks readied on each tick, in task order, are hashed and
+*            written to the file named on the command line. The two
+*            builds order tasks due on the same tick differently, but
+*            have to write the same file.
+*
+*            The cycles per insert, remove and tick are host cycles.
+*
+*            Usage: TickListBench start_tick hashes.txt
+*
+* 10/18/2026 Initial version
+*************************************************************************/
+#define OS_GLOBALS
+#include "os_tick.c"                    /* For the static update calls    */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "HostBench.h"
+
+#define TL_MAX_WAITERS  10000u
+#define TL_TICKS        20000u
+#define TL_DLY_MAX      5000u
+#define TL_DLY_LONG_MAX 20000u          /* Every 16th, to reach level 2   */
+#define TL_POSTS_PER    100u            /* A post per 100 waiters a tick  */
+#define TL_REPORT_FAILS 10u
+
+static const INT32U tlWaiters[] = {1u, 100u, 1000u, 4000u, 10000u};
+
+static OS_TCB tlTCB[TL_MAX_WAITERS];
+static OS_TICK tlDue[TL_MAX_WAITERS];   /* The tick each task is due on   */
+static INT32U tlRdy[TL_MAX_WAITERS];    /* Readied by the tick just done  */
+static INT32U tlNumRdy;
+static INT64U tlTickCyc[TL_TICKS];
+static INT32U tlFails;
+
+static OS_TICK tlDly(INT32U task, OS_TICK tick);
+static void tlWait(INT32U task, OS_TICK dly, INT64U *cyc);
+static void tlRun(INT32U waiters, OS_TICK start, FILE *out);
+static INT32U tlHash(INT32U a, INT32U b);
+static int tlCmp(const void *a, const void *b);
+static void tlFail(const char *fmt, INT32U task, OS_TICK tick, OS_TICK due);
+
+/* The kernel calls os_tick.c makes, reduced to what the lists need */
+CPU_STK *const OSCfg_TickTaskStkBasePtr = (CPU_STK *)tlTCB;
+CPU_STK_SIZE const OSCfg_TickTaskStkSize = 128u;
+CPU_STK_SIZE const OSCfg_TickTaskStkLimit = 12u;
+CPU_STK_SIZE const OSCfg_StkSizeMin = 64u;
+OS_PRIO const OSCfg_TickTaskPrio = 1u;
+
+CPU_SR CPU_SR_Save(void) {
+    return(0);
+}
+
+void CPU_SR_Restore(CPU_SR cpu_sr) {
+    (void)cpu_sr;
+}
+
+OS_SEM_CTR OSTaskSemPend(OS_TICK timeout, OS_OPT opt, CPU_TS *p_ts, OS_ERR *p_err) {
+    (void)timeout;
+    (void)opt;
+    (void)p_ts;
+    *p_err = OS_ERR_NONE;
+    return(0);
+}
+
+void OSTaskCreate(OS_TCB *p_tcb, CPU_CHAR *p_name, OS_TASK_PTR p_task, void *p_arg,
+                  OS_PRIO prio, CPU_STK *p_stk_base, CPU_STK_SIZE stk_limit,
+                  CPU_STK_SIZE stk_size, OS_MSG_QTY q_size, OS_TICK time_quanta,
+                  void *p_ext, OS_OPT opt, OS_ERR *p_err) {
+    *p_err = OS_ERR_NONE;
+}
+
+void OS_PendListRemove(OS_TCB *p_tcb) {
+    (void)p_tcb;
+}
+
+OS_PRIO OS_MutexGrpPrioFindHighest(OS_TCB *p_tcb) {
+    return(p_tcb->Prio);
+}
+
+void OS_TaskChangePrio(OS_TCB *p_tcb, OS_PRIO prio_new) {
+    p_tcb->Prio = prio_new;
+}
+
+void OS_RdyListInsert(OS_TCB *p_tcb) {
+    tlRdy[tlNumRdy] = (INT32U)(p_tcb - tlTCB);
+    tlNumRdy++;
+}
+
+/*************************************************************************
+  main() - Every size from the start tick
+*************************************************************************/
+int main(int argc, char **argv) {
+    OS_TICK start;
+    FILE *out;
+    INT8U size;
+
+    if(argc != 3) {
+        fprintf(stderr, "usage: TickListBench start_tick hashes.txt\n");
+        return(2);
+    }else{
+    }
+    start = (OS_TICK)strtoul(argv[1], (char **)0, 0);
+    out = fopen(argv[2], "w");
+    if(out == NULL) {
+        perror(argv[2]);
+        return(2);
+    }else{
+    }
+    HostBenchInit();
+    printf("TickListBench, %s, start tick 0x%08x, %u ticks, host cycles\n",
+           (OS_CFG_TICK_WHEEL_EN == DEF_ENABLED) ? "timing wheel" : "delta list",
+           start, TL_TICKS);
+    printf("  waiters   insert   remove   tick mean   tick p99   events\n");
+    for(size = 0; size < (sizeof(tlWaiters) / sizeof(tlWaiters[0])); size++) {
+        tlRun(tlWaiters[size], start, out);
+    }
+    (void)fclose(out);
+    printf("TickListBench: %u failed checks\n", tlFails);
+    return((tlFails == 0) ? 0 : 1);
+}
+
+/*************************************************************************
+  tlRun() - waiters tasks for TL_TICKS ticks from start
+*************************************************************************/
+static void tlRun(INT32U waiters, OS_TICK start, FILE *out) {
+    OS_ERR os_err;
+    INT32U task, cnt, post;
+    INT32U tick;
+    INT32U events = 0;
+    INT32U hash = 0;
+    INT64U cyc;
+    INT64U ins_cyc = 0, ins_num = 0;
+    INT64U rem_cyc = 0, rem_num = 0;
+    INT64U tick_cyc = 0;
+
+    memset(tlTCB, 0, sizeof(tlTCB));
+    OS_TickTaskInit(&os_err);
+    OSTickCtr = start;
+#if (OS_CFG_TICK_WHEEL_EN == DEF_ENABLED)
+    OS_TickWheelInit(&OSTickListDly);   /* The wheels start at OSTickCtr  */
+    OS_TickWheelInit(&OSTickListTimeout);
+#endif
+    for(task = 0; task < waiters; task++) {
+        tlWait(task, tlDly(task, start), &ins_cyc);
+    }
+    ins_num += waiters;
+
+    for(tick = 0; tick < TL_TICKS; tick++) {
+        tlNumRdy = 0;
+        cyc = HostBenchCyc();
+        OSTickCtr++;
+        (void)OS_TickListUpdateDly(1u);
+        (void)OS_TickListUpdateTimeout(1u);
+        tlTickCyc[tick] = HostBenchSince(cyc);
+        tick_cyc += tlTickCyc[tick];
+
+        /* Due tasks in task order, the wheel readies them by slot */
+        qsort(tlRdy, tlNumRdy, sizeof(tlRdy[0]), tlCmp);
+        for(cnt = 0; cnt < tlNumRdy; cnt++) {
+            task = tlRdy[cnt];
+            if(tlDue[task] != OSTickCtr) {
+                tlFail("task %u readied at 0x%08x, due 0x%08x", task, OSTickCtr, tlDue[task]);
+            }else{
+            }
+            hash = (hash * 1000003u) ^ tlHash(task, OSTickCtr);
+            tlWait(task, tlDly(task, OSTickCtr), &ins_cyc);
+        }
+        events += tlNumRdy;
+        ins_num += tlNumRdy;
+
+        for(cnt = 0; cnt < (waiters / TL_POSTS_PER); cnt++) {
+            post = (tlHash(cnt, OSTickCtr) % waiters) | 1u;
+            if((post < waiters) && (tlTCB[post].TickListPtr != (OS_TICK_LIST *)0)) {
+                cyc = HostBenchCyc();
+                OS_TickListRemove(&tlTCB[post]);
+                rem_cyc += HostBenchSince(cyc);
+                rem_num++;
+                tlWait(post, tlDly(post, ~OSTickCtr), &ins_cyc);
+                ins_num++;
+                hash = (hash * 31u) ^ tlHash(post, OSTickCtr + 7u);
+            }else{
+            }
+        }
+    }
+
+    /* Nothing missed, whatever is left is due later */
+    for(task = 0; task < waiters; task++) {
+        if((OS_TICK)(tlDue[task] - OSTickCtr - 1u) >= TL_DLY_LONG_MAX) {
+            tlFail("task %u still waiting at 0x%08x, due 0x%08x", task, OSTickCtr, tlDue[task]);
+        }else{
+        }
+    }
+    printf("  %7u  %7.1f  %7.1f  %10.1f  %9u  %7u\n", waiters,
+           (double)ins_cyc / (double)ins_num,
+           (rem_num != 0) ? ((double)rem_cyc / (double)rem_num) : 0.0,
+           (double)tick_cyc / TL_TICKS, (INT32U)HostBenchPct(tlTickCyc, TL_TICKS, 99u), events);
+    fprintf(out, "waiters %u start 0x%08x events %u hash %08x\n", waiters, start, events, hash);
+}
+
+/*************************************************************************
+  tlWait() - Even tasks delay, odd ones pend with a timeout, for dly
+*************************************************************************/
+static void tlWait(INT32U task, OS_TICK dly, INT64U *cyc) {
+    OS_ERR os_err;
+    INT64U start;
+
+    tlDue[task] = OSTickCtr + dly;
+    if((task & 1u) != 0) {
+        tlTCB[task].TaskState = OS_TASK_STATE_PEND_TIMEOUT;
+        start = HostBenchCyc();
+        OS_TickListInsert(&OSTickListTimeout, &tlTCB[task], dly);
+        *cyc += HostBenchSince(start);
+    }else{
+        start = HostBenchCyc();
+        OS_TickListInsertDly(&tlTCB[task], dly, OS_OPT_TIME_DLY, &os_err);
+        *cyc += HostBenchSince(start);
+    }
+}
+
+static OS_TICK tlDly(INT32U task, OS_TICK tick) {
+    OS_TICK max = ((task % 16u) == 0) ? TL_DLY_LONG_MAX : TL_DLY_MAX;
+
+    return(1u + (tlHash(task, tick) % max));
+}
+
+static INT32U tlHash(INT32U a, INT32U b) {
+    INT32U x = (a * 2654435761u) ^ ((b + 0x9e3779b9u) * 40503u);
+
+    x ^= x >> 15;
+    x *= 2246822519u;
+    x ^= x >> 13;
+    return(x);
+}
+
+static int tlCmp(const void *a, const void *b) {
+    INT32U x = *(const INT32U *)a;
+    INT32U y = *(const INT32U *)b;
+
+    return((x < y) ? -1 : (x > y));
+}
+
+static void tlFail(const char *fmt, INT32U task, OS_TICK tick, OS_TICK due) {
+    if(tlFails < TL_REPORT_FAILS) {
+        printf(fmt, task, tick, due);
+        printf("\n");
+    }else{
+    }
+    tlFails++;
+}
@@ -0,0 +1,449 @@
+/*************************************************************************
+* TmrListBench.c - The software timers as a list and as a timing wheel
+*
+*            Builds the real os_tmr.c, with the mutex, scheduler lock
+*            and task calls stubbed, and runs OS_TmrTask() as is. Each
+*            return from its OSTaskSemPend() is a timer tick, and the
+*            time until the next call is what the tick cost. The
+*            Makefile builds it with OS_CFG_TMR_WHEEL_EN disabled and
+*            enabled.
+*
+*            Two scenes, from the start tick on the command line:
+*
+*              load   1, 100, 1000 and 10000 timers for 20000 ticks.
+*                     Three quarters are periodic, the rest one-shots
+*                     that restart from their callback with a new
+*                     delay, 1-600 ticks. Between ticks, timers/100
+*                     stop, start or OSTmrRemainGet() calls are made
+*                     and timed.
+*              same   groups of four timers due on the same ticks. In
+*                     each pair one callback stops or restarts the
+*                     other. With the wheel that is before or after the
+*                     other's callback, with the list only after, see
+*                     tmSameRole(). A stopped timer starts again after
+*                     the tick.
+*
+*            A model of each timer follows the calls made. Every
+*            callback has to come on the tick its timer is due, every
+*            timer due has to have fired by the end of the tick, and
+*            every OSTmrRemainGet() has to give the ticks left. The load
+*            scene's callbacks and OSTmrRemainGet() values are hashed
+*            and written to the file named on the command line, the two
+*            builds have to write the same file. The same scene's
+*            callbacks reach other timers, so their order, which the
+*            builds do not share, decides what fires. It is checked
+*            against the model only.
+*
+*            The cycles are host cycles.
+*
+*            Usage: TmrListBench start_tick hashes.txt
+*
+* 10/18/2026 Initial version
+*************************************************************************/
+#define OS_GLOBALS
+#include "os_tmr.c"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include "HostBench.h"
+
+#define TM_MAX_TMRS     10000u
+#define TM_TICKS        20000u
+#define TM_DLY_MAX      600u            /* A minute at the 10Hz timer tick */
+#define TM_CALLS_PER    100u            /* A control call per 100 timers   */
+#define TM_SAME_TMRS    64u
+#define TM_SAME_TICKS   5000u
+#define TM_REPORT_FAILS 10u
+
+typedef enum {TM_LOAD, TM_SAME} TM_SCENE;
+typedef enum {TM_STOPS, TM_RESTARTS, TM_TARGET} TM_ROLE;
+
+typedef struct{
+    INT8U running;
+    OS_TICK due;                        /* OSTmrTickCtr it fires at        */
+    OS_TICK dly;
+    OS_TICK period;
+    OS_OPT opt;
+}TM_MODEL;
+
+static const INT32U tmTimers[] = {1u, 100u, 1000u, 10000u};
+
+static OS_TMR tmTmr[TM_MAX_TMRS];
+static TM_MODEL tmModel[TM_MAX_TMRS];
+static INT32U tmNum;
+static TM_SCENE tmScene;
+static INT32U tmTick;                   /* Ticks done in this run          */
+static INT32U tmTicks;
+static INT64U tmTickStart;
+static INT64U tmTickCyc[TM_TICKS];
+static INT64U tmCallCyc;
+static INT64U tmLastCyc;                /* The last timer call alone       */
+static INT32U tmCalls;
+static INT32U tmFired;
+static INT32U tmFireHash;               /* Order free, summed per callback */
+static INT32U tmRemainHash;
+static INT32U tmFails;
+static jmp_buf tmDone;
+
+static void tmRun(TM_SCENE scene, INT32U timers, OS_TICK start, FILE *out);
+static void tmCreate(INT32U id, OS_TICK dly, OS_TICK period, OS_OPT opt);
+static void tmStart(INT32U id);
+static void tmStop(INT32U id);
+static void tmRemain(INT32U id);
+static void tmCallback(void *p_tmr, void *p_arg);
+static void tmBetweenTicks(void);
+static TM_ROLE tmSameRole(INT32U id);
+static INT32U tmHash(INT32U a, INT32U b);
+static void tmFail(const char *fmt, INT32U id, OS_TICK got, OS_TICK expect);
+
+/* The kernel calls os_tmr.c makes, reduced to what the timers need */
+CPU_STK *const OSCfg_TmrTaskStkBasePtr = (CPU_STK *)tmTmr;
+CPU_STK_SIZE const OSCfg_TmrTaskStkSize = 128u;
+CPU_STK_SIZE const OSCfg_TmrTaskStkLimit = 12u;
+CPU_STK_SIZE const OSCfg_StkSizeMin = 64u;
+OS_PRIO const OSCfg_TmrTaskPrio = 2u;
+OS_RATE_HZ const OSCfg_TmrTaskRate_Hz = OS_CFG_TMR_TASK_RATE_HZ;
+OS_RATE_HZ const OSCfg_TickRate_Hz = OS_CFG_TICK_RATE_HZ;
+
+CPU_SR CPU_SR_Save(void) {
+    return(0);
+}
+
+void CPU_SR_Restore(CPU_SR cpu_sr) {
+    (void)cpu_sr;
+}
+
+void OSSchedLock(OS_ERR *p_err) {
+    *p_err = OS_ERR_NONE;
+}
+
+void OSSchedUnlock(OS_ERR *p_err) {
+    *p_err = OS_ERR_NONE;
+}
+
+void OSMutexCreate(OS_MUTEX *p_mutex, CPU_CHAR *p_name, OS_ERR *p_err) {
+    *p_err = OS_ERR_NONE;
+}
+
+void OSMutexPend(OS_MUTEX *p_mutex, OS_TICK timeout, OS_OPT opt, CPU_TS *p_ts, OS_ERR *p_err) {
+    *p_err = OS_ERR_NONE;
+}
+
+void OSMutexPost(OS_MUTEX *p_mutex, OS_OPT opt, OS_ERR *p_err) {
+    *p_err = OS_ERR_NONE;
+}
+
+void OSTimeDly(OS_TICK dly, OS_OPT opt, OS_ERR *p_err) {
+    *p_err = OS_ERR_NONE;
+}
+
+void OSTaskCreate(OS_TCB *p_tcb, CPU_CHAR *p_name, OS_TASK_PTR p_task, void *p_arg,
+                  OS_PRIO prio, CPU_STK *p_stk_base, CPU_STK_SIZE stk_limit,
+                  CPU_STK_SIZE stk_size, OS_MSG_QTY q_size, OS_TICK time_quanta,
+                  void *p_ext, OS_OPT opt, OS_ERR *p_err) {
+    *p_err = OS_ERR_NONE;
+}
+
+/*************************************************************************
+  OSTaskSemPend() - The timer task between two ticks. Times the tick
+                    just done, checks it, and makes the control calls.
+*************************************************************************/
+OS_SEM_CTR OSTaskSemPend(OS_TICK timeout, OS_OPT opt, CPU_TS *p_ts, OS_ERR *p_err) {
+    *p_err = OS_ERR_NONE;
+    if(tmTick != 0) {
+        tmTickCyc[tmTick - 1u] = HostBenchSince(tmTickStart);
+        tmBetweenTicks();
+    }else{
+    }
+    if(tmTick == tmTicks) {
+        longjmp(tmDone, 1);
+    }else{
+    }
+    tmTick++;
+    tmTickStart = HostBenchCyc();
+    return(0);
+}
+
+/*************************************************************************
+  main() - The load scene at every size, then the same tick scene
+*************************************************************************/
+int main(int argc, char **argv) {
+    OS_TICK start;
+    FILE *out;
+    INT8U size;
+
+    if(argc != 3) {
+        fprintf(stderr, "usage: TmrListBench start_tick hashes.txt\n");
+        return(2);
+    }else{
+    }
+    start = (OS_TICK)strtoul(argv[1], (char **)0, 0);
+    out = fopen(argv[2], "w");
+    if(out == NULL) {
+        perror(argv[2]);
+        return(2);
+    }else{
+    }
+    HostBenchInit();
+    printf("TmrListBench, %s, start tick 0x%08x, %u ticks, host cycles\n",
+           (OS_CFG_TMR_WHEEL_EN == DEF_ENABLED) ? "timing wheel" : "list", start, TM_TICKS);
+    printf("   timers  tick mean  tick p99  control call  fired\n");
+    for(size = 0; size < (sizeof(tmTimers) / sizeof(tmTimers[0])); size++) {
+        tmRun(TM_LOAD, tmTimers[size], start, out);
+    }
+    tmRun(TM_SAME, TM_SAME_TMRS, start, (FILE *)0);
+    (void)fclose(out);
+    printf("TmrListBench: %u failed checks\n", tmFails);
+    return((tmFails == 0) ? 0 : 1);
+}
+
+/*************************************************************************
+  tmRun() - One scene with timers timers from start
+*************************************************************************/
+static void tmRun(TM_SCENE scene, INT32U timers, OS_TICK start, FILE *out) {
+    OS_ERR os_err;
+    INT32U id;
+    INT64U tick_cyc = 0;
+
+    memset(tmTmr, 0, sizeof(tmTmr));
+    memset(tmModel, 0, sizeof(tmModel));
+    tmScene = scene;
+    tmNum = timers;
+    tmTick = 0;
+    tmTicks = (scene == TM_LOAD) ? TM_TICKS : TM_SAME_TICKS;
+    tmCallCyc = 0;
+    tmCalls = 0;
+    tmFired = 0;
+    tmFireHash = 0;
+    tmRemainHash = 0;
+    OSRunning = OS_STATE_OS_RUNNING;
+    OS_TmrInit(&os_err);
+    OSTmrTickCtr = start;
+
+    for(id = 0; id < timers; id++) {
+        if(scene == TM_SAME) {
+            /* A group's four are due together, then every period */
+            tmCreate(id, 1u + (id / 4u), 2u + ((id / 4u) % 7u), OS_OPT_TMR_PERIODIC);
+        }else if((id % 4u) == 3u) {
+            tmCreate(id, 1u + (tmHash(id, 1u) % TM_DLY_MAX), 0, OS_OPT_TMR_ONE_SHOT);
+        }else{
+            tmCreate(id, tmHash(id, 2u) % 3u, 1u + (tmHash(id, 0) % TM_DLY_MAX), OS_OPT_TMR_PERIODIC);
+        }
+        tmStart(id);
+    }
+    if(setjmp(tmDone) == 0) {
+        OS_TmrTask((void *)0);
+    }else{
+    }
+
+    if(scene == TM_LOAD) {
+        for(id = 0; id < tmTicks; id++) {
+            tick_cyc += tmTickCyc[id];
+        }
+        printf("  %7u  %9.1f  %8u  %12.1f  %6u\n", timers, (double)tick_cyc / tmTicks,
+               (INT32U)HostBenchPct(tmTickCyc, tmTicks, 99u),
+               (tmCalls != 0) ? ((double)tmCallCyc / tmCalls) : 0.0, tmFired);
+        fprintf(out, "timers %u start 0x%08x fired %u hash %08x remain %08x\n", timers, start,
+                tmFired, tmFireHash, tmRemainHash);
+    }else{
+        printf("  same tick: %u timers, %u callbacks\n", timers, tmFired);
+    }
+}
+
+/*************************************************************************
+  tmCreate(), tmStart(), tmStop() - The timer calls, with the model
+                                    following them. tmLastCyc is the
+                                    call's own cost.
+*************************************************************************/
+static void tmCreate(INT32U id, OS_TICK dly, OS_TICK period, OS_OPT opt) {
+    OS_ERR os_err;
+
+    OSTmrCreate(&tmTmr[id], (CPU_CHAR *)"Bench", dly, period, opt, tmCallback, (void *)0, &os_err);
+    tmModel[id].running = FALSE;
+    tmModel[id].dly = dly;
+    tmModel[id].period = period;
+    tmModel[id].opt = opt;
+}
+
+static void tmStart(INT32U id) {
+    OS_ERR os_err;
+
+    INT64U cyc = HostBenchCyc();
+
+    (void)OSTmrStart(&tmTmr[id], &os_err);
+    tmLastCyc = HostBenchSince(cyc);
+    tmModel[id].running = TRUE;
+    tmModel[id].due = OSTmrTickCtr + ((tmModel[id].dly != 0) ? tmModel[id].dly : tmModel[id].period);
+}
+
+static void tmStop(INT32U id) {
+    OS_ERR os_err;
+
+    INT64U cyc = HostBenchCyc();
+
+    (void)OSTmrStop(&tmTmr[id], OS_OPT_TMR_NONE, (void *)0, &os_err);
+    tmLastCyc = HostBenchSince(cyc);
+    tmModel[id].running = FALSE;
+}
+
+/*************************************************************************
+  tmRemain() - OSTmrRemainGet() against the model
+*************************************************************************/
+static void tmRemain(INT32U id) {
+    OS_ERR os_err;
+    OS_TICK remain;
+    OS_TICK expect;
+    INT64U cyc = HostBenchCyc();
+
+    remain = OSTmrRemainGet(&tmTmr[id], &os_err);
+    tmLastCyc = HostBenchSince(cyc);
+    if(tmModel[id].running) {
+        expect = tmModel[id].due - OSTmrTickCtr;
+    }else if(tmTmr[id].State == OS_TMR_STATE_COMPLETED) {
+        expect = 0;
+    }else{
+        expect = (tmModel[id].dly != 0) ? tmModel[id].dly : tmModel[id].period;
+    }
+    if(remain != expect) {
+        tmFail("timer %u: %u ticks remain, expected %u", id, remain, expect);
+    }else{
+    }
+    tmRemainHash += remain * (id + 1u);
+}
+
+/*************************************************************************
+  tmCallback() - Checks the timer was due, and in the load scene
+                 restarts one-shots. In the same tick scene it reaches
+                 its partner, see tmSameRole().
+*************************************************************************/
+static void tmCallback(void *p_tmr, void *p_arg) {
+    OS_ERR os_err;
+    INT32U id = (INT32U)((OS_TMR *)p_tmr - tmTmr);
+    TM_MODEL *pm = &tmModel[id];
+    (void)p_arg;
+
+    if(!pm->running || (pm->due != OSTmrTickCtr)) {
+        tmFail("timer %u fired at 0x%08x, due 0x%08x", id, OSTmrTickCtr, pm->running ? pm->due : 0);
+    }else{
+    }
+    tmFired++;
+    tmFireHash += tmHash(OSTmrTickCtr, id);
+    if(pm->opt == OS_OPT_TMR_PERIODIC) {
+        pm->due = OSTmrTickCtr + pm->period;
+    }else{
+        pm->running = FALSE;
+    }
+
+    if(tmScene == TM_LOAD) {
+        if(pm->opt == OS_OPT_TMR_ONE_SHOT) {
+            pm->dly = 1u + (tmHash(id, OSTmrTickCtr) % TM_DLY_MAX);
+            OSTmrSet(&tmTmr[id], pm->dly, 0, tmCallback, (void *)0, &os_err);
+            tmStart(id);
+        }else{
+        }
+    }else{
+        switch(tmSameRole(id)) {
+        case TM_STOPS:                  /* Its partner is due with it     */
+            tmStop(id ^ 1u);
+            break;
+        case TM_RESTARTS:
+            tmStart(id ^ 1u);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+/*************************************************************************
+  tmBetweenTicks() - Every timer due has fired, then the control calls
+
+        In the same tick scene a stopped timer starts again, and every
+        timer's remain is read.
+*************************************************************************/
+static void tmBetweenTicks(void) {
+    INT32U id, call;
+
+    for(id = 0; id < tmNum; id++) {
+        if(tmModel[id].running && (tmModel[id].due == OSTmrTickCtr)) {
+            tmFail("timer %u due at 0x%08x did not fire", id, tmModel[id].due, 0);
+            tmModel[id].running = FALSE;
+        }else{
+        }
+    }
+    if(tmScene == TM_SAME) {
+        for(id = 0; id < tmNum; id++) {
+            if((tmSameRole(id ^ 1u) == TM_STOPS) && !tmModel[id].running) {
+                tmStart(id);
+            }else{
+            }
+            tmRemain(id);
+        }
+        return;
+    }else{
+    }
+    for(call = 0; call < ((tmNum + TM_CALLS_PER - 1u) / TM_CALLS_PER); call++) {
+        id = tmHash(tmTick, call) % tmNum;
+        switch(tmHash(call, tmTick) % 3u) {
+        case 0:
+            tmStop(id);
+            break;
+        case 1:
+            tmStart(id);
+            break;
+        default:
+            tmRemain(id);
+            break;
+        }
+        tmCallCyc += tmLastCyc;
+        tmCalls++;
+    }
+}
+
+/*************************************************************************
+  tmSameRole() - A group's first pair stops, its second restarts. In
+                 even groups the lower id reaches the higher, in odd
+                 groups the other way, so the wheel's callbacks come in
+                 both orders.
+
+        The list walk keeps its next timer across a callback, so a
+        callback that stops the timer after its own still has it fire
+        and ends the walk for that tick. With the list every group is
+        even: a timer is started at the head, and the higher id is the
+        one the walk has passed.
+*************************************************************************/
+static TM_ROLE tmSameRole(INT32U id) {
+    INT8U low = (INT8U)((id & 1u) == 0);
+#if (OS_CFG_TMR_WHEEL_EN == DEF_ENABLED)
+    INT8U even = (INT8U)(((id / 4u) & 1u) == 0);
+#else
+    INT8U even = TRUE;
+#endif
+
+    if(low != even) {
+        return(TM_TARGET);
+    }else if((id % 4u) < 2u) {
+        return(TM_STOPS);
+    }else{
+        return(TM_RESTARTS);
+    }
+}
+
+static INT32U tmHash(INT32U a, INT32U b) {
+    INT32U x = (a * 2654435761u) ^ ((b + 0x9e3779b9u) * 40503u);
+
+    x ^= x >> 15;
+    x *= 2246822519u;
+    x ^= x >> 13;
+    return(x);
+}
+
+static void tmFail(const char *fmt, INT32U id, OS_TICK got, OS_TICK expect) {
+    if(tmFails < TM_REPORT_FAILS) {
+        printf(fmt, id, got, expect);
+        printf("\n");
+    }else{
+    }
+    tmFails++;
+}
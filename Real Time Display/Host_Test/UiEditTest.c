@@ -0,0 +1,186 @@
+/*************************************************************************
+* UiEditTest.c - Lab2.c's time entry table, uiEditKey() and uiTimeFields[]
+*
+*            Lab2.c is included here, its main() renamed, so the test
+*            can call its static uiEditKey() on the real table. The
+*            rest of the application is linked but never started.
+*
+*            Every key code is tried at every position after every
+*            digit before it, against the limits of hh:mm:ss written
+*            out here: hour tens 0-2, hour ones 0-9 or 0-3 after a 2,
+*            minute and second tens 0-5, ones 0-9. A key taken has to
+*            be stored and move the position on, one refused has to
+*            leave the digits and the position alone. Then the cases
+*            the table was made for, a whole entry through 2 and 3
+*            with 4 to 9 refused in between, and the last digit, which
+*            keeps the position and takes each new digit over the last.
+*
+*            The report gives the host cycles per key at each position,
+*            which come out much the same, the check is one mask test
+*            wherever it is, and the sizes of the table and the code
+*            from a -Os build of Lab2.c, UE_..._BYTES from the Makefile.
+*            uiEditKey() has one caller, so gcc inlines it into
+*            uiClockKey() there and its own size comes out as 0. Only
+*            the table size is checked, host cycles change run to run.
+*
+* 10/18/2026 Initial version
+*************************************************************************/
+#include <stdio.h>
+#include "MCUType.h"
+#include "HostOs.h"
+#include "HostBench.h"
+
+#define main AppMain
+#include "Lab2.c"
+#undef main
+
+#define UE_BENCH_KEYS   1000000u
+#define UE_KEYS         "0123456789*#\x11\x12\x13\x14"
+
+static INT32U ueCases;
+
+static INT8U ueLimit(INT8U pos, INT8U before);
+static void ueAllCodes(void);
+static void ueEntry(void);
+static void ueEnter(INT8U *digits, INT8U *pos, const INT8C *keys, INT8U took);
+static void ueBench(void);
+
+/*************************************************************************
+  main() - The table checks, then the report
+*************************************************************************/
+int main(void) {
+    HostBenchInit();
+    ueAllCodes();
+    ueEntry();
+    ueBench();
+    printf("UiEditTest: %u cases, %u failed checks\n", ueCases, HostFails());
+    return((HostFails() == 0) ? 0 : 1);
+}
+
+/* Highest digit at pos, given the digit before it */
+static INT8U ueLimit(INT8U pos, INT8U before) {
+    static const INT8U limits[UI_TIME_DIGITS] = {2, 9, 5, 9, 5, 9};
+
+    return(((pos == 1u) && (before == 2u)) ? 3u : limits[pos]);
+}
+
+/*************************************************************************
+  ueAllCodes() - Each key code at each position after each digit
+*************************************************************************/
+static void ueAllCodes(void) {
+    INT8U digits[UI_TIME_DIGITS];
+    INT8U pos, before, took, want, cnt;
+    INT16U key;
+
+    for(pos = 0; pos < UI_TIME_DIGITS; pos++) {
+        for(before = 0; before < 10u; before++) {
+            for(key = 0; key < 256u; key++) {
+                for(cnt = 0; cnt < UI_TIME_DIGITS; cnt++) {
+                    digits[cnt] = (INT8U)((cnt == (pos - 1u)) ? before : 7u);
+                }
+                uiSetPos = pos;
+                took = uiEditKey(uiTimeFields, UI_TIME_DIGITS, digits, &uiSetPos, (INT8U)key);
+                want = (INT8U)((key >= '0') && (key <= ('0' + ueLimit(pos, before))));
+                ueCases++;
+                HOST_CHECK(took == want, "pos %u after %u: key 0x%02x %s", pos, before, key,
+                           took ? "taken" : "refused");
+                HOST_CHECK(digits[pos] == (want ? (key - '0') : 7u),
+                           "pos %u after %u: key 0x%02x left digit %u", pos, before, key,
+                           digits[pos]);
+                HOST_CHECK(uiSetPos == ((want && (pos < (UI_TIME_DIGITS - 1u))) ? (pos + 1u) : pos),
+                           "pos %u after %u: key 0x%02x moved to %u", pos, before, key, uiSetPos);
+            }
+            if(pos == 0) {
+                break;                      /* Nothing before the first */
+            }else{
+            }
+        }
+    }
+}
+
+/*************************************************************************
+  ueEntry() - Whole entries, the hour tens of 2 and the last digit
+*************************************************************************/
+static void ueEntry(void) {
+    INT8U digits[UI_TIME_DIGITS] = {1, 2, 0, 0, 0, 0};
+    INT8U pos = 0;
+    TIME_T ltime;
+
+    ueEnter(digits, &pos, "2", TRUE);
+    ueEnter(digits, &pos, "456789", FALSE);
+    HOST_CHECK(pos == 1u, "hour ones after a 2: at %u", pos);
+    ueEnter(digits, &pos, "3", TRUE);
+    ueEnter(digits, &pos, "6789", FALSE);
+    ueEnter(digits, &pos, "59", TRUE);
+    ueEnter(digits, &pos, "6", FALSE);
+    ueEnter(digits, &pos, "5", TRUE);
+    HOST_CHECK(pos == (UI_TIME_DIGITS - 1u), "entry ended at %u", pos);
+
+    /* The last digit holds the position and takes each new digit */
+    ueEnter(digits, &pos, "8", TRUE);
+    HOST_CHECK(pos == (UI_TIME_DIGITS - 1u), "last digit: moved to %u", pos);
+    ueEnter(digits, &pos, "#", FALSE);
+    ueEnter(digits, &pos, "2", TRUE);
+    HOST_CHECK(pos == (UI_TIME_DIGITS - 1u), "last digit: moved to %u", pos);
+    uiDigitsToTime(digits, &ltime);
+    HOST_CHECK((ltime.hr == 23u) && (ltime.min == 59u) && (ltime.sec == 52u),
+               "entry gave %02u:%02u:%02u, expected 23:59:52", ltime.hr, ltime.min, ltime.sec);
+
+    /* A 1 lets the hour ones go to 9 */
+    pos = 0;
+    ueEnter(digits, &pos, "3", FALSE);
+    ueEnter(digits, &pos, "19", TRUE);
+    uiDigitsToTime(digits, &ltime);
+    HOST_CHECK(ltime.hr == 19u, "entry gave hour %u, expected 19", ltime.hr);
+    uiTimeToDigits(&ltime, digits);
+    HOST_CHECK((digits[0] == 1u) && (digits[1] == 9u) && (digits[5] == 2u),
+               "19:59:52 back to digits %u%u%u%u%u%u", digits[0], digits[1], digits[2],
+               digits[3], digits[4], digits[5]);
+}
+
+/* Each of keys has to be taken, or refused, in turn */
+static void ueEnter(INT8U *digits, INT8U *pos, const INT8C *keys, INT8U took) {
+    INT8U was;
+
+    for(; *keys != '\0'; keys++) {
+        was = *pos;
+        ueCases++;
+        HOST_CHECK(uiEditKey(uiTimeFields, UI_TIME_DIGITS, digits, pos, (INT8U)*keys) == took,
+                   "'%c' at %u %s", *keys, was, took ? "refused" : "taken");
+    }
+}
+
+/*************************************************************************
+  ueBench() - Host cycles per key at each position, and the -Os sizes
+*************************************************************************/
+static void ueBench(void) {
+    INT8U digits[UI_TIME_DIGITS] = {0};
+    INT64U start, cyc[UI_TIME_DIGITS];
+    INT32U key, seed = 1u;
+    INT8U pos, at;
+    INT8U keys[256];
+    volatile INT8U took = 0;
+
+    for(key = 0; key < sizeof(keys); key++) {
+        seed = (seed * 1103515245u) + 12345u;
+        keys[key] = (INT8U)UE_KEYS[(seed >> 16) % (sizeof(UE_KEYS) - 1u)];
+    }
+    for(pos = 0; pos < UI_TIME_DIGITS; pos++) {
+        start = HostBenchCyc();
+        for(key = 0; key < UE_BENCH_KEYS; key++) {
+            at = pos;
+            took += uiEditKey(uiTimeFields, UI_TIME_DIGITS, digits, &at, keys[key & 0xffu]);
+        }
+        cyc[pos] = HostBenchSince(start);
+    }
+    printf("  position      1     2     3     4     5     6\n");
+    printf("  host cycles");
+    for(pos = 0; pos < UI_TIME_DIGITS; pos++) {
+        printf("  %4.1f", (double)cyc[pos] / UE_BENCH_KEYS);
+    }
+    printf("\n  -Os bytes: uiTimeFields %u, uiEditKey %u, uiClockKey %u, Lab2.o text %u\n",
+           (INT32U)UE_FIELDS_BYTES, (INT32U)UE_EDIT_KEY_BYTES, (INT32U)UE_CLOCK_KEY_BYTES,
+           (INT32U)UE_TEXT_BYTES);
+    HOST_CHECK(sizeof(uiTimeFields) == UE_FIELDS_BYTES, "uiTimeFields is %u bytes here",
+               (INT32U)sizeof(uiTimeFields));
+}
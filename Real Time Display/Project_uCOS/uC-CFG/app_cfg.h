@@ -58,6 +58,8 @@
 *                                            TASK STACK SIZES
 *********************************************************************************************************
 */
+                                        /* CPU_STK words. StkMonCfgWrite() writes this section from */
+                                        /* the high-water marks of a run, see StkMon.h              */
 
 #define APP_CFG_TASK_START_STK_SIZE 128u
 #define APP_CFG_UITASK_STK_SIZE      128u
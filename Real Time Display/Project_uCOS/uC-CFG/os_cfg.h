@@ -104,6 +104,8 @@
 #define OS_CFG_TASK_SEM_PEND_ABORT_EN   DEF_ENABLED        /* Include (DEF_ENABLED) code for OSTaskSemPendAbort()                   */
 #define OS_CFG_TASK_SUSPEND_EN          DEF_ENABLED        /* Include (DEF_ENABLED) code for OSTaskSuspend() and OSTaskResume()     */
 #define OS_CFG_TASK_TICK_EN             DEF_ENABLED        /* Include (DEF_ENABLED) the kernel tick task                            */
+#define OS_CFG_TICK_WHEEL_EN            DEF_DISABLED       /*     Tick lists as timing wheels (DEF_ENABLED), O(1) insert and remove */
+#define OS_CFG_TICK_WHEEL_BITS          6u                 /*     log2 of the slots per wheel level, RAM is 2 lists x levels x slots*/
 
                                                            /* ------------------ TASK LOCAL STORAGE MANAGEMENT -------------------  */
 #define OS_CFG_TLS_TBL_SIZE             0u                 /* Include (DEF_ENABLED) code for Task Local Storage (TLS) registers     */
@@ -115,6 +117,8 @@
                                                            /* ------------------------- TIMER MANAGEMENT -------------------------- */
 #define OS_CFG_TMR_EN                   DEF_ENABLED        /* Enable (DEF_ENABLED) code generation for TIMERS                       */
 #define OS_CFG_TMR_DEL_EN               DEF_ENABLED        /* Enable (DEF_ENABLED) code generation for OSTmrDel()                   */
+#define OS_CFG_TMR_WHEEL_EN             DEF_DISABLED       /*     Timer list as a timing wheel (DEF_ENABLED), ticks touch due timers*/
+#define OS_CFG_TMR_WHEEL_BITS           6u                 /*     log2 of the slots per wheel level, RAM is levels x slots pointers */
 
                                                            /* ------------------------- TRACE RECORDER ---------------------------- */
 #define OS_CFG_TRACE_EN                 DEF_DISABLED       /* Enable (DEF_ENABLED) uC/OS-III Trace instrumentation                  */
@@ -377,6 +377,34 @@ extern "C" {
 #define  OS_TICK_TH_RDY                     (OS_TICK)(DEF_BIT_FIELD(((sizeof(OS_TICK) * DEF_OCTET_NBR_BITS) / 2u), \
                                                                     ((sizeof(OS_TICK) * DEF_OCTET_NBR_BITS) / 2u)))
 
+/*
+------------------------------------------------------------------------------------------------------------------------
+*                                                      TICK WHEEL
+------------------------------------------------------------------------------------------------------------------------
+*/
+
+#if (OS_CFG_TICK_WHEEL_EN == DEF_ENABLED)
+#define  OS_TICK_WHEEL_SLOTS                (1u << OS_CFG_TICK_WHEEL_BITS)  /* Slots per level                    */
+#define  OS_TICK_WHEEL_MASK                 (OS_TICK)(OS_TICK_WHEEL_SLOTS - 1u)
+                                                                    /* Enough levels to cover every OS_TICK value     */
+#define  OS_TICK_WHEEL_LEVELS               (((sizeof(OS_TICK) * DEF_OCTET_NBR_BITS) + OS_CFG_TICK_WHEEL_BITS - 1u) \
+                                                                    / OS_CFG_TICK_WHEEL_BITS)
+#endif
+
+/*
+------------------------------------------------------------------------------------------------------------------------
+*                                                      TIMER WHEEL
+------------------------------------------------------------------------------------------------------------------------
+*/
+
+#if (OS_CFG_TMR_EN == DEF_ENABLED) && (OS_CFG_TMR_WHEEL_EN == DEF_ENABLED)
+#define  OS_TMR_WHEEL_SLOTS                 (1u << OS_CFG_TMR_WHEEL_BITS)   /* Slots per level                    */
+#define  OS_TMR_WHEEL_MASK                  (OS_TICK)(OS_TMR_WHEEL_SLOTS - 1u)
+                                                                    /* Enough levels to cover every OS_TICK value     */
+#define  OS_TMR_WHEEL_LEVELS                (((sizeof(OS_TICK) * DEF_OCTET_NBR_BITS) + OS_CFG_TMR_WHEEL_BITS - 1u) \
+                                                                    / OS_CFG_TMR_WHEEL_BITS)
+#endif
+
 
 /*
 ------------------------------------------------------------------------------------------------------------------------
@@ -1019,7 +1047,7 @@ struct os_tcb {
 
 #if (OS_CFG_TASK_TICK_EN == DEF_ENABLED)
     OS_TCB              *TickNextPtr;
-    OS_TCB              *TickPrevPtr;
+    OS_TCB              *TickPrevPtr;                       /* With the tick wheel, the link that points to this TCB  */
 
     OS_TICK_LIST        *TickListPtr;                       /* Pointer to tick list if task is in a tick list         */
 #endif
@@ -1066,6 +1094,7 @@ struct os_tcb {
                                                             /* DELAY / TIMEOUT                                        */
 #if (OS_CFG_TASK_TICK_EN == DEF_ENABLED)
     OS_TICK              TickRemain;                        /* Number of ticks remaining (updated by OS_TickTask()    */
+                                                            /* ... or the match tick with the tick wheel              */
     OS_TICK              TickCtrPrev;                       /* Used by OSTimeDlyXX() in PERIODIC mode                 */
 #endif
 
@@ -1149,6 +1178,10 @@ struct os_tcb {
 
 struct  os_tick_list {
     OS_TCB              *TCB_Ptr;                           /* Pointer to list of tasks in tick list                 */
+#if (OS_CFG_TICK_WHEEL_EN == DEF_ENABLED)
+    OS_TICK              TickNext;                          /* Next tick the wheel processes                         */
+    OS_TCB              *Wheel[OS_TICK_WHEEL_LEVELS][OS_TICK_WHEEL_SLOTS];  /* TCBs by match tick, TCB_Ptr unused   */
+#endif
 #if (OS_CFG_DBG_EN == DEF_ENABLED)
     OS_OBJ_QTY           NbrEntries;                        /* Current number of entries in the tick list            */
     OS_OBJ_QTY           NbrUpdated;                        /* Number of entries updated                             */
@@ -1172,8 +1205,9 @@ struct  os_tmr {
     OS_TMR_CALLBACK_PTR  CallbackPtr;                       /* Function to call when timer expires                    */
     void                *CallbackPtrArg;                    /* Argument to pass to function when timer expires        */
     OS_TMR              *NextPtr;                           /* Double link list pointers                              */
-    OS_TMR              *PrevPtr;
+    OS_TMR              *PrevPtr;                           /* With the timer wheel, the link that points to this tmr */
     OS_TICK              Remain;                            /* Amount of time remaining before timer expires          */
+                                                            /* ... or the match tick with the timer wheel             */
     OS_TICK              Dly;                               /* Delay before start of repeat                           */
     OS_TICK              Period;                            /* Period to repeat timer                                 */
     OS_OPT               Opt;                               /* Options (see OS_OPT_TMR_xxx)                           */
@@ -1357,7 +1391,10 @@ OS_EXT            OS_TICK_LIST              OSTickListTimeout;
 OS_EXT            OS_TMR                   *OSTmrDbgListPtr;
 OS_EXT            OS_OBJ_QTY                OSTmrListEntries;           /* Doubly-linked list of timers               */
 #endif
-OS_EXT            OS_TMR                   *OSTmrListPtr;
+OS_EXT            OS_TMR                   *OSTmrListPtr;               /* Unused with the timer wheel                */
+#if (OS_CFG_TMR_WHEEL_EN == DEF_ENABLED)
+OS_EXT            OS_TMR                   *OSTmrWheel[OS_TMR_WHEEL_LEVELS][OS_TMR_WHEEL_SLOTS];  /* Tmrs by match tick */
+#endif
 #if (OS_CFG_MUTEX_EN == DEF_ENABLED)                                    /* Use a Mutex (if available) to protect tmrs */
 OS_EXT            OS_MUTEX                  OSTmrMutex;
 #endif
@@ -2455,6 +2492,21 @@ OS_TICK       BSP_OS_TickNextSet        (OS_TICK                ticks);
 #error  "OS_CFG.H, Missing OS_CFG_TIME_DLY_RESUME_EN: Include code for OSTimeDlyResume()"
 #endif
 
+#ifndef OS_CFG_TICK_WHEEL_EN
+#error  "OS_CFG.H, Missing OS_CFG_TICK_WHEEL_EN: Enable (1) or Disable (0) the timing wheel tick lists"
+#else
+    #if    (OS_CFG_TICK_WHEEL_EN == DEF_ENABLED)
+    #ifndef OS_CFG_TICK_WHEEL_BITS
+    #error  "OS_CFG.H, Missing OS_CFG_TICK_WHEEL_BITS: log2 of the slots per tick wheel level"
+    #elif  (OS_CFG_TICK_WHEEL_BITS < 1u) || (OS_CFG_TICK_WHEEL_BITS > 8u)
+    #error  "OS_CFG.H,         OS_CFG_TICK_WHEEL_BITS must be 1 to 8"
+    #endif
+    #if    (OS_CFG_DYN_TICK_EN == DEF_ENABLED)
+    #error  "OS_CFG.H,         OS_CFG_DYN_TICK_EN must be Disabled (0) to use the tick wheel"
+    #endif
+    #endif
+#endif
+
 /*
 ************************************************************************************************************************
 *                                                  TIMER MANAGEMENT
@@ -2467,6 +2519,15 @@ OS_TICK       BSP_OS_TickNextSet        (OS_TICK                ticks);
     #ifndef OS_CFG_TMR_DEL_EN
     #error  "OS_CFG.H, Missing OS_CFG_TMR_DEL_EN: Enables (1) or Disables (0) code for OSTmrDel()"
     #endif
+    #ifndef OS_CFG_TMR_WHEEL_EN
+    #error  "OS_CFG.H, Missing OS_CFG_TMR_WHEEL_EN: Enable (1) or Disable (0) the timing wheel timer list"
+    #elif  (OS_CFG_TMR_WHEEL_EN == DEF_ENABLED)
+        #ifndef OS_CFG_TMR_WHEEL_BITS
+        #error  "OS_CFG.H, Missing OS_CFG_TMR_WHEEL_BITS: log2 of the slots per timer wheel level"
+        #elif  (OS_CFG_TMR_WHEEL_BITS < 1u) || (OS_CFG_TMR_WHEEL_BITS > 8u)
+        #error  "OS_CFG.H,         OS_CFG_TMR_WHEEL_BITS must be 1 to 8"
+        #endif
+    #endif
 #endif
 
 /*
@@ -48,6 +48,15 @@ const  CPU_CHAR  *os_tick__c = "$Id: $";
 
 static  CPU_TS  OS_TickListUpdateDly     (OS_TICK ticks);
 static  CPU_TS  OS_TickListUpdateTimeout (OS_TICK ticks);
+static  void    OS_TickListDlyRdy        (OS_TCB *p_tcb);
+static  void    OS_TickListTimeoutRdy    (OS_TCB *p_tcb);
+
+#if (OS_CFG_TICK_WHEEL_EN == DEF_ENABLED)
+static  void    OS_TickWheelInit         (OS_TICK_LIST *p_list);
+static  void    OS_TickWheelPlace        (OS_TICK_LIST *p_list,
+                                          OS_TCB       *p_tcb);
+static  OS_TCB *OS_TickWheelAdvance      (OS_TICK_LIST *p_list);
+#endif
 
 /*
 ************************************************************************************************************************
@@ -164,6 +173,11 @@ void  OS_TickTaskInit (OS_ERR  *p_err)
     OSTickListDly.TCB_Ptr        = (OS_TCB *)0;
     OSTickListTimeout.TCB_Ptr    = (OS_TCB *)0;
 
+#if (OS_CFG_TICK_WHEEL_EN == DEF_ENABLED)
+    OS_TickWheelInit(&OSTickListDly);
+    OS_TickWheelInit(&OSTickListTimeout);
+#endif
+
 #if (OS_CFG_DBG_EN == DEF_ENABLED)
     OSTickListDly.NbrEntries     = 0u;
     OSTickListDly.NbrUpdated     = 0u;
@@ -221,10 +235,14 @@ void  OS_TickTaskInit (OS_ERR  *p_err)
 *
 * Returns    : none
 *
-* Note(s)    : This function is INTERNAL to uC/OS-III and your application should not call it.
+* Note(s)    : 1) This function is INTERNAL to uC/OS-III and your application should not call it.
+*
+*              2) The list is kept in delta order, each TCB holds the ticks after the one before it, so the insert walks
+*                 the list.  With OS_CFG_TICK_WHEEL_EN the insert is O(1), see the TICK WHEEL section.
 ************************************************************************************************************************
 */
 
+#if (OS_CFG_TICK_WHEEL_EN == DEF_DISABLED)
 void  OS_TickListInsert (OS_TICK_LIST  *p_list,
                          OS_TCB        *p_tcb,
                          OS_TICK        time)
@@ -315,6 +333,24 @@ void  OS_TickListInsert (OS_TICK_LIST  *p_list,
 #endif
 }
 
+#else
+
+void  OS_TickListInsert (OS_TICK_LIST  *p_list,
+                         OS_TCB        *p_tcb,
+                         OS_TICK        time)
+{
+    if (time == 0u) {                                           /* A delta list readies a 0 on the next tick too        */
+        time = 1u;
+    }
+    p_tcb->TickRemain  = p_list->TickNext + (time - 1u);        /* Match tick                                           */
+    p_tcb->TickListPtr = p_list;
+    OS_TickWheelPlace(p_list, p_tcb);
+#if (OS_CFG_DBG_EN == DEF_ENABLED)
+    p_list->NbrEntries++;
+#endif
+}
+#endif
+
 /*
 ************************************************************************************************************************
 *                                            ADD TASK TO DELAYED TICK LIST
@@ -419,6 +455,7 @@ void  OS_TickListInsertDly (OS_TCB   *p_tcb,
 ************************************************************************************************************************
 */
 
+#if (OS_CFG_TICK_WHEEL_EN == DEF_DISABLED)
 void  OS_TickListRemove (OS_TCB  *p_tcb)
 {
     OS_TICK_LIST  *p_list;
@@ -464,6 +501,30 @@ void  OS_TickListRemove (OS_TCB  *p_tcb)
     }
 }
 
+#else
+
+void  OS_TickListRemove (OS_TCB  *p_tcb)
+{
+    OS_TCB  **p_link;
+    OS_TCB   *p_tcb2;
+
+
+    p_link  = (OS_TCB **)(void *)p_tcb->TickPrevPtr;            /* The slot or TickNextPtr that points to this TCB      */
+    p_tcb2  =  p_tcb->TickNextPtr;
+   *p_link  =  p_tcb2;
+    if (p_tcb2 != (OS_TCB *)0) {
+        p_tcb2->TickPrevPtr = (OS_TCB *)(void *)p_link;
+    }
+#if (OS_CFG_DBG_EN == DEF_ENABLED)
+    p_tcb->TickListPtr->NbrEntries--;
+#endif
+    p_tcb->TickPrevPtr  = (OS_TCB       *)0;
+    p_tcb->TickNextPtr  = (OS_TCB       *)0;
+    p_tcb->TickRemain   =                 0u;
+    p_tcb->TickListPtr  = (OS_TICK_LIST *)0;
+}
+#endif
+
 /*
 ************************************************************************************************************************
 *                                           UPDATE THE LIST OF TASKS DELAYED
@@ -478,6 +539,7 @@ void  OS_TickListRemove (OS_TCB  *p_tcb)
 ************************************************************************************************************************
 */
 
+#if (OS_CFG_TICK_WHEEL_EN == DEF_DISABLED)
 static  CPU_TS  OS_TickListUpdateDly (OS_TICK  ticks)
 {
     OS_TCB       *p_tcb;
@@ -511,15 +573,7 @@ static  CPU_TS  OS_TickListUpdateDly (OS_TICK  ticks)
 #if (OS_CFG_DBG_EN == DEF_ENABLED)
             nbr_updated++;                                      /* Keep track of the number of TCBs updated             */
 #endif
-            if (p_tcb->TaskState == OS_TASK_STATE_DLY) {
-                p_tcb->TaskState = OS_TASK_STATE_RDY;
-                OS_RdyListInsert(p_tcb);                        /* Insert the task in the ready list                    */
-
-            } else {
-                if (p_tcb->TaskState == OS_TASK_STATE_DLY_SUSPENDED) {
-                    p_tcb->TaskState = OS_TASK_STATE_SUSPENDED;
-                }
-            }
+            OS_TickListDlyRdy(p_tcb);
 
             p_list->TCB_Ptr = p_tcb->TickNextPtr;
             p_tcb           = p_list->TCB_Ptr;                  /* Get 'p_tcb' again for loop                           */
@@ -557,6 +611,61 @@ static  CPU_TS  OS_TickListUpdateDly (OS_TICK  ticks)
 #endif
 }
 
+#else
+
+static  CPU_TS  OS_TickListUpdateDly (OS_TICK  ticks)
+{
+    OS_TCB       *p_tcb;
+    OS_TCB       *p_tcb_next;
+    OS_TICK_LIST *p_list;
+#if (OS_CFG_TS_EN == DEF_ENABLED)
+    CPU_TS        ts_start;
+    CPU_TS        ts_delta_dly;
+#endif
+#if (OS_CFG_DBG_EN == DEF_ENABLED)
+    OS_OBJ_QTY    nbr_updated;
+#endif
+
+                                                                /*  ========= UPDATE TASKS WAITING FOR DELAY =========  */
+#if (OS_CFG_TS_EN == DEF_ENABLED)
+    ts_start    = OS_TS_GET();
+#endif
+#if (OS_CFG_DBG_EN == DEF_ENABLED)
+    nbr_updated = (OS_OBJ_QTY)0u;
+#endif
+    p_list      = &OSTickListDly;
+    while (ticks > 0u) {
+        p_tcb = OS_TickWheelAdvance(p_list);                    /* Only the TCBs that match this tick are touched       */
+        while (p_tcb != (OS_TCB *)0) {
+#if (OS_CFG_DBG_EN == DEF_ENABLED)
+            nbr_updated++;
+            p_list->NbrEntries--;
+#endif
+            p_tcb_next         = p_tcb->TickNextPtr;
+            p_tcb->TickNextPtr = (OS_TCB       *)0;
+            p_tcb->TickPrevPtr = (OS_TCB       *)0;
+            p_tcb->TickListPtr = (OS_TICK_LIST *)0;
+            p_tcb->TickRemain  =                 0u;
+            OS_TickListDlyRdy(p_tcb);
+            p_tcb              = p_tcb_next;
+        }
+        ticks--;
+    }
+#if (OS_CFG_DBG_EN == DEF_ENABLED)
+    p_list->NbrUpdated = nbr_updated;
+#endif
+#if (OS_CFG_TS_EN == DEF_ENABLED)
+    ts_delta_dly       = OS_TS_GET() - ts_start;                /* Measure execution time of the update                 */
+#endif
+
+#if (OS_CFG_TS_EN == DEF_ENABLED)
+    return (ts_delta_dly);
+#else
+    return (0u);
+#endif
+}
+#endif
+
 
 /*
 ************************************************************************************************************************
@@ -572,6 +681,7 @@ static  CPU_TS  OS_TickListUpdateDly (OS_TICK  ticks)
 ************************************************************************************************************************
 */
 
+#if (OS_CFG_TICK_WHEEL_EN == DEF_DISABLED)
 static  CPU_TS  OS_TickListUpdateTimeout (OS_TICK  ticks)
 {
     OS_TCB       *p_tcb;
@@ -583,10 +693,6 @@ static  CPU_TS  OS_TickListUpdateTimeout (OS_TICK  ticks)
 #if (OS_CFG_DBG_EN == DEF_ENABLED)
     OS_OBJ_QTY    nbr_updated;
 #endif
-#if (OS_CFG_MUTEX_EN == DEF_ENABLED)
-    OS_TCB       *p_tcb_owner;
-    OS_PRIO       prio_new;
-#endif
 
                                                                 /*  ======= UPDATE TASKS WAITING WITH TIMEOUT ========  */
 #if (OS_CFG_TS_EN == DEF_ENABLED)
@@ -610,46 +716,7 @@ static  CPU_TS  OS_TickListUpdateTimeout (OS_TICK  ticks)
             nbr_updated++;
 #endif
 
-#if (OS_CFG_MUTEX_EN == DEF_ENABLED)
-            p_tcb_owner = (OS_TCB *)0;
-            if (p_tcb->PendOn == OS_TASK_PEND_ON_MUTEX) {
-                p_tcb_owner = (OS_TCB *)((OS_MUTEX *)((void *)p_tcb->PendObjPtr))->OwnerTCBPtr;
-            }
-#endif
-
-#if (OS_MSG_EN == DEF_ENABLED)
-            p_tcb->MsgPtr  = (void *)0;
-            p_tcb->MsgSize = 0u;
-#endif
-#if (OS_CFG_TS_EN == DEF_ENABLED)
-            p_tcb->TS      = OS_TS_GET();
-#endif
-            OS_PendListRemove(p_tcb);                           /* Remove task from pend list                           */
-            if (p_tcb->TaskState == OS_TASK_STATE_PEND_TIMEOUT) {
-                OS_RdyListInsert(p_tcb);                        /* Insert the task in the ready list                    */
-                p_tcb->TaskState  = OS_TASK_STATE_RDY;
-
-            } else {
-                if (p_tcb->TaskState == OS_TASK_STATE_PEND_TIMEOUT_SUSPENDED) {
-                    p_tcb->TaskState  = OS_TASK_STATE_SUSPENDED;
-                }
-            }
-            p_tcb->PendStatus = OS_STATUS_PEND_TIMEOUT;         /* Indicate pend timed out                              */
-            p_tcb->PendOn     = OS_TASK_PEND_ON_NOTHING;        /* Indicate no longer pending                           */
-
-#if (OS_CFG_MUTEX_EN == DEF_ENABLED)
-            if (p_tcb_owner != (OS_TCB *)0) {
-                if ((p_tcb_owner->Prio != p_tcb_owner->BasePrio) &&
-                    (p_tcb_owner->Prio == p_tcb->Prio)) {       /* Has the owner inherited a priority?                  */
-                    prio_new = OS_MutexGrpPrioFindHighest(p_tcb_owner);
-                    prio_new = (prio_new > p_tcb_owner->BasePrio) ? p_tcb_owner->BasePrio : prio_new;
-                    if(prio_new != p_tcb_owner->Prio) {
-                        OS_TaskChangePrio(p_tcb_owner, prio_new);
-                        OS_TRACE_MUTEX_TASK_PRIO_DISINHERIT(p_tcb_owner, p_tcb_owner->Prio);
-                    }
-                }
-            }
-#endif
+            OS_TickListTimeoutRdy(p_tcb);
 
             p_list->TCB_Ptr = p_tcb->TickNextPtr;
             p_tcb           = p_list->TCB_Ptr;                  /* Get 'p_tcb' again for loop                           */
@@ -685,4 +752,254 @@ static  CPU_TS  OS_TickListUpdateTimeout (OS_TICK  ticks)
     return (0u);
 #endif
 }
+
+#else
+
+static  CPU_TS  OS_TickListUpdateTimeout (OS_TICK  ticks)
+{
+    OS_TCB       *p_tcb;
+    OS_TCB       *p_tcb_next;
+    OS_TICK_LIST *p_list;
+#if (OS_CFG_TS_EN == DEF_ENABLED)
+    CPU_TS        ts_start;
+    CPU_TS        ts_delta_timeout;
+#endif
+#if (OS_CFG_DBG_EN == DEF_ENABLED)
+    OS_OBJ_QTY    nbr_updated;
+#endif
+
+                                                                /*  ======= UPDATE TASKS WAITING WITH TIMEOUT ========  */
+#if (OS_CFG_TS_EN == DEF_ENABLED)
+    ts_start    = OS_TS_GET();
+#endif
+#if (OS_CFG_DBG_EN == DEF_ENABLED)
+    nbr_updated = (OS_OBJ_QTY)0u;
+#endif
+    p_list      = &OSTickListTimeout;
+    while (ticks > 0u) {
+        p_tcb = OS_TickWheelAdvance(p_list);                    /* Only the TCBs that match this tick are touched       */
+        while (p_tcb != (OS_TCB *)0) {
+#if (OS_CFG_DBG_EN == DEF_ENABLED)
+            nbr_updated++;
+            p_list->NbrEntries--;
+#endif
+            p_tcb_next         = p_tcb->TickNextPtr;
+            p_tcb->TickNextPtr = (OS_TCB       *)0;
+            p_tcb->TickPrevPtr = (OS_TCB       *)0;
+            p_tcb->TickListPtr = (OS_TICK_LIST *)0;
+            p_tcb->TickRemain  =                 0u;
+            OS_TickListTimeoutRdy(p_tcb);
+            p_tcb              = p_tcb_next;
+        }
+        ticks--;
+    }
+#if (OS_CFG_DBG_EN == DEF_ENABLED)
+    p_list->NbrUpdated = nbr_updated;
+#endif
+#if (OS_CFG_TS_EN == DEF_ENABLED)
+    ts_delta_timeout   = OS_TS_GET() - ts_start;                /* Measure execution time of the update                 */
+#endif
+
+#if (OS_CFG_TS_EN == DEF_ENABLED)
+    return (ts_delta_timeout);
+#else
+    return (0u);
+#endif
+}
+#endif
+
+
+/*
+************************************************************************************************************************
+*                                              MAKE A DELAYED TASK READY
+*
+* Description: This function readies a task whose delay has expired, or leaves it suspended.
+*
+* Arguments  : p_tcb          is a pointer to the OS_TCB of the task, already taken out of the tick list.
+*
+* Returns    : none
+*
+* Note(s)    : 1) This function is INTERNAL to uC/OS-III and your application MUST NOT call it.
+************************************************************************************************************************
+*/
+
+static  void  OS_TickListDlyRdy (OS_TCB  *p_tcb)
+{
+    if (p_tcb->TaskState == OS_TASK_STATE_DLY) {
+        p_tcb->TaskState = OS_TASK_STATE_RDY;
+        OS_RdyListInsert(p_tcb);                                /* Insert the task in the ready list                    */
+
+    } else {
+        if (p_tcb->TaskState == OS_TASK_STATE_DLY_SUSPENDED) {
+            p_tcb->TaskState = OS_TASK_STATE_SUSPENDED;
+        }
+    }
+}
+
+/*
+************************************************************************************************************************
+*                                                TIME OUT A PENDING TASK
+*
+* Description: This function ends the pend of a task whose timeout has expired, readies it or leaves it suspended, and
+*              gives back any priority a mutex owner inherited from it.
+*
+* Arguments  : p_tcb          is a pointer to the OS_TCB of the task, already taken out of the tick list.
+*
+* Returns    : none
+*
+* Note(s)    : 1) This function is INTERNAL to uC/OS-III and your application MUST NOT call it.
+************************************************************************************************************************
+*/
+
+static  void  OS_TickListTimeoutRdy (OS_TCB  *p_tcb)
+{
+#if (OS_CFG_MUTEX_EN == DEF_ENABLED)
+    OS_TCB       *p_tcb_owner;
+    OS_PRIO       prio_new;
+#endif
+
+
+#if (OS_CFG_MUTEX_EN == DEF_ENABLED)
+    p_tcb_owner = (OS_TCB *)0;
+    if (p_tcb->PendOn == OS_TASK_PEND_ON_MUTEX) {
+        p_tcb_owner = (OS_TCB *)((OS_MUTEX *)((void *)p_tcb->PendObjPtr))->OwnerTCBPtr;
+    }
+#endif
+
+#if (OS_MSG_EN == DEF_ENABLED)
+    p_tcb->MsgPtr  = (void *)0;
+    p_tcb->MsgSize = 0u;
+#endif
+#if (OS_CFG_TS_EN == DEF_ENABLED)
+    p_tcb->TS      = OS_TS_GET();
+#endif
+    OS_PendListRemove(p_tcb);                                   /* Remove task from pend list                           */
+    if (p_tcb->TaskState == OS_TASK_STATE_PEND_TIMEOUT) {
+        OS_RdyListInsert(p_tcb);                                /* Insert the task in the ready list                    */
+        p_tcb->TaskState  = OS_TASK_STATE_RDY;
+
+    } else {
+        if (p_tcb->TaskState == OS_TASK_STATE_PEND_TIMEOUT_SUSPENDED) {
+            p_tcb->TaskState  = OS_TASK_STATE_SUSPENDED;
+        }
+    }
+    p_tcb->PendStatus = OS_STATUS_PEND_TIMEOUT;                 /* Indicate pend timed out                              */
+    p_tcb->PendOn     = OS_TASK_PEND_ON_NOTHING;                /* Indicate no longer pending                           */
+
+#if (OS_CFG_MUTEX_EN == DEF_ENABLED)
+    if (p_tcb_owner != (OS_TCB *)0) {
+        if ((p_tcb_owner->Prio != p_tcb_owner->BasePrio) &&
+            (p_tcb_owner->Prio == p_tcb->Prio)) {               /* Has the owner inherited a priority?                  */
+            prio_new = OS_MutexGrpPrioFindHighest(p_tcb_owner);
+            prio_new = (prio_new > p_tcb_owner->BasePrio) ? p_tcb_owner->BasePrio : prio_new;
+            if(prio_new != p_tcb_owner->Prio) {
+                OS_TaskChangePrio(p_tcb_owner, prio_new);
+                OS_TRACE_MUTEX_TASK_PRIO_DISINHERIT(p_tcb_owner, p_tcb_owner->Prio);
+            }
+        }
+    }
+#endif
+}
+
+#if (OS_CFG_TICK_WHEEL_EN == DEF_ENABLED)
+/*
+************************************************************************************************************************
+*                                                      TICK WHEEL
+*
+* Description: With OS_CFG_TICK_WHEEL_EN each tick list is a hierarchical timing wheel instead of a delta list.  A TCB
+*              holds its match tick in .TickRemain and sits in one slot of one level.  Level 0 has a slot per tick for
+*              the next OS_TICK_WHEEL_SLOTS ticks, each level above has a slot per OS_TICK_WHEEL_SLOTS ticks of the level
+*              below, and there are enough levels for any OS_TICK delay.
+*
+*              Each tick empties one level 0 slot, every TCB in it is due.  When level 0 wraps, the next slot of
+*              level 1 is spread over level 0, and so on up while levels wrap.  Insert and remove are O(1), a tick
+*              touches only the TCBs that are due plus, amortised, at most OS_TICK_WHEEL_LEVELS - 1 moves per TCB over
+*              its whole wait.  The scheduler is locked for that much instead of a walk of the whole list.
+*
+*              Slots are doubly linked through .TickNextPtr, and .TickPrevPtr points at the link that points to the TCB,
+*              the slot itself or the .TickNextPtr of the TCB before, so a TCB is unlinked without knowing its slot.
+*
+*              Tasks due on the same tick are readied in a different order than with the delta list.  The tick list
+*              RAM is 2 x OS_TICK_WHEEL_LEVELS x OS_TICK_WHEEL_SLOTS pointers, 3072 bytes with 6 bits.
+*
+* Note(s)    : 1) These functions are INTERNAL to uC/OS-III and your application MUST NOT call them.
+*
+*              2) These functions are assumed to be called with interrupts disabled.
+************************************************************************************************************************
+*/
+
+static  void  OS_TickWheelInit (OS_TICK_LIST  *p_list)
+{
+    CPU_INT08U  level;
+    OS_TICK     slot;
+
+
+    for (level = 0u; level < OS_TICK_WHEEL_LEVELS; level++) {
+        for (slot = 0u; slot < OS_TICK_WHEEL_SLOTS; slot++) {
+            p_list->Wheel[level][slot] = (OS_TCB *)0;
+        }
+    }
+    p_list->TickNext = OSTickCtr + 1u;
+}
+
+
+static  void  OS_TickWheelPlace (OS_TICK_LIST  *p_list,
+                                 OS_TCB        *p_tcb)
+{
+    OS_TICK      delta;
+    CPU_INT08U   level;
+    OS_TCB     **p_slot;
+
+
+    delta = p_tcb->TickRemain - p_list->TickNext;               /* Ticks after the next one processed                   */
+    level = 0u;
+    while (((delta >> OS_CFG_TICK_WHEEL_BITS) != 0u) &&         /* Lowest level whose span covers the delta             */
+           (level < (OS_TICK_WHEEL_LEVELS - 1u))) {
+        delta >>= OS_CFG_TICK_WHEEL_BITS;
+        level++;
+    }
+    p_slot = &p_list->Wheel[level][(p_tcb->TickRemain >> (level * OS_CFG_TICK_WHEEL_BITS)) & OS_TICK_WHEEL_MASK];
+
+    p_tcb->TickNextPtr = *p_slot;                               /* Link at the head of the slot                         */
+    p_tcb->TickPrevPtr = (OS_TCB *)(void *)p_slot;
+    if (*p_slot != (OS_TCB *)0) {
+        (*p_slot)->TickPrevPtr = (OS_TCB *)(void *)&p_tcb->TickNextPtr;
+    }
+   *p_slot = p_tcb;
+}
+
+
+static  OS_TCB  *OS_TickWheelAdvance (OS_TICK_LIST  *p_list)
+{
+    OS_TICK      tick;
+    OS_TICK      slot;
+    CPU_INT08U   level;
+    OS_TCB      *p_tcb;
+    OS_TCB      *p_tcb_next;
+
+
+    tick = p_list->TickNext;
+    if ((tick & OS_TICK_WHEEL_MASK) == 0u) {                    /* Level 0 wrapped, spread the levels above down        */
+        for (level = 1u; level < OS_TICK_WHEEL_LEVELS; level++) {
+            slot  = (tick >> (level * OS_CFG_TICK_WHEEL_BITS)) & OS_TICK_WHEEL_MASK;
+            p_tcb = p_list->Wheel[level][slot];
+            p_list->Wheel[level][slot] = (OS_TCB *)0;
+            while (p_tcb != (OS_TCB *)0) {                      /* Each lands in a lower level, TickNext is still tick  */
+                p_tcb_next = p_tcb->TickNextPtr;
+                OS_TickWheelPlace(p_list, p_tcb);
+                p_tcb      = p_tcb_next;
+            }
+            if (slot != 0u) {                                   /* This level did not wrap, the ones above wait         */
+                break;
+            }
+        }
+    }
+
+    slot  = tick & OS_TICK_WHEEL_MASK;                          /* Every TCB in the level 0 slot matches this tick      */
+    p_tcb = p_list->Wheel[0][slot];
+    p_list->Wheel[0][slot] = (OS_TCB *)0;
+    p_list->TickNext       = tick + 1u;
+    return (p_tcb);
+}
+#endif
 #endif
@@ -50,6 +50,12 @@ const  CPU_CHAR  *os_tmr__c = "$Id: $";
 static  void  OS_TmrLock   (void);
 static  void  OS_TmrUnlock (void);
 
+#if (OS_CFG_TMR_WHEEL_EN == DEF_ENABLED)
+static  void  OS_TmrWheelPlace   (OS_TMR   *p_tmr);
+static  void  OS_TmrWheelRemove  (OS_TMR   *p_tmr);
+static  void  OS_TmrWheelAdvance (OS_TMR  **p_due);
+#endif
+
 
 /*
 ************************************************************************************************************************
@@ -394,7 +400,11 @@ OS_TICK  OSTmrRemainGet (OS_TMR  *p_tmr,
 
     switch (p_tmr->State) {
         case OS_TMR_STATE_RUNNING:
+#if (OS_CFG_TMR_WHEEL_EN == DEF_ENABLED)
+             remain = p_tmr->Remain - OSTmrTickCtr;             /* Remain is the match tick                             */
+#else
              remain = p_tmr->Remain;
+#endif
             *p_err  = OS_ERR_NONE;
              break;
 
@@ -590,7 +600,9 @@ void  OSTmrSet (OS_TMR               *p_tmr,
 CPU_BOOLEAN  OSTmrStart (OS_TMR  *p_tmr,
                          OS_ERR  *p_err)
 {
+#if (OS_CFG_TMR_WHEEL_EN == DEF_DISABLED)
     OS_TMR      *p_next;
+#endif
     CPU_BOOLEAN  success;
 
 
@@ -639,6 +651,11 @@ CPU_BOOLEAN  OSTmrStart (OS_TMR  *p_tmr,
              } else {
                  p_tmr->Remain = p_tmr->Dly;
              }
+#if (OS_CFG_TMR_WHEEL_EN == DEF_ENABLED)
+             OS_TmrWheelRemove(p_tmr);                          /* Move it to the slot of its new match tick            */
+             p_tmr->Remain += OSTmrTickCtr;
+             OS_TmrWheelPlace(p_tmr);
+#endif
             *p_err         = OS_ERR_NONE;
              success       = DEF_TRUE;
              break;
@@ -651,6 +668,13 @@ CPU_BOOLEAN  OSTmrStart (OS_TMR  *p_tmr,
              } else {
                  p_tmr->Remain = p_tmr->Dly;
              }
+#if (OS_CFG_TMR_WHEEL_EN == DEF_ENABLED)
+             p_tmr->Remain += OSTmrTickCtr;                     /* Link into the timer wheel at its match tick          */
+             OS_TmrWheelPlace(p_tmr);
+#if (OS_CFG_DBG_EN == DEF_ENABLED)
+             OSTmrListEntries++;
+#endif
+#else
              if (OSTmrListPtr == (OS_TMR *)0) {                 /* Link into timer list                                 */
                  p_tmr->NextPtr   = (OS_TMR *)0;                /* This is the first timer in the list                  */
                  p_tmr->PrevPtr   = (OS_TMR *)0;
@@ -668,6 +692,7 @@ CPU_BOOLEAN  OSTmrStart (OS_TMR  *p_tmr,
                  OSTmrListEntries++;
 #endif
              }
+#endif
             *p_err   = OS_ERR_NONE;
              success = DEF_TRUE;
              break;
@@ -1044,11 +1069,24 @@ void  OS_TmrDbgListRemove (OS_TMR  *p_tmr)
 
 void  OS_TmrInit (OS_ERR  *p_err)
 {
+#if (OS_CFG_TMR_WHEEL_EN == DEF_ENABLED)
+    CPU_INT08U  level;
+    OS_TICK     slot;
+#endif
+
+
 #if (OS_CFG_DBG_EN == DEF_ENABLED)
     OSTmrDbgListPtr     = (OS_TMR *)0;
 #endif
 
     OSTmrListPtr        = (OS_TMR *)0;                          /* Create an empty timer list                           */
+#if (OS_CFG_TMR_WHEEL_EN == DEF_ENABLED)
+    for (level = 0u; level < OS_TMR_WHEEL_LEVELS; level++) {    /* ... and an empty timer wheel                         */
+        for (slot = 0u; slot < OS_TMR_WHEEL_SLOTS; slot++) {
+            OSTmrWheel[level][slot] = (OS_TMR *)0;
+        }
+    }
+#endif
 #if (OS_CFG_DBG_EN == DEF_ENABLED)
     OSTmrListEntries    =           0u;
 #endif
@@ -1132,6 +1170,9 @@ void  OS_TmrInit (OS_ERR  *p_err)
 
 void  OS_TmrUnlink (OS_TMR  *p_tmr)
 {
+#if (OS_CFG_TMR_WHEEL_EN == DEF_ENABLED)
+    OS_TmrWheelRemove(p_tmr);                                   /* Remove timer from its wheel slot                     */
+#else
     OS_TMR  *p_tmr1;
     OS_TMR  *p_tmr2;
 
@@ -1150,6 +1191,7 @@ void  OS_TmrUnlink (OS_TMR  *p_tmr)
             p_tmr2->PrevPtr = p_tmr1;
         }
     }
+#endif
     p_tmr->State   = OS_TMR_STATE_STOPPED;
     p_tmr->NextPtr = (OS_TMR *)0;
     p_tmr->PrevPtr = (OS_TMR *)0;
@@ -1178,7 +1220,11 @@ void  OS_TmrTask (void  *p_arg)
     OS_ERR               err;
     OS_TMR_CALLBACK_PTR  p_fnct;
     OS_TMR              *p_tmr;
+#if (OS_CFG_TMR_WHEEL_EN == DEF_ENABLED)
+    OS_TMR              *p_tmr_due;
+#else
     OS_TMR              *p_tmr_next;
+#endif
 #if (OS_CFG_DYN_TICK_EN != DEF_ENABLED)
     CPU_TS               ts;
 #endif
@@ -1210,6 +1256,28 @@ void  OS_TmrTask (void  *p_arg)
 #if (OS_CFG_TS_EN == DEF_ENABLED)
         ts_start = OS_TS_GET();
 #endif
+#if (OS_CFG_TMR_WHEEL_EN == DEF_ENABLED)
+        OS_TmrWheelAdvance(&p_tmr_due);                         /* Increment the current time, take the timers due      */
+        while (p_tmr_due != (OS_TMR *)0) {                      /* Update only the timers that expire                   */
+            OSSchedLock(&err);
+            (void)err;
+            p_tmr = p_tmr_due;
+            if (p_tmr->Opt == OS_OPT_TMR_PERIODIC) {
+                OS_TmrWheelRemove(p_tmr);                       /* Reload the match tick                                */
+                p_tmr->Remain = OSTmrTickCtr + p_tmr->Period;
+                OS_TmrWheelPlace(p_tmr);
+            } else {
+                OS_TmrUnlink(p_tmr);                            /* Remove from list                                     */
+                p_tmr->State = OS_TMR_STATE_COMPLETED;          /* Indicate that the timer has completed                */
+            }
+            p_fnct = p_tmr->CallbackPtr;                        /* Execute callback function if available               */
+            if (p_fnct != (OS_TMR_CALLBACK_PTR)0u) {
+                (*p_fnct)(p_tmr, p_tmr->CallbackPtrArg);
+            }
+            OSSchedUnlock(&err);
+            (void)err;
+        }
+#else
         OSTmrTickCtr++;                                         /* Increment the current time                           */
         p_tmr    = OSTmrListPtr;
         while (p_tmr != (OS_TMR *)0) {                          /* Update all the timers in the list                    */
@@ -1233,6 +1301,7 @@ void  OS_TmrTask (void  *p_arg)
             OSSchedUnlock(&err);
             (void)err;
         }
+#endif
 
 #if (OS_CFG_TS_EN == DEF_ENABLED)
         ts_delta = OS_TS_GET() - ts_start;                      /* Measure execution time of timer task                 */
@@ -1301,4 +1370,112 @@ static  void  OS_TmrUnlock (void)
 #endif
 }
 
+
+#if (OS_CFG_TMR_WHEEL_EN == DEF_ENABLED)
+/*
+************************************************************************************************************************
+*                                                     TIMER WHEEL
+*
+* Description: With OS_CFG_TMR_WHEEL_EN the running timers sit in a hierarchical timing wheel, OSTmrWheel[], instead of
+*              the list at OSTmrListPtr.  A running timer holds its match tick, the value of OSTmrTickCtr it expires at,
+*              in .Remain.  Level 0 has a slot per timer tick for the next OS_TMR_WHEEL_SLOTS ticks, each level above
+*              has a slot per OS_TMR_WHEEL_SLOTS ticks of the level below, and there are enough levels for any delay.
+*
+*              Each timer tick empties one level 0 slot, every timer in it expires.  When level 0 wraps, the next slot
+*              of level 1 is spread over level 0, and so on up while levels wrap.  Start, stop and delete are O(1), a
+*              tick touches only the timers that expire plus, amortised, at most OS_TMR_WHEEL_LEVELS - 1 moves per
+*              timer per period, instead of a decrement and a scheduler lock for every running timer.
+*
+*              Slots are doubly linked through .NextPtr, and .PrevPtr points at the link that points to the timer, the
+*              slot itself or the .NextPtr of the timer before, so a timer is unlinked without knowing its slot.  The
+*              timers due on a tick are moved to a list of their own first, a callback may stop or restart any timer.
+*
+*              Timers that expire on the same tick have their callbacks called in a different order than with the list.
+*              The wheel RAM is OS_TMR_WHEEL_LEVELS x OS_TMR_WHEEL_SLOTS pointers, 1536 bytes with 6 bits.
+*
+* Note(s)    : 1) These functions are INTERNAL to uC/OS-III and your application MUST NOT call them.
+*
+*              2) These functions are assumed to be called with the timers locked by OS_TmrLock().
+************************************************************************************************************************
+*/
+
+static  void  OS_TmrWheelPlace (OS_TMR  *p_tmr)
+{
+    OS_TICK      delta;
+    CPU_INT08U   level;
+    OS_TMR     **p_slot;
+
+
+    delta = p_tmr->Remain - (OSTmrTickCtr + 1u);                /* Timer ticks after the next one processed             */
+    level = 0u;
+    while (((delta >> OS_CFG_TMR_WHEEL_BITS) != 0u) &&          /* Lowest level whose span covers the delta             */
+           (level < (OS_TMR_WHEEL_LEVELS - 1u))) {
+        delta >>= OS_CFG_TMR_WHEEL_BITS;
+        level++;
+    }
+    p_slot = &OSTmrWheel[level][(p_tmr->Remain >> (level * OS_CFG_TMR_WHEEL_BITS)) & OS_TMR_WHEEL_MASK];
+
+    p_tmr->NextPtr = *p_slot;                                   /* Link at the head of the slot                         */
+    p_tmr->PrevPtr = (OS_TMR *)(void *)p_slot;
+    if (*p_slot != (OS_TMR *)0) {
+        (*p_slot)->PrevPtr = (OS_TMR *)(void *)&p_tmr->NextPtr;
+    }
+   *p_slot = p_tmr;
+}
+
+
+
+static  void  OS_TmrWheelRemove (OS_TMR  *p_tmr)
+{
+    OS_TMR  **p_link;
+    OS_TMR   *p_tmr2;
+
+
+    p_link  = (OS_TMR **)(void *)p_tmr->PrevPtr;                /* The slot or NextPtr that points to this timer        */
+    p_tmr2  =  p_tmr->NextPtr;
+   *p_link  =  p_tmr2;
+    if (p_tmr2 != (OS_TMR *)0) {
+        p_tmr2->PrevPtr = (OS_TMR *)(void *)p_link;
+    }
+}
+
+
+
+static  void  OS_TmrWheelAdvance (OS_TMR  **p_due)
+{
+    OS_TICK      tick;
+    OS_TICK      slot;
+    CPU_INT08U   level;
+    OS_TMR      *p_tmr;
+    OS_TMR      *p_tmr_next;
+
+
+    tick = OSTmrTickCtr + 1u;
+    if ((tick & OS_TMR_WHEEL_MASK) == 0u) {                     /* Level 0 wrapped, spread the levels above down        */
+        for (level = 1u; level < OS_TMR_WHEEL_LEVELS; level++) {
+            slot  = (tick >> (level * OS_CFG_TMR_WHEEL_BITS)) & OS_TMR_WHEEL_MASK;
+            p_tmr = OSTmrWheel[level][slot];
+            OSTmrWheel[level][slot] = (OS_TMR *)0;
+            while (p_tmr != (OS_TMR *)0) {                      /* Each lands in a lower level, OSTmrTickCtr + 1 = tick */
+                p_tmr_next = p_tmr->NextPtr;
+                OS_TmrWheelPlace(p_tmr);
+                p_tmr      = p_tmr_next;
+            }
+            if (slot != 0u) {                                   /* This level did not wrap, the ones above wait         */
+                break;
+            }
+        }
+    }
+
+    slot   = tick & OS_TMR_WHEEL_MASK;                          /* Every timer in the level 0 slot matches this tick    */
+    p_tmr  = OSTmrWheel[0][slot];
+    OSTmrWheel[0][slot] = (OS_TMR *)0;
+   *p_due  = p_tmr;                                             /* The due list heads at *p_due, not at the slot        */
+    if (p_tmr != (OS_TMR *)0) {
+        p_tmr->PrevPtr = (OS_TMR *)(void *)p_due;
+    }
+    OSTmrTickCtr = tick;
+}
+#endif
+
 #endif
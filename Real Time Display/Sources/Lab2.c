@@ -3,8 +3,14 @@
 * Semaphores and Mutexs are used to handle task pending/posting and data management.
 * Upon restart the clock starts counting up from 1200 in 24-Hour time on row 1.
 * Can input time on second row to set main time display, using on board keypad.
+* D and B step through the clock, stopwatch and system stats screens.
+* The stats screen shows the least free stack, * there writes the StkMon
+* stack report and app_cfg.h sizes out the SWO port.
 *
 * 01/18/2018, Anthony Needles
+* 10/18/2026 Clock, stopwatch and stats screens on the Screen.c manager
+* 10/18/2026 Staged start up with a boot profile, see Boot.h
+* 10/18/2026 Stack high-water marks and sizing, see StkMon.h
 *****************************************************************************************/
 #include "MCUType.h"
 #include "app_cfg.h"
@@ -13,9 +19,13 @@
 #include "LcdLayered.h"
 #include "uCOSKey.h"
 #include "Time.h"
+#include "Screen.h"
+#include "Boot.h"
+#include "StkMon.h"
 
 #define ROW1 1
 #define ROW2 2
+#define COLUMN1 1
 #define COLUMN9 9
 #define COLUMN10 10
 #define COLUMN12 12
@@ -28,9 +38,32 @@
 #define BLINKON 1
 #define CURSOROFF 0
 #define BLINKOFF 0
+#define SWATCH_START_KEY '*'    /* Start/stop */
+#define SWATCH_RESET_KEY '#'
+#define STATS_STK_KEY '*'      /* Stack report out SWO */
+#define UI_CLOCK_SCREEN 0       /* Index in uiScreens[] */
+#define UI_DIGITS(lo, hi) ((INT16U)(((2u << (hi)) - 1u) & ~((1u << (lo)) - 1u)))
+#define UI_NO_DEP 0xFFu
 
 typedef enum{TIME, TIMESET} UISTATE;
-typedef enum{HOURTENS, HOURONES, MINUTETENS, MINUTEONES, SECONDTENS, SECONDONES} SETSTATE;
+
+typedef struct{                 /* One editable digit                          */
+    INT16U allowed;             /* Bit n set if digit n can be entered         */
+    INT16U dep_allowed;         /* When the digit before is dep_digit, only    */
+    INT8U dep_digit;            /* these can be entered. UI_NO_DEP for none    */
+    INT8U col;                  /* LCD column on ROW2                          */
+}UI_FIELD;
+
+/* Time entry, hh:mm:ss. Hour ones only go to 3 after a hour tens of 2. */
+static const UI_FIELD uiTimeFields[] = {
+    {UI_DIGITS(0,2), 0,              UI_NO_DEP, COLUMN9},      /* Hour tens    */
+    {UI_DIGITS(0,9), UI_DIGITS(0,3), 2,         COLUMN10},     /* Hour ones    */
+    {UI_DIGITS(0,5), 0,              UI_NO_DEP, COLUMN12},     /* Minute tens  */
+    {UI_DIGITS(0,9), 0,              UI_NO_DEP, COLUMN13},     /* Minute ones  */
+    {UI_DIGITS(0,5), 0,              UI_NO_DEP, COLUMN15},     /* Second tens  */
+    {UI_DIGITS(0,9), 0,              UI_NO_DEP, COLUMN16}      /* Second ones  */
+};
+#define UI_TIME_DIGITS ((INT8U)(sizeof(uiTimeFields) / sizeof(uiTimeFields[0])))
 
 static OS_TCB AppTaskStartTCB;
 static OS_TCB UITaskTCB;
@@ -41,16 +74,73 @@ static CPU_STK UITaskStk[APP_CFG_UITASK_STK_SIZE];
 static CPU_STK TimeDispTaskStk[APP_CFG_TIMEDISPTASK_STK_SIZE];
 
 static void  AppStartTask(void *p_arg);
+static void  appTickInit(void);
+static void  appLcdInit(void);
+static void  appScreenInit(void);
+static void  appTaskCreate(void);
+static void  appStatInit(void);
 static void  UITask(void *p_arg);
 static void  TimeDispTask(void *p_arg);
+static INT8U uiEditKey(const UI_FIELD *fields, INT8U num, INT8U *digits, INT8U *pos, INT8U key);
+static void  uiTimeToDigits(const TIME_T *ltime, INT8U *digits);
+static void  uiDigitsToTime(const INT8U *digits, TIME_T *ltime);
+static void  uiTimeSetStart(void);
+static void  uiClockEnter(void);
+static INT8U uiClockKey(INT8U key);
+static void  uiSwatchEnter(void);
+static INT8U uiSwatchKey(INT8U key);
+static void  uiSwatchTick(void);
+static void  uiSwatchDraw(void);
+static void  uiStatsTick(void);
+static INT8U uiStatsKey(INT8U key);
+#if STK_MON_EN
+static void  uiSwoPutc(INT8C c);
+#endif
+
+/* Start up, run in order by AppStartTask. Every stage is quick, the LCD */
+/* powers up in its task with OS delays while the later stages run.     */
+static const BOOT_STAGE appBootStages[] = {
+    {"Tick",      appTickInit},
+    {"LCD",       appLcdInit},
+    {"DBug bits", GpioDBugBitsInit},
+    {"Keys",      KeyInit},
+    {"Time",      TimeInit},
+    {"Screens",   appScreenInit},
+    {"Tasks",     appTaskCreate},
+    {"CPU usage", appStatInit}
+};
+#define APP_BOOT_STAGES ((INT8U)(sizeof(appBootStages) / sizeof(appBootStages[0])))
+
+/* Screens, D steps down the table and B up it. Stats draw on entry. */
+static const SCREEN uiScreens[] = {
+    {TIMEDISPLAYER, 0,    uiClockEnter,  uiClockKey,  0},
+    {SWATCHLAYER,   100,  uiSwatchEnter, uiSwatchKey, uiSwatchTick},
+    {STATSLAYER,    1000, uiStatsTick,   uiStatsKey,  uiStatsTick}
+};
+#define UI_NUM_SCREENS ((INT8U)(sizeof(uiScreens) / sizeof(uiScreens[0])))
+
+/* Clock screen time entry */
+static UISTATE uiState;
+static INT8U uiSetPos;                  /* Digit being entered */
+static INT8U uiDigits[UI_TIME_DIGITS];
+static TIME_T uiSetTime;
+
+/* Stopwatch, kept as ticks so it costs nothing while not shown */
+static OS_TICK uiSwatchStart;           /* OSTimeGet() when last started */
+static OS_TICK uiSwatchAcc;             /* Ticks counted before that     */
+static INT8U uiSwatchRun;
 
 void main(void) {
     OS_ERR  os_err;
 
+    BootStart();
     CPU_IntDis();
 
     OSInit(&os_err);                    /* Initialize uC/OS-III                         */
     while(os_err != OS_ERR_NONE){}
+#if STK_MON_EN
+    StkMonInit();
+#endif
 
     OSTaskCreate(&AppTaskStartTCB,
                  "Start Task",
@@ -66,6 +156,7 @@ void main(void) {
                  (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR),
                  &os_err);
     while(os_err != OS_ERR_NONE){}
+    STK_MON_ADD(&AppTaskStartTCB, APP_CFG_TASK_START_STK_SIZE);
 
     OSStart(&os_err);               /*Start multitasking(i.e. give control to uC/OS)    */
     while(os_err != OS_ERR_NONE){}
@@ -74,12 +165,15 @@ void main(void) {
 * AppStartTask - uCos startup task
 *
 * Description:  This task should run once then be suspended. Could restart
-*               everything if resumed. Runs initialization functions and creates
-*               UITask and TimeDispTask.
+*               everything if resumed. Runs the appBootStages[] start up
+*               stages, which create UITask and TimeDispTask. The boot
+*               profile can be read with BootProfileGet().
 *
 * Return value: None
 *
 * Arguments:    None
+*
+* 10/18/2026 Start up moved to appBootStages[]
 ********************************************************************/
 static void AppStartTask(void *p_arg) {
 
@@ -87,11 +181,41 @@ static void AppStartTask(void *p_arg) {
 
     (void)p_arg;                        /* Avoid compiler warning for unused variable   */
 
+    BOOT_MARK("Start task");
+    BootRun(appBootStages, APP_BOOT_STAGES);
+
+    OSTaskSuspend((OS_TCB *)0, &os_err);
+    while(os_err != OS_ERR_NONE){}
+}
+/********************************************************************
+* appTickInit/appLcdInit/appScreenInit - Start up stages
+*
+* Description:  The tick comes first so later stages can use OS delays.
+*               LcdInit() returns at once, the clock drawn by the screens
+*               stage shows in the LCD task's first frame.
+*
+* 10/18/2026 Moved from AppStartTask
+********************************************************************/
+static void appTickInit(void){
     OS_CPU_SysTickInitFreq(DEFAULT_SYSTEM_CLOCK);
+}
+
+static void appLcdInit(void){
     LcdInit();
-    GpioDBugBitsInit();
-    KeyInit();
-    TimeInit();
+    LcdLayerUrgent(TIMESETLAYER, TRUE);     /* Key entry skips the frame rate cap */
+}
+
+static void appScreenInit(void){
+    ScreenInit(uiScreens, UI_NUM_SCREENS);
+}
+/********************************************************************
+* appTaskCreate - Start up stage, creates UITask and TimeDispTask
+*
+* 10/18/2026 Moved from AppStartTask
+********************************************************************/
+static void appTaskCreate(void){
+
+    OS_ERR os_err;
 
     OSTaskCreate(&UITaskTCB,                  /* Create UITask  */
                 "UITask ",
@@ -107,6 +231,7 @@ static void AppStartTask(void *p_arg) {
                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR),
                 &os_err);
     while(os_err != OS_ERR_NONE){}
+    STK_MON_ADD(&UITaskTCB, APP_CFG_UITASK_STK_SIZE);
 
     OSTaskCreate(&TimeDispTaskTCB,    /* Create TimeDispTask */
                 "TimeDispTask ",
@@ -122,217 +247,373 @@ static void AppStartTask(void *p_arg) {
                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR),
                 &os_err);
     while(os_err != OS_ERR_NONE){}
+    STK_MON_ADD(&TimeDispTaskTCB, APP_CFG_TIMEDISPTASK_STK_SIZE);
+}
+/********************************************************************
+* appStatInit - Start up stage, CPU usage reference for the stats screen
+*
+* Description:  OSStatTaskCPUUsageInit() counts idle loops for 100ms, so
+*               it is the last stage and the clock is up before it. The
+*               LCD power up and first frame fall in its window, about
+*               1ms of bus spinning, so usage reads up to 1% low.
+*
+* 10/18/2026
+********************************************************************/
+static void appStatInit(void){
+#if (OS_CFG_STAT_TASK_EN == DEF_ENABLED)
+    OS_ERR os_err;
 
-    OSTaskSuspend((OS_TCB *)0, &os_err);
+    OSStatTaskCPUUsageInit(&os_err);
     while(os_err != OS_ERR_NONE){}
+#endif
 }
 /********************************************************************
-* UITask - Time/Time Set state handler
+* UITask - Key and screen handler
 *
-* Description:  This task handles keypad input, and will alter the time
-*               of day if in TIMESET mode as per the lab hand out. Runs whenever
-*               new key is pressed. '#' if in Time mode will trigger Time Set
-*               mode, and C or A will exit Time Set and enter Time
-*               (either saving current edited time or discarding). First time
-*               run through will skip key pending to start in "out of reset"
-*               mode (see init_check).
+* Description:  This task passes keypad input to the active screen, see
+*               Screen.c, and runs the active screen's refresh between
+*               keys. Starts in time set on the clock screen, "out of
+*               reset" mode.
 *
 * Return value: None
 *
 * Arguments:    None
 *
 * Anthony Needles - 01/20/18
+* 10/18/2026 Digit entry moved to the uiTimeFields[] table
+* 10/18/2026 Time/Time Set handling moved to the clock screen
 ********************************************************************/
 static void UITask(void *p_arg){
 
     OS_ERR os_err;
     (void)p_arg;
-    UISTATE ui_state = TIMESET;
-    SETSTATE set_state = HOURTENS;
     INT8U user_input;
-    TIME_T buffertime;
-    INT8U init_check = 1;
-    
+    INT16U tout;
+
+    uiTimeSetStart();
     while(1){
-    
-        if(init_check){
-            init_check = 0;
-            TimeGet(&buffertime);
-            LcdDispTime(ROW2, COLUMN9, TIMESETLAYER, buffertime.hr, buffertime.min, buffertime.sec);
-            LcdCursor(ROW2, COLUMN9, TIMESETLAYER, CURSORON, BLINKON);
+        tout = ScreenService();
+        DB0_TURN_OFF();
+        user_input = KeyPend(tout,&os_err);
+        DB0_TURN_ON();
+        if(os_err == OS_ERR_NONE){
+            ScreenKey(user_input);
         } else{
-            DB0_TURN_OFF();
-            user_input = KeyPend(0,&os_err);
-            while(os_err != OS_ERR_NONE){}
-            DB0_TURN_ON();
+            while(os_err != OS_ERR_TIMEOUT){}
         }
+    }
+}
+/********************************************************************
+* uiTimeSetStart - Enters Time Set on the clock screen
+*
+* Description:  Loads the running time for editing and shows it on the
+*               time set layer with the cursor on the first digit.
+*
+* 10/18/2026 Moved from UITask
+********************************************************************/
+static void uiTimeSetStart(void){
+    TimeGet(&uiSetTime);
+    uiTimeToDigits(&uiSetTime, uiDigits);
+    LcdShowLayer(TIMESETLAYER);
+    LcdDispTime(ROW2, COLUMN9, TIMESETLAYER, uiSetTime.hr, uiSetTime.min, uiSetTime.sec);
+    uiState = TIMESET;
+    uiSetPos = 0;
+    LcdCursor(ROW2, uiTimeFields[0].col, TIMESETLAYER, CURSORON, BLINKON);
+}
+/********************************************************************
+* uiClockEnter - Clock screen, draws the running time on ROW1
+*
+* 10/18/2026
+********************************************************************/
+static void uiClockEnter(void){
+    TIME_T ltime;
 
-        switch(ui_state){
-            case(TIMESET):
-                switch(user_input){
-                    case(A_PRESS):
-                        ui_state = TIME;
-                        TimeSet(&buffertime);
-                        LcdHideLayer(TIMESETLAYER);
-                        break;
-                    case(C_PRESS):
-                        ui_state = TIME;
-                        LcdHideLayer(TIMESETLAYER);
-                        break;
-                    default:
-                        break;
-                }
-                switch(set_state){
-                    case(HOURTENS):
-                        switch(user_input){
-                            case('0'):
-                            case('1'):
-                            case('2'):
-                                user_input = ((user_input - 0x30)*10);
-                                buffertime.hr = (buffertime.hr % 10) + user_input;
-                                set_state = HOURONES;
-                                LcdCursor(ROW2, COLUMN10, TIMESETLAYER, CURSORON, BLINKON);
-                                break;
-                            default:
-                                break;
-                        }
-                    break;
-                    case(HOURONES):
-                        switch(user_input){
-                            case('0'):  //Uses "fall through" property of switch
-                            case('1'):  //statements for threshold checking
-                            case('2'):
-                            case('3'):
-                                user_input = (user_input - 0x30);
-                                buffertime.hr = (buffertime.hr - (buffertime.hr % 10)) + user_input;
-                                set_state = MINUTETENS;
-                                LcdCursor(ROW2, COLUMN12, TIMESETLAYER, CURSORON, BLINKON);
-                                break;
-                            case('4'):
-                            case('5'):
-                            case('6'):
-                            case('7'):
-                            case('8'):
-                            case('9'):
-                                if((buffertime.hr/10) != 2){
-                                    user_input = (user_input - 0x30);
-                                    buffertime.hr = (buffertime.hr - (buffertime.hr % 10)) + user_input;
-                                    set_state = MINUTETENS;
-                                    LcdCursor(ROW2, COLUMN12, TIMESETLAYER, CURSORON, BLINKON);
-                                } else{
-                                }
-                                break;
-                            default:
-                                break;
-                        }
+    TimeGet(&ltime);
+    LcdDispTime(ROW1, COLUMN9, TIMEDISPLAYER, ltime.hr, ltime.min, ltime.sec);
+}
+/********************************************************************
+* uiClockKey - Clock screen, Time/Time Set key handler
+*
+* Description:  Alters the time of day if in TIMESET mode as per the lab
+*               hand out. '#' if in Time mode will trigger Time Set mode,
+*               and C or A will exit Time Set and enter Time (either
+*               saving current edited time or discarding). Digits are
+*               checked and placed by uiEditKey() from the uiTimeFields[]
+*               table. Time Set takes every key, so the screen can't be
+*               switched away from part way through an edit.
+*
+* Return value: TRUE if the key was used
+*
+* Arguments:    key - ASCII key code
+*
+* Anthony Needles - 01/20/18
+* 10/18/2026 Moved from UITask
+********************************************************************/
+static INT8U uiClockKey(INT8U key){
+
+    INT8U used = TRUE;
+    INT8U last_pos;
+
+    switch(uiState){
+        case(TIMESET):
+            switch(key){
+                case(A_PRESS):
+                    uiState = TIME;
+                    TimeSet(&uiSetTime);
+                    LcdHideLayer(TIMESETLAYER);
                     break;
-                    case(MINUTETENS):
-                        switch(user_input){
-                            case('0'):
-                            case('1'):
-                            case('2'):
-                            case('3'):
-                            case('4'):
-                            case('5'):
-                                user_input = ((user_input - 0x30)*10);
-                                buffertime.min = (buffertime.min % 10) + user_input;
-                                set_state = MINUTEONES;
-                                LcdCursor(ROW2, COLUMN13, TIMESETLAYER, CURSORON, BLINKON);
-                                break;
-                            default:
-                                break;
-                        }
+                case(C_PRESS):
+                    uiState = TIME;
+                    LcdHideLayer(TIMESETLAYER);
                     break;
-                    case(MINUTEONES):
-                        switch(user_input){
-                            case('0'):
-                            case('1'):
-                            case('2'):
-                            case('3'):
-                            case('4'):
-                            case('5'):
-                            case('6'):
-                            case('7'):
-                            case('8'):
-                            case('9'):
-                                user_input = (user_input - 0x30);
-                                buffertime.min = (buffertime.min - (buffertime.min % 10)) + user_input;
-                                set_state = SECONDTENS;
-                                LcdCursor(ROW2, COLUMN15, TIMESETLAYER, CURSORON, BLINKON);
-                                break;
-                            default:
-                                break;
-                        }
+                default:
+                    last_pos = uiSetPos;
+                    if(uiEditKey(uiTimeFields, UI_TIME_DIGITS, uiDigits, &uiSetPos, key)){
+                        uiDigitsToTime(uiDigits, &uiSetTime);
+                    } else{
+                    }
+                    if(uiSetPos != last_pos){
+                        LcdCursor(ROW2, uiTimeFields[uiSetPos].col, TIMESETLAYER, CURSORON, BLINKON);
+                    } else{
+                    }
                     break;
-                    case(SECONDTENS):
-                        switch(user_input){
-                            case('0'):
-                            case('1'):
-                            case('2'):
-                            case('3'):
-                            case('4'):
-                            case('5'):
-                                user_input = ((user_input - 0x30)*10);
-                                buffertime.sec = (buffertime.sec % 10) + user_input;
-                                set_state = SECONDONES;
-                                LcdCursor(ROW2, COLUMN16, TIMESETLAYER, CURSORON, BLINKON);
-                                break;
-                            default:
-                                break;
-                        }
+            }
+        LcdDispTime(ROW2, COLUMN9, TIMESETLAYER, uiSetTime.hr, uiSetTime.min, uiSetTime.sec);
+        break;
+        case(TIME):
+            switch(key){
+                case('#'):
+                    uiTimeSetStart();
                     break;
-                    case(SECONDONES):
-                        switch(user_input){
-                            case('0'):
-                            case('1'):
-                            case('2'):
-                            case('3'):
-                            case('4'):
-                            case('5'):
-                            case('6'):
-                            case('7'):
-                            case('8'):
-                            case('9'):
-                                user_input = (user_input - 0x30);
-                                buffertime.sec = (buffertime.sec - (buffertime.sec % 10)) + user_input;
-                                break;
-                            default:
-                                break;
-                        }
+                default:
+                    used = FALSE;
                     break;
-                }
-            LcdDispTime(ROW2, COLUMN9, TIMESETLAYER, buffertime.hr, buffertime.min, buffertime.sec);
+            }
+            break;
+        default:
+            used = FALSE;
             break;
-            case(TIME):
-                switch(user_input){
-                    case('#'):
-                        TimeGet(&buffertime);
-                        LcdShowLayer(TIMESETLAYER);
-                        LcdDispTime(ROW2, COLUMN9, TIMESETLAYER, buffertime.hr, buffertime.min, buffertime.sec);
-                        ui_state = TIMESET;
-                        set_state = HOURTENS;
-                        LcdCursor(ROW2, COLUMN9, TIMESETLAYER, CURSORON, BLINKON);
-                        break;
-                    default:
-                        break;
-                }
-                break;
-            default:
-                break;
-        }
     }
+    return used;
+}
+/********************************************************************
+* uiSwatchEnter/uiSwatchKey/uiSwatchTick - Stopwatch screen
+*
+* Description:  '*' starts and stops, '#' zeroes it and keeps it going
+*               if it was. Shows mm:ss.t on ROW2, refreshed every 100ms
+*               while it is running and the screen is up.
+*
+* 10/18/2026
+********************************************************************/
+static void uiSwatchEnter(void){
+    (void)LcdPrintf(ROW1, COLUMN1, SWATCHLAYER, "Stopwatch");
+    uiSwatchDraw();
+}
+
+static INT8U uiSwatchKey(INT8U key){
+
+    OS_ERR os_err;
+    OS_TICK now = OSTimeGet(&os_err);
+    INT8U used = TRUE;
+
+    switch(key){
+        case(SWATCH_START_KEY):
+            if(uiSwatchRun){
+                uiSwatchAcc += now - uiSwatchStart;
+                uiSwatchRun = FALSE;
+            } else{
+                uiSwatchStart = now;
+                uiSwatchRun = TRUE;
+            }
+            break;
+        case(SWATCH_RESET_KEY):
+            uiSwatchAcc = 0;
+            uiSwatchStart = now;
+            break;
+        default:
+            used = FALSE;
+            break;
+    }
+    if(used){
+        uiSwatchDraw();
+    } else{
+    }
+    return used;
+}
+
+static void uiSwatchTick(void){
+    if(uiSwatchRun){
+        uiSwatchDraw();
+    } else{
+    }
+}
+
+static void uiSwatchDraw(void){
+
+    OS_ERR os_err;
+    OS_TICK ticks = uiSwatchAcc;
+    INT32U tenths;
+
+    if(uiSwatchRun){
+        ticks += OSTimeGet(&os_err) - uiSwatchStart;
+    } else{
+    }
+    tenths = ticks / (OS_CFG_TICK_RATE_HZ / 10u);
+    (void)LcdPrintf(ROW2, COLUMN9, SWATCHLAYER, "%02u:%02u.%u",
+                    (INT32U)((tenths / 600u) % 100u), (INT32U)((tenths / 10u) % 60u),
+                    (INT32U)(tenths % 10u));
+}
+/********************************************************************
+* uiStatsTick - System stats screen, drawn on entry and every second
+*
+* Description:  CPU usage from the statistics task and the least free
+*               stack words on ROW1, LCD frames and key events on ROW2.
+*
+* 10/18/2026
+********************************************************************/
+static void uiStatsTick(void){
+
+    LCD_STATS lcd_stats;
+    KEY_STATS key_stats;
+    OS_CPU_USAGE usage = OSStatTaskCPUUsage;
+#if STK_MON_EN
+    INT32U stk_free = StkMonLeastFree();
+
+    if(stk_free > 999u){
+        stk_free = 999u;
+    } else{
+    }
+#endif
+
+    (void)LcdStatsGet(0, &lcd_stats);
+    KeyStatsGet(&key_stats);
+    (void)LcdPrintf(ROW1, COLUMN1, STATSLAYER, "CPU %3u.%02u%%",
+                    (INT32U)(usage / 100u), (INT32U)(usage % 100u));
+#if STK_MON_EN
+    (void)LcdPrintf(ROW1, COLUMN13, STATSLAYER, "S%3u", stk_free);
+#endif
+    (void)LcdPrintf(ROW2, COLUMN1, STATSLAYER, "F%-7u K%-6u",
+                    (INT32U)lcd_stats.frames, (INT32U)key_stats.events);
+}
+/********************************************************************
+* uiStatsKey - System stats screen keys
+*
+* Description:  STATS_STK_KEY writes the StkMon report and app_cfg.h
+*               stack sizes out the SWO port, for the debugger's ITM
+*               console. Run the app through everything first, the
+*               sizes are only as good as the run.
+*
+* Return value: TRUE if the key was used
+*
+* Arguments:    key - ASCII key code
+*
+* 10/18/2026
+********************************************************************/
+static INT8U uiStatsKey(INT8U key){
+
+#if STK_MON_EN
+    if(key == STATS_STK_KEY){
+        StkMonCfgWrite(uiSwoPutc);
+        return TRUE;
+    } else{
+    }
+#else
+    (void)key;
+#endif
+    return FALSE;
+}
+#if STK_MON_EN
+/********************************************************************
+* uiSwoPutc - One character out ITM stimulus port 0
+*
+* Description:  ITM_SendChar() drops the character if no debugger has
+*               the port enabled.
+*
+* 10/18/2026
+********************************************************************/
+static void uiSwoPutc(INT8C c){
+    (void)ITM_SendChar((uint32_t)(INT8U)c);
+}
+#endif
+/********************************************************************
+* uiEditKey - Enters a digit key into a field of digits
+*
+* Description:  The digit is checked against the table entry for the
+*               position: the digits allowed, narrowed to dep_allowed
+*               when the digit before is dep_digit. One table lookup
+*               and a mask test, whatever the position. An accepted
+*               digit is stored and the position moves on, it stays
+*               on the last digit.
+*
+* Return value: TRUE if the key was accepted
+*
+* Arguments:    fields - The field table, one entry per digit
+*               num - Digits in the field
+*               digits - The digits being edited, 0 to 9 each
+*               *pos - The position, updated
+*               key - ASCII key code
+*
+* 10/18/2026
+********************************************************************/
+static INT8U uiEditKey(const UI_FIELD *fields, INT8U num, INT8U *digits, INT8U *pos, INT8U key){
+
+    const UI_FIELD *field = &fields[*pos];
+    INT16U allowed;
+    INT8U digit = (INT8U)(key - '0');
+
+    if(digit > 9){
+        return FALSE;
+    } else{
+    }
+    allowed = field->allowed;
+    if((*pos != 0) && (digits[*pos - 1] == field->dep_digit)){
+        allowed = field->dep_allowed;
+    } else{
+    }
+    if((allowed & (1u << digit)) == 0){
+        return FALSE;
+    } else{
+    }
+    digits[*pos] = digit;
+    if(*pos < (num - 1)){
+        (*pos)++;
+    } else{
+    }
+    return TRUE;
+}
+/********************************************************************
+* uiTimeToDigits/uiDigitsToTime - Convert between TIME_T and the
+*                                 six uiTimeFields[] digits, hhmmss
+*
+* 10/18/2026
+********************************************************************/
+static void uiTimeToDigits(const TIME_T *ltime, INT8U *digits){
+    digits[0] = ltime->hr / 10;
+    digits[1] = ltime->hr % 10;
+    digits[2] = ltime->min / 10;
+    digits[3] = ltime->min % 10;
+    digits[4] = ltime->sec / 10;
+    digits[5] = ltime->sec % 10;
+}
+
+static void uiDigitsToTime(const INT8U *digits, TIME_T *ltime){
+    ltime->hr = (INT8U)((digits[0] * 10) + digits[1]);
+    ltime->min = (INT8U)((digits[2] * 10) + digits[3]);
+    ltime->sec = (INT8U)((digits[4] * 10) + digits[5]);
 }
 /********************************************************************
 * TimeDispTask - Displays time on ROW1
 *
 * Description:  This task will grab the current timeOfDay in Time.c every time
-*               the time changes and displays it on the LCD.
+*               the time changes and displays it on the LCD. Sleeps while
+*               the clock screen is not up.
 *
 * Return value: None
 *
 * Arguments:    None
 *
 * Anthony Needles - 01/20/18
+* 10/18/2026 Waits for the clock screen
 ********************************************************************/
 static void TimeDispTask(void *p_arg){
 
@@ -345,6 +626,7 @@ static void TimeDispTask(void *p_arg){
     while(1) {                                  /* wait for Task 1 to signal semaphore  */
 
         DB2_TURN_OFF();                         /* Turn off debug bit while waiting     */
+        ScreenPend(UI_CLOCK_SCREEN);
         TimePend(&ltime);
         DB2_TURN_ON();
         LcdDispTime(ROW1, COLUMN9, TIMEDISPLAYER, ltime.hr, ltime.min, ltime.sec);
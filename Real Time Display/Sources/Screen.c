@@ -0,0 +1,186 @@
+/*******************************************************************************
+* Screen.c - Screen manager. Each screen owns an LCD layer, only the active
+*            screen's layer is shown and only the active screen gets keys
+*            and Tick calls. See Screen.h.
+*
+*            A task that draws a screen on its own events waits in
+*            ScreenPend() while the screen is not up, on an event flag
+*            group with a bit per screen.
+*
+* Created on: 10/18/2026
+*******************************************************************************/
+#include "MCUType.h"
+#include "app_cfg.h"
+#include "os.h"
+#include "LcdLayered.h"
+#include "Screen.h"
+
+#define SCREEN_TICKS(ms) ((OS_TICK)((((INT32U)(ms) * OS_CFG_TICK_RATE_HZ) + 999u) / 1000u))
+#define SCREEN_FLAG(id) ((OS_FLAGS)1u << (id))
+
+static const SCREEN *screenTable;
+static INT8U screenNum;
+static INT8U screenCur;
+static OS_TICK screenDue;              /* Tick the active screen's Tick is due */
+static OS_FLAG_GRP screenFlags;        /* Bit per screen, set while active     */
+
+/********************************************************************
+* ScreenInit - Sets up the screen table
+*
+* Description:  Creates screenFlags with the first screen's bit set,
+*               hides every other screen's layer and shows the first.
+*
+* Return value: None
+*
+* Arguments:    screens - The screen table
+*               num - Screens in the table, 1 to SCREEN_MAX
+*
+* 10/18/2026
+********************************************************************/
+void ScreenInit(const SCREEN *screens, INT8U num){
+    OS_ERR os_err;
+    INT8U id;
+
+    while((num == 0) || (num > SCREEN_MAX)){}  /* Error Trap */
+
+    screenTable = screens;
+    screenNum = num;
+    screenCur = 0;
+
+    OSFlagCreate(&screenFlags, "Screen Flags", SCREEN_FLAG(0), &os_err);
+    while(os_err != OS_ERR_NONE){}
+
+    for(id = 1; id < num; id++){
+        LcdHideLayer(screens[id].layer);
+    }
+    if(screens[0].Enter != 0){
+        screens[0].Enter();
+    }else{
+    }
+    LcdShowLayer(screens[0].layer);
+    screenDue = OSTimeGet(&os_err) + SCREEN_TICKS(screens[0].period_ms);
+}
+/********************************************************************
+* ScreenSelect - Makes a screen the active one
+*
+* Description:  The new layer is drawn while hidden, so the swap is the
+*               only LCD work. The old screen's flag is cleared before
+*               the new one's is set, a task waiting on the new screen
+*               runs once the UI task blocks.
+*
+* Return value: None
+*
+* Arguments:    id - Index of the screen in the table
+*
+* 10/18/2026
+********************************************************************/
+void ScreenSelect(INT8U id){
+    OS_ERR os_err;
+    const SCREEN *scr;
+
+    if((id < screenNum) && (id != screenCur)){
+        scr = &screenTable[id];
+        if(scr->Enter != 0){
+            scr->Enter();
+        }else{
+        }
+        LcdSwapLayers(screenTable[screenCur].layer, scr->layer);
+
+        (void)OSFlagPost(&screenFlags, SCREEN_FLAG(screenCur), OS_OPT_POST_FLAG_CLR, &os_err);
+        while(os_err != OS_ERR_NONE){}
+        screenCur = id;
+        (void)OSFlagPost(&screenFlags, SCREEN_FLAG(id), OS_OPT_POST_FLAG_SET, &os_err);
+        while(os_err != OS_ERR_NONE){}
+
+        screenDue = OSTimeGet(&os_err) + SCREEN_TICKS(scr->period_ms);
+    }else{
+    }
+}
+/********************************************************************
+* ScreenKey - Passes a key to the active screen
+*
+* Return value: None
+*
+* Arguments:    key - ASCII key code
+*
+* 10/18/2026
+********************************************************************/
+void ScreenKey(INT8U key){
+    const SCREEN *scr = &screenTable[screenCur];
+
+    if((scr->Key != 0) && scr->Key(key)){
+    }else if(key == SCREEN_NEXT_KEY){
+        ScreenSelect((INT8U)((screenCur + 1u) % screenNum));
+    }else if(key == SCREEN_PREV_KEY){
+        ScreenSelect((INT8U)((screenCur + screenNum - 1u) % screenNum));
+    }else{
+    }
+}
+/********************************************************************
+* ScreenService - Ticks the active screen when it is due
+*
+* Description:  Tick calls keep to the period, if the UI task falls a
+*               whole period behind the next one is a period from now
+*               rather than a burst to catch up.
+*
+* Return value: Ticks until the next Tick call, 0 if the active screen
+*               has none
+*
+* Arguments:    None
+*
+* 10/18/2026
+********************************************************************/
+INT16U ScreenService(void){
+    OS_ERR os_err;
+    OS_TICK now, period;
+    const SCREEN *scr = &screenTable[screenCur];
+
+    if((scr->Tick == 0) || (scr->period_ms == 0)){
+        return 0;
+    }else{
+    }
+    period = SCREEN_TICKS(scr->period_ms);
+    now = OSTimeGet(&os_err);
+    if((INT32S)(screenDue - now) <= 0){
+        scr->Tick();
+        screenDue += period;
+        if((INT32S)(screenDue - now) <= 0){
+            screenDue = now + period;
+        }else{
+        }
+    }else{
+    }
+    return (INT16U)(screenDue - now);
+}
+/********************************************************************
+* ScreenActive - The active screen
+*
+* Return value: Index of the active screen in the table
+*
+* Arguments:    None
+*
+* 10/18/2026
+********************************************************************/
+INT8U ScreenActive(void){
+    return screenCur;
+}
+/********************************************************************
+* ScreenPend - Waits until a screen is active
+*
+* Description:  Pends on the screen's bit in screenFlags without
+*               consuming it.
+*
+* Return value: None
+*
+* Arguments:    id - Index of the screen in the table
+*
+* 10/18/2026
+********************************************************************/
+void ScreenPend(INT8U id){
+    OS_ERR os_err;
+
+    (void)OSFlagPend(&screenFlags, SCREEN_FLAG(id), 0,
+                     (OS_OPT_PEND_FLAG_SET_ALL | OS_OPT_PEND_BLOCKING),
+                     (CPU_TS *)0, &os_err);
+    while(os_err != OS_ERR_NONE){}
+}
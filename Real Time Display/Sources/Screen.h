@@ -0,0 +1,116 @@
+/*******************************************************************************
+* Screen.h - Project header for Screen.c
+*
+*            A screen is an LCD layer and the handlers that draw it and take
+*            its keys. Only the active screen's layer is shown, and only the
+*            active screen gets keys and refresh calls, so a screen that is
+*            not up costs no CPU and no LCD work. Switching screens is a
+*            layer swap, the new layer is brought up to date while it is
+*            still hidden and goes on the glass in one frame.
+*
+*            Keys a screen does not use switch screens, SCREEN_NEXT_KEY
+*            and SCREEN_PREV_KEY step through the table in order.
+*
+* Created on: 10/18/2026
+*******************************************************************************/
+#ifndef SOURCES_SCREEN_H_
+#define SOURCES_SCREEN_H_
+
+#define SCREEN_MAX 8u                   /* Screens in a table, at most      */
+#define SCREEN_NEXT_KEY 0x14u           /* D                                */
+#define SCREEN_PREV_KEY 0x12u           /* B                                */
+
+typedef struct{
+    INT8U layer;                /* LCD layer, shown only while active       */
+    INT16U period_ms;           /* Tick period while active, 0 for none     */
+    void (*Enter)(void);        /* Bring the layer up to date, called while */
+                                /* it is still hidden. May be 0             */
+    INT8U (*Key)(INT8U key);    /* Handle a key, TRUE if it was used. May   */
+                                /* be 0                                     */
+    void (*Tick)(void);         /* Refresh the layer. May be 0              */
+}SCREEN;
+
+/********************************************************************
+* ScreenInit - Sets up the screen table
+*
+* Description:  Shows the first screen and hides the rest. Call once,
+*               after LcdInit() and before the tasks that use the
+*               screens are created. The table is not copied.
+*
+* Return value: None
+*
+* Arguments:    screens - The screen table
+*               num - Screens in the table, 1 to SCREEN_MAX
+*
+* 10/18/2026
+********************************************************************/
+void ScreenInit(const SCREEN *screens, INT8U num);
+/********************************************************************
+* ScreenSelect - Makes a screen the active one
+*
+* Description:  Calls the new screen's Enter handler, then swaps its
+*               layer in for the old screen's. Nothing happens if the
+*               screen is already active. Only call from the UI task.
+*
+* Return value: None
+*
+* Arguments:    id - Index of the screen in the table
+*
+* 10/18/2026
+********************************************************************/
+void ScreenSelect(INT8U id);
+/********************************************************************
+* ScreenKey - Passes a key to the active screen
+*
+* Description:  Keys the active screen does not use are checked for
+*               SCREEN_NEXT_KEY and SCREEN_PREV_KEY. Only call from
+*               the UI task.
+*
+* Return value: None
+*
+* Arguments:    key - ASCII key code
+*
+* 10/18/2026
+********************************************************************/
+void ScreenKey(INT8U key);
+/********************************************************************
+* ScreenService - Ticks the active screen when it is due
+*
+* Description:  Calls the active screen's Tick handler if its period has
+*               gone by. Only call from the UI task, before each key
+*               pend, using the result as the pend timeout.
+*
+* Return value: Ticks until the next Tick call, 0 if the active screen
+*               has none
+*
+* Arguments:    None
+*
+* 10/18/2026
+********************************************************************/
+INT16U ScreenService(void);
+/********************************************************************
+* ScreenActive - The active screen
+*
+* Return value: Index of the active screen in the table
+*
+* Arguments:    None
+*
+* 10/18/2026
+********************************************************************/
+INT8U ScreenActive(void);
+/********************************************************************
+* ScreenPend - Waits until a screen is active
+*
+* Description:  For tasks that update a screen's layer on their own
+*               events. Returns at once if the screen is active,
+*               otherwise the task sleeps until it is selected.
+*
+* Return value: None
+*
+* Arguments:    id - Index of the screen in the table
+*
+* 10/18/2026
+********************************************************************/
+void ScreenPend(INT8U id);
+
+#endif /* SOURCES_SCREEN_H_ */
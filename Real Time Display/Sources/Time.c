@@ -12,6 +12,7 @@
 #include "os.h"
 #include "Time.h"
 #include "K65TWR_GPIO.h"
+#include "StkMon.h"
 
 static void timeTask(void *p_arg);
 static OS_TCB ApptimeTaskTCB;
@@ -70,6 +71,7 @@ void TimeInit(void){
                 (OS_OPT      )(OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR),
                 (OS_ERR     *)&os_err);
     while(os_err != OS_ERR_NONE){}
+    STK_MON_ADD(&ApptimeTaskTCB, APP_CFG_TIME_TASK_STK_SIZE);
 
 
 }
@@ -202,18 +204,24 @@ void TimeGet(TIME_T *ltime){
 * Description:  This function will copy over running time to passed time
 *               structure it can access timeMutexKey, just like TimeGet,
 *               except only when the time changes. Used so that time to
-*               display is only updated once a second.
+*               display is only updated once a second. Changes that went
+*               by with nobody pending, while the clock screen was not
+*               up, are dropped so the caller wakes once, not once each.
 *
 * Return value: *ltime - Pointer to time structure to copy to
 *
 * Arguments:    None
 *
 * Anthony Needles - 01/23/18
+* 10/18/2026 Drops missed changes
 ********************************************************************/
 void TimePend(TIME_T *ltime){
     OS_ERR os_err;
     (void)OSSemPend(&timeChgFlag,0,OS_OPT_PEND_BLOCKING,(CPU_TS *)0,&os_err);
     while(os_err != OS_ERR_NONE){}
 
+    OSSemSet(&timeChgFlag, 0, &os_err);
+    while(os_err != OS_ERR_NONE){}
+
     *ltime = timeOfDay;
 }
@@ -20,7 +20,8 @@ typedef struct { //Main structure used to hold current/buffer 24-hour times
 * Description:  This function will copy over running time to passed time
 *               structure it can access timeMutexKey, just like TimeGet,
 *               except only when the time changes. Used so that time to
-*               display is only updated once a second.
+*               display is only updated once a second. Changes missed
+*               while nobody was pending are dropped.
 *
 * Return value: *ltime - Pointer to time structure to copy to
 *